@@ -56,9 +56,17 @@
  * CRC16 CCITT checksum. */
 /* #define CO_USE_OWN_CRC16 */
 
+/* If defined, the Object Dictionary is flattened into a table of descriptors
+ * for faster access, see CO_OD_descriptor_t. This speeds up the OD access of
+ * SDO transfers, not the whole request, see benchmark/sdo_expedited.c of the
+ * socketCAN driver. With CO_USE_GLOBALS the size of
+ * the table must be defined by CO_OD_DESCRIPTORS_SIZE_FIXED, at least the
+ * number of subIndexes of all OD entries. Otherwise the table is not used. */
+/* #define CO_USE_OD_DESCRIPTORS */
+
 #ifndef CO_USE_GLOBALS
     #include <stdlib.h> /*  for malloc, free */
-    static uint32_t CO_memoryUsed = 0; /* informative */
+    #include <string.h> /*  for memcpy */
 #endif
 
 
@@ -67,13 +75,7 @@
     static CO_t COO;
     CO_t *CO = NULL;
 
-    static CO_CANrx_t          *CO_CANmodule_rxArray0;
-    static CO_CANtx_t          *CO_CANmodule_txArray0;
-    static CO_OD_extension_t   *CO_SDO_ODExtensions;
-    static CO_HBconsNode_t     *CO_HBcons_monitoredNodes;
 #if CO_NO_TRACE > 0
-    static uint32_t            *CO_traceTimeBuffers[CO_NO_TRACE];
-    static int32_t             *CO_traceValueBuffers[CO_NO_TRACE];
   #ifdef CO_USE_GLOBALS
   #ifndef CO_TRACE_BUFFER_SIZE_FIXED
     #define CO_TRACE_BUFFER_SIZE_FIXED 100
@@ -81,6 +83,14 @@
   #endif
 #endif
 
+#ifdef CO_USE_OD_DESCRIPTORS
+  #ifdef CO_USE_GLOBALS
+  #ifndef CO_OD_DESCRIPTORS_SIZE_FIXED
+    #error CO_OD_DESCRIPTORS_SIZE_FIXED must be defined for CO_USE_OD_DESCRIPTORS with CO_USE_GLOBALS!
+  #endif
+  #endif
+#endif
+
 
 /* Verify features from CO_OD *************************************************/
     /* generate error, if features are not correctly configured for this project */
@@ -140,6 +150,10 @@
     static CO_CANtx_t           COO_CANmodule_txArray0[CO_TXCAN_NO_MSGS];
     static CO_SDO_t             COO_SDO[CO_NO_SDO_SERVER];
     static CO_OD_extension_t    COO_SDO_ODExtensions[CO_OD_NoOfElements];
+    static uint16_t             COO_SDO_ODIndex[CO_OD_INDEX_SIZE(CO_OD_NoOfElements)];
+#ifdef CO_USE_OD_DESCRIPTORS
+    static CO_OD_descriptor_t   COO_SDO_ODDescriptors[CO_OD_DESCRIPTORS_SIZE_FIXED];
+#endif
     static CO_EM_t              COO_EM;
     static CO_EMpr_t            COO_EMpr;
     static CO_NMT_t             COO_NMT;
@@ -171,22 +185,135 @@
 #endif
 
 
+/* Object Dictionary of a CANopen object **************************************/
+/*
+ * Use the global Object Dictionary variables.
+ */
+static void CO_OD_useGlobals(CO_t *CO)
+{
+    CO->OD = &CO_OD[0];
+    CO->OD_RAM = &CO_OD_RAM;
+    CO->OD_EEPROM = &CO_OD_EEPROM;
+    CO->OD_ROM = &CO_OD_ROM;
+}
+
+#ifndef CO_USE_GLOBALS
+/*
+ * Translate pointer to a global Object Dictionary variable into pointer to the
+ * same variable of the CANopen object. Other pointers are not changed.
+ */
+static void *CO_OD_relocate(CO_t *CO, void *pData)
+{
+    const uint8_t *p = (const uint8_t*)pData;
+
+    if(p >= (const uint8_t*)&CO_OD_RAM && p < (const uint8_t*)(&CO_OD_RAM + 1)){
+        return (uint8_t*)CO->OD_RAM + (p - (const uint8_t*)&CO_OD_RAM);
+    }
+    if(p >= (const uint8_t*)&CO_OD_EEPROM && p < (const uint8_t*)(&CO_OD_EEPROM + 1)){
+        return (uint8_t*)CO->OD_EEPROM + (p - (const uint8_t*)&CO_OD_EEPROM);
+    }
+    if(p >= (const uint8_t*)&CO_OD_ROM && p < (const uint8_t*)(&CO_OD_ROM + 1)){
+        return (uint8_t*)CO->OD_ROM + (p - (const uint8_t*)&CO_OD_ROM);
+    }
+    return pData;
+}
+
+/*
+ * Create own copy of the Object Dictionary for a CANopen object. The
+ * variables are initialized from the global ones. Entries and records are
+ * copied, because they contain pointers to the variables.
+ */
+static CO_ReturnError_t CO_OD_newInstance(CO_t *CO)
+{
+    uint16_t i;
+    uint16_t noOfRecords = 0;
+    CO_OD_entry_t *OD;
+    CO_OD_entryRecord_t *records;
+
+    for(i=0; i<CO_OD_NoOfElements; i++){
+        if(CO_OD[i].maxSubIndex != 0U && CO_OD[i].attribute == 0U){
+            noOfRecords += CO_OD[i].maxSubIndex + 1U;
+        }
+    }
+
+    CO->OD_RAM = (struct sCO_OD_RAM *) malloc(sizeof(CO_OD_RAM));
+    CO->OD_EEPROM = (struct sCO_OD_EEPROM *) malloc(sizeof(CO_OD_EEPROM));
+    CO->OD_ROM = (struct sCO_OD_ROM *) malloc(sizeof(CO_OD_ROM));
+    /* entries, followed by subentries of all records */
+    OD = (CO_OD_entry_t *) malloc(CO_OD_NoOfElements * sizeof(CO_OD_entry_t)
+                                  + noOfRecords * sizeof(CO_OD_entryRecord_t));
+    CO->OD = OD;
+    if(CO->OD_RAM == NULL || CO->OD_EEPROM == NULL || CO->OD_ROM == NULL || OD == NULL){
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    records = (CO_OD_entryRecord_t *) &OD[CO_OD_NoOfElements];
+    memcpy(CO->OD_RAM, &CO_OD_RAM, sizeof(CO_OD_RAM));
+    memcpy(CO->OD_EEPROM, &CO_OD_EEPROM, sizeof(CO_OD_EEPROM));
+    memcpy(CO->OD_ROM, &CO_OD_ROM, sizeof(CO_OD_ROM));
+
+    for(i=0; i<CO_OD_NoOfElements; i++){
+        OD[i] = CO_OD[i];
+        if(CO_OD[i].maxSubIndex != 0U && CO_OD[i].attribute == 0U){
+            /* Record, pData points to array of subentries */
+            const CO_OD_entryRecord_t *record = (const CO_OD_entryRecord_t*)CO_OD[i].pData;
+            uint16_t j;
+
+            for(j=0; j<=CO_OD[i].maxSubIndex; j++){
+                records[j] = record[j];
+                records[j].pData = CO_OD_relocate(CO, record[j].pData);
+            }
+            OD[i].pData = records;
+            records += CO_OD[i].maxSubIndex + 1U;
+        }
+        else{
+            OD[i].pData = CO_OD_relocate(CO, CO_OD[i].pData);
+        }
+    }
+    CO->memoryUsed += sizeof(CO_OD_RAM) + sizeof(CO_OD_EEPROM) + sizeof(CO_OD_ROM)
+                    + CO_OD_NoOfElements * sizeof(CO_OD_entry_t)
+                    + noOfRecords * sizeof(CO_OD_entryRecord_t);
+
+    return CO_ERROR_NO;
+}
+
+/*
+ * Free Object Dictionary copy of a CANopen object, if any.
+ */
+static void CO_OD_deleteInstance(CO_t *CO)
+{
+    if(CO->OD != &CO_OD[0]){
+        free((void*)CO->OD);
+        free(CO->OD_RAM);
+        free(CO->OD_EEPROM);
+        free(CO->OD_ROM);
+    }
+    CO->OD = NULL;
+    CO->OD_RAM = NULL;
+    CO->OD_EEPROM = NULL;
+    CO->OD_ROM = NULL;
+}
+#endif /* CO_USE_GLOBALS */
+
+/* OD_xxx macros from CO_OD.h refer to the global variables. From here on,
+ * they refer to the variables of the CANopen object "CO" in scope: the
+ * function argument or the global object. */
+#include "CO_OD_instance.h"
+
+
 /* Helper function for NMT master *********************************************/
 #if CO_NO_NMT_MASTER == 1
-    CO_CANtx_t *NMTM_txBuff = 0;
-
     static CO_ReturnError_t CO_sendNMTcommandInternal(
             CO_t      *CO,
             uint8_t    command,
             uint8_t    nodeID,
             bool_t     ignoreBcst)
     {
-        if(NMTM_txBuff == 0){
+        if(CO->NMTM_txBuff == 0){
             /* error, CO_CANtxBufferInit() was not called for this buffer. */
             return CO_ERROR_TX_UNCONFIGURED; /* -11 */
         }
-        NMTM_txBuff->data[0] = command;
-        NMTM_txBuff->data[1] = nodeID;
+        CO->NMTM_txBuff->data[0] = command;
+        CO->NMTM_txBuff->data[1] = nodeID;
 
         /* Apply NMT command also to this node, if set so. */
         if((nodeID == 0 && ignoreBcst == 0) || nodeID == CO->NMT->nodeId){
@@ -211,7 +338,7 @@
             }
         }
 
-        return CO_CANsend(CO->CANmodule[0], NMTM_txBuff); /* 0 = success */
+        return CO_CANsend(CO->CANmodule[0], CO->NMTM_txBuff); /* 0 = success */
     }
 
     CO_ReturnError_t CO_sendNMTcommand(
@@ -232,19 +359,11 @@
 #endif
 
 
-#if CO_NO_TRACE > 0
-static uint32_t CO_traceBufferSize[CO_NO_TRACE];
-#endif
-
-/******************************************************************************/
-CO_ReturnError_t CO_new(void)
+/*
+ * Verify parameters from CO_OD.
+ */
+static CO_ReturnError_t CO_verifyParameters(void)
 {
-    int16_t i;
-#ifndef CO_USE_GLOBALS
-    uint16_t errCnt;
-#endif
-
-    /* Verify parameters from CO_OD */
     if(   sizeof(OD_TPDOCommunicationParameter_t) != sizeof(CO_TPDOCommPar_t)
        || sizeof(OD_TPDOMappingParameter_t) != sizeof(CO_TPDOMapPar_t)
        || sizeof(OD_RPDOCommunicationParameter_t) != sizeof(CO_RPDOCommPar_t)
@@ -259,149 +378,133 @@ CO_ReturnError_t CO_new(void)
     }
     #endif
 
+    return CO_ERROR_NO;
+}
 
-    /* Initialize CANopen object */
-#ifdef CO_USE_GLOBALS
-    CO = &COO;
 
-    CO->CANmodule[0]                    = &COO_CANmodule;
-    CO_CANmodule_rxArray0               = &COO_CANmodule_rxArray0[0];
-    CO_CANmodule_txArray0               = &COO_CANmodule_txArray0[0];
-    for(i=0; i<CO_NO_SDO_SERVER; i++)
-        CO->SDO[i]                      = &COO_SDO[i];
-    CO_SDO_ODExtensions                 = &COO_SDO_ODExtensions[0];
-    CO->em                              = &COO_EM;
-    CO->emPr                            = &COO_EMpr;
-    CO->NMT                             = &COO_NMT;
-    CO->SYNC                            = &COO_SYNC;
-    for(i=0; i<CO_NO_RPDO; i++)
-        CO->RPDO[i]                     = &COO_RPDO[i];
-    for(i=0; i<CO_NO_TPDO; i++)
-        CO->TPDO[i]                     = &COO_TPDO[i];
-    CO->HBcons                          = &COO_HBcons;
-    CO_HBcons_monitoredNodes            = &COO_HBcons_monitoredNodes[0];
+#ifndef CO_USE_GLOBALS
+/*
+ * Allocate all objects of a CANopen object.
+ *
+ * Allocated memory must be verified with CO_verifyAllocation().
+ */
+static void CO_allocate(CO_t *CO)
+{
+    int16_t i;
+
+    CO->CANmodule[0]                    = (CO_CANmodule_t *)    calloc(1, sizeof(CO_CANmodule_t));
+    CO->CANmodule_rxArray0              = (CO_CANrx_t *)        calloc(CO_RXCAN_NO_MSGS, sizeof(CO_CANrx_t));
+    CO->CANmodule_txArray0              = (CO_CANtx_t *)        calloc(CO_TXCAN_NO_MSGS, sizeof(CO_CANtx_t));
+    for(i=0; i<CO_NO_SDO_SERVER; i++){
+        CO->SDO[i]                      = (CO_SDO_t *)          calloc(1, sizeof(CO_SDO_t));
+    }
+    CO->SDO_ODExtensions                = (CO_OD_extension_t*)  calloc(CO_OD_NoOfElements, sizeof(CO_OD_extension_t));
+    CO->SDO_ODIndex                     = (uint16_t *)          calloc(CO_OD_INDEX_SIZE(CO_OD_NoOfElements), sizeof(uint16_t));
+  #ifdef CO_USE_OD_DESCRIPTORS
+    CO->SDO_ODDescriptorsSize           = CO_OD_getDescriptorCount(CO_OD, CO_OD_NoOfElements);
+    CO->SDO_ODDescriptors               = (CO_OD_descriptor_t*) calloc(CO->SDO_ODDescriptorsSize, sizeof(CO_OD_descriptor_t));
+    if(CO->SDO_ODDescriptors == NULL) {
+        CO->SDO_ODDescriptorsSize = 0;
+    }
+  #endif
+    CO->em                              = (CO_EM_t *)           calloc(1, sizeof(CO_EM_t));
+    CO->emPr                            = (CO_EMpr_t *)         calloc(1, sizeof(CO_EMpr_t));
+    CO->NMT                             = (CO_NMT_t *)          calloc(1, sizeof(CO_NMT_t));
+    CO->SYNC                            = (CO_SYNC_t *)         calloc(1, sizeof(CO_SYNC_t));
+    for(i=0; i<CO_NO_RPDO; i++){
+        CO->RPDO[i]                     = (CO_RPDO_t *)         calloc(1, sizeof(CO_RPDO_t));
+    }
+    for(i=0; i<CO_NO_TPDO; i++){
+        CO->TPDO[i]                     = (CO_TPDO_t *)         calloc(1, sizeof(CO_TPDO_t));
+    }
+    CO->HBcons                          = (CO_HBconsumer_t *)   calloc(1, sizeof(CO_HBconsumer_t));
+    CO->HBcons_monitoredNodes           = (CO_HBconsNode_t *)   calloc(CO_NO_HB_CONS, sizeof(CO_HBconsNode_t));
   #if CO_NO_LSS_SERVER == 1
-    CO->LSSslave                        = &CO0_LSSslave;
+    CO->LSSslave                        = (CO_LSSslave_t *)     calloc(1, sizeof(CO_LSSslave_t));
   #endif
   #if CO_NO_LSS_CLIENT == 1
-    CO->LSSmaster                       = &CO0_LSSmaster;
+    CO->LSSmaster                       = (CO_LSSmaster_t *)    calloc(1, sizeof(CO_LSSmaster_t));
+  #endif
+  #if CO_DAISY_CONSUMER == 1
+    CO->DaisyConsumer                   = (CO_DaisyConsumer_t *)calloc(1, sizeof(CO_DaisyConsumer_t));
+  #endif
+  #if CO_DAISY_PRODUCER == 1
+    CO->DaisyProducer                   = (CO_DaisyProducer_t *)calloc(1, sizeof(CO_DaisyProducer_t));
   #endif
-#if CO_DAISY_CONSUMER == 1
-    CO->DaisyConsumer                   = &CO0_DaisyConsumer;
-#endif
-#if CO_DAISY_PRODUCER == 1
-    CO->DaisyProducer                   = &CO0_DaisyProducer;
-#endif
   #if CO_NO_SDO_CLIENT != 0
-    for(i=0; i<CO_NO_SDO_CLIENT; i++) {
-      CO->SDOclient[i]                  = &COO_SDOclient[i];
+    for(i=0; i<CO_NO_SDO_CLIENT; i++){
+        CO->SDOclient[i]                = (CO_SDOclient_t *)    calloc(1, sizeof(CO_SDOclient_t));
     }
   #endif
   #if CO_NO_TRACE > 0
     for(i=0; i<CO_NO_TRACE; i++) {
-        CO->trace[i]                    = &COO_trace[i];
-        CO_traceTimeBuffers[i]          = &COO_traceTimeBuffers[i][0];
-        CO_traceValueBuffers[i]         = &COO_traceValueBuffers[i][0];
-        CO_traceBufferSize[i]           = CO_TRACE_BUFFER_SIZE_FIXED;
+        CO->trace[i]                    = (CO_trace_t *)        calloc(1, sizeof(CO_trace_t));
+        CO->traceTimeBuffers[i]         = (uint32_t *)          calloc(OD_traceConfig[i].size, sizeof(uint32_t));
+        CO->traceValueBuffers[i]        = (int32_t *)           calloc(OD_traceConfig[i].size, sizeof(int32_t));
+        if(CO->traceTimeBuffers[i] != NULL && CO->traceValueBuffers[i] != NULL) {
+            CO->traceBufferSize[i] = OD_traceConfig[i].size;
+        } else {
+            CO->traceBufferSize[i] = 0;
+        }
     }
   #endif
-#else
-    if(CO == NULL){    /* Use malloc only once */
-        CO = &COO;
-        CO->CANmodule[0]                    = (CO_CANmodule_t *)    calloc(1, sizeof(CO_CANmodule_t));
-        CO_CANmodule_rxArray0               = (CO_CANrx_t *)        calloc(CO_RXCAN_NO_MSGS, sizeof(CO_CANrx_t));
-        CO_CANmodule_txArray0               = (CO_CANtx_t *)        calloc(CO_TXCAN_NO_MSGS, sizeof(CO_CANtx_t));
-        for(i=0; i<CO_NO_SDO_SERVER; i++){
-            CO->SDO[i]                      = (CO_SDO_t *)          calloc(1, sizeof(CO_SDO_t));
-        }
-        CO_SDO_ODExtensions                 = (CO_OD_extension_t*)  calloc(CO_OD_NoOfElements, sizeof(CO_OD_extension_t));
-        CO->em                              = (CO_EM_t *)           calloc(1, sizeof(CO_EM_t));
-        CO->emPr                            = (CO_EMpr_t *)         calloc(1, sizeof(CO_EMpr_t));
-        CO->NMT                             = (CO_NMT_t *)          calloc(1, sizeof(CO_NMT_t));
-        CO->SYNC                            = (CO_SYNC_t *)         calloc(1, sizeof(CO_SYNC_t));
-        for(i=0; i<CO_NO_RPDO; i++){
-            CO->RPDO[i]                     = (CO_RPDO_t *)         calloc(1, sizeof(CO_RPDO_t));
-        }
-        for(i=0; i<CO_NO_TPDO; i++){
-            CO->TPDO[i]                     = (CO_TPDO_t *)         calloc(1, sizeof(CO_TPDO_t));
-        }
-        CO->HBcons                          = (CO_HBconsumer_t *)   calloc(1, sizeof(CO_HBconsumer_t));
-        CO_HBcons_monitoredNodes            = (CO_HBconsNode_t *)   calloc(CO_NO_HB_CONS, sizeof(CO_HBconsNode_t));
-      #if CO_NO_LSS_SERVER == 1
-        CO->LSSslave                        = (CO_LSSslave_t *)     calloc(1, sizeof(CO_LSSslave_t));
-      #endif
-      #if CO_NO_LSS_CLIENT == 1
-        CO->LSSmaster                       = (CO_LSSmaster_t *)    calloc(1, sizeof(CO_LSSmaster_t));
-      #endif
-      #if CO_DAISY_CONSUMER == 1
-        CO->DaisyConsumer                   = (CO_DaisyConsumer_t *)calloc(1, sizeof(CO_DaisyConsumer_t));
-      #endif
-      #if CO_DAISY_PRODUCER == 1
-        CO->DaisyProducer                   = (CO_DaisyProducer_t *)calloc(1, sizeof(CO_DaisyProducer_t));
-      #endif
-      #if CO_NO_SDO_CLIENT != 0
-        for(i=0; i<CO_NO_SDO_CLIENT; i++){
-            CO->SDOclient[i]                = (CO_SDOclient_t *)    calloc(1, sizeof(CO_SDOclient_t));
-        }
-      #endif
-      #if CO_NO_TRACE > 0
-        for(i=0; i<CO_NO_TRACE; i++) {
-            CO->trace[i]                    = (CO_trace_t *)        calloc(1, sizeof(CO_trace_t));
-            CO_traceTimeBuffers[i]          = (uint32_t *)          calloc(OD_traceConfig[i].size, sizeof(uint32_t));
-            CO_traceValueBuffers[i]         = (int32_t *)           calloc(OD_traceConfig[i].size, sizeof(int32_t));
-            if(CO_traceTimeBuffers[i] != NULL && CO_traceValueBuffers[i] != NULL) {
-                CO_traceBufferSize[i] = OD_traceConfig[i].size;
-            } else {
-                CO_traceBufferSize[i] = 0;
-            }
-        }
-      #endif
-    }
-
-    CO_memoryUsed = sizeof(CO_CANmodule_t)
-                  + sizeof(CO_CANrx_t) * CO_RXCAN_NO_MSGS
-                  + sizeof(CO_CANtx_t) * CO_TXCAN_NO_MSGS
-                  + sizeof(CO_SDO_t) * CO_NO_SDO_SERVER
-                  + sizeof(CO_OD_extension_t) * CO_OD_NoOfElements
-                  + sizeof(CO_EM_t)
-                  + sizeof(CO_EMpr_t)
-                  + sizeof(CO_NMT_t)
-                  + sizeof(CO_SYNC_t)
-                  + sizeof(CO_RPDO_t) * CO_NO_RPDO
-                  + sizeof(CO_TPDO_t) * CO_NO_TPDO
-                  + sizeof(CO_HBconsumer_t)
-                  + sizeof(CO_HBconsNode_t) * CO_NO_HB_CONS
+
+    CO->memoryUsed += sizeof(CO_CANmodule_t)
+                    + sizeof(CO_CANrx_t) * CO_RXCAN_NO_MSGS
+                    + sizeof(CO_CANtx_t) * CO_TXCAN_NO_MSGS
+                    + sizeof(CO_SDO_t) * CO_NO_SDO_SERVER
+                    + sizeof(CO_OD_extension_t) * CO_OD_NoOfElements
+                    + sizeof(uint16_t) * CO_OD_INDEX_SIZE(CO_OD_NoOfElements)
+                    + sizeof(CO_OD_descriptor_t) * CO->SDO_ODDescriptorsSize
+                    + sizeof(CO_EM_t)
+                    + sizeof(CO_EMpr_t)
+                    + sizeof(CO_NMT_t)
+                    + sizeof(CO_SYNC_t)
+                    + sizeof(CO_RPDO_t) * CO_NO_RPDO
+                    + sizeof(CO_TPDO_t) * CO_NO_TPDO
+                    + sizeof(CO_HBconsumer_t)
+                    + sizeof(CO_HBconsNode_t) * CO_NO_HB_CONS
   #if CO_NO_LSS_SERVER == 1
-                  + sizeof(CO_LSSslave_t)
+                    + sizeof(CO_LSSslave_t)
   #endif
   #if CO_NO_LSS_CLIENT == 1
-                  + sizeof(CO_LSSmaster_t)
+                    + sizeof(CO_LSSmaster_t)
   #endif
   #if CO_DAISY_CONSUMER == 1
-                  + sizeof(CO_DaisyProducer_t)
+                    + sizeof(CO_DaisyConsumer_t)
   #endif
   #if CO_DAISY_PRODUCER == 1
-                  + sizeof(CO_DaisyConsumer_t)
+                    + sizeof(CO_DaisyProducer_t)
   #endif
   #if CO_NO_SDO_CLIENT != 0
-                  + sizeof(CO_SDOclient_t) * CO_NO_SDO_CLIENT
+                    + sizeof(CO_SDOclient_t) * CO_NO_SDO_CLIENT
   #endif
-                  + 0;
+                    + 0;
   #if CO_NO_TRACE > 0
-    CO_memoryUsed += sizeof(CO_trace_t) * CO_NO_TRACE;
+    CO->memoryUsed += sizeof(CO_trace_t) * CO_NO_TRACE;
     for(i=0; i<CO_NO_TRACE; i++) {
-        CO_memoryUsed += CO_traceBufferSize[i] * 8;
+        CO->memoryUsed += CO->traceBufferSize[i] * 8;
     }
   #endif
+}
+
+
+/*
+ * Verify if all objects of a CANopen object are allocated.
+ */
+static CO_ReturnError_t CO_verifyAllocation(CO_t *CO)
+{
+    int16_t i;
+    uint16_t errCnt = 0;
 
-    errCnt = 0;
     if(CO->CANmodule[0]                 == NULL) errCnt++;
-    if(CO_CANmodule_rxArray0            == NULL) errCnt++;
-    if(CO_CANmodule_txArray0            == NULL) errCnt++;
+    if(CO->CANmodule_rxArray0           == NULL) errCnt++;
+    if(CO->CANmodule_txArray0           == NULL) errCnt++;
     for(i=0; i<CO_NO_SDO_SERVER; i++){
         if(CO->SDO[i]                   == NULL) errCnt++;
     }
-    if(CO_SDO_ODExtensions              == NULL) errCnt++;
+    if(CO->SDO_ODExtensions             == NULL) errCnt++;
+    if(CO->SDO_ODIndex                  == NULL) errCnt++;
     if(CO->em                           == NULL) errCnt++;
     if(CO->emPr                         == NULL) errCnt++;
     if(CO->NMT                          == NULL) errCnt++;
@@ -413,7 +516,7 @@ CO_ReturnError_t CO_new(void)
         if(CO->TPDO[i]                  == NULL) errCnt++;
     }
     if(CO->HBcons                       == NULL) errCnt++;
-    if(CO_HBcons_monitoredNodes         == NULL) errCnt++;
+    if(CO->HBcons_monitoredNodes        == NULL) errCnt++;
   #if CO_NO_LSS_SERVER == 1
     if(CO->LSSslave                     == NULL) errCnt++;
   #endif
@@ -437,16 +540,203 @@ CO_ReturnError_t CO_new(void)
     }
   #endif
 
-    if(errCnt != 0) return CO_ERROR_OUT_OF_MEMORY;
+    return (errCnt != 0) ? CO_ERROR_OUT_OF_MEMORY : CO_ERROR_NO;
+}
+
+
+/*
+ * Free all objects of a CANopen object.
+ */
+static void CO_free(CO_t *CO)
+{
+    int16_t i;
+
+  #if CO_NO_TRACE > 0
+    for(i=0; i<CO_NO_TRACE; i++) {
+        free(CO->trace[i]);
+        free(CO->traceTimeBuffers[i]);
+        free(CO->traceValueBuffers[i]);
+    }
+  #endif
+  #if CO_NO_SDO_CLIENT != 0
+    for(i=0; i<CO_NO_SDO_CLIENT; i++) {
+        free(CO->SDOclient[i]);
+    }
+  #endif
+  #if CO_NO_LSS_SERVER == 1
+    free(CO->LSSslave);
+  #endif
+  #if CO_NO_LSS_CLIENT == 1
+    free(CO->LSSmaster);
+  #endif
+  #if CO_DAISY_CONSUMER == 1
+    free(CO->DaisyConsumer);
+  #endif
+  #if CO_DAISY_PRODUCER == 1
+    free(CO->DaisyProducer);
+  #endif
+    free(CO->HBcons_monitoredNodes);
+    free(CO->HBcons);
+    for(i=0; i<CO_NO_RPDO; i++){
+        free(CO->RPDO[i]);
+    }
+    for(i=0; i<CO_NO_TPDO; i++){
+        free(CO->TPDO[i]);
+    }
+    free(CO->SYNC);
+    free(CO->NMT);
+    free(CO->emPr);
+    free(CO->em);
+    free(CO->SDO_ODDescriptors);
+    free(CO->SDO_ODIndex);
+    free(CO->SDO_ODExtensions);
+    for(i=0; i<CO_NO_SDO_SERVER; i++){
+        free(CO->SDO[i]);
+    }
+    free(CO->CANmodule_txArray0);
+    free(CO->CANmodule_rxArray0);
+    free(CO->CANmodule[0]);
+    CO_OD_deleteInstance(CO);
+}
+#endif /* CO_USE_GLOBALS */
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_new(void)
+{
+#ifdef CO_USE_GLOBALS
+    int16_t i;
+#endif
+    CO_ReturnError_t err;
+
+    err = CO_verifyParameters();
+    if(err){
+        return err;
+    }
+
+    /* Initialize CANopen object */
+#ifdef CO_USE_GLOBALS
+    CO = &COO;
+
+    CO->CANmodule[0]                    = &COO_CANmodule;
+    CO->CANmodule_rxArray0              = &COO_CANmodule_rxArray0[0];
+    CO->CANmodule_txArray0              = &COO_CANmodule_txArray0[0];
+    for(i=0; i<CO_NO_SDO_SERVER; i++)
+        CO->SDO[i]                      = &COO_SDO[i];
+    CO->SDO_ODExtensions                = &COO_SDO_ODExtensions[0];
+    CO->SDO_ODIndex                     = &COO_SDO_ODIndex[0];
+  #ifdef CO_USE_OD_DESCRIPTORS
+    CO->SDO_ODDescriptors               = &COO_SDO_ODDescriptors[0];
+    CO->SDO_ODDescriptorsSize           = CO_OD_DESCRIPTORS_SIZE_FIXED;
+  #endif
+    CO->em                              = &COO_EM;
+    CO->emPr                            = &COO_EMpr;
+    CO->NMT                             = &COO_NMT;
+    CO->SYNC                            = &COO_SYNC;
+    for(i=0; i<CO_NO_RPDO; i++)
+        CO->RPDO[i]                     = &COO_RPDO[i];
+    for(i=0; i<CO_NO_TPDO; i++)
+        CO->TPDO[i]                     = &COO_TPDO[i];
+    CO->HBcons                          = &COO_HBcons;
+    CO->HBcons_monitoredNodes           = &COO_HBcons_monitoredNodes[0];
+  #if CO_NO_LSS_SERVER == 1
+    CO->LSSslave                        = &CO0_LSSslave;
+  #endif
+  #if CO_NO_LSS_CLIENT == 1
+    CO->LSSmaster                       = &CO0_LSSmaster;
+  #endif
+#if CO_DAISY_CONSUMER == 1
+    CO->DaisyConsumer                   = &CO0_DaisyConsumer;
+#endif
+#if CO_DAISY_PRODUCER == 1
+    CO->DaisyProducer                   = &CO0_DaisyProducer;
+#endif
+  #if CO_NO_SDO_CLIENT != 0
+    for(i=0; i<CO_NO_SDO_CLIENT; i++) {
+      CO->SDOclient[i]                  = &COO_SDOclient[i];
+    }
+  #endif
+  #if CO_NO_TRACE > 0
+    for(i=0; i<CO_NO_TRACE; i++) {
+        CO->trace[i]                    = &COO_trace[i];
+        CO->traceTimeBuffers[i]         = &COO_traceTimeBuffers[i][0];
+        CO->traceValueBuffers[i]        = &COO_traceValueBuffers[i][0];
+        CO->traceBufferSize[i]          = CO_TRACE_BUFFER_SIZE_FIXED;
+    }
+  #endif
+    CO_OD_useGlobals(CO);
+#else
+    if(CO == NULL){    /* Use malloc only once */
+        CO = &COO;
+        CO_allocate(CO);
+        CO_OD_useGlobals(CO);
+    }
+
+    err = CO_verifyAllocation(CO);
+    if(err){
+        return err;
+    }
 #endif
     return CO_ERROR_NO;
 }
 
 
+/******************************************************************************/
+CO_ReturnError_t CO_newInstance(CO_t **pCO)
+{
+#ifdef CO_USE_GLOBALS
+    /* there is only one set of static objects */
+    (void)pCO;
+    return CO_ERROR_OUT_OF_MEMORY;
+#else
+    CO_t *newCO;
+    CO_ReturnError_t err;
+
+    if(pCO == NULL){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    err = CO_verifyParameters();
+    if(err){
+        return err;
+    }
+
+    newCO = (CO_t *) calloc(1, sizeof(CO_t));
+    if(newCO == NULL){
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    newCO->memoryUsed = sizeof(CO_t);
+    CO_allocate(newCO);
+    err = CO_OD_newInstance(newCO);
+    if(err == CO_ERROR_NO){
+        err = CO_verifyAllocation(newCO);
+    }
+    if(err){
+        CO_free(newCO);
+        free(newCO);
+        return err;
+    }
+
+    *pCO = newCO;
+    return CO_ERROR_NO;
+#endif
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_CANinit(
         int32_t                 CANbaseAddress,
         uint16_t                bitRate)
+{
+    return CO_CANinitInstance(CO, CANbaseAddress, bitRate);
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANinitInstance(
+        CO_t                   *CO,
+        int32_t                 CANbaseAddress,
+        uint16_t                bitRate)
 {
     CO_ReturnError_t err;
 
@@ -456,9 +746,9 @@ CO_ReturnError_t CO_CANinit(
     err = CO_CANmodule_init(
             CO->CANmodule[0],
             CANbaseAddress,
-            CO_CANmodule_rxArray0,
+            CO->CANmodule_rxArray0,
             CO_RXCAN_NO_MSGS,
-            CO_CANmodule_txArray0,
+            CO->CANmodule_txArray0,
             CO_TXCAN_NO_MSGS,
             bitRate);
 
@@ -471,6 +761,16 @@ CO_ReturnError_t CO_CANinit(
 CO_ReturnError_t CO_LSSinit(
         uint8_t                 nodeId,
         uint16_t                bitRate)
+{
+    return CO_LSSinitInstance(CO, nodeId, bitRate);
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_LSSinitInstance(
+        CO_t                   *CO,
+        uint8_t                 nodeId,
+        uint16_t                bitRate)
 {
     CO_LSS_address_t lssAddress;
     CO_ReturnError_t err;
@@ -499,6 +799,15 @@ CO_ReturnError_t CO_LSSinit(
 /******************************************************************************/
 CO_ReturnError_t CO_CANopenInit(
         uint8_t                 nodeId)
+{
+    return CO_CANopenInitInstance(CO, nodeId);
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANopenInitInstance(
+        CO_t                   *CO,
+        uint8_t                 nodeId)
 {
     int16_t i;
     CO_ReturnError_t err;
@@ -527,9 +836,13 @@ CO_ReturnError_t CO_CANopenInit(
                 COB_IDServerToClient,
                 OD_H1200_SDO_SERVER_PARAM+i,
                 i==0 ? 0 : CO->SDO[0],
-               &CO_OD[0],
+                CO->OD,
                 CO_OD_NoOfElements,
-                CO_SDO_ODExtensions,
+                CO->SDO_ODExtensions,
+                CO->SDO_ODIndex,
+                CO_OD_INDEX_SIZE(CO_OD_NoOfElements),
+                CO->SDO_ODDescriptors,
+                CO->SDO_ODDescriptorsSize,
                 nodeId,
                 CO->CANmodule[0],
                 CO_RXCAN_SDO_SRV+i,
@@ -572,7 +885,7 @@ CO_ReturnError_t CO_CANopenInit(
 
 
 #if CO_NO_NMT_MASTER == 1
-    NMTM_txBuff = CO_CANtxBufferInit(/* return pointer to 8-byte CAN data buffer, which should be populated */
+    CO->NMTM_txBuff = CO_CANtxBufferInit(/* return pointer to 8-byte CAN data buffer, which should be populated */
             CO->CANmodule[0], /* pointer to CAN module used for sending this message */
             CO_TXCAN_NMT,     /* index of specific buffer inside CAN module */
             0x0000,           /* CAN identifier */
@@ -687,7 +1000,7 @@ CO_ReturnError_t CO_CANopenInit(
             CO->em,
             CO->SDO[0],
            &OD_consumerHeartbeatTime[0],
-            CO_HBcons_monitoredNodes,
+            CO->HBcons_monitoredNodes,
             CO_NO_HB_CONS,
             CO->CANmodule[0],
             CO_RXCAN_CONS_HB);
@@ -720,9 +1033,9 @@ CO_ReturnError_t CO_CANopenInit(
             CO->trace[i],
             CO->SDO[0],
             OD_traceConfig[i].axisNo,
-            CO_traceTimeBuffers[i],
-            CO_traceValueBuffers[i],
-            CO_traceBufferSize[i],
+            CO->traceTimeBuffers[i],
+            CO->traceValueBuffers[i],
+            CO->traceBufferSize[i],
             &OD_traceConfig[i].map,
             &OD_traceConfig[i].format,
             &OD_traceConfig[i].trigger,
@@ -771,58 +1084,28 @@ CO_ReturnError_t CO_init(
 
 /******************************************************************************/
 void CO_delete(int32_t CANbaseAddress){
+    CO_CANsetConfigurationMode(CANbaseAddress);
+    CO_CANmodule_disable(CO->CANmodule[0]);
+
 #ifndef CO_USE_GLOBALS
-    int16_t i;
+    CO_free(CO);
+    CO = NULL;
 #endif
+}
+
+
+/******************************************************************************/
+void CO_deleteInstance(CO_t *CO, int32_t CANbaseAddress){
+    if(CO == NULL){
+        return;
+    }
 
     CO_CANsetConfigurationMode(CANbaseAddress);
     CO_CANmodule_disable(CO->CANmodule[0]);
 
 #ifndef CO_USE_GLOBALS
-  #if CO_NO_TRACE > 0
-      for(i=0; i<CO_NO_TRACE; i++) {
-          free(CO->trace[i]);
-          free(CO_traceTimeBuffers[i]);
-          free(CO_traceValueBuffers[i]);
-      }
-  #endif
-  #if CO_NO_SDO_CLIENT == 1
-      for(i=0; i<CO_NO_SDO_CLIENT; i++) {
-          free(CO->SDOclient[i]);
-      }
-  #endif
-  #if CO_NO_LSS_SERVER == 1
-    free(CO->LSSslave);
-  #endif
-  #if CO_NO_LSS_CLIENT == 1
-    free(CO->LSSmaster);
-  #if CO_DAISY_CONSUMER == 1
-    free(CO->DaisyConsumer);
-  #endif
-  #if CO_DAISY_PRODUCER == 1
-    free(CO->DaisyProducer);
-  #endif
-  #endif
-    free(CO_HBcons_monitoredNodes);
-    free(CO->HBcons);
-    for(i=0; i<CO_NO_RPDO; i++){
-        free(CO->RPDO[i]);
-    }
-    for(i=0; i<CO_NO_TPDO; i++){
-        free(CO->TPDO[i]);
-    }
-    free(CO->SYNC);
-    free(CO->NMT);
-    free(CO->emPr);
-    free(CO->em);
-    free(CO_SDO_ODExtensions);
-    for(i=0; i<CO_NO_SDO_SERVER; i++){
-        free(CO->SDO[i]);
-    }
-    free(CO_CANmodule_txArray0);
-    free(CO_CANmodule_rxArray0);
-    free(CO->CANmodule[0]);
-    CO = NULL;
+    CO_free(CO);
+    free(CO);
 #endif
 }
 
@@ -836,20 +1119,27 @@ CO_NMT_reset_cmd_t CO_process(
     uint8_t i;
     bool_t NMTisPreOrOperational = false;
     CO_NMT_reset_cmd_t reset = CO_RESET_NOT;
-    static uint16_t ms50 = 0;
 
     if(CO->NMT->operatingState == CO_NMT_PRE_OPERATIONAL || CO->NMT->operatingState == CO_NMT_OPERATIONAL)
         NMTisPreOrOperational = true;
 
-    ms50 += timeDifference_ms;
-    if(ms50 >= 50){
-        ms50 -= 50;
+    CO->ms50 += timeDifference_ms;
+    while(CO->ms50 >= 50){
+        CO->ms50 -= 50;
         CO_NMT_blinkingProcess50ms(CO->NMT);
     }
+    /* LED blinking needs a 50 ms cycle */
     if(timerNext_ms != NULL){
+#ifdef CO_PROCESS_TICKLESS
+        /* exactly until the next LED step */
+        if(*timerNext_ms > 50 - CO->ms50){
+            *timerNext_ms = 50 - CO->ms50;
+        }
+#else
         if(*timerNext_ms > 50){
             *timerNext_ms = 50;
         }
+#endif
     }
 
 
@@ -883,7 +1173,8 @@ CO_NMT_reset_cmd_t CO_process(
     CO_HBconsumer_process(
             CO->HBcons,
             NMTisPreOrOperational,
-            timeDifference_ms);
+            timeDifference_ms,
+            timerNext_ms);
 
     return reset;
 }
@@ -892,12 +1183,13 @@ CO_NMT_reset_cmd_t CO_process(
 /******************************************************************************/
 bool_t CO_process_SYNC_RPDO(
         CO_t                   *CO,
-        uint32_t                timeDifference_us)
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us)
 {
     int16_t i;
     bool_t syncWas = false;
 
-    switch(CO_SYNC_process(CO->SYNC, timeDifference_us, OD_synchronousWindowLength)){
+    switch(CO_SYNC_process(CO->SYNC, timeDifference_us, OD_synchronousWindowLength, timerNext_us)){
         case 1:     //immediately after the SYNC message
             syncWas = true;
             break;
@@ -918,7 +1210,8 @@ bool_t CO_process_SYNC_RPDO(
 void CO_process_TPDO(
         CO_t                   *CO,
         bool_t                  syncWas,
-        uint32_t                timeDifference_us)
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us)
 {
     int16_t i;
 
@@ -931,7 +1224,32 @@ void CO_process_TPDO(
             /* Verify PDO Change of State */
             CO->TPDO[i]->sendRequest = CO_TPDOisCOS(CO->TPDO[i]);
         }
-        CO_TPDO_process(CO->TPDO[i], CO->SYNC, syncWas, timeDifference_us);
+        CO_TPDO_process(CO->TPDO[i], CO->SYNC, syncWas, timeDifference_us, timerNext_us);
+    }
+}
+
+
+/******************************************************************************/
+void CO_process_catchUp(
+        CO_t                   *CO,
+        uint32_t                timeDifference_us)
+{
+    int16_t i;
+    CO_SYNC_t *SYNC = CO->SYNC;
+    uint32_t timerNew;
+
+    /* same conditions as in CO_SYNC_process(), no overflow */
+    if(*SYNC->operatingState == CO_NMT_OPERATIONAL || *SYNC->operatingState == CO_NMT_PRE_OPERATIONAL){
+        timerNew = SYNC->timer + timeDifference_us;
+        SYNC->timer = (timerNew > SYNC->timer) ? timerNew : UINT32_MAX;
+    }
+
+    /* same as end of CO_TPDO_process() */
+    for(i=0; i<CO_NO_TPDO; i++){
+        CO_TPDO_t *TPDO = CO->TPDO[i];
+
+        TPDO->inhibitTimer = (TPDO->inhibitTimer > timeDifference_us) ? (TPDO->inhibitTimer - timeDifference_us) : 0;
+        TPDO->eventTimer = (TPDO->eventTimer > timeDifference_us) ? (TPDO->eventTimer - timeDifference_us) : 0;
     }
 }
 
@@ -82,6 +82,7 @@ extern "C" {
     #include "CO_NMT_Heartbeat.h"
     #include "CO_SYNC.h"
     #include "CO_PDO.h"
+    #include "CO_timerWheel.h"
     #include "CO_HBconsumer.h"
 #if CO_NO_SDO_CLIENT != 0
     #include "CO_SDOmaster.h"
@@ -160,10 +161,40 @@ typedef struct{
 #if CO_NO_TRACE > 0
     CO_trace_t         *trace[CO_NO_TRACE]; /**< Trace object for monitoring variables */
 #endif
+    /* Internal state of this instance, from CO_new() or CO_newInstance() */
+    CO_CANrx_t         *CANmodule_rxArray0; /**< Receive buffers of CANmodule[0] */
+    CO_CANtx_t         *CANmodule_txArray0; /**< Transmit buffers of CANmodule[0] */
+    CO_OD_extension_t  *SDO_ODExtensions;   /**< Object Dictionary extensions */
+    uint16_t           *SDO_ODIndex;        /**< Buffer for the OD index of CO_OD_find() */
+    CO_OD_descriptor_t *SDO_ODDescriptors;  /**< Buffer for OD descriptors or NULL */
+    uint16_t            SDO_ODDescriptorsSize; /**< Number of above descriptors */
+    CO_HBconsNode_t    *HBcons_monitoredNodes; /**< Nodes of HBcons */
+#if CO_NO_NMT_MASTER == 1
+    CO_CANtx_t         *NMTM_txBuff;        /**< Transmit buffer of NMT master */
+#endif
+#if CO_NO_TRACE > 0
+    uint32_t           *traceTimeBuffers[CO_NO_TRACE];  /**< Time buffers of trace */
+    int32_t            *traceValueBuffers[CO_NO_TRACE]; /**< Value buffers of trace */
+    uint32_t            traceBufferSize[CO_NO_TRACE];   /**< Size of above buffers */
+#endif
+    uint16_t            ms50;               /**< Time for LED blinking in CO_process() */
+    uint32_t            memoryUsed;         /**< Allocated memory, informative */
+    /** Object Dictionary of this instance. Same as CO_OD[] for the object
+     * from CO_new(), a copy with own variables for CO_newInstance(). */
+    const CO_OD_entry_t *OD;
+    struct sCO_OD_RAM  *OD_RAM;             /**< Variables of the above OD in RAM */
+    struct sCO_OD_EEPROM *OD_EEPROM;        /**< Variables of the above OD in EEPROM */
+    struct sCO_OD_ROM  *OD_ROM;             /**< Variables of the above OD in ROM */
 }CO_t;
 
 
-/** CANopen object */
+/**
+ * CANopen object.
+ *
+ * Used by the functions without CO_t argument, like CO_new() or CO_init().
+ * Further CANopen objects in the same process are created with
+ * CO_newInstance(), see @ref CO_instances.
+ */
     extern CO_t *CO;
 
 
@@ -291,6 +322,90 @@ CO_ReturnError_t CO_init(
 void CO_delete(int32_t CANbaseAddress);
 
 
+/**
+ * @defgroup CO_instances Multiple CANopen instances
+ * @{
+ *
+ * Functions for running several CANopen nodes in one process.
+ *
+ * The functions above work on the global object _CO_. The functions below
+ * work on the given object instead, so any number of CANopen objects may be
+ * used side by side. All state of the stack is inside CO_t, each object may be
+ * processed by its own threads. Each object has its own copy of the Object
+ * Dictionary variables, initialized from the global CO_OD_RAM, CO_OD_EEPROM
+ * and CO_OD_ROM at the time of CO_newInstance(). OD_xxx macros from CO_OD.h
+ * refer to the global variables. After CO_OD_instance.h they refer to the
+ * variables of the object _CO_ in scope. CO_t.OD_RAM, CO_t.OD_EEPROM and
+ * CO_t.OD_ROM point to the variables of an instance as well.
+ *
+ * Instances are not available if CO_USE_GLOBALS is defined in CANopen.c.
+ */
+
+/**
+ * Allocate memory for a new CANopen object, including a copy of the Object
+ * Dictionary.
+ *
+ * Unlike CO_new(), this function allocates a new object on every call.
+ * For communication reset, call CO_CANinitInstance() and
+ * CO_CANopenInitInstance() again on the same object.
+ *
+ * @param [out] pCO New CANopen object.
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_PARAMETERS, CO_ERROR_OUT_OF_MEMORY
+ */
+CO_ReturnError_t CO_newInstance(CO_t **pCO);
+
+/**
+ * Initialize CAN driver of a CANopen object, see CO_CANinit().
+ *
+ * @param CO CANopen object from CO_newInstance().
+ * @param CANbaseAddress Address of the CAN module, passed to CO_CANmodule_init().
+ * @param bitRate CAN bit rate.
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_ILLEGAL_BAUDRATE, CO_ERROR_OUT_OF_MEMORY
+ */
+CO_ReturnError_t CO_CANinitInstance(
+        CO_t                   *CO,
+        int32_t                 CANbaseAddress,
+        uint16_t                bitRate);
+
+#if CO_NO_LSS_SERVER == 1
+/**
+ * Initialize LSS slave of a CANopen object, see CO_LSSinit().
+ *
+ * @param CO CANopen object from CO_newInstance().
+ * @param nodeId Node ID of the CANopen device (1 ... 127) or CO_LSS_NODE_ID_ASSIGNMENT
+ * @param bitRate CAN bit rate.
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT
+ */
+CO_ReturnError_t CO_LSSinitInstance(
+        CO_t                   *CO,
+        uint8_t                 nodeId,
+        uint16_t                bitRate);
+#endif /* CO_NO_LSS_SERVER == 1 */
+
+/**
+ * Initialize CANopen objects of a CANopen object, see CO_CANopenInit().
+ *
+ * @param CO CANopen object from CO_newInstance().
+ * @param nodeId Node ID of the CANopen device (1 ... 127).
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT
+ */
+CO_ReturnError_t CO_CANopenInitInstance(
+        CO_t                   *CO,
+        uint8_t                 nodeId);
+
+/**
+ * Delete CANopen object from CO_newInstance() and free memory.
+ *
+ * @param CO CANopen object from CO_newInstance().
+ * @param CANbaseAddress Address of the CAN module, passed to CO_CANmodule_init().
+ */
+void CO_deleteInstance(CO_t *CO, int32_t CANbaseAddress);
+
+/** @} */
+
+
 /**
  * Process CANopen objects.
  *
@@ -304,7 +419,9 @@ void CO_delete(int32_t CANbaseAddress);
  *        sleep time. Initial value must be set to something, 50ms typically.
  *        Output will be equal or lower to initial value. If there is new object
  *        to process, delay should be suspended and this function should be
- *        called immediately. Parameter is ignored if NULL.
+ *        called immediately. Parameter is ignored if NULL. Output is at most
+ *        50ms for LED blinking. If the driver defines CO_PROCESS_TICKLESS, it
+ *        is the time to the next LED step instead.
  *
  * @return #CO_NMT_reset_cmd_t from CO_NMT_process().
  */
@@ -322,12 +439,16 @@ CO_NMT_reset_cmd_t CO_process(
  *
  * @param CO This object.
  * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_us Return value - info to OS - maximum delay after function
+ *        should be called next time in [microseconds]. Output will be equal or
+ *        lower to initial value. Parameter is ignored if NULL.
  *
  * @return True, if CANopen SYNC message was just received or transmitted.
  */
 bool_t CO_process_SYNC_RPDO(
         CO_t                   *CO,
-        uint32_t                timeDifference_us);
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us);
 
 
 /**
@@ -339,10 +460,30 @@ bool_t CO_process_SYNC_RPDO(
  * @param CO This object.
  * @param syncWas True, if CANopen SYNC message was just received or transmitted.
  * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_us Return value - info to OS - see CO_process_SYNC_RPDO().
  */
 void CO_process_TPDO(
         CO_t                   *CO,
         bool_t                  syncWas,
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us);
+
+
+/**
+ * Advance SYNC and TPDO timers after the real time thread missed intervals.
+ *
+ * Replaces a burst of #CO_process_SYNC_RPDO() and #CO_process_TPDO() calls
+ * with one step. Nothing is sent and no RPDO is processed. Expired SYNC
+ * period, TPDO event and inhibit timers take effect with the next regular
+ * call, so at most one SYNC and one event driven TPDO are sent for the whole
+ * stall. SYNC counter and synchronous TPDOs only count SYNCs actually sent or
+ * received.
+ *
+ * @param CO This object.
+ * @param timeDifference_us Time of the skipped intervals in [microseconds].
+ */
+void CO_process_catchUp(
+        CO_t                   *CO,
         uint32_t                timeDifference_us);
 
 
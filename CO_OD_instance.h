@@ -0,0 +1,84 @@
+/**
+ * Object Dictionary variables of a CANopen object.
+ *
+ * @file        CO_OD_instance.h
+ * @ingroup     CO_instances
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+
+#ifndef CO_OD_INSTANCE_H
+#define CO_OD_INSTANCE_H
+
+#include "CANopen.h"
+
+/**
+ * @addtogroup CO_instances
+ * @{
+ *
+ * OD_xxx macros from CO_OD.h refer to the global Object Dictionary variables.
+ * Include this file after all other headers. From there on, the macros refer
+ * to the variables of the CANopen object named _CO_ in scope: a function
+ * argument, a local variable or the global object. So the same code serves
+ * every instance:
+ *
+ * \code{.c}
+ * #include "CO_OD_instance.h"
+ *
+ * void app_powerOn(CO_t *CO)
+ * {
+ *     CO_LOCK_OD(CO->CANmodule[0]);
+ *     OD_powerOnCounter ++;
+ *     CO_UNLOCK_OD(CO->CANmodule[0]);
+ * }
+ * \endcode
+ *
+ * The global variables can't be named in such a file any more. The global
+ * object _CO_ uses them, so OD_xxx on the global object still reaches them.
+ */
+#undef CO_OD_RAM
+#undef CO_OD_EEPROM
+#undef CO_OD_ROM
+#define CO_OD_RAM       (*CO->OD_RAM)       /**< RAM variables of _CO_ in scope */
+#define CO_OD_EEPROM    (*CO->OD_EEPROM)    /**< EEPROM variables of _CO_ in scope */
+#define CO_OD_ROM       (*CO->OD_ROM)       /**< ROM variables of _CO_ in scope */
+
+/** @} */
+#endif
@@ -54,7 +54,8 @@ const CLI_Command_Definition_t terminal =
 {
   .pcCommand = "canopen",
   .pcHelpString = "canopen -n x - address"  NEWLINE \
-                  "  -b x baudrate"  NEWLINE,
+                  "  -b x baudrate"  NEWLINE \
+                  "  -s x cycle statistics, 1 = reset"  NEWLINE,
   .pxCommandInterpreter = canopen_terminal,
   .cExpectedNumberOfParameters = 2
 };
@@ -67,6 +68,7 @@ extern void housekeeping_main(void);
 class Canopen canopen;
 /* Klassenvariablen */
 QueueHandle_t Canopen::nmt_event_queue;
+std::atomic<u32> Canopen::od_generation(1);
 
 /** @defgroup Objektverzeichnishandler
  * Objektverzeichnishandler in der Reihenfolge, in der die Eintr"age
@@ -180,6 +182,7 @@ CO_SDO_abortCode_t Canopen::store_parameters_callback(CO_ODF_arg_t *p_odf_arg)
       OD_identity.serialNumber =
           OD_serialNumber.serial % 100000000;
       type = Canopen_storage::SERIAL;
+      storage.invalidate(type);
       break;
     case OD_1010_6_storeParameters_saveTestData:
       type = Canopen_storage::TEST;
@@ -560,6 +563,81 @@ CO_SDO_abortCode_t Canopen::daisychain_callback(CO_ODF_arg_t *p_odf_arg)
   return CO_SDO_AB_NONE;
 }
 
+/** 2113 - Diagnose: Zykluszeit Statistik
+ *
+ * Histogramme der Verz"ogerung (Sollzeitpunkt bis Start) und der Laufzeit des
+ * Timer Threads. Bin n z"ahlt Werte im Bereich [2^n, 2^(n+1)) us. Schreiben
+ * von Subindex 7 setzt die Statistik zur"uck. Subindex 8 und 9 z"ahlen die
+ * nach einem Stillstand zusammengefassten Intervalle.
+ *
+ * @param p_odf_arg OD Eintrag
+ * @return CO_SDO_AB_NONE wenn erfolgreich
+ */
+CO_SDO_abortCode_t Canopen::cycle_statistics_callback(CO_ODF_arg_t *p_odf_arg)
+{
+  CANrx_threadTmr_stats_t stats;
+
+  if (p_odf_arg->reading == false) {
+    /* Nur Subindex 7 ist beschreibbar, stats wird nicht ben"otigt */
+    if (p_odf_arg->subIndex != OD_2113_7_cycleStatistics_reset) {
+      return CO_SDO_AB_READONLY;
+    }
+    if (*p_odf_arg->data != 0) {
+      CANrx_threadTmr_resetStats();
+    }
+    return CO_SDO_AB_NONE;
+  }
+
+  CANrx_threadTmr_getStats(&stats);
+
+  switch (p_odf_arg->subIndex) {
+    case OD_2113_0_cycleStatistics_maxSubIndex:
+      break;
+    case OD_2113_1_cycleStatistics_cycles:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.cycles;
+      break;
+    case OD_2113_2_cycleStatistics_overruns:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.overruns;
+      break;
+    case OD_2113_3_cycleStatistics_latencyMax:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.latency.max_us;
+      break;
+    case OD_2113_4_cycleStatistics_processingMax:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.processing.max_us;
+      break;
+    case OD_2113_5_cycleStatistics_latencyHistogram:
+      /* OCTET_STRING, 16 x UNSIGNED32 little endian */
+      (void)memcpy(p_odf_arg->data, stats.latency.bins,
+                   sizeof(stats.latency.bins));
+      p_odf_arg->dataLength = sizeof(stats.latency.bins);
+      break;
+    case OD_2113_6_cycleStatistics_processingHistogram:
+      (void)memcpy(p_odf_arg->data, stats.processing.bins,
+                   sizeof(stats.processing.bins));
+      p_odf_arg->dataLength = sizeof(stats.processing.bins);
+      break;
+    case OD_2113_7_cycleStatistics_reset:
+      *p_odf_arg->data = 0;
+      break;
+    case OD_2113_8_cycleStatistics_catchUps:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.catchUps;
+      break;
+    case OD_2113_9_cycleStatistics_skipped:
+      *(reinterpret_cast<UNSIGNED32*>(p_odf_arg->data)) =
+          stats.skipped;
+      break;
+    default:
+      return CO_SDO_AB_SUB_UNKNOWN;
+  }
+
+  return CO_SDO_AB_NONE;
+}
+
 /* ab 2200 - Allgemein
  * Auf diese Eintr"age wird direkt aus den FBs zugegriffen
  */
@@ -618,10 +696,12 @@ CO_SDO_abortCode_t Canopen::serial_number_callback(CO_ODF_arg_t *p_odf_arg)
  * Schreibt bei NMT Zustands"anderung ein Event auf die per
  * <nmt_event()> vorgegebene Queue
  *
+ * @param p_object Canopen Objekt, die Queue ist statisch
  * @param state neuer NMT Zustand
  */
-void Canopen::nmt_state_callback(CO_NMT_internalState_t state)
+void Canopen::nmt_state_callback(void *p_object, CO_NMT_internalState_t state)
 {
+  (void)p_object;
   nmt_relay_event(static_cast<nmt_event_t>(state));
 }
 
@@ -673,9 +753,11 @@ void Canopen::set_callback(u16 obj_dict_id,
  * @param index OD Index (z.B. aus CO_OD.h)
  * @param subindex OD Subindex (z.B. aus CO_OD.h)
  * @param size Größe des hinterlegten Eintrags in Bytes
+ * @param write Eintrag wird geschrieben, "Anderung f"ur CO_OD_dirtyClear()
+ * vermerken
  * @return Zeiger auf Eintrag oder NULL falls nicht existend
  */
-void* Canopen::get_od_pointer(u16 index, u8 subindex, size_t size)
+void* Canopen::get_od_pointer(u16 index, u8 subindex, size_t size, bool write)
 {
   u16 entry;
   u8 length;
@@ -691,9 +773,79 @@ void* Canopen::get_od_pointer(u16 index, u8 subindex, size_t size)
     return NULL;
   }
 
+  if (write == true) {
+    od_written(CO_OD_getPosition(CO->SDO[0], entry, subindex),
+               CO_OD_getAttribute(CO->SDO[0], entry, subindex));
+  }
   return CO_OD_getDataPointer(CO->SDO[0], entry, subindex);
 }
 
+/**
+ * Schreibzugriff der Anwendung auf OD Eintrag vermerken
+ *
+ * Markiert den Eintrag f"ur CO_OD_dirtyClear(). Ist der Eintrag auf TPDOs
+ * abbildbar oder wurde er markiert, wird der Echtzeitthread geweckt. Mit
+ * CO_DRIVER_TICKLESS erkennt er den Change of State sonst erst beim n"achsten
+ * Termin. Das OD ist gesperrt, der geweckte Durchlauf sieht also den neuen
+ * Wert, auch wenn er erst nach diesem Aufruf geschrieben wird.
+ *
+ * @param position Position aus CO_OD_getPosition()
+ * @param attribute CO_SDO_OD_attributes_t des Eintrags
+ */
+void Canopen::od_written(u16 position, u16 attribute)
+{
+  bool_t dirty;
+
+  dirty = CO_OD_markDirty(CO->SDO[0], position);
+  if ((dirty == true) || ((attribute & CO_ODA_TPDO_MAPABLE) != 0)) {
+    CANrx_threadTmr_wakeup();
+  }
+}
+
+/**
+ * OD Eintrag f"ur Zugriffe per Handle aufl"osen
+ *
+ * @param p_entry [out] aufgel"oster Eintrag
+ * @param index OD Index (z.B. aus CO_OD.h)
+ * @param subindex OD Subindex (z.B. aus CO_OD.h)
+ * @param size Größe des hinterlegten Eintrags in Bytes
+ * @return true wenn der Eintrag existiert und die Größe passt
+ */
+bool Canopen::od_resolve_entry(od_entry_t *p_entry, u16 index, u8 subindex, u16 size)
+{
+  u16 entry;
+
+  p_entry->p_data = nullptr;
+  p_entry->p_ext = nullptr;
+  p_entry->generation = od_generation.load(std::memory_order_acquire);
+  p_entry->index = index;
+  p_entry->attribute = 0;
+  p_entry->length = size;
+  p_entry->position = 0xffff;
+  p_entry->subindex = subindex;
+
+  if (CO == NULL) {
+    return false;
+  }
+  entry = CO_OD_find(CO->SDO[0], index);
+  if (entry == 0xffff) {
+    /* Existiert nicht */
+    return false;
+  }
+  if (CO_OD_getLength(CO->SDO[0], entry, subindex) != size) {
+    return false;
+  }
+
+  p_entry->attribute = CO_OD_getAttribute(CO->SDO[0], entry, subindex);
+  if (CO->SDO[0]->ODExtensions != NULL) {
+    p_entry->p_ext = &CO->SDO[0]->ODExtensions[entry];
+  }
+  p_entry->position = CO_OD_getPosition(CO->SDO[0], entry, subindex);
+  p_entry->p_data = CO_OD_getDataPointer(CO->SDO[0], entry, subindex);
+
+  return p_entry->p_data != nullptr;
+}
+
 /**
  * Daisychain Shift In Eventhandler
  */
@@ -702,12 +854,12 @@ void Canopen::daisychain_event_callback(void)
   u8 nid;
   u8 shift_count;
 
-  CO_LOCK_OD();
+  CO_LOCK_OD(CO->CANmodule[0]);
   OD_daisyChain.shiftIn ++;
 
   nid = OD_CANNodeID;
   shift_count = OD_daisyChain.shiftIn;
-  CO_UNLOCK_OD();
+  CO_UNLOCK_OD(CO->CANmodule[0]);
 
   (void)CO_DaisyProducer_sendEvent(CO->DaisyProducer, shift_count, nid);
 }
@@ -729,19 +881,19 @@ bool Canopen::store_lss_config_callback(uint8_t nid, uint16_t bit_rate)
    * - zu speichernde NID eintragen, speichern
    * - aktive NID wieder eintragen
    */
-  CO_LOCK_OD();
+  CO_LOCK_OD(CO->CANmodule[0]);
   active_nid = OD_CANNodeID;
   OD_CANNodeID = nid;
-  CO_UNLOCK_OD();
+  storage.invalidate(Canopen_storage::COMMUNICATION);
 
   result = storage.save(Canopen_storage::COMMUNICATION);
   if (result == CO_ERROR_NO) {
+    CO_UNLOCK_OD(CO->CANmodule[0]);
     return true;
   }
 
-  CO_LOCK_OD();
   OD_CANNodeID = active_nid;
-  CO_UNLOCK_OD();
+  CO_UNLOCK_OD(CO->CANmodule[0]);
 
   return false;
 }
@@ -800,11 +952,16 @@ void Canopen::timer_rx_thread(void)
 void Canopen::nmt_register(QueueHandle_t event_queue)
 {
   Canopen::nmt_event_queue = event_queue;
-  CO_NMT_initCallback(CO->NMT, &nmt_state_callback);
+  CO_NMT_initCallback(CO->NMT, this, &nmt_state_callback);
 }
 
 void Canopen::nmt_relay_event(nmt_event_t event)
 {
+  /* OD Extensions wurden neu angelegt, alle Handles neu aufl"osen */
+  if ((event == RESET_COMMUNICATION) || (event == INITIALIZING)) {
+    (void)od_generation.fetch_add(1, std::memory_order_release);
+  }
+
   /* Mit dieser Implementierung ist nur ein Konsument der Events f"ur alle
    * Instanzen m"oglich. Falls mehr ben"otigt werden m"ussen die Queues in einer
    * Liste abgelegt werden */
@@ -817,17 +974,28 @@ void Canopen::nmt_relay_event(nmt_event_t event)
 
 /**
  * @defgroup Zugriffsfunktionen f"ur Objektverzeichnis
- * @todo Linux Version - CO_OD_find() kostet Zeit, Entries in Tabelle ablegen
+ * F"ur h"aufige Zugriffe auf die gleichen Eintr"age gibt es <od_handle>,
+ * damit entf"allt die Suche per CO_OD_find().
  */
 
 void Canopen::od_lock(void)
 {
-  CO_LOCK_OD();
+  CO_LOCK_OD(CO->CANmodule[0]);
 }
 
 void Canopen::od_unlock(void)
 {
-  CO_UNLOCK_OD();
+  CO_UNLOCK_OD(CO->CANmodule[0]);
+}
+
+u32 Canopen::od_read_begin(void)
+{
+  return CO_OD_READ_BEGIN(CO->CANmodule[0]);
+}
+
+bool Canopen::od_read_retry(u32 seq)
+{
+  return CO_OD_READ_RETRY(CO->CANmodule[0], seq);
 }
 
 void Canopen::od_get(u16 index, u8 subindex, bool* p_retval)
@@ -974,7 +1142,7 @@ void Canopen::od_set(u16 index, u8 subindex, bool val)
 {
   u8 *p;
 
-  p = (u8*)get_od_pointer(index, subindex, sizeof(*p));
+  p = (u8*)get_od_pointer(index, subindex, sizeof(*p), true);
   if (p == NULL) {
     return;
   }
@@ -985,7 +1153,7 @@ void Canopen::od_set(u16 index, u8 subindex, u8 val)
 {
   u8 *p;
 
-  p = (u8*)get_od_pointer(index, subindex, sizeof(val));
+  p = (u8*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -996,7 +1164,7 @@ void Canopen::od_set(u16 index, u8 subindex, u16 val)
 {
   u16 *p;
 
-  p = (u16*)get_od_pointer(index, subindex, sizeof(val));
+  p = (u16*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1007,7 +1175,7 @@ void Canopen::od_set(u16 index, u8 subindex, u32 val)
 {
   u32 *p;
 
-  p = (u32*)get_od_pointer(index, subindex, sizeof(val));
+  p = (u32*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1018,7 +1186,7 @@ void Canopen::od_set(u16 index, u8 subindex, u64 val)
 {
   u64 *p;
 
-  p = (u64*)get_od_pointer(index, subindex, sizeof(val));
+  p = (u64*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1029,7 +1197,7 @@ void Canopen::od_set(u16 index, u8 subindex, s8 val)
 {
   s8 *p;
 
-  p = (s8*)get_od_pointer(index, subindex, sizeof(val));
+  p = (s8*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1040,7 +1208,7 @@ void Canopen::od_set(u16 index, u8 subindex, s16 val)
 {
   s16 *p;
 
-  p = (s16*)get_od_pointer(index, subindex, sizeof(val));
+  p = (s16*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1051,7 +1219,7 @@ void Canopen::od_set(u16 index, u8 subindex, s32 val)
 {
   s32 *p;
 
-  p = (s32*)get_od_pointer(index, subindex, sizeof(val));
+  p = (s32*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1062,7 +1230,7 @@ void Canopen::od_set(u16 index, u8 subindex, s64 val)
 {
   s64 *p;
 
-  p = (s64*)get_od_pointer(index, subindex, sizeof(val));
+  p = (s64*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1073,7 +1241,7 @@ void Canopen::od_set(u16 index, u8 subindex, f32 val)
 {
   f32 *p;
 
-  p = (f32*)get_od_pointer(index, subindex, sizeof(val));
+  p = (f32*)get_od_pointer(index, subindex, sizeof(val), true);
   if (p == NULL) {
     return;
   }
@@ -1105,6 +1273,8 @@ void Canopen::od_set(u16 index, u8 subindex, const char* p_visible_string)
   /* Der Quellstring muss entweder ein echter, nullterminierter String sein
    * oder die gleiche Länge haben wie der OD Eintrag. */
   (void)snprintf(p, length, p_visible_string);
+  od_written(CO_OD_getPosition(CO->SDO[0], entry, subindex),
+             CO_OD_getAttribute(CO->SDO[0], entry, subindex));
 }
 
 void Canopen::od_event(u16 index, QueueHandle_t event_queue)
@@ -1222,7 +1392,7 @@ CO_ReturnError_t Canopen::tpdo_send(u16 id)
   tpdo_called = now;
 
   reinterpret_cast<CO_TPDO_t*>(p_tpdo)->sendRequest = true;
-  return CO_TPDO_process(reinterpret_cast<CO_TPDO_t*>(p_tpdo), nullptr, false, difference_us); //nicht zyklisch -> kein Heartbeat!!
+  return CO_TPDO_process(reinterpret_cast<CO_TPDO_t*>(p_tpdo), nullptr, false, difference_us, nullptr); //nicht zyklisch -> kein Heartbeat!!
 }
 
 CO_ReturnError_t Canopen::rpdo_take_control(u16 rpdo_com_param_index, void *param,
@@ -1504,6 +1674,10 @@ CO_ReturnError_t Canopen::co_start(u8 pending_nid, u32 interval)
   }
   *this->p_active_nid = pending_nid;
 
+  /* "Anderungen f"ur Speichern per 1010 verfolgen. Schl"agt das fehl, wird
+   * beim Speichern immer der CRC verglichen */
+  (void)storage.track(CO->SDO[0]);
+
   /* Infos eintragen */
   threadMain_init(this->main_interval, xTaskGetCurrentTaskHandle()); /* ms Interval */
 
@@ -1516,15 +1690,17 @@ CO_ReturnError_t Canopen::co_start(u8 pending_nid, u32 interval)
   set_callback(OD_2109_voltage, voltage_callback_wrapper);
   set_callback(OD_2110_canRuntimeInfo, can_runtime_info_callback_wrapper);
   set_callback(OD_2112_daisyChain, daisychain_callback_wrapper);
+  set_callback(OD_2113_cycleStatistics, cycle_statistics_callback_wrapper);
   set_callback(OD_5000_serialNumber, serial_number_callback_wrapper);
 
   /* Durch Reset Communication werden alle Callbacks im Stack gel"oscht. Falls bereits
-   * ein NMT Callback eingetragen war, wird dieser erneut eingetragen und
-   * ein Event "Reset Communication" verteilt */
+   * ein NMT Callback eingetragen war, wird dieser erneut eingetragen. Das Event
+   * "Reset Communication" wird immer verteilt, es macht auch alle OD Handles
+   * ung"ultig */
   if (Canopen::nmt_event_queue != 0) {
     nmt_register(Canopen::nmt_event_queue);
-    nmt_relay_event(RESET_COMMUNICATION);
   }
+  nmt_relay_event(RESET_COMMUNICATION);
 
   /* Configure Timer function for execution every <interval> millisecond */
   CANrx_threadTmr_init(this->worker_interval);
@@ -1582,8 +1758,11 @@ CO_ReturnError_t Canopen::init(u8 nid, u32 interval)
 
   if (once != true) {
     once = true;
+    CO_LOCK_OD(CO->CANmodule[0]);
     OD_powerOnCounter ++;
+    storage.invalidate(Canopen_storage::RUNTIME);
     (void)storage.save(Canopen_storage::RUNTIME);
+    CO_UNLOCK_OD(CO->CANmodule[0]);
   }
 
   return CO_ERROR_NO;
@@ -1601,6 +1780,7 @@ void Canopen::deinit(void)
   /* NMT Subscribern den Zugriff auf CANopen Funktionen entziehen */
   nmt_relay_event(INITIALIZING);
 
+  storage.untrack();
   CO_delete(CAN_MODULE_A);
   reset = CO_RESET_NOT;
   *p_active_nid = 0;
@@ -1649,6 +1829,41 @@ void Canopen::process(void)
 
 #ifndef UNIT_TEST
 
+/*
+ * Zykluszeit Statistik des Timer Threads ausgeben
+ */
+static void print_cycle_statistics(char *pcWriteBuffer, size_t xWriteBufferLen)
+{
+  int len;
+  unsigned i;
+  size_t pos;
+  CANrx_threadTmr_stats_t stats;
+
+  CANrx_threadTmr_getStats(&stats);
+  len = snprintf(pcWriteBuffer, xWriteBufferLen,
+                 "cycles %lu overruns %lu catch-ups %lu skipped %lu" NEWLINE
+                 "latency max %lu processing max %lu" NEWLINE,
+                 static_cast<unsigned long>(stats.cycles),
+                 static_cast<unsigned long>(stats.overruns),
+                 static_cast<unsigned long>(stats.catchUps),
+                 static_cast<unsigned long>(stats.skipped),
+                 static_cast<unsigned long>(stats.latency.max_us),
+                 static_cast<unsigned long>(stats.processing.max_us));
+  pos = (len > 0) ? static_cast<size_t>(len) : 0;
+
+  /* Bin i z"ahlt Werte ab 2^i us */
+  for (i = 0; (i < CANRX_THREADTMR_HISTOGRAM_BINS) && (pos < xWriteBufferLen); i++) {
+    len = snprintf(&pcWriteBuffer[pos], xWriteBufferLen - pos,
+                   "%6lu: %10lu %10lu" NEWLINE, 1ul << i,
+                   static_cast<unsigned long>(stats.latency.bins[i]),
+                   static_cast<unsigned long>(stats.processing.bins[i]));
+    if (len <= 0) {
+      break;
+    }
+    pos += static_cast<size_t>(len);
+  }
+}
+
 /*
  * CANopen per CLI steuern
  */
@@ -1680,8 +1895,11 @@ BaseType_t Canopen::cmd_terminal( char *pcWriteBuffer,
   switch (opt) {
     case 'n':
       /* nach Muster -n 22 */
+      CO_LOCK_OD(CO->CANmodule[0]);
       OD_CANNodeID = tmp;
+      storage.invalidate(Canopen_storage::COMMUNICATION);
       (void)storage.save(Canopen_storage::COMMUNICATION);
+      CO_UNLOCK_OD(CO->CANmodule[0]);
       globals.request_reboot(); //triggert Comm Params restore
       break;
     case 'b':
@@ -1701,6 +1919,13 @@ BaseType_t Canopen::cmd_terminal( char *pcWriteBuffer,
       }
       (void)storage.restore(static_cast<Canopen_storage::storage_type_t>(tmp));
       break;
+    case 's':
+      /* nach Muster -s <reset>. Ausgabe der Zykluszeit Statistik in us */
+      print_cycle_statistics(pcWriteBuffer, xWriteBufferLen);
+      if (tmp != 0) {
+        CANrx_threadTmr_resetStats();
+      }
+      break;
     default:
       (void)snprintf(pcWriteBuffer, xWriteBufferLen, terminal_text_unknown_option, opt);
       return pdFALSE;
@@ -1773,6 +1998,11 @@ CO_SDO_abortCode_t Canopen::daisychain_callback_wrapper(CO_ODF_arg_t *p_odf_arg)
   return reinterpret_cast<Canopen*>(p_odf_arg->object)->daisychain_callback(p_odf_arg);
 }
 
+CO_SDO_abortCode_t Canopen::cycle_statistics_callback_wrapper(CO_ODF_arg_t *p_odf_arg)
+{
+  return reinterpret_cast<Canopen*>(p_odf_arg->object)->cycle_statistics_callback(p_odf_arg);
+}
+
 /**
 * @} @}
 **/
@@ -13,6 +13,8 @@
 #ifndef SRC_CANOPEN_CANOPEN_H_
 #define SRC_CANOPEN_CANOPEN_H_
 
+#include <atomic>
+
 #include "CANopen.h"
 
 #include "os/freertos/include/FreeRTOS.h"
@@ -56,6 +58,7 @@ class Canopen: public Canopen_errors {
     /*2109*/CO_SDO_abortCode_t voltage_callback(CO_ODF_arg_t *p_odf_arg);
     /*2110*/CO_SDO_abortCode_t can_runtime_info_callback(CO_ODF_arg_t *p_odf_arg);
     /*2112*/CO_SDO_abortCode_t daisychain_callback(CO_ODF_arg_t *p_odf_arg);
+    /*2113*/CO_SDO_abortCode_t cycle_statistics_callback(CO_ODF_arg_t *p_odf_arg);
     /*5000*/CO_SDO_abortCode_t serial_number_callback(CO_ODF_arg_t *p_odf_arg);
 
     /* Init Helper */
@@ -69,12 +72,71 @@ class Canopen: public Canopen_errors {
     /* Diese Callbacks m"ussen Klassenmethoden sein, da der Stack Callback
      * keinen Pointer f"ur die Instanz zur Verf"ugung stellt. Diese sind daher
      * so aufgebaut das keine Info "uber die Instanz notwendig ist. */
-    static void nmt_state_callback(CO_NMT_internalState_t state);
+    static void nmt_state_callback(void *p_object, CO_NMT_internalState_t state);
     static CO_SDO_abortCode_t generic_write_callback(CO_ODF_arg_t *p_odf_arg);
 
     void set_callback(u16 obj_dict_id, CO_SDO_abortCode_t (*pODFunc)(CO_ODF_arg_t *ODF_arg));
 
-    void *get_od_pointer(u16 index, u8 subindex, size_t size);
+    void *get_od_pointer(u16 index, u8 subindex, size_t size, bool write = false);
+    void od_written(u16 position, u16 attribute);
+
+    /** Wird bei #RESET_COMMUNICATION im CANopen Thread erh"oht (release),
+     * Anwendungsthreads lesen per acquire */
+    static std::atomic<u32> od_generation;
+
+  public:
+    /**
+     * Aufgel"oster OD Eintrag, siehe <od_handle>
+     */
+    typedef struct od_entry {
+      void *p_data;                   /*!< Wert im OD, nullptr wenn ung"ultig */
+      CO_OD_extension_t *p_ext;       /*!< Extension des OD Eintrags */
+      u32 generation;                 /*!< <od_generation> bei Aufl"osung */
+      u16 index;                      /*!< OD Index */
+      u16 attribute;                  /*!< CO_SDO_OD_attributes_t */
+      u16 length;                     /*!< L"ange in Bytes */
+      u16 position;                   /*!< f"ur CO_OD_markDirty(), 0xffff wenn ung"ultig */
+      u8 subindex;                    /*!< OD Subindex */
+    } od_entry_t;
+
+    /**
+     * Typisierter, aufgel"oster OD Eintrag f"ur wiederholte Zugriffe per
+     * <od_get()>/<od_set()> ohne Suche im OD
+     *
+     * Muss vor der Verwendung mit <od_resolve()> aufgel"ost werden. Nach
+     * #RESET_COMMUNICATION wird der Eintrag beim n"achsten Zugriff
+     * automatisch neu aufgel"ost. Ein Handle darf nur von einem Thread
+     * verwendet werden.
+     *
+     * @tparam T Datentyp des OD Eintrags (bool, u8..u64, s8..s64, f32)
+     */
+    template <typename T>
+    struct od_handle: od_entry_t {
+      od_handle(void): od_entry_t() {}
+    };
+
+  private:
+    bool od_resolve_entry(od_entry_t *p_entry, u16 index, u8 subindex, u16 size);
+
+    /**
+     * Eintrag ggf. neu aufl"osen
+     *
+     * @return true wenn der Eintrag g"ultig ist
+     */
+    bool od_check(od_entry_t *p_entry)
+    {
+      if (p_entry->generation != od_generation.load(std::memory_order_acquire)) {
+        (void)od_resolve_entry(p_entry, p_entry->index, p_entry->subindex, p_entry->length);
+      }
+      return p_entry->p_data != nullptr;
+    }
+
+    template <typename T>
+    static void od_copy(T *p_dst, const void *p_src) { *p_dst = *static_cast<const T*>(p_src); }
+    static void od_copy(bool *p_dst, const void *p_src) { *p_dst = (*static_cast<const u8*>(p_src) != 0); }
+    template <typename T>
+    static void od_store(void *p_dst, T val) { *static_cast<T*>(p_dst) = val; }
+    static void od_store(void *p_dst, bool val) { *static_cast<u8*>(p_dst) = (val == true) ? 1 : 0; }
 
     void daisychain_event_callback(void);
     bool store_lss_config_callback(uint8_t nid, uint16_t bitRate);
@@ -151,10 +213,35 @@ class Canopen: public Canopen_errors {
      */
     void od_unlock(void);
 
+    /**
+     * Beginnt lesenden Zugriff auf mehrere OD Einträge, ohne Schreiber (z.B.
+     * den zeitkritischen PDO Thread) zu blockieren. Anwendung:
+     *
+     *     do {
+     *       seq = od_read_begin();
+     *       od_get(...);
+     *     } while (od_read_retry(seq));
+     *
+     * Ohne Sequenzsperre im Treiber wird das OD wie mit <od_lock()> gesperrt.
+     *
+     * @return Sequenznummer für <od_read_retry()>
+     */
+    u32 od_read_begin(void);
+
+    /**
+     * Lesenden Zugriff abschließen
+     *
+     * @param seq Rückgabewert von <od_read_begin()>
+     * @return true falls das OD währenddessen geschrieben wurde, die gelesenen
+     * Werte sind zu verwerfen und neu zu lesen
+     */
+    bool od_read_retry(u32 seq);
+
     /**
      * Zugriff auf Einträge im Objektverzeichnis
      *
-     * Das OD muss mit <od_lock()> gesperrt sein
+     * Das OD muss mit <od_lock()> gesperrt sein oder innerhalb von
+     * <od_read_begin()>/<od_read_retry()> gelesen werden
      *
      * @param index OD Index (z.B. aus CO_OD.h)
      * @param subindex OD Subindex (z.B. aus CO_OD.h)
@@ -215,6 +302,60 @@ class Canopen: public Canopen_errors {
     void od_set(u16 index, u8 subindex, const char *p_visible_string);
     // weitere CO Standardtypen
 
+    /**
+     * OD Eintrag f"ur <od_get()>/<od_set()> per Handle aufl"osen
+     *
+     * Sucht den Eintrag einmalig im OD. Kann ohne Sperre des OD aufgerufen
+     * werden.
+     *
+     * @param index OD Index (z.B. aus CO_OD.h)
+     * @param subindex OD Subindex (z.B. aus CO_OD.h)
+     * @param [out] p_handle aufgel"oster Eintrag
+     * @return true wenn der Eintrag existiert und die L"ange zum Typ passt
+     */
+    template <typename T>
+    bool od_resolve(u16 index, u8 subindex, od_handle<T> *p_handle)
+    {
+      return od_resolve_entry(p_handle, index, subindex, sizeof(T));
+    }
+
+    /**
+     * Zugriff auf Eintr"age im Objektverzeichnis per Handle
+     *
+     * Wie <od_get()> mit Index/Subindex, aber ohne Suche im OD.
+     *
+     * @param p_handle mit <od_resolve()> aufgel"oster Eintrag
+     * @param [out] p_retval Im OD hinterlegter Wert, 0 falls der Eintrag
+     * ung"ultig ist
+     */
+    template <typename T>
+    void od_get(od_handle<T> *p_handle, T *p_retval)
+    {
+      if (od_check(p_handle) != true) {
+        *p_retval = 0;
+        return;
+      }
+      od_copy(p_retval, p_handle->p_data);
+    }
+
+    /**
+     * "Andern von Eintr"agen im Objektverzeichnis per Handle
+     *
+     * Wie <od_set()> mit Index/Subindex, aber ohne Suche im OD.
+     *
+     * @param p_handle mit <od_resolve()> aufgel"oster Eintrag
+     * @param val Zu "ubernehmender Wert
+     */
+    template <typename T>
+    void od_set(od_handle<T> *p_handle, T val)
+    {
+      if (od_check(p_handle) != true) {
+        return;
+      }
+      od_store(p_handle->p_data, val);
+      od_written(p_handle->position, p_handle->attribute);
+    }
+
     /**
      * Eintragen einer Event Queue
      *
@@ -396,6 +537,7 @@ class Canopen: public Canopen_errors {
     static CO_SDO_abortCode_t voltage_callback_wrapper(CO_ODF_arg_t *p_odf_arg);
     static CO_SDO_abortCode_t can_runtime_info_callback_wrapper(CO_ODF_arg_t *p_odf_arg);
     static CO_SDO_abortCode_t daisychain_callback_wrapper(CO_ODF_arg_t *p_odf_arg);
+    static CO_SDO_abortCode_t cycle_statistics_callback_wrapper(CO_ODF_arg_t *p_odf_arg);
     static CO_SDO_abortCode_t serial_number_callback_wrapper(CO_ODF_arg_t *p_odf_arg);
     /** @} */
 
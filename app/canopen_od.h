@@ -0,0 +1,218 @@
+/**
+* @addtogroup io8000 template
+* @{
+* @addtogroup application
+* @{
+* @file canopen_od.h
+* @copyright Neuberger Gebäudeautomation GmbH
+* @brief Typisierter Zugriff auf das Objektverzeichnis zur Compilezeit
+*
+* @details \b Programm-Name template
+* @details Jeder OD Eintrag wird durch eine Spezialisierung von
+* <Canopen_od_entry> beschrieben. Diese werden per CO_OD_TYPED_xxx() Makros in
+* CO_OD_typed.h erzeugt, das parallel zu CO_OD.c gepflegt wird. Die
+* Beschreibung verweist auf die gleichen Variablen wie die Tabellen in CO_OD.c,
+* CO_OD_entry_t und CO_OD_entryRecord_t bleiben unver"andert.
+*
+* Zugriffe werden zur Compilezeit aufgel"ost, es l"auft kein Suchcode:
+*
+*     u8 in;
+*
+*     canopen.od_lock();
+*     in = od_get<0x6000, 1>();
+*     od_set<0x6200, 1>(in);
+*     od_ref<0x1017, 0>() = 1000;
+*     canopen.od_unlock();
+*
+* Nicht existierende Eintr"age, Subindizes au"serhalb eines Arrays und
+* abweichende Datentypen f"uhren zu Fehlern beim Compilieren. Die in
+* CO_OD_typed.h eingetragene L"ange wird per static_assert gegen den Datentyp
+* gepr"uft. Ob CO_OD_typed.h zu CO_OD.c passt (Variable, Attribut, L"ange,
+* Anzahl Elemente), pr"uft erst check_od_typed aus
+* stack/neuberger-socketCAN/benchmark.
+*
+* @remark Die Zugriffe gehen auf das OD des globalen CANopen Objekts (CO_new()).
+* Wie bei <Canopen::od_get()> muss das OD gesperrt sein.
+*
+* @remark Schreibzugriffe werden nicht per CO_OD_markDirty() vermerkt. Vor dem
+* Speichern eines so ge"anderten Bereichs ist <Canopen_storage::invalidate()>
+* aufzurufen.
+*
+* @remark od_set() weckt den Echtzeitthread f"ur auf TPDOs abbildbare Eintr"age
+* (CANrx_threadTmr_wakeup()). Nach Schreibzugriffen per od_ref() muss das die
+* Anwendung selbst tun.
+**/
+#ifndef SRC_CANOPEN_CANOPEN_OD_H_
+#define SRC_CANOPEN_CANOPEN_OD_H_
+
+#include <type_traits>
+
+#include "CANopen.h"
+#include "CO_OD.h"
+
+#include "os/freertos/include/FreeRTOS.h"
+#include "os/freertos/include/task.h"
+#include "CO_freertos_threads.h"
+
+#include "interface/nbtyp.h"
+
+/**
+ * Beschreibung eines OD Eintrags
+ *
+ * Existiert nur f"ur Eintr"age aus CO_OD_typed.h. Jede Spezialisierung
+ * enth"alt:
+ * - type: Datentyp des Eintrags
+ * - attribute: CO_SDO_OD_attributes_t wie in CO_OD.c
+ * - ref(): Referenz auf die Variable im OD
+ *
+ * @tparam index OD Index
+ * @tparam subindex OD Subindex
+ */
+template <u16 index, u8 subindex>
+struct Canopen_od_entry {
+  static_assert(subindex != subindex, "OD entry does not exist in CO_OD_typed.h");
+};
+
+/**
+ * Eintrag vom Typ Var
+ *
+ * @param index OD Index
+ * @param attr Attribut aus CO_OD.c
+ * @param length L"ange in Bytes aus CO_OD.c
+ * @param var Variable im OD
+ */
+#define CO_OD_TYPED_VAR(index, attr, length, var)                             \
+  template <> struct Canopen_od_entry<index, 0> {                             \
+    typedef std::remove_reference<decltype((var))>::type type;               \
+    static const u16 attribute = (attr);                                      \
+    static type &ref(void) { return (var); }                                  \
+    static_assert(sizeof(type) == (length), "OD length mismatch");            \
+  };
+
+/**
+ * Eintrag vom Typ Array, Subindex 0 ist die konstante Anzahl Elemente
+ *
+ * @param index OD Index
+ * @param count Anzahl Elemente (max. Subindex) aus CO_OD.c
+ * @param attr Attribut aus CO_OD.c
+ * @param length L"ange eines Elements in Bytes aus CO_OD.c
+ * @param var Array im OD
+ */
+#define CO_OD_TYPED_ARRAY(index, count, attr, length, var)                    \
+  template <> struct Canopen_od_entry<index, 0> {                             \
+    typedef const u8 type;                                                    \
+    static const u16 attribute = ((attr) & ~(CO_ODA_WRITEABLE | CO_ODA_RPDO_MAPABLE)) | CO_ODA_READABLE; \
+    static type &ref(void) { static const u8 value = (count); return value; } \
+  };                                                                          \
+  template <u8 subindex> struct Canopen_od_entry<index, subindex> {           \
+    static_assert(subindex <= (count), "OD subindex out of range");           \
+    typedef typename std::remove_reference<decltype((var)[0])>::type type;   \
+    static const u16 attribute = (attr);                                      \
+    static type &ref(void) { return (var)[subindex - 1]; }                    \
+    static_assert(sizeof(type) == (length), "OD length mismatch");            \
+  };
+
+/**
+ * Subindex eines Eintrags vom Typ Record
+ *
+ * @param index OD Index
+ * @param subindex OD Subindex
+ * @param attr Attribut aus CO_OD.c
+ * @param length L"ange in Bytes aus CO_OD.c
+ * @param var Element der Struktur im OD
+ */
+#define CO_OD_TYPED_RECORD(index, subindex, attr, length, var)                \
+  template <> struct Canopen_od_entry<index, subindex> {                      \
+    typedef std::remove_reference<decltype((var))>::type type;               \
+    static const u16 attribute = (attr);                                      \
+    static type &ref(void) { return (var); }                                  \
+    static_assert(sizeof(type) == (length), "OD length mismatch");            \
+  };
+
+/** Typ eines REAL64 Eintrags, nur vorhanden wenn er 8 Bytes belegt */
+template <bool valid, typename T>
+struct Canopen_od_real64 {
+  typedef T type;
+};
+
+template <typename T>
+struct Canopen_od_real64<false, T> {
+};
+
+/**
+ * Subindex eines Eintrags vom Typ Record mit Datentyp REAL64
+ *
+ * float64_t ist je nach Treiber long double und damit auf x86-64 16 Bytes
+ * lang. Stimmt die Gr"o"se nicht mit den 8 Bytes aus CO_OD.c "uberein, fehlt
+ * dem Eintrag <type>. Er wird dann nicht abgelehnt, Zugriffe per od_get(),
+ * od_set() und od_ref() scheitern aber beim Compilieren.
+ *
+ * @param index OD Index
+ * @param subindex OD Subindex
+ * @param attr Attribut aus CO_OD.c
+ * @param var Element der Struktur im OD
+ */
+#define CO_OD_TYPED_RECORD_REAL64(index, subindex, attr, var)                 \
+  template <> struct Canopen_od_entry<index, subindex>                        \
+    : Canopen_od_real64<sizeof((var)) == 8,                                   \
+                        std::remove_reference<decltype((var))>::type> {       \
+    static const u16 attribute = (attr);                                      \
+    static decltype((var)) ref(void) { return (var); }                        \
+  };
+
+#include "CO_OD_typed.h"
+
+/**
+ * Referenz auf OD Eintrag
+ *
+ * F"ur Strings und Octet Strings, die nicht per Wert "ubergeben werden k"onnen.
+ *
+ * @tparam index OD Index
+ * @tparam subindex OD Subindex
+ * @return Variable im OD
+ */
+template <u16 index, u8 subindex>
+inline typename Canopen_od_entry<index, subindex>::type &od_ref(void)
+{
+  return Canopen_od_entry<index, subindex>::ref();
+}
+
+/**
+ * OD Eintrag lesen
+ *
+ * @tparam index OD Index
+ * @tparam subindex OD Subindex
+ * @return Im OD hinterlegter Wert
+ */
+template <u16 index, u8 subindex>
+inline typename std::remove_const<typename Canopen_od_entry<index, subindex>::type>::type od_get(void)
+{
+  return Canopen_od_entry<index, subindex>::ref();
+}
+
+/**
+ * OD Eintrag "andern
+ *
+ * Der Typ von <val> muss genau dem Typ des Eintrags entsprechen.
+ *
+ * @tparam index OD Index
+ * @tparam subindex OD Subindex
+ * @param val Zu "ubernehmender Wert
+ */
+template <u16 index, u8 subindex, typename T>
+inline void od_set(T val)
+{
+  static_assert(std::is_same<T, typename Canopen_od_entry<index, subindex>::type>::value,
+                "OD type mismatch");
+  Canopen_od_entry<index, subindex>::ref() = val;
+  if ((Canopen_od_entry<index, subindex>::attribute & CO_ODA_TPDO_MAPABLE) != 0) {
+    /* Change of State, siehe <Canopen::od_written()> */
+    CANrx_threadTmr_wakeup();
+  }
+}
+
+#endif /* SRC_CANOPEN_CANOPEN_OD_H_ */
+
+/**
+* @} @}
+**/
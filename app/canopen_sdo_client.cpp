@@ -0,0 +1,405 @@
+/**
+* @addtogroup io8000 template
+* @{
+* @addtogroup application
+* @{
+* @file canopen_sdo_client.cpp
+* @copyright Neuberger Gebäudeautomation GmbH
+* @brief Asynchrone SDO Client Zugriffe per C++20 Koroutinen
+*
+* @details \b Programm-Name template
+* @details Dieses Modul verteilt beliebig viele ausstehende SDO Up- und
+* Downloads auf die vorhandenen SDO Client Kan"ale
+**/
+
+#include "CANopen.h"
+#include "CO_OD.h"
+
+#include "os/freertos/include/FreeRTOS.h"
+#include "os/freertos/include/task.h"
+
+#include "interface/nbtyp.h"
+
+#include "canopen_sdo_client.h"
+
+#if CO_NO_SDO_CLIENT != 0
+
+Canopen_sdo_client::transfer::transfer(
+    Canopen_sdo_client *p_client, bool upload, u8 nid, u16 index,
+    u8 subindex, u8 *p_data, u32 size, bool block)
+  : p_client(p_client)
+{
+  this->request.p_next = nullptr;
+  this->request.upload = upload;
+  this->request.block = block;
+  this->request.nid = nid;
+  this->request.subindex = subindex;
+  this->request.index = index;
+  this->request.p_data = p_data;
+  this->request.size = size;
+  this->request.result.ret = CO_SDOcli_waitingServerResponse;
+  this->request.result.abort_code = 0;
+  this->request.result.size = 0;
+}
+
+void Canopen_sdo_client::transfer::await_suspend(std::coroutine_handle<> handle) noexcept
+{
+  /* Der Transfer liegt im Rahmen der Koroutine und bleibt bis zu deren
+   * Fortsetzung g"ultig */
+  this->request.handle = handle;
+  this->p_client->enqueue(&this->request);
+}
+
+Canopen_sdo_client::transfer Canopen_sdo_client::upload(
+    u8 nid, u16 index, u8 subindex, void *p_data, u32 size, bool block)
+{
+  return transfer(this, true, nid, index, subindex,
+                  reinterpret_cast<u8*>(p_data), size, block);
+}
+
+Canopen_sdo_client::transfer Canopen_sdo_client::download(
+    u8 nid, u16 index, u8 subindex, const void *p_data, u32 size, bool block)
+{
+  /* Der Stack liest aus dem Puffer nur */
+  return transfer(this, false, nid, index, subindex,
+                  reinterpret_cast<u8*>(const_cast<void*>(p_data)), size, block);
+}
+
+void Canopen_sdo_client::enqueue(request_t *p_request)
+{
+  p_request->p_next = nullptr;
+  if (this->p_pending_tail != nullptr) {
+    this->p_pending_tail->p_next = p_request;
+  } else {
+    this->p_pending_head = p_request;
+  }
+  this->p_pending_tail = p_request;
+}
+
+/**
+ * Transfer beenden und wartende Koroutine fortsetzen
+ *
+ * Der Transfer darf zu diesem Zeitpunkt keinem Kanal mehr zugeordnet sein, da
+ * er mit der Koroutine freigegeben werden kann.
+ */
+void Canopen_sdo_client::finish(
+    request_t *p_request, CO_SDOclient_return_t ret, u32 abort_code, u32 size)
+{
+  p_request->result.ret = ret;
+  p_request->result.abort_code = abort_code;
+  p_request->result.size = size;
+  p_request->handle.resume();
+}
+
+/**
+ * Pr"uft ob bereits ein Kanal mit dem SDO Server kommuniziert
+ *
+ * Ein SDO Server hat nur einen Kanal mit festen COB-IDs, Transfers zum selben
+ * Server m"ussen daher nacheinander abgearbeitet werden.
+ */
+bool Canopen_sdo_client::nid_active(u8 nid) const
+{
+  u8 i;
+
+  for (i = 0; i < this->channel_count; i++) {
+    if (((this->channels[i].hold_nid != 0) && (this->channels[i].hold_nid == nid)) ||
+        ((this->channels[i].p_request != nullptr) &&
+         (this->channels[i].p_request->nid == nid))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * N"achsten startbaren Transfer aus der Warteschlange entnehmen
+ *
+ * @return "altester Transfer zu einem SDO Server ohne laufenden Transfer oder
+ * nullptr
+ */
+Canopen_sdo_client::request_t *Canopen_sdo_client::dequeue(void)
+{
+  request_t *p_prev = nullptr;
+  request_t *p_request;
+
+  for (p_request = this->p_pending_head; p_request != nullptr; p_request = p_request->p_next) {
+    if (!this->nid_active(p_request->nid)) {
+      if (p_prev != nullptr) {
+        p_prev->p_next = p_request->p_next;
+      } else {
+        this->p_pending_head = p_request->p_next;
+      }
+      if (this->p_pending_tail == p_request) {
+        this->p_pending_tail = p_prev;
+      }
+      return p_request;
+    }
+    p_prev = p_request;
+  }
+  return nullptr;
+}
+
+/**
+ * Wartende Transfers freien Kan"alen zuordnen
+ *
+ * @return true wenn mind. ein Transfer gestartet wurde
+ */
+bool Canopen_sdo_client::start_pending(void)
+{
+  bool started = false;
+  u8 i;
+  request_t *p_request;
+  CO_SDOclient_return_t ret;
+
+  for (i = 0; i < this->channel_count; i++) {
+    channel_t *p_channel = &this->channels[i];
+
+    /* fortgesetzte Koroutinen k"onnen neue Transfers eintragen, daher wird
+     * ein Kanal so lange belegt bis ein Transfer tats"achlich l"auft */
+    while ((p_channel->p_request == nullptr) && (p_channel->hold_nid == 0)) {
+      p_request = this->dequeue();
+      if (p_request == nullptr) {
+        return started;
+      }
+
+      if ((p_request->nid == 0) || (p_request->nid > 127)) {
+        this->finish(p_request, CO_SDOcli_wrongArguments, 0, 0);
+        continue;
+      }
+      ret = CO_SDOclient_setup(p_channel->p_sdo, 0, 0, p_request->nid);
+      if (ret == CO_SDOcli_ok_communicationEnd) {
+        if (p_request->upload) {
+          ret = CO_SDOclientUploadInitiate(p_channel->p_sdo, p_request->index,
+                                           p_request->subindex, p_request->p_data,
+                                           p_request->size, p_request->block ? 1 : 0);
+        } else {
+          ret = CO_SDOclientDownloadInitiate(p_channel->p_sdo, p_request->index,
+                                             p_request->subindex, p_request->p_data,
+                                             p_request->size, p_request->block ? 1 : 0);
+        }
+      }
+      if (ret < 0) {
+        CO_SDOclientClose(p_channel->p_sdo);
+        this->finish(p_request, ret, 0, 0);
+        continue;
+      }
+      p_channel->p_request = p_request;
+      started = true;
+    }
+  }
+  return started;
+}
+
+/**
+ * Alle aktiven Kan"ale bedienen
+ *
+ * @param time_difference_ms Zeit seit dem letzten Aufruf
+ * @return Zeit in ms bis zum n"achsten f"alligen SDO Timeout, 0 falls sofort
+ * weitergearbeitet werden muss
+ */
+u16 Canopen_sdo_client::process_channels(u16 time_difference_ms)
+{
+  u8 i;
+  u16 wait = 0xFFFF;
+  u16 remaining;
+  u32 abort_code;
+  u32 size;
+  TickType_t now;
+  CO_SDOclient_return_t ret;
+
+  now = xTaskGetTickCount();
+  for (i = 0; i < this->channel_count; i++) {
+    channel_t *p_channel = &this->channels[i];
+    request_t *p_request = p_channel->p_request;
+    CO_SDOclient_t *p_sdo = p_channel->p_sdo;
+
+    if (p_request == nullptr) {
+      if (p_channel->hold_nid != 0) {
+        if ((TickType_t)(now - p_channel->hold_until) < ((TickType_t)-1 / 2)) {
+          p_channel->hold_nid = 0;
+        } else {
+          remaining = (p_channel->hold_until - now) * portTICK_PERIOD_MS;
+          if (remaining < wait) {
+            wait = remaining;
+          }
+        }
+      }
+      continue;
+    }
+
+    abort_code = 0;
+    size = 0;
+    if (p_request->upload) {
+      ret = CO_SDOclientUpload(p_sdo, time_difference_ms, this->timeout_ms,
+                               &size, &abort_code);
+    } else {
+      ret = CO_SDOclientDownload(p_sdo, time_difference_ms, this->timeout_ms,
+                                 &abort_code);
+      size = p_request->size;
+    }
+
+    if (ret > 0) {
+      if ((ret == CO_SDOcli_blockDownldInProgress) ||
+          (ret == CO_SDOcli_transmittBufferFull)) {
+        /* Blocktransfer sendet weiter sobald Platz im Sendepuffer ist */
+        wait = 0;
+      } else {
+        remaining = (p_sdo->timeoutTimer < this->timeout_ms) ?
+            (this->timeout_ms - p_sdo->timeoutTimer) : 0;
+        if (remaining < wait) {
+          wait = remaining;
+        }
+        if (p_sdo->timeoutTimerBLOCK != 0) {
+          remaining = (p_sdo->timeoutTimerBLOCK < (this->timeout_ms / 2)) ?
+              ((this->timeout_ms / 2) - p_sdo->timeoutTimerBLOCK) : 0;
+          if (remaining < wait) {
+            wait = remaining;
+          }
+        }
+      }
+      continue;
+    }
+
+    /* Kanal freigeben bevor die Koroutine fortgesetzt wird, diese kann sofort
+     * den n"achsten Transfer eintragen */
+    CO_SDOclientClose(p_sdo);
+    p_channel->p_request = nullptr;
+    if ((ret == CO_SDOcli_endedWithTimeout) || (ret == CO_SDOcli_endedWithClientAbort)) {
+      p_channel->hold_nid = p_request->nid;
+      p_channel->hold_until = now + pdMS_TO_TICKS(abort_holdoff);
+      if (abort_holdoff < wait) {
+        wait = abort_holdoff;
+      }
+    }
+    this->finish(p_request, ret, abort_code, size);
+  }
+
+  return wait;
+}
+
+CO_ReturnError_t Canopen_sdo_client::init(CO_t *co, u16 timeout_ms)
+{
+  u8 i;
+
+  if ((co == nullptr) || (timeout_ms == 0)) {
+    return CO_ERROR_ILLEGAL_ARGUMENT;
+  }
+
+  /* Nach Reset Communication sind die Kan"ale neu initialisiert, laufende
+   * Transfers k"onnen nicht fortgesetzt werden */
+  this->deinit();
+
+  this->timeout_ms = timeout_ms;
+  this->loop_handle = xTaskGetCurrentTaskHandle();
+  this->last_tick = xTaskGetTickCount();
+  for (i = 0; i < this->channel_count; i++) {
+    this->channels[i].p_sdo = co->SDOclient[i];
+    this->channels[i].p_request = nullptr;
+    this->channels[i].hold_nid = 0;
+    CO_SDOclient_initCallback(co->SDOclient[i], this, signal_callback_wrapper);
+  }
+  return CO_ERROR_NO;
+}
+
+void Canopen_sdo_client::deinit(void)
+{
+  u8 i;
+  request_t *p_request;
+  request_t *p_pending;
+
+  /* Nur die bisher wartenden Transfers abbrechen. Die Liste wird vor dem
+   * Fortsetzen der ersten Koroutine "ubernommen, von diesen neu eingetragene
+   * Transfers bleiben bis zum n"achsten <init()> erhalten. */
+  p_pending = this->p_pending_head;
+  this->p_pending_head = nullptr;
+  this->p_pending_tail = nullptr;
+
+  this->loop_handle = nullptr;
+  for (i = 0; i < this->channel_count; i++) {
+    p_request = this->channels[i].p_request;
+    if (this->channels[i].p_sdo != nullptr) {
+      CO_SDOclient_initCallback(this->channels[i].p_sdo, nullptr, nullptr);
+      CO_SDOclientClose(this->channels[i].p_sdo);
+    }
+    this->channels[i].p_request = nullptr;
+    if (p_request != nullptr) {
+      this->finish(p_request, CO_SDOcli_endedWithClientAbort, CO_SDO_AB_GENERAL, 0);
+    }
+  }
+
+  while (p_pending != nullptr) {
+    request_t *p_next = p_pending->p_next;
+    this->finish(p_pending, CO_SDOcli_endedWithClientAbort, CO_SDO_AB_GENERAL, 0);
+    p_pending = p_next;
+  }
+}
+
+void Canopen_sdo_client::process(u32 timeout_ms)
+{
+  TickType_t now;
+  u32 diff_ms;
+  u16 wait;
+
+  if (this->loop_handle == nullptr) {
+    vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+    return;
+  }
+
+  now = xTaskGetTickCount();
+  diff_ms = (now - this->last_tick) * portTICK_PERIOD_MS;
+  this->last_tick = now;
+
+  /* Zeitdifferenz nur laufenden Transfers anrechnen, neu gestartete
+   * beginnen mit 0. Beendete Transfers geben Kan"ale frei. */
+  wait = this->process_channels((diff_ms > 0xFFFF) ? 0xFFFF : (u16)diff_ms);
+  while (this->start_pending()) {
+    wait = this->process_channels(0);
+  }
+
+  if (wait < timeout_ms) {
+    timeout_ms = wait;
+  }
+
+  /* Das Signal des Stacks trifft aus dem CO Thread ein, sobald eine SDO
+   * Antwort empfangen wurde */
+  (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+}
+
+u32 Canopen_sdo_client::get_outstanding(void) const
+{
+  u8 i;
+  u32 count = 0;
+  const request_t *p_request;
+
+  for (i = 0; i < this->channel_count; i++) {
+    if (this->channels[i].p_request != nullptr) {
+      count++;
+    }
+  }
+  for (p_request = this->p_pending_head; p_request != nullptr; p_request = p_request->p_next) {
+    count++;
+  }
+  return count;
+}
+
+void Canopen_sdo_client::signal_callback_wrapper(void *p_object)
+{
+  Canopen_sdo_client *p_this = reinterpret_cast<Canopen_sdo_client*>(p_object);
+  TaskHandle_t handle;
+
+  /* w"ahrend <deinit()> kann der CAN Empfang noch mit dem bereits
+   * gel"oschten Objekt aufrufen */
+  if (p_this == nullptr) {
+    return;
+  }
+  handle = p_this->loop_handle;
+  if (handle != nullptr) {
+    (void)xTaskNotifyGive(handle);
+  }
+}
+
+#endif /* CO_NO_SDO_CLIENT != 0 */
+
+/**
+* @} @}
+**/
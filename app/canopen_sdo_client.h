@@ -0,0 +1,241 @@
+/**
+* @addtogroup io8000 template
+* @{
+* @addtogroup application
+* @{
+* @file canopen_sdo_client.h
+* @copyright Neuberger Gebäudeautomation GmbH
+* @brief Asynchrone SDO Client Zugriffe per C++20 Koroutinen
+*
+* @details \b Programm-Name template
+* @details Dieses Modul verteilt beliebig viele ausstehende SDO Up- und
+* Downloads auf die vorhandenen SDO Client Kan"ale. Transfers zum selben SDO
+* Server werden nacheinander ausgef"uhrt. Alle Transfers werden in
+* einem einzigen Thread abgearbeitet, der per <process()> die Zustandsmaschinen
+* des Stacks bedient. Der Thread wird durch das Signal aus
+* CO_SDOclient_initCallback() geweckt und muss nicht pollen.
+*
+* Anwendung:
+*
+*     Canopen_sdo_client::task read_serial(Canopen_sdo_client &sdo, u8 nid)
+*     {
+*       u32 serial;
+*       Canopen_sdo_client::result_t result;
+*
+*       result = co_await sdo.upload(nid, 0x1018, 4, &serial, sizeof(serial));
+*       if (result.ret == CO_SDOcli_ok_communicationEnd) {
+*         ...
+*       }
+*     }
+*
+*     sdo.init(CO, 500);
+*     for (nid = 1; nid <= 127; nid++) {
+*       read_serial(sdo, nid);
+*     }
+*     while (true) {
+*       sdo.process(50);
+*     }
+*
+* @remark <Canopen_sdo_client> existiert nur, wenn das OD SDO Client Kan"ale
+* enth"alt (CO_NO_SDO_CLIENT != 0).
+**/
+#ifndef SRC_CANOPEN_CANOPEN_SDO_CLIENT_H_
+#define SRC_CANOPEN_CANOPEN_SDO_CLIENT_H_
+
+#include <coroutine>
+#include <new>
+
+#include "CANopen.h"
+#include "CO_OD.h"
+
+#include "os/freertos/include/FreeRTOS.h"
+#include "os/freertos/include/task.h"
+
+#include "interface/nbtyp.h"
+
+#if !defined(__cpp_impl_coroutine)
+#error "canopen_sdo_client.h requires C++20 coroutines (-std=c++20)"
+#endif
+
+/* CO_SDOclient_t ist ohne SDO Client Kan"ale nicht deklariert */
+#if CO_NO_SDO_CLIENT != 0
+
+/**
+ * SDO Client mit co_await-baren Up- und Downloads
+ *
+ * @remark Koroutinen, die Transfers dieses Objekts abwarten, d"urfen nur im
+ * Thread von <init()>/<process()> gestartet werden. Sie werden auch in diesem
+ * Thread fortgesetzt.
+ */
+class Canopen_sdo_client {
+  public:
+    /**
+     * Ergebnis eines Transfers
+     */
+    typedef struct {
+      CO_SDOclient_return_t ret; /*!< CO_SDOcli_ok_communicationEnd wenn erfolgreich */
+      u32 abort_code;            /*!< SDO Abort Code bei Abbruch */
+      u32 size;                  /*!< Upload: Anzahl empfangener Bytes */
+    } result_t;
+
+    /**
+     * R"uckgabetyp f"ur Koroutinen, die Transfers abwarten
+     *
+     * Die Koroutine startet sofort und gibt ihren Speicher nach Ende selbst
+     * frei ("fire and forget"). Schl"agt die Allokation fehl, wird die
+     * Koroutine nicht ausgef"uhrt.
+     */
+    struct task {
+      struct promise_type {
+        task get_return_object(void) noexcept { return {}; }
+        static task get_return_object_on_allocation_failure(void) noexcept { return {}; }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) noexcept {}
+        void unhandled_exception(void) noexcept { configASSERT(0); }
+      };
+    };
+
+  private:
+    /**
+     * Ausstehender Transfer. Liegt im Rahmen der wartenden Koroutine.
+     */
+    typedef struct request {
+      struct request *p_next;    /*!< Warteschlange */
+      bool upload;               /*!< true: Upload, false: Download */
+      bool block;                /*!< Blocktransfer versuchen */
+      u8 nid;                    /*!< Node ID des SDO Servers */
+      u8 subindex;
+      u16 index;
+      u8 *p_data;                /*!< Sende-/Empfangspuffer */
+      u32 size;                  /*!< Download: Datenl"ange, Upload: Puffergr"o"se */
+      std::coroutine_handle<> handle; /*!< wartende Koroutine */
+      result_t result;
+    } request_t;
+
+    /**
+     * SDO Client Kanal des Stacks
+     */
+    typedef struct {
+      CO_SDOclient_t *p_sdo;
+      request_t *p_request;      /*!< aktiver Transfer oder nullptr */
+      u8 hold_nid;               /*!< Server nach Client Abort, 0 = keiner */
+      TickType_t hold_until;     /*!< Ende der Wartezeit nach Client Abort */
+    } channel_t;
+
+    static const u8 channel_count = CO_NO_SDO_CLIENT;
+    /* Der SDO Server verwirft eine Anfrage, die eintrifft bevor er den
+     * vorhergehenden Abort verarbeitet hat. Nach einem Client Abort bleibt der
+     * Kanal daher kurz f"ur diesen Server reserviert. */
+    static const u8 abort_holdoff = 10; /*!< ms */
+    channel_t channels[CO_NO_SDO_CLIENT] = {};
+    request_t *p_pending_head = nullptr; /*!< noch keinem Kanal zugeordnet */
+    request_t *p_pending_tail = nullptr;
+    u16 timeout_ms = 0;                  /*!< SDO Timeout */
+    TickType_t last_tick = 0;            /*!< Zeitpunkt des letzten <process()> */
+    TaskHandle_t loop_handle = nullptr;  /*!< Thread von <process()> */
+
+    void enqueue(request_t *p_request);
+    request_t *dequeue(void);
+    bool nid_active(u8 nid) const;
+    bool start_pending(void);
+    u16 process_channels(u16 time_difference_ms);
+    void finish(request_t *p_request, CO_SDOclient_return_t ret, u32 abort_code, u32 size);
+
+  public:
+    /**
+     * co_await-bares Transferobjekt, wird von <upload()>/<download()>
+     * zur"uckgegeben
+     */
+    class transfer {
+      private:
+        Canopen_sdo_client *p_client;
+        request_t request;
+
+      public:
+        transfer(Canopen_sdo_client *p_client, bool upload, u8 nid, u16 index,
+                 u8 subindex, u8 *p_data, u32 size, bool block);
+        bool await_ready(void) const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) noexcept;
+        result_t await_resume(void) const noexcept { return this->request.result; }
+    };
+
+    /**
+     * SDO Client initialisieren
+     *
+     * Tr"agt den Wecker f"ur alle SDO Client Kan"ale ein. Muss im Thread von
+     * <process()> aufgerufen werden, auch erneut nach jedem NMT Event
+     * RESET_COMMUNICATION. Laufende Transfers werden dabei mit
+     * CO_SDOcli_endedWithClientAbort beendet.
+     *
+     * @param co CANopen Objekt
+     * @param timeout_ms SDO Timeout in ms
+     * @return CO_ERROR_NO wenn erfolgreich
+     */
+    CO_ReturnError_t init(CO_t *co, u16 timeout_ms);
+
+    /**
+     * Wecker austragen, alle Transfers mit CO_SDOcli_endedWithClientAbort beenden
+     */
+    void deinit(void);
+
+    /**
+     * SDO Upload (Lesen vom Server) starten
+     *
+     * @param nid Node ID des SDO Servers
+     * @param index OD Index im Server
+     * @param subindex OD Subindex im Server
+     * @param p_data Empfangspuffer, muss bis zum Ende des Transfers g"ultig sein
+     * @param size Gr"o"se des Empfangspuffers, mind. 4 Bytes. F"ur
+     * Blocktransfer mind. 7 * CO_SDOclient_t::block_size_max Bytes.
+     * @param block Blocktransfer versuchen
+     * @return mit co_await abzuwartender Transfer
+     */
+    transfer upload(u8 nid, u16 index, u8 subindex, void *p_data, u32 size,
+                    bool block = false);
+
+    /**
+     * SDO Download (Schreiben zum Server) starten
+     *
+     * @param nid Node ID des SDO Servers
+     * @param index OD Index im Server
+     * @param subindex OD Subindex im Server
+     * @param p_data Zu sendende Daten (little-endian), muss bis zum Ende des
+     * Transfers g"ultig sein
+     * @param size Anzahl zu sendender Bytes
+     * @param block Blocktransfer versuchen
+     * @return mit co_await abzuwartender Transfer
+     */
+    transfer download(u8 nid, u16 index, u8 subindex, const void *p_data,
+                      u32 size, bool block = false);
+
+    /**
+     * Abarbeitung aller Transfers
+     *
+     * Ordnet wartende Transfers freien Kan"alen zu, bedient alle aktiven
+     * Kan"ale und setzt die Koroutinen beendeter Transfers fort. Blockiert
+     * danach bis eine SDO Antwort eintrifft, der n"achste SDO Timeout
+     * f"allig ist oder <timeout_ms> abgelaufen ist.
+     *
+     * @param timeout_ms max. Wartezeit in ms
+     */
+    void process(u32 timeout_ms);
+
+    /**
+     * @return Anzahl laufender und wartender Transfers
+     */
+    u32 get_outstanding(void) const;
+
+    /**
+     * Wrapper f"ur "C" Callback
+     */
+    static void signal_callback_wrapper(void *p_object);
+};
+
+#endif /* CO_NO_SDO_CLIENT != 0 */
+
+#endif /* SRC_CANOPEN_CANOPEN_SDO_CLIENT_H_ */
+
+/**
+* @} @}
+**/
@@ -142,6 +142,7 @@ CO_ReturnError_t Canopen_storage::load(storage_type_t type)
 CO_ReturnError_t Canopen_storage::save(storage_type_t type)
 {
   CO_ReturnError_t result;
+  bool changed;
 
   if (this->remaining_size < 0) {
     return CO_ERROR_OUT_OF_MEMORY;
@@ -149,9 +150,19 @@ CO_ReturnError_t Canopen_storage::save(storage_type_t type)
 
   lock();
 
+  /* Seit dem letzten Speichern unver"andert? Dann sparen wir uns den CRC */
+  if (this->p_sdo != nullptr) {
+    changed = CO_OD_dirtyClear(&this->dirty[type]);
+    if ((this->synced[type] == true) && (changed != true)) {
+      unlock();
+      return CO_ERROR_NO;
+    }
+  }
+
   result =  Canopen_storage_type::save(this->start[type], this->reserved_size[type],
                                        this->actual_size[type], this->work,
                                        this->p_ram[type]);
+  this->synced[type] = (result == CO_ERROR_NO);
 
   unlock();
 
@@ -169,7 +180,81 @@ void Canopen_storage::restore(storage_type_t type)
   Canopen_storage_type::erase(this->start[type], this->reserved_size[type]);
   /* Der eigentliche Restore wird erst beim n"achsten NMT reset comm/app
    * durchgef"uhrt */
+  this->synced[type] = false;
+
+  unlock();
+}
+
+CO_ReturnError_t Canopen_storage::track(CO_SDO_t *p_sdo)
+{
+  CO_ReturnError_t result = CO_ERROR_NO;
+  u8 type;
+
+  /* Reihenfolge wie bei <save()> aus dem SDO Callback: erst OD, dann Speicher */
+  CO_LOCK_OD(p_sdo->CANdevTx);
+  lock();
+
+  unregister();
+  for (type = 0; type < TYPE_COUNT; type++) {
+    (void)memset(this->dirty_mask[type], 0, sizeof(this->dirty_mask[type]));
+    (void)CO_OD_dirtyMaskRange(p_sdo, this->dirty_mask[type], dirty_words,
+                               this->p_ram[type], this->actual_size[type]);
+    result = CO_OD_dirtyRegister(p_sdo, &this->dirty[type], this->dirty_bits[type],
+                                 this->dirty_mask[type], dirty_words);
+    if (result != CO_ERROR_NO) {
+      break;
+    }
+  }
+  if (result == CO_ERROR_NO) {
+    this->p_sdo = p_sdo;
+  } else {
+    while (type > 0) {
+      type--;
+      CO_OD_dirtyUnregister(p_sdo, &this->dirty[type]);
+    }
+  }
+
+  unlock();
+  CO_UNLOCK_OD(p_sdo->CANdevTx);
+
+  return result;
+}
+
+void Canopen_storage::untrack(void)
+{
+  CO_CANmodule_t *p_can = nullptr;
+
+  /* nur der Thread, der <track()> aufgerufen hat, "andert p_sdo */
+  if (this->p_sdo == nullptr) {
+    return;
+  }
+  p_can = this->p_sdo->CANdevTx;
+
+  CO_LOCK_OD(p_can);
+  lock();
+  unregister();
+  unlock();
+  CO_UNLOCK_OD(p_can);
+}
 
+void Canopen_storage::unregister(void)
+{
+  u8 type;
+
+  if (this->p_sdo == nullptr) {
+    return;
+  }
+  for (type = 0; type < TYPE_COUNT; type++) {
+    CO_OD_dirtyUnregister(this->p_sdo, &this->dirty[type]);
+    this->synced[type] = false;
+  }
+  this->p_sdo = nullptr;
+}
+
+void Canopen_storage::invalidate(storage_type_t type)
+{
+  lock();
+  this->synced[type] = false;
   unlock();
 }
 
@@ -163,6 +163,19 @@ class Canopen_storage : Canopen_storage_type {
     void lock(void);
     void unlock(void);
 
+    /*
+     * Dirty Bits je Bereich. Ist das OD gr"o"ser als <dirty_positions>
+     * Subindizes, bleibt es beim CRC Vergleich.
+     */
+    static const u16 dirty_positions = 512;
+    static const u16 dirty_words = CO_OD_DIRTY_WORDS(dirty_positions);
+    CO_SDO_t *p_sdo = nullptr;                      /* nullptr: keine Dirty Bits */
+    CO_OD_dirty_t dirty[TYPE_COUNT] = {};
+    u32 dirty_bits[TYPE_COUNT][dirty_words] = {};
+    u32 dirty_mask[TYPE_COUNT][dirty_words] = {};
+    bool synced[TYPE_COUNT] = {};                   /* EEPROM entspricht RAM */
+    void unregister(void);
+
   public:
 
     /**
@@ -178,11 +191,39 @@ class Canopen_storage : Canopen_storage_type {
      * Parametersatz speichern. Ein Schreibvorgang wird nur ausgel"ost wenn
      * sich Daten ge"andert haben.
      *
+     * Mit <track()> wird der CRC nur berechnet, wenn seit dem letzten
+     * Speichern per SDO, RPDO oder <Canopen::od_set()> in den Bereich
+     * geschrieben wurde. Das OD muss dann mit CO_LOCK_OD() gesperrt sein.
+     *
      * @param type Zu bearbeitender Speicherbereich
      * @return CO_ERROR_NO wenn OK
      */
     CO_ReturnError_t save(storage_type_t type);
 
+    /**
+     * "Anderungen im OD f"ur <save()> verfolgen
+     *
+     * Nach jedem CO_CANopenInit() aufzurufen. Das OD darf nicht gesperrt sein.
+     *
+     * @param p_sdo SDO Server mit dem OD
+     * @return CO_ERROR_NO wenn OK, sonst wird immer der CRC verglichen
+     */
+    CO_ReturnError_t track(CO_SDO_t *p_sdo);
+
+    /**
+     * Verfolgung beenden, vor CO_delete() aufzurufen. Das OD darf nicht
+     * gesperrt sein.
+     */
+    void untrack(void);
+
+    /**
+     * Direkten Schreibzugriff auf Variablen des Bereichs melden, z.B.
+     * OD_powerOnCounter. Der n"achste <save()> vergleicht den CRC.
+     *
+     * @param type Ge"anderter Speicherbereich
+     */
+    void invalidate(storage_type_t type);
+
     /**
      * Parametersatz zur"ucksetzen. Dieses ver"andert die aktuell geladene
      * Konfiguration nicht (siehe CiA 301 Beschreibung Objekt 1011).
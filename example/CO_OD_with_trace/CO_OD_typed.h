@@ -0,0 +1,338 @@
+/*
+ * CANopen Object Dictionary, typed access for C++.
+ *
+ * One entry per object of CO_OD[] in CO_OD.c, using the same variables. It
+ * has to be kept in sync with CO_OD.c by hand. The CO_OD_TYPED_xxx() macros
+ * are defined by the includer (see canopen_od.h). REAL64 entries use
+ * CO_OD_TYPED_RECORD_REAL64(), as float64_t is not 8 bytes on every target.
+ * For more information on CANopen Object Dictionary see <CO_SDO.h>.
+ *
+ * @file        CO_OD_typed.h
+ * @author      Martin Wagner
+ */
+
+
+#ifndef CO_OD_TYPED_H
+#define CO_OD_TYPED_H
+
+
+/*******************************************************************************
+   TYPED OBJECT DICTIONARY
+*******************************************************************************/
+/*1000*/
+      CO_OD_TYPED_VAR(0x1000, 0x85, 4, CO_OD_ROM.deviceType)
+
+/*1001*/
+      CO_OD_TYPED_VAR(0x1001, 0x36, 1, CO_OD_RAM.errorRegister)
+
+/*1002*/
+      CO_OD_TYPED_VAR(0x1002, 0xB6, 4, CO_OD_RAM.manufacturerStatusRegister)
+
+/*1003*/
+      CO_OD_TYPED_ARRAY(0x1003, 8, 0x8E, 4, CO_OD_RAM.preDefinedErrorField)
+
+/*1005*/
+      CO_OD_TYPED_VAR(0x1005, 0x8D, 4, CO_OD_ROM.COB_ID_SYNCMessage)
+
+/*1006*/
+      CO_OD_TYPED_VAR(0x1006, 0x8D, 4, CO_OD_ROM.communicationCyclePeriod)
+
+/*1007*/
+      CO_OD_TYPED_VAR(0x1007, 0x8D, 4, CO_OD_ROM.synchronousWindowLength)
+
+/*1008*/
+      CO_OD_TYPED_VAR(0x1008, 0x05, 11, CO_OD_ROM.manufacturerDeviceName)
+
+/*1009*/
+      CO_OD_TYPED_VAR(0x1009, 0x05, 4, CO_OD_ROM.manufacturerHardwareVersion)
+
+/*100A*/
+      CO_OD_TYPED_VAR(0x100A, 0x05, 4, CO_OD_ROM.manufacturerSoftwareVersion)
+
+/*1010*/
+      CO_OD_TYPED_ARRAY(0x1010, 1, 0x8E, 4, CO_OD_RAM.storeParameters)
+
+/*1011*/
+      CO_OD_TYPED_ARRAY(0x1011, 1, 0x8E, 4, CO_OD_RAM.restoreDefaultParameters)
+
+/*1014*/
+      CO_OD_TYPED_VAR(0x1014, 0x85, 4, CO_OD_ROM.COB_ID_EMCY)
+
+/*1015*/
+      CO_OD_TYPED_VAR(0x1015, 0x8D, 2, CO_OD_ROM.inhibitTimeEMCY)
+
+/*1016*/
+      CO_OD_TYPED_ARRAY(0x1016, 4, 0x8D, 4, CO_OD_ROM.consumerHeartbeatTime)
+
+/*1017*/
+      CO_OD_TYPED_VAR(0x1017, 0x8D, 2, CO_OD_ROM.producerHeartbeatTime)
+
+/*1018*/
+      CO_OD_TYPED_RECORD(0x1018, 0, 0x05, 1, CO_OD_ROM.identity.maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1018, 1, 0x85, 4, CO_OD_ROM.identity.vendorID)
+      CO_OD_TYPED_RECORD(0x1018, 2, 0x85, 4, CO_OD_ROM.identity.productCode)
+      CO_OD_TYPED_RECORD(0x1018, 3, 0x85, 4, CO_OD_ROM.identity.revisionNumber)
+      CO_OD_TYPED_RECORD(0x1018, 4, 0x85, 4, CO_OD_ROM.identity.serialNumber)
+
+/*1019*/
+      CO_OD_TYPED_VAR(0x1019, 0x0D, 1, CO_OD_ROM.synchronousCounterOverflowValue)
+
+/*1029*/
+      CO_OD_TYPED_ARRAY(0x1029, 6, 0x0D, 1, CO_OD_ROM.errorBehavior)
+
+/*1200*/
+      CO_OD_TYPED_RECORD(0x1200, 0, 0x05, 1, CO_OD_ROM.SDOServerParameter[0].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1200, 1, 0x85, 4, CO_OD_ROM.SDOServerParameter[0].COB_IDClientToServer)
+      CO_OD_TYPED_RECORD(0x1200, 2, 0x85, 4, CO_OD_ROM.SDOServerParameter[0].COB_IDServerToClient)
+
+/*1400*/
+      CO_OD_TYPED_RECORD(0x1400, 0, 0x05, 1, CO_OD_ROM.RPDOCommunicationParameter[0].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1400, 1, 0x8D, 4, CO_OD_ROM.RPDOCommunicationParameter[0].COB_IDUsedByRPDO)
+      CO_OD_TYPED_RECORD(0x1400, 2, 0x0D, 1, CO_OD_ROM.RPDOCommunicationParameter[0].transmissionType)
+
+/*1401*/
+      CO_OD_TYPED_RECORD(0x1401, 0, 0x05, 1, CO_OD_ROM.RPDOCommunicationParameter[1].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1401, 1, 0x8D, 4, CO_OD_ROM.RPDOCommunicationParameter[1].COB_IDUsedByRPDO)
+      CO_OD_TYPED_RECORD(0x1401, 2, 0x0D, 1, CO_OD_ROM.RPDOCommunicationParameter[1].transmissionType)
+
+/*1402*/
+      CO_OD_TYPED_RECORD(0x1402, 0, 0x05, 1, CO_OD_ROM.RPDOCommunicationParameter[2].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1402, 1, 0x8D, 4, CO_OD_ROM.RPDOCommunicationParameter[2].COB_IDUsedByRPDO)
+      CO_OD_TYPED_RECORD(0x1402, 2, 0x0D, 1, CO_OD_ROM.RPDOCommunicationParameter[2].transmissionType)
+
+/*1403*/
+      CO_OD_TYPED_RECORD(0x1403, 0, 0x05, 1, CO_OD_ROM.RPDOCommunicationParameter[3].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1403, 1, 0x8D, 4, CO_OD_ROM.RPDOCommunicationParameter[3].COB_IDUsedByRPDO)
+      CO_OD_TYPED_RECORD(0x1403, 2, 0x0D, 1, CO_OD_ROM.RPDOCommunicationParameter[3].transmissionType)
+
+/*1600*/
+      CO_OD_TYPED_RECORD(0x1600, 0, 0x0D, 1, CO_OD_ROM.RPDOMappingParameter[0].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1600, 1, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1600, 2, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1600, 3, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1600, 4, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1600, 5, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1600, 6, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1600, 7, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1600, 8, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[0].mappedObject8)
+
+/*1601*/
+      CO_OD_TYPED_RECORD(0x1601, 0, 0x0D, 1, CO_OD_ROM.RPDOMappingParameter[1].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1601, 1, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1601, 2, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1601, 3, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1601, 4, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1601, 5, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1601, 6, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1601, 7, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1601, 8, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[1].mappedObject8)
+
+/*1602*/
+      CO_OD_TYPED_RECORD(0x1602, 0, 0x0D, 1, CO_OD_ROM.RPDOMappingParameter[2].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1602, 1, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1602, 2, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1602, 3, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1602, 4, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1602, 5, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1602, 6, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1602, 7, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1602, 8, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[2].mappedObject8)
+
+/*1603*/
+      CO_OD_TYPED_RECORD(0x1603, 0, 0x0D, 1, CO_OD_ROM.RPDOMappingParameter[3].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1603, 1, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1603, 2, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1603, 3, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1603, 4, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1603, 5, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1603, 6, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1603, 7, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1603, 8, 0x8D, 4, CO_OD_ROM.RPDOMappingParameter[3].mappedObject8)
+
+/*1800*/
+      CO_OD_TYPED_RECORD(0x1800, 0, 0x05, 1, CO_OD_ROM.TPDOCommunicationParameter[0].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1800, 1, 0x8D, 4, CO_OD_ROM.TPDOCommunicationParameter[0].COB_IDUsedByTPDO)
+      CO_OD_TYPED_RECORD(0x1800, 2, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[0].transmissionType)
+      CO_OD_TYPED_RECORD(0x1800, 3, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[0].inhibitTime)
+      CO_OD_TYPED_RECORD(0x1800, 4, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[0].compatibilityEntry)
+      CO_OD_TYPED_RECORD(0x1800, 5, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[0].eventTimer)
+      CO_OD_TYPED_RECORD(0x1800, 6, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[0].SYNCStartValue)
+
+/*1801*/
+      CO_OD_TYPED_RECORD(0x1801, 0, 0x05, 1, CO_OD_ROM.TPDOCommunicationParameter[1].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1801, 1, 0x8D, 4, CO_OD_ROM.TPDOCommunicationParameter[1].COB_IDUsedByTPDO)
+      CO_OD_TYPED_RECORD(0x1801, 2, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[1].transmissionType)
+      CO_OD_TYPED_RECORD(0x1801, 3, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[1].inhibitTime)
+      CO_OD_TYPED_RECORD(0x1801, 4, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[1].compatibilityEntry)
+      CO_OD_TYPED_RECORD(0x1801, 5, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[1].eventTimer)
+      CO_OD_TYPED_RECORD(0x1801, 6, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[1].SYNCStartValue)
+
+/*1802*/
+      CO_OD_TYPED_RECORD(0x1802, 0, 0x05, 1, CO_OD_ROM.TPDOCommunicationParameter[2].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1802, 1, 0x8D, 4, CO_OD_ROM.TPDOCommunicationParameter[2].COB_IDUsedByTPDO)
+      CO_OD_TYPED_RECORD(0x1802, 2, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[2].transmissionType)
+      CO_OD_TYPED_RECORD(0x1802, 3, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[2].inhibitTime)
+      CO_OD_TYPED_RECORD(0x1802, 4, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[2].compatibilityEntry)
+      CO_OD_TYPED_RECORD(0x1802, 5, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[2].eventTimer)
+      CO_OD_TYPED_RECORD(0x1802, 6, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[2].SYNCStartValue)
+
+/*1803*/
+      CO_OD_TYPED_RECORD(0x1803, 0, 0x05, 1, CO_OD_ROM.TPDOCommunicationParameter[3].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x1803, 1, 0x8D, 4, CO_OD_ROM.TPDOCommunicationParameter[3].COB_IDUsedByTPDO)
+      CO_OD_TYPED_RECORD(0x1803, 2, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[3].transmissionType)
+      CO_OD_TYPED_RECORD(0x1803, 3, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[3].inhibitTime)
+      CO_OD_TYPED_RECORD(0x1803, 4, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[3].compatibilityEntry)
+      CO_OD_TYPED_RECORD(0x1803, 5, 0x8D, 2, CO_OD_ROM.TPDOCommunicationParameter[3].eventTimer)
+      CO_OD_TYPED_RECORD(0x1803, 6, 0x0D, 1, CO_OD_ROM.TPDOCommunicationParameter[3].SYNCStartValue)
+
+/*1A00*/
+      CO_OD_TYPED_RECORD(0x1A00, 0, 0x0D, 1, CO_OD_ROM.TPDOMappingParameter[0].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1A00, 1, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1A00, 2, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1A00, 3, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1A00, 4, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1A00, 5, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1A00, 6, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1A00, 7, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1A00, 8, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[0].mappedObject8)
+
+/*1A01*/
+      CO_OD_TYPED_RECORD(0x1A01, 0, 0x0D, 1, CO_OD_ROM.TPDOMappingParameter[1].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1A01, 1, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1A01, 2, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1A01, 3, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1A01, 4, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1A01, 5, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1A01, 6, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1A01, 7, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1A01, 8, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[1].mappedObject8)
+
+/*1A02*/
+      CO_OD_TYPED_RECORD(0x1A02, 0, 0x0D, 1, CO_OD_ROM.TPDOMappingParameter[2].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1A02, 1, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1A02, 2, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1A02, 3, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1A02, 4, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1A02, 5, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1A02, 6, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1A02, 7, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1A02, 8, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[2].mappedObject8)
+
+/*1A03*/
+      CO_OD_TYPED_RECORD(0x1A03, 0, 0x0D, 1, CO_OD_ROM.TPDOMappingParameter[3].numberOfMappedObjects)
+      CO_OD_TYPED_RECORD(0x1A03, 1, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject1)
+      CO_OD_TYPED_RECORD(0x1A03, 2, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject2)
+      CO_OD_TYPED_RECORD(0x1A03, 3, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject3)
+      CO_OD_TYPED_RECORD(0x1A03, 4, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject4)
+      CO_OD_TYPED_RECORD(0x1A03, 5, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject5)
+      CO_OD_TYPED_RECORD(0x1A03, 6, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject6)
+      CO_OD_TYPED_RECORD(0x1A03, 7, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject7)
+      CO_OD_TYPED_RECORD(0x1A03, 8, 0x8D, 4, CO_OD_ROM.TPDOMappingParameter[3].mappedObject8)
+
+/*1F80*/
+      CO_OD_TYPED_VAR(0x1F80, 0x8D, 4, CO_OD_ROM.NMTStartup)
+
+/*2100*/
+      CO_OD_TYPED_VAR(0x2100, 0x36, 10, CO_OD_RAM.errorStatusBits)
+
+/*2101*/
+      CO_OD_TYPED_VAR(0x2101, 0x0D, 1, CO_OD_ROM.CANNodeID)
+
+/*2102*/
+      CO_OD_TYPED_VAR(0x2102, 0x8D, 2, CO_OD_ROM.CANBitRate)
+
+/*2103*/
+      CO_OD_TYPED_VAR(0x2103, 0x8E, 2, CO_OD_RAM.SYNCCounter)
+
+/*2104*/
+      CO_OD_TYPED_VAR(0x2104, 0x86, 2, CO_OD_RAM.SYNCTime)
+
+/*2106*/
+      CO_OD_TYPED_VAR(0x2106, 0x87, 4, CO_OD_EEPROM.powerOnCounter)
+
+/*2107*/
+      CO_OD_TYPED_ARRAY(0x2107, 5, 0xBE, 2, CO_OD_RAM.performance)
+
+/*2108*/
+      CO_OD_TYPED_ARRAY(0x2108, 1, 0xB6, 2, CO_OD_RAM.temperature)
+
+/*2109*/
+      CO_OD_TYPED_ARRAY(0x2109, 1, 0xB6, 2, CO_OD_RAM.voltage)
+
+/*2110*/
+      CO_OD_TYPED_ARRAY(0x2110, 16, 0xFE, 4, CO_OD_RAM.variableInt32)
+
+/*2111*/
+      CO_OD_TYPED_ARRAY(0x2111, 16, 0xFD, 4, CO_OD_ROM.variableROMInt32)
+
+/*2112*/
+      CO_OD_TYPED_ARRAY(0x2112, 16, 0xFF, 4, CO_OD_EEPROM.variableNVInt32)
+
+/*2120*/
+      CO_OD_TYPED_RECORD(0x2120, 0, 0x06, 1, CO_OD_RAM.testVar.maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2120, 1, 0xBE, 8, CO_OD_RAM.testVar.I64)
+      CO_OD_TYPED_RECORD(0x2120, 2, 0xBE, 8, CO_OD_RAM.testVar.U64)
+      CO_OD_TYPED_RECORD(0x2120, 3, 0xBE, 4, CO_OD_RAM.testVar.R32)
+      CO_OD_TYPED_RECORD_REAL64(0x2120, 4, 0xBE, CO_OD_RAM.testVar.R64)
+
+/*2130*/
+      CO_OD_TYPED_RECORD(0x2130, 0, 0x06, 1, CO_OD_RAM.time.maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2130, 1, 0x06, 30, CO_OD_RAM.time.string)
+      CO_OD_TYPED_RECORD(0x2130, 2, 0x8E, 8, CO_OD_RAM.time.epochTimeBaseMs)
+      CO_OD_TYPED_RECORD(0x2130, 3, 0xBE, 4, CO_OD_RAM.time.epochTimeOffsetMs)
+
+/*2301*/
+      CO_OD_TYPED_RECORD(0x2301, 0, 0x05, 1, CO_OD_ROM.traceConfig[0].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2301, 1, 0x8D, 4, CO_OD_ROM.traceConfig[0].size)
+      CO_OD_TYPED_RECORD(0x2301, 2, 0x0D, 1, CO_OD_ROM.traceConfig[0].axisNo)
+      CO_OD_TYPED_RECORD(0x2301, 3, 0x0D, 30, CO_OD_ROM.traceConfig[0].name)
+      CO_OD_TYPED_RECORD(0x2301, 4, 0x0D, 20, CO_OD_ROM.traceConfig[0].color)
+      CO_OD_TYPED_RECORD(0x2301, 5, 0x8D, 4, CO_OD_ROM.traceConfig[0].map)
+      CO_OD_TYPED_RECORD(0x2301, 6, 0x0D, 1, CO_OD_ROM.traceConfig[0].format)
+      CO_OD_TYPED_RECORD(0x2301, 7, 0x0D, 1, CO_OD_ROM.traceConfig[0].trigger)
+      CO_OD_TYPED_RECORD(0x2301, 8, 0x8D, 4, CO_OD_ROM.traceConfig[0].threshold)
+
+/*2302*/
+      CO_OD_TYPED_RECORD(0x2302, 0, 0x05, 1, CO_OD_ROM.traceConfig[1].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2302, 1, 0x8D, 4, CO_OD_ROM.traceConfig[1].size)
+      CO_OD_TYPED_RECORD(0x2302, 2, 0x0D, 1, CO_OD_ROM.traceConfig[1].axisNo)
+      CO_OD_TYPED_RECORD(0x2302, 3, 0x0D, 30, CO_OD_ROM.traceConfig[1].name)
+      CO_OD_TYPED_RECORD(0x2302, 4, 0x0D, 20, CO_OD_ROM.traceConfig[1].color)
+      CO_OD_TYPED_RECORD(0x2302, 5, 0x8D, 4, CO_OD_ROM.traceConfig[1].map)
+      CO_OD_TYPED_RECORD(0x2302, 6, 0x0D, 1, CO_OD_ROM.traceConfig[1].format)
+      CO_OD_TYPED_RECORD(0x2302, 7, 0x0D, 1, CO_OD_ROM.traceConfig[1].trigger)
+      CO_OD_TYPED_RECORD(0x2302, 8, 0x8D, 4, CO_OD_ROM.traceConfig[1].threshold)
+
+/*2400*/
+      CO_OD_TYPED_VAR(0x2400, 0x3E, 1, CO_OD_RAM.traceEnable)
+
+/*2401*/
+      CO_OD_TYPED_RECORD(0x2401, 0, 0x06, 1, CO_OD_RAM.trace[0].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2401, 1, 0xBE, 4, CO_OD_RAM.trace[0].size)
+      CO_OD_TYPED_RECORD(0x2401, 2, 0xA6, 4, CO_OD_RAM.trace[0].value)
+      CO_OD_TYPED_RECORD(0x2401, 3, 0xBE, 4, CO_OD_RAM.trace[0].min)
+      CO_OD_TYPED_RECORD(0x2401, 4, 0xBE, 4, CO_OD_RAM.trace[0].max)
+      CO_OD_TYPED_RECORD(0x2401, 6, 0xBE, 4, CO_OD_RAM.trace[0].triggerTime)
+
+/*2402*/
+      CO_OD_TYPED_RECORD(0x2402, 0, 0x06, 1, CO_OD_RAM.trace[1].maxSubIndex)
+      CO_OD_TYPED_RECORD(0x2402, 1, 0xBE, 4, CO_OD_RAM.trace[1].size)
+      CO_OD_TYPED_RECORD(0x2402, 2, 0xA6, 4, CO_OD_RAM.trace[1].value)
+      CO_OD_TYPED_RECORD(0x2402, 3, 0xBE, 4, CO_OD_RAM.trace[1].min)
+      CO_OD_TYPED_RECORD(0x2402, 4, 0xBE, 4, CO_OD_RAM.trace[1].max)
+      CO_OD_TYPED_RECORD(0x2402, 6, 0xBE, 4, CO_OD_RAM.trace[1].triggerTime)
+
+/*6000*/
+      CO_OD_TYPED_ARRAY(0x6000, 8, 0x76, 1, CO_OD_RAM.readInput8Bit)
+
+/*6200*/
+      CO_OD_TYPED_ARRAY(0x6200, 8, 0x3E, 1, CO_OD_RAM.writeOutput8Bit)
+
+/*6401*/
+      CO_OD_TYPED_ARRAY(0x6401, 12, 0xB6, 2, CO_OD_RAM.readAnalogueInput16Bit)
+
+/*6411*/
+      CO_OD_TYPED_ARRAY(0x6411, 8, 0xBE, 2, CO_OD_RAM.writeAnalogueOutput16Bit)
+
+
+#endif
@@ -143,12 +143,12 @@ static void tmrTask_thread(void){
             bool_t syncWas;
 
             /* Process Sync and read inputs */
-            syncWas = CO_process_SYNC_RPDO(CO, TMR_TASK_INTERVAL);
+            syncWas = CO_process_SYNC_RPDO(CO, TMR_TASK_INTERVAL, NULL);
 
             /* Further I/O or nonblocking application code may go here. */
 
             /* Write outputs */
-            CO_process_TPDO(CO, syncWas, TMR_TASK_INTERVAL);
+            CO_process_TPDO(CO, syncWas, TMR_TASK_INTERVAL, NULL);
 
             /* verify timer overflow */
             if(0) {
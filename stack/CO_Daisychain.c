@@ -183,7 +183,11 @@ void CO_DaisyConsumer_initCallback(
         void               (*pFunctSignal)(void *object))
 {
     if(DaisyConsumer != NULL){
+        /* CAN receive may call pFunctSignal meanwhile, so it is set last */
+        DaisyConsumer->pFunctSignal = NULL;
+        CANrxMemoryBarrier();
         DaisyConsumer->functSignalObject = object;
+        CANrxMemoryBarrier();
         DaisyConsumer->pFunctSignal = pFunctSignal;
     }
 }
@@ -150,6 +150,8 @@ CO_ReturnError_t CO_EM_init(
     em->bufFull                 = 0U;
     em->wrongErrorReport        = 0U;
     em->pFunctSignal            = NULL;
+    em->functSignalObject       = NULL;
+    em->CANdev                  = CANdev;
     emPr->em                    = em;
     emPr->errorRegister         = errorRegister;
     emPr->preDefErr             = preDefErr;
@@ -184,9 +186,15 @@ CO_ReturnError_t CO_EM_init(
 /******************************************************************************/
 void CO_EM_initCallback(
         CO_EM_t                *em,
-        void                  (*pFunctSignal)(void))
+        void                   *object,
+        void                  (*pFunctSignal)(void *object))
 {
     if(em != NULL){
+        /* CAN receive may call pFunctSignal meanwhile, so it is set last */
+        em->pFunctSignal = NULL;
+        CANrxMemoryBarrier();
+        em->functSignalObject = object;
+        CANrxMemoryBarrier();
         em->pFunctSignal = pFunctSignal;
     }
 }
@@ -343,17 +351,17 @@ void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCod
             CO_memcpySwap4(&bufCopy[4], &infoCode);
 
             /* copy data to the buffer, increment writePtr and verify buffer full */
-            CO_LOCK_EMCY();
+            CO_LOCK_EMCY(em->CANdev);
             CO_memcpy(em->bufWritePtr, &bufCopy[0], 8);
             em->bufWritePtr += 8;
 
             if(em->bufWritePtr == em->bufEnd) em->bufWritePtr = em->buf;
             if(em->bufWritePtr == em->bufReadPtr) em->bufFull = 1;
-            CO_UNLOCK_EMCY();
+            CO_UNLOCK_EMCY(em->CANdev);
 
             /* Optional signal to RTOS, which can resume task, which handles CO_EM_process */
             if(em->pFunctSignal != NULL) {
-                em->pFunctSignal();
+                em->pFunctSignal(em->functSignalObject);
             }
         }
     }
@@ -402,17 +410,17 @@ void CO_errorReset(CO_EM_t *em, const uint8_t errorBit, const uint32_t infoCode)
             CO_memcpySwap4(&bufCopy[4], &infoCode);
 
             /* copy data to the buffer, increment writePtr and verify buffer full */
-            CO_LOCK_EMCY();
+            CO_LOCK_EMCY(em->CANdev);
             CO_memcpy(em->bufWritePtr, &bufCopy[0], 8);
             em->bufWritePtr += 8;
 
             if(em->bufWritePtr == em->bufEnd) em->bufWritePtr = em->buf;
             if(em->bufWritePtr == em->bufReadPtr) em->bufFull = 1;
-            CO_UNLOCK_EMCY();
+            CO_UNLOCK_EMCY(em->CANdev);
 
             /* Optional signal to RTOS, which can resume task, which handles CO_EM_process */
             if(em->pFunctSignal != NULL) {
-                em->pFunctSignal();
+                em->pFunctSignal(em->functSignalObject);
             }
         }
     }
@@ -281,7 +281,9 @@ typedef struct{
     uint8_t            *bufReadPtr;     /**< Read pointer in the above buffer */
     uint8_t             bufFull;        /**< True if above buffer is full */
     uint8_t             wrongErrorReport;/**< Error in arguments to CO_errorReport() */
-    void              (*pFunctSignal)(void);/**< From CO_EM_initCallback() or NULL */
+    void              (*pFunctSignal)(void *object);/**< From CO_EM_initCallback() or NULL */
+    void               *functSignalObject;/**< From CO_EM_initCallback() or NULL */
+    CO_CANmodule_t     *CANdev;         /**< From CO_EM_init(), for CO_LOCK_EMCY() */
 }CO_EM_t;
 
 
@@ -401,11 +403,13 @@ CO_ReturnError_t CO_EM_init(
  * which processes mainline CANopen functions.
  *
  * @param em This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL
  * @param pFunctSignal Pointer to the callback function. Not called if NULL.
  */
 void CO_EM_initCallback(
         CO_EM_t               *em,
-        void                  (*pFunctSignal)(void));
+        void                  *object,
+        void                  (*pFunctSignal)(void *object));
 
 
 /**
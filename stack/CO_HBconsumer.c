@@ -55,15 +55,49 @@
  */
 static void CO_HBcons_receive(void *object, const CO_CANrxMsg_t *msg){
     CO_HBconsNode_t *HBconsNode;
+    CO_HBconsumer_t *HBcons;
 
     HBconsNode = (CO_HBconsNode_t*) object; /* this is the correct pointer type of the first argument */
+    HBcons = HBconsNode->HBcons;
 
     /* verify message length */
     if(msg->DLC == 1){
         /* copy data and set 'new message' flag. */
-        HBconsNode->NMTstate = (CO_NMT_internalState_t)msg->data[0];
-        SET_CANrxNew(HBconsNode->CANrxNew);
+        HBconsNode->NMTstateRx = (CO_NMT_internalState_t)msg->data[0];
+#ifdef CO_CANRX_TIMESTAMP
+        HBconsNode->CANrxTimestamp = msg->timestamp;
+#endif
+        /* A queued node is processed after its flag is cleared, so it sees
+         * the data above, even if it is not queued again. */
+        CANrxMemoryBarrier();
+        if(!IS_CANrxNew(HBconsNode->CANrxNew)){
+            HBcons->rxQueue[HBcons->rxQueueIn] = (uint8_t)(HBconsNode - HBcons->monitoredNodes);
+            SET_CANrxNew(HBconsNode->CANrxNew);
+            CANrxMemoryBarrier();
+            HBcons->rxQueueIn++;
+        }
+    }
+}
+
+
+/*
+ * Change NMT state of a node and count monitored nodes, which are not
+ * operational.
+ */
+static void CO_HBcons_setNMTstate(
+        CO_HBconsumer_t        *HBcons,
+        CO_HBconsNode_t        *monitoredNode,
+        CO_NMT_internalState_t  NMTstate)
+{
+    if(monitoredNode->time > 0){
+        if(monitoredNode->NMTstate == CO_NMT_OPERATIONAL && NMTstate != CO_NMT_OPERATIONAL){
+            HBcons->nodesNotOperational++;
+        }
+        else if(monitoredNode->NMTstate != CO_NMT_OPERATIONAL && NMTstate == CO_NMT_OPERATIONAL){
+            HBcons->nodesNotOperational--;
+        }
     }
+    monitoredNode->NMTstate = NMTstate;
 }
 
 
@@ -82,6 +116,14 @@ static void CO_HBcons_monitoredNodeConfig(
     if(idx >= HBcons->numberOfMonitoredNodes) return;
 
     monitoredNode = &HBcons->monitoredNodes[idx];
+    CO_timer_stop(&HBcons->timerWheel, &monitoredNode->timer);
+    /* remove the node from the counters, before it is configured again */
+    if(monitoredNode->time > 0 && monitoredNode->NMTstate != CO_NMT_OPERATIONAL){
+        HBcons->nodesNotOperational--;
+    }
+    if(monitoredNode->HBstate == CO_HBconsumer_TIMEOUT){
+        HBcons->nodesTimeout--;
+    }
     monitoredNode->nodeId = nodeId;
     monitoredNode->time = time;
     monitoredNode->NMTstate = CO_NMT_INITIALIZING;
@@ -91,7 +133,7 @@ static void CO_HBcons_monitoredNodeConfig(
     if(monitoredNode->nodeId && monitoredNode->time){
         COB_ID = monitoredNode->nodeId + CO_CAN_ID_HEARTBEAT;
         monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
-
+        HBcons->nodesNotOperational++;
     }
     else{
         COB_ID = 0;
@@ -173,7 +215,22 @@ CO_ReturnError_t CO_HBconsumer_init(
     HBcons->allMonitoredOperational = 0;
     HBcons->CANdevRx = CANdevRx;
     HBcons->CANdevRxIdxStart = CANdevRxIdxStart;
+    CO_timerWheel_init(&HBcons->timerWheel);
+    HBcons->rxQueueIn = 0;
+    HBcons->rxQueueOut = 0;
+    HBcons->nodesTimeout = 0;
+    HBcons->nodesNotOperational = 0;
+    HBcons->NMTisPreOrOperationalPrev = false;
 
+    for(i=0; i<HBcons->numberOfMonitoredNodes; i++) {
+        CO_HBconsNode_t *monitoredNode = &HBcons->monitoredNodes[i];
+
+        monitoredNode->HBcons = HBcons;
+        monitoredNode->time = 0;
+        monitoredNode->HBstate = CO_HBconsumer_UNCONFIGURED;
+        CLEAR_CANrxNew(monitoredNode->CANrxNew);
+        CO_timer_init(&monitoredNode->timer, (void*)monitoredNode);
+    }
     for(i=0; i<HBcons->numberOfMonitoredNodes; i++) {
         uint8_t nodeId = (HBcons->HBconsTime[i] >> 16U) & 0xFFU;
         uint16_t time = HBcons->HBconsTime[i] & 0xFFFFU;
@@ -282,98 +339,123 @@ void CO_HBconsumer_initCallbackRemoteReset(
 void CO_HBconsumer_process(
         CO_HBconsumer_t        *HBcons,
         bool_t                  NMTisPreOrOperational,
-        uint16_t                timeDifference_ms)
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms)
 {
     uint8_t i;
-    uint8_t emcyHeartbeatTimeoutActive = 0;
+    uint8_t rxQueueIn;
     uint8_t emcyRemoteResetActive = 0;
-    uint8_t AllMonitoredOperationalCopy;
     CO_HBconsNode_t *monitoredNode;
+    CO_timer_t *timer;
 
-    AllMonitoredOperationalCopy = 5;
-    monitoredNode = &HBcons->monitoredNodes[0];
+    /* Advance time first. Timers of heartbeats received meanwhile are
+     * restarted below, which also takes them from the list of expired timers. */
+    if(NMTisPreOrOperational){
+        CO_timerWheel_process(&HBcons->timerWheel, timeDifference_ms);
+    }
+
+    /* Received messages, only the queued nodes */
+    rxQueueIn = HBcons->rxQueueIn;
+    CANrxMemoryBarrier();
+    while(HBcons->rxQueueOut != rxQueueIn){
+        CO_NMT_internalState_t NMTstate;
+
+        i = HBcons->rxQueue[HBcons->rxQueueOut];
+        HBcons->rxQueueOut++;
+        monitoredNode = &HBcons->monitoredNodes[i];
+        CLEAR_CANrxNew(monitoredNode->CANrxNew);
+        CANrxMemoryBarrier();
+        NMTstate = monitoredNode->NMTstateRx;
+
+        if(!NMTisPreOrOperational || monitoredNode->time == 0){
+            /* not monitored now, message is dropped */
+            continue;
+        }
+        if(NMTstate == CO_NMT_INITIALIZING){
+            /* bootup message, call callback */
+            if (monitoredNode->pFunctSignalRemoteReset != NULL) {
+                monitoredNode->pFunctSignalRemoteReset(monitoredNode->nodeId, i,
+                    monitoredNode->functSignalObjectRemoteReset);
+            }
+            CO_HBcons_setNMTstate(HBcons, monitoredNode, CO_NMT_INITIALIZING);
+            if(monitoredNode->HBstate == CO_HBconsumer_ACTIVE){
+                /* there was a bootup message */
+                CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, i);
+                emcyRemoteResetActive = 1;
+
+                monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
+                CO_timer_stop(&HBcons->timerWheel, &monitoredNode->timer);
+            }
+        }
+        else {
+            /* heartbeat message */
+            if (monitoredNode->HBstate!=CO_HBconsumer_ACTIVE &&
+                monitoredNode->pFunctSignalHbStarted!=NULL) {
+                monitoredNode->pFunctSignalHbStarted(monitoredNode->nodeId, i,
+                    monitoredNode->functSignalObjectHbStarted);
+            }
+            if(monitoredNode->HBstate == CO_HBconsumer_TIMEOUT){
+                HBcons->nodesTimeout--;
+            }
+            monitoredNode->HBstate = CO_HBconsumer_ACTIVE;
+            CO_HBcons_setNMTstate(HBcons, monitoredNode, NMTstate);
+            /* restart timer */
+            CO_timer_start(&HBcons->timerWheel, &monitoredNode->timer, monitoredNode->time);
+        }
+    }
 
     if(NMTisPreOrOperational){
-        for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
-            if(monitoredNode->time > 0){/* is node monitored */
-                /* Verify if received message is heartbeat or bootup */
-                if(IS_CANrxNew(monitoredNode->CANrxNew)){
-                    if(monitoredNode->NMTstate == CO_NMT_INITIALIZING){
-                        /* bootup message, call callback */
-                        if (monitoredNode->pFunctSignalRemoteReset != NULL) {
-                            monitoredNode->pFunctSignalRemoteReset(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectRemoteReset);
-                        }
-                    }
-                    else {
-                        /* heartbeat message */
-                        if (monitoredNode->HBstate!=CO_HBconsumer_ACTIVE &&
-                            monitoredNode->pFunctSignalHbStarted!=NULL) {
-                            monitoredNode->pFunctSignalHbStarted(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectHbStarted);
-                        }
-                        monitoredNode->HBstate = CO_HBconsumer_ACTIVE;
-                        monitoredNode->timeoutTimer = 0;  /* reset timer */
-                        timeDifference_ms = 0;
-                    }
-                    CLEAR_CANrxNew(monitoredNode->CANrxNew);
-                }
-
-                /* Verify timeout */
-                if(monitoredNode->timeoutTimer < monitoredNode->time) {
-                    monitoredNode->timeoutTimer += timeDifference_ms;
-                }
-                if(monitoredNode->HBstate!=CO_HBconsumer_UNCONFIGURED &&
-                   monitoredNode->HBstate!=CO_HBconsumer_UNKNOWN) {
-                    if(monitoredNode->timeoutTimer >= monitoredNode->time){
-                        /* timeout expired */
-                        CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, i);
-                        emcyHeartbeatTimeoutActive = 1;
-
-                        monitoredNode->NMTstate = CO_NMT_INITIALIZING;
-                        if (monitoredNode->HBstate!=CO_HBconsumer_TIMEOUT &&
-                            monitoredNode->pFunctSignalTimeout!=NULL) {
-                            monitoredNode->pFunctSignalTimeout(monitoredNode->nodeId, i,
-                                monitoredNode->functSignalObjectTimeout);
-                        }
-                        monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
-                    }
-                    else if(monitoredNode->NMTstate == CO_NMT_INITIALIZING){
-                        /* there was a bootup message */
-                        CO_errorReport(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, CO_EMC_HEARTBEAT, i);
-                        emcyRemoteResetActive = 1;
-
-                        monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
-                    }
-                }
-                if(monitoredNode->NMTstate != CO_NMT_OPERATIONAL) {
-                    AllMonitoredOperationalCopy = 0;
-                }
+        /* Verify timeouts, only expired timers are returned */
+        while((timer = CO_timerWheel_getExpired(&HBcons->timerWheel)) != NULL){
+            monitoredNode = (CO_HBconsNode_t*)timer->object;
+            i = (uint8_t)(monitoredNode - HBcons->monitoredNodes);
+
+            /* timeout expired */
+            CO_errorReport(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, CO_EMC_HEARTBEAT, i);
+            CO_HBcons_setNMTstate(HBcons, monitoredNode, CO_NMT_INITIALIZING);
+            if (monitoredNode->pFunctSignalTimeout!=NULL) {
+                monitoredNode->pFunctSignalTimeout(monitoredNode->nodeId, i,
+                    monitoredNode->functSignalObjectTimeout);
+            }
+            monitoredNode->HBstate = CO_HBconsumer_TIMEOUT;
+            HBcons->nodesTimeout++;
+        }
+
+        /* Lower timerNext_ms to the next heartbeat timeout, if necessary. */
+        if(timerNext_ms != NULL){
+            uint32_t diff = CO_timerWheel_next(&HBcons->timerWheel);
+            if(*timerNext_ms > diff){
+                *timerNext_ms = (uint16_t)diff;
             }
-            monitoredNode++;
         }
     }
-    else{ /* not in (pre)operational state */
+    else if(HBcons->NMTisPreOrOperationalPrev){
+        /* left (pre)operational state, all nodes start again */
+        monitoredNode = &HBcons->monitoredNodes[0];
         for(i=0; i<HBcons->numberOfMonitoredNodes; i++){
-            monitoredNode->NMTstate = CO_NMT_INITIALIZING;
-            CLEAR_CANrxNew(monitoredNode->CANrxNew);
+            CO_timer_stop(&HBcons->timerWheel, &monitoredNode->timer);
+            CO_HBcons_setNMTstate(HBcons, monitoredNode, CO_NMT_INITIALIZING);
             if(monitoredNode->HBstate != CO_HBconsumer_UNCONFIGURED){
                 monitoredNode->HBstate = CO_HBconsumer_UNKNOWN;
             }
             monitoredNode++;
         }
-        AllMonitoredOperationalCopy = 0;
+        HBcons->nodesTimeout = 0;
     }
+    HBcons->NMTisPreOrOperationalPrev = NMTisPreOrOperational;
+
     /* clear emergencies. We only have one emergency index for all
      * monitored nodes! */
-    if ( ! emcyHeartbeatTimeoutActive) {
+    if (HBcons->nodesTimeout == 0) {
         CO_errorReset(HBcons->em, CO_EM_HEARTBEAT_CONSUMER, 0);
     }
     if ( ! emcyRemoteResetActive) {
         CO_errorReset(HBcons->em, CO_EM_HB_CONSUMER_REMOTE_RESET, 0);
     }
 
-    HBcons->allMonitoredOperational = AllMonitoredOperationalCopy;
+    /* True, if all monitored nodes are operational or no node is monitored */
+    HBcons->allMonitoredOperational =
+        (NMTisPreOrOperational && HBcons->nodesNotOperational == 0) ? 5 : 0;
 }
 
 
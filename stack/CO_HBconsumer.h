@@ -67,6 +67,10 @@ extern "C" {
  * Heartbeat set up is done by writing to the OD registers 0x1016 or by using
  * the function _CO_HBconsumer_initEntry()_
  *
+ * Timeouts are kept in a @ref CO_timerWheel and CAN reception queues the
+ * index of the node, so processing time depends on the number of received
+ * and expiring heartbeats and not on the number of monitored nodes.
+ *
  * @see  @ref CO_NMT_Heartbeat
  */
 
@@ -81,16 +85,25 @@ typedef enum {
 } CO_HBconsumer_state_t;
 
 
+struct CO_HBconsumer;
+
 /**
  * One monitored node inside CO_HBconsumer_t.
  */
 typedef struct{
+    struct CO_HBconsumer   *HBcons;       /**< From CO_HBconsumer_init() */
     uint8_t                 nodeId;       /**< Node Id of the monitored node */
     CO_NMT_internalState_t  NMTstate;     /**< Of the remote node (Heartbeat payload) */
+    /** Heartbeat payload of the last received message, copied to NMTstate
+        by CO_HBconsumer_process() */
+    volatile CO_NMT_internalState_t NMTstateRx;
     CO_HBconsumer_state_t   HBstate;      /**< Current heartbeat state */
-    uint16_t                timeoutTimer; /**< Time since last heartbeat received */
+    CO_timer_t              timer;        /**< Heartbeat timeout, running while node is active */
     uint16_t                time;         /**< Consumer heartbeat time from OD */
     volatile void          *CANrxNew;     /**< Indication if new Heartbeat message received from the CAN bus */
+#ifdef CO_CANRX_TIMESTAMP
+    struct timespec         CANrxTimestamp; /**< Reception time of last heartbeat */
+#endif
     /** Callback for heartbeat state change to active event */
     void                  (*pFunctSignalHbStarted)(uint8_t nodeId, uint8_t idx, void *object); /**< From CO_HBconsumer_initTimeoutCallback() or NULL */
     void                   *functSignalObjectHbStarted;/**< Pointer to object */
@@ -109,7 +122,7 @@ typedef struct{
  * Object is initilaized by CO_HBconsumer_init(). It contains an array of
  * CO_HBconsNode_t objects.
  */
-typedef struct{
+typedef struct CO_HBconsumer{
     CO_EM_t            *em;               /**< From CO_HBconsumer_init() */
     const uint32_t     *HBconsTime;       /**< From CO_HBconsumer_init() */
     CO_HBconsNode_t    *monitoredNodes;   /**< From CO_HBconsumer_init() */
@@ -119,6 +132,18 @@ typedef struct{
     uint8_t             allMonitoredOperational;
     CO_CANmodule_t     *CANdevRx;         /**< From CO_HBconsumer_init() */
     uint16_t            CANdevRxIdxStart; /**< From CO_HBconsumer_init() */
+    /** Heartbeat timeouts of all monitored nodes in [milliseconds] */
+    CO_timerWheel_t     timerWheel;
+    /** Indexes of nodes with a received message not yet processed. A node
+        is queued only while its CANrxNew flag is clear, so there are never
+        more than numberOfMonitoredNodes entries and the uint8_t indexes
+        below may simply wrap around. */
+    uint8_t             rxQueue[256];
+    volatile uint8_t    rxQueueIn;        /**< Written by CAN receive only */
+    uint8_t             rxQueueOut;       /**< Written by CO_HBconsumer_process() only */
+    uint8_t             nodesTimeout;     /**< Monitored nodes in CO_HBconsumer_TIMEOUT */
+    uint8_t             nodesNotOperational; /**< Monitored nodes not NMT operational */
+    bool_t              NMTisPreOrOperationalPrev; /**< From previous CO_HBconsumer_process() */
 }CO_HBconsumer_t;
 
 
@@ -229,16 +254,24 @@ void CO_HBconsumer_initCallbackRemoteReset(
 /**
  * Process Heartbeat consumer object.
  *
- * Function must be called cyclically.
+ * Function must be called cyclically. Received heartbeats restart their
+ * timers before expired timers are evaluated, so a heartbeat received in the
+ * same cycle, in which its time runs out, is not a timeout.
+ *
+ * The argument timerNext_ms was added together with the timer wheel. Callers
+ * of the former function with three arguments pass NULL, if they don't need
+ * the time until the next heartbeat timeout.
  *
  * @param HBcons This object.
  * @param NMTisPreOrOperational True if this node is NMT_PRE_OPERATIONAL or NMT_OPERATIONAL.
  * @param timeDifference_ms Time difference from previous function call in [milliseconds].
+ * @param timerNext_ms Return value - info to OS - see CO_process(). Can be NULL.
  */
 void CO_HBconsumer_process(
         CO_HBconsumer_t        *HBcons,
         bool_t                  NMTisPreOrOperational,
-        uint16_t                timeDifference_ms);
+        uint16_t                timeDifference_ms,
+        uint16_t               *timerNext_ms);
 
 /**
  * Get the heartbeat producer object index by node ID
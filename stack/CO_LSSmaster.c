@@ -211,7 +211,11 @@ void CO_LSSmaster_initCallback(
         void                  (*pFunctSignal)(void *object))
 {
     if(LSSmaster != NULL){
+        /* CAN receive may call pFunctSignal meanwhile, so it is set last */
+        LSSmaster->pFunctSignal = NULL;
+        CANrxMemoryBarrier();
         LSSmaster->functSignalObject = object;
+        CANrxMemoryBarrier();
         LSSmaster->pFunctSignal = pFunctSignal;
     }
 }
@@ -87,7 +87,7 @@ static void CO_NMT_receive(void *object, const CO_CANrxMsg_t *msg){
         }
 
         if(NMT->pFunctNMT!=NULL && currentOperatingState!=NMT->operatingState){
-            NMT->pFunctNMT(NMT->operatingState);
+            NMT->pFunctNMT(NMT->functNMTObject, NMT->operatingState);
         }
     }
 }
@@ -129,6 +129,7 @@ CO_ReturnError_t CO_NMT_init(
     NMT->HBproducerTimer        = 0xFFFF;
     NMT->emPr                   = emPr;
     NMT->pFunctNMT              = NULL;
+    NMT->functNMTObject         = NULL;
 
     /* configure NMT CAN reception */
     CO_CANrxBufferInit(
@@ -157,12 +158,18 @@ CO_ReturnError_t CO_NMT_init(
 /******************************************************************************/
 void CO_NMT_initCallback(
         CO_NMT_t               *NMT,
-        void                  (*pFunctNMT)(CO_NMT_internalState_t state))
+        void                   *object,
+        void                  (*pFunctNMT)(void *object, CO_NMT_internalState_t state))
 {
     if(NMT != NULL){
+        /* CAN receive may call pFunctNMT meanwhile, so it is set last */
+        NMT->pFunctNMT = NULL;
+        CANrxMemoryBarrier();
+        NMT->functNMTObject = object;
+        CANrxMemoryBarrier();
         NMT->pFunctNMT = pFunctNMT;
-        if(NMT->pFunctNMT != NULL){
-            NMT->pFunctNMT(NMT->operatingState);
+        if(pFunctNMT != NULL){
+            pFunctNMT(object, NMT->operatingState);
         }
     }
 }
@@ -337,7 +344,7 @@ CO_NMT_reset_cmd_t CO_NMT_process(
     }
 
     if(NMT->pFunctNMT!=NULL && currentOperatingState!=NMT->operatingState){
-        NMT->pFunctNMT(NMT->operatingState);
+        NMT->pFunctNMT(NMT->functNMTObject, NMT->operatingState);
     }
 
     return NMT->resetCommand;
@@ -165,7 +165,8 @@ typedef struct{
     uint16_t            firstHBTime;    /**< From CO_NMT_init() */
     CO_EMpr_t          *emPr;           /**< From CO_NMT_init() */
     CO_CANmodule_t     *HB_CANdev;      /**< From CO_NMT_init() */
-    void              (*pFunctNMT)(CO_NMT_internalState_t state); /**< From CO_NMT_initCallback() or NULL */
+    void              (*pFunctNMT)(void *object, CO_NMT_internalState_t state); /**< From CO_NMT_initCallback() or NULL */
+    void               *functNMTObject; /**< From CO_NMT_initCallback() or NULL */
     CO_CANtx_t         *HB_TXbuff;      /**< CAN transmit buffer */
 }CO_NMT_t;
 
@@ -214,11 +215,13 @@ CO_ReturnError_t CO_NMT_init(
  * function context. Depending on the driver, this might be inside an interrupt!
  *
  * @param NMT This object.
+ * @param object Pointer to object, which will be passed to pFunctNMT(). Can be NULL
  * @param pFunctNMT Pointer to the callback function. Not called if NULL.
  */
 void CO_NMT_initCallback(
         CO_NMT_t               *NMT,
-        void                  (*pFunctNMT)(CO_NMT_internalState_t state));
+        void                   *object,
+        void                  (*pFunctNMT)(void *object, CO_NMT_internalState_t state));
 
 
 /**
@@ -89,6 +89,9 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
             RPDO->CANrxData[1][5] = msg->data[5];
             RPDO->CANrxData[1][6] = msg->data[6];
             RPDO->CANrxData[1][7] = msg->data[7];
+#ifdef CO_CANRX_TIMESTAMP
+            RPDO->CANrxTimestamp[1] = msg->timestamp;
+#endif
 
             SET_CANrxNew(RPDO->CANrxNew[1]);
         }
@@ -102,6 +105,9 @@ static void CO_PDO_receive(void *object, const CO_CANrxMsg_t *msg){
             RPDO->CANrxData[0][5] = msg->data[5];
             RPDO->CANrxData[0][6] = msg->data[6];
             RPDO->CANrxData[0][7] = msg->data[7];
+#ifdef CO_CANRX_TIMESTAMP
+            RPDO->CANrxTimestamp[0] = msg->timestamp;
+#endif
 
             SET_CANrxNew(RPDO->CANrxNew[0]);
         }
@@ -210,6 +216,7 @@ static void CO_TPDOconfigCom(CO_TPDO_t* TPDO, uint32_t COB_IDUsedByTPDO, uint8_t
  * @param map PDO mapping parameter.
  * @param R_T 0 for RPDO map, 1 for TPDO map.
  * @param ppData Pointer to returning parameter: pointer to data of mapped variable.
+ * NULL for a dummy entry in RPDO map, caller must provide a sink for the data.
  * @param pLength Pointer to returning parameter: *add* length of mapped variable.
  * @param pSendIfCOSFlags Pointer to returning parameter: sendIfCOSFlags variable.
  * @param pIsMultibyteVar Pointer to returning parameter: true for multibyte variable.
@@ -247,8 +254,8 @@ static uint32_t CO_PDOfindMap(
 
     /* is there a reference to dummy entries */
     if(index <=7 && subIndex == 0){
-        static uint32_t dummyTX = 0;
-        static uint32_t dummyRX;
+        /* read only, so it can be shared by all CANopen instances */
+        static const uint32_t dummyTX = 0;
         uint8_t dummySize = 4;
 
         if(index<2) dummySize = 0;
@@ -259,7 +266,7 @@ static uint32_t CO_PDOfindMap(
         if(dummySize < dataLen) return CO_SDO_AB_NO_MAP;   /* Object cannot be mapped to the PDO. */
 
         /* Data and ODE pointer */
-        if(R_T == 0) *ppData = (uint8_t*) &dummyRX;
+        if(R_T == 0) *ppData = NULL;
         else         *ppData = (uint8_t*) &dummyTX;
 
         return 0;
@@ -311,8 +318,8 @@ static uint32_t CO_PDOfindMap(
  *
  * Function is called from communication reset or when parameter changes.
  *
- * Function configures following variables from CO_RPDO_t: _dataLength_ and
- * _mapPointer_.
+ * Function configures following variables from CO_RPDO_t: _dataLength_,
+ * _mapPointer_ and _dirtyPosition_.
  *
  * @param RPDO RPDO object.
  * @param noOfMappedObjects Number of mapped object (from OD).
@@ -325,6 +332,8 @@ static uint32_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedObjects){
     uint32_t ret = 0;
     const uint32_t* pMap = &RPDO->RPDOMapPar->mappedObject1;
 
+    RPDO->dirtyCount = 0;
+
     for(i=noOfMappedObjects; i>0; i--){
         int16_t j;
         uint8_t* pData;
@@ -344,9 +353,19 @@ static uint32_t CO_RPDOconfigMap(CO_RPDO_t* RPDO, uint8_t noOfMappedObjects){
                 &MBvar);
         if(ret){
             length = 0;
+            RPDO->dirtyCount = 0;
             CO_errorReport(RPDO->em, CO_EM_PDO_WRONG_MAPPING, CO_EMC_PROTOCOL_ERROR, map);
             break;
         }
+        if(pData == NULL){
+            /* dummy entry, received data is discarded */
+            pData = (uint8_t*) &RPDO->dummy;
+        }
+        else{
+            uint16_t entryNo = CO_OD_find(RPDO->SDO, (uint16_t)(map>>16));
+            RPDO->dirtyPosition[RPDO->dirtyCount++] =
+                CO_OD_getPosition(RPDO->SDO, entryNo, (uint8_t)(map>>8));
+        }
 
         /* write PDO data pointers */
 #ifdef CO_BIG_ENDIAN
@@ -1020,6 +1039,13 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas){
             }
             update = true;
         }
+        if(update==true){
+            int16_t i;
+
+            for(i=0; i<RPDO->dirtyCount; i++){
+                CO_OD_markDirty(RPDO->SDO, RPDO->dirtyPosition[i]);
+            }
+        }
 #ifdef RPDO_CALLS_EXTENSION
         if(update==true && RPDO->SDO->ODExtensions){
             int16_t i;
@@ -1058,7 +1084,8 @@ CO_ReturnError_t CO_TPDO_process(
         CO_TPDO_t              *TPDO,
         CO_SYNC_t              *SYNC,
         bool_t                  syncWas,
-        uint32_t                timeDifference_us)
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us)
 {
     CO_ReturnError_t retval = CO_ERROR_WRONG_NMT_STATE;
 
@@ -1119,5 +1146,22 @@ CO_ReturnError_t CO_TPDO_process(
     TPDO->inhibitTimer = (TPDO->inhibitTimer > timeDifference_us) ? (TPDO->inhibitTimer - timeDifference_us) : 0;
     TPDO->eventTimer = (TPDO->eventTimer > timeDifference_us) ? (TPDO->eventTimer - timeDifference_us) : 0;
 
+    /* Calculate, when the event driven PDO is due next and lower timerNext_us
+     * if necessary. Pending request waits for inhibit time only. */
+    if(timerNext_us != NULL && TPDO->valid && *TPDO->operatingState == CO_NMT_OPERATIONAL &&
+       TPDO->TPDOCommPar->transmissionType >= 253){
+        uint32_t diff = UINT32_MAX;
+
+        if(TPDO->sendRequest){
+            diff = TPDO->inhibitTimer;
+        }
+        else if(TPDO->TPDOCommPar->eventTimer){
+            diff = (TPDO->eventTimer > TPDO->inhibitTimer) ? TPDO->eventTimer : TPDO->inhibitTimer;
+        }
+        if(*timerNext_us > diff){
+            *timerNext_us = diff;
+        }
+    }
+
     return retval;
 }
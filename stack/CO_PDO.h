@@ -233,6 +233,13 @@ struct CO_RPDO{
     uint8_t             dataLength;
     /** Pointers to 8 data objects, where PDO will be copied */
     uint8_t            *mapPointer[8];
+    /** Destination for data mapped to dummy entries */
+    uint32_t            dummy;
+    /** Positions of the mapped objects for CO_OD_markDirty(), without dummy
+    entries. Calculated from mapping */
+    uint16_t            dirtyPosition[8];
+    /** Number of valid entries in dirtyPosition */
+    uint8_t             dirtyCount;
 #ifdef RPDO_MANUAL_CONTROL_EXTENSION
     /** Callback from #CO_RPDO_takeManualControl() */
     void              (*pFuncManualControl)(void *object, const CO_RPDO_t *rpdo, const CO_CANrxMsg_t *message);
@@ -242,6 +249,10 @@ struct CO_RPDO{
     volatile void      *CANrxNew[2];
     /** 8 data bytes of the received message. */
     uint8_t             CANrxData[2][8];
+#ifdef CO_CANRX_TIMESTAMP
+    /** Reception time of _CANrxData_, valid if _CANrxNew_ is set */
+    struct timespec     CANrxTimestamp[2];
+#endif
     CO_CANmodule_t     *CANdevRx;       /**< From CO_RPDO_init() */
     uint16_t            CANdevRxIdx;    /**< From CO_RPDO_init() */
 };
@@ -500,13 +511,16 @@ void CO_RPDO_process(CO_RPDO_t *RPDO, bool_t syncWas);
  * @param SYNC SYNC object. Ignored if NULL.
  * @param syncWas True, if CANopen SYNC message was just received or transmitted.
  * @param timeDifference_us Time difference from previous function call in [microseconds].
+ * @param timerNext_us Return value - info to OS - time until an event driven
+ * TPDO is due or its inhibit time ends. Lowered if necessary, ignored if NULL.
  * @return Same as CO_CANsend() or #CO_ERROR_WRONG_NMT_STATE if not in NMT Operational
  */
 CO_ReturnError_t CO_TPDO_process(
         CO_TPDO_t              *TPDO,
         CO_SYNC_t              *SYNC,
         bool_t                  syncWas,
-        uint32_t                timeDifference_us);
+        uint32_t                timeDifference_us,
+        uint32_t               *timerNext_us);
 
 #ifdef __cplusplus
 }
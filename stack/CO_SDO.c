@@ -258,7 +258,7 @@ static void CO_SDO_receive(void *object, const CO_CANrxMsg_t *msg){
 
         /* Optional signal to RTOS, which can resume task, which handles SDO server. */
         if(IS_CANrxNew(SDO->CANrxNew) && SDO->pFunctSignal != NULL) {
-            SDO->pFunctSignal();
+            SDO->pFunctSignal(SDO->functSignalObject);
         }
     }
 }
@@ -288,6 +288,165 @@ static CO_SDO_abortCode_t CO_ODF_1200(CO_ODF_arg_t *ODF_arg){
 }
 
 
+/*
+ * OD index: hash and displace. Each OD index falls into a bucket. For each
+ * bucket a displacement is searched, so that all its OD indexes map to free
+ * slots. Lookup is then one hash calculation and one comparison.
+ */
+#define CO_OD_INDEX_EMPTY           0xFFFFU
+#define CO_OD_INDEX_UNPLACED        0x8000U     /* bucket not placed, lower bits are count */
+#define CO_OD_INDEX_BUCKET_MAX      16U
+
+static uint32_t CO_OD_indexHash(uint32_t x){
+    x ^= x >> 16;
+    x *= 0x85EBCA6BUL;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35UL;
+    x ^= x >> 16;
+    return x;
+}
+
+static uint16_t CO_OD_indexBucket(uint16_t index, uint16_t bucketMask){
+    return (uint16_t)CO_OD_indexHash(index) & bucketMask;
+}
+
+static uint16_t CO_OD_indexSlot(uint16_t index, uint16_t displacement, uint16_t mask){
+    return (uint16_t)CO_OD_indexHash((((uint32_t)displacement << 16) | index) ^ 0x5BD1E995UL) & mask;
+}
+
+/*
+ * Build OD index in buffer. Returns false if buffer is too small or no
+ * displacement was found, then CO_OD_find() uses binary search.
+ */
+static bool_t CO_OD_indexBuild(CO_SDO_t *SDO, uint16_t ODIndex[], uint16_t ODIndexSize){
+    uint16_t slotCount = 1U;
+    uint16_t bucketCount;
+    uint16_t bucketMask;
+    uint16_t maxCount = 0U;
+    uint16_t count;
+    uint16_t i;
+
+    if(ODIndex == NULL || SDO->ODSize == 0U){
+        return false;
+    }
+    /* largest power of two of slots, which fits with its buckets */
+    while(slotCount < 0x8000U && (uint32_t)slotCount * 2U + (slotCount + 1U) / 2U <= ODIndexSize){
+        slotCount *= 2U;
+    }
+    if(slotCount < SDO->ODSize){
+        return false;
+    }
+    bucketCount = (slotCount >= 4U) ? (slotCount / 4U) : 1U;
+    bucketMask = bucketCount - 1U;
+    SDO->ODIndexSlots = &ODIndex[0];
+    SDO->ODIndexDisplacement = &ODIndex[slotCount];
+    SDO->ODIndexMask = slotCount - 1U;
+
+    /* count OD entries per bucket */
+    for(i=0U; i<slotCount; i++){
+        SDO->ODIndexSlots[i] = CO_OD_INDEX_EMPTY;
+    }
+    for(i=0U; i<bucketCount; i++){
+        SDO->ODIndexDisplacement[i] = CO_OD_INDEX_UNPLACED;
+    }
+    for(i=0U; i<SDO->ODSize; i++){
+        uint16_t *d = &SDO->ODIndexDisplacement[CO_OD_indexBucket(SDO->OD[i].index, bucketMask)];
+
+        (*d)++;
+        if((*d & ~CO_OD_INDEX_UNPLACED) > maxCount){
+            maxCount = *d & ~CO_OD_INDEX_UNPLACED;
+        }
+    }
+    if(maxCount > CO_OD_INDEX_BUCKET_MAX){
+        return false;
+    }
+
+    /* place largest buckets first */
+    for(count=maxCount; count>0U; count--){
+        uint16_t b;
+
+        for(b=0U; b<bucketCount; b++){
+            uint16_t entries[CO_OD_INDEX_BUCKET_MAX];
+            uint16_t slots[CO_OD_INDEX_BUCKET_MAX];
+            uint16_t n = 0U;
+            uint16_t d;
+
+            if(SDO->ODIndexDisplacement[b] != (CO_OD_INDEX_UNPLACED | count)){
+                continue;
+            }
+            for(i=0U; i<SDO->ODSize && n<count; i++){
+                if(CO_OD_indexBucket(SDO->OD[i].index, bucketMask) == b){
+                    entries[n++] = i;
+                }
+            }
+            for(d=0U; d<CO_OD_INDEX_UNPLACED; d++){
+                uint16_t j, k;
+
+                for(j=0U; j<n; j++){
+                    slots[j] = CO_OD_indexSlot(SDO->OD[entries[j]].index, d, SDO->ODIndexMask);
+                    if(SDO->ODIndexSlots[slots[j]] != CO_OD_INDEX_EMPTY){
+                        break;
+                    }
+                    for(k=0U; k<j; k++){
+                        if(slots[k] == slots[j]){
+                            break;
+                        }
+                    }
+                    if(k < j){
+                        break;
+                    }
+                }
+                if(j == n){
+                    break;
+                }
+            }
+            if(d == CO_OD_INDEX_UNPLACED){
+                return false;
+            }
+            for(i=0U; i<n; i++){
+                SDO->ODIndexSlots[slots[i]] = entries[i];
+            }
+            SDO->ODIndexDisplacement[b] = d;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+ * Build table of OD descriptors in buffer. Returns false if buffer is too
+ * small, then OD entries are evaluated on every access. Must be called after
+ * ODExtensions are initialized, CO_OD_configure() fills in the flags.
+ */
+static bool_t CO_OD_descriptorsBuild(CO_SDO_t *SDO, CO_OD_descriptor_t ODDescriptors[], uint16_t ODDescriptorsSize){
+    uint16_t i, count;
+    uint16_t n = 0U;
+
+    SDO->ODDescriptors = NULL;
+    count = CO_OD_getDescriptorCount(SDO->OD, SDO->ODSize);
+    if(ODDescriptors == NULL || count == 0xFFFFU || count > ODDescriptorsSize){
+        return false;
+    }
+
+    for(i=0U; i<SDO->ODSize; i++){
+        uint16_t subIndex;
+
+        for(subIndex=0U; subIndex<=SDO->OD[i].maxSubIndex; subIndex++){
+            CO_OD_descriptor_t *desc = &ODDescriptors[n++];
+
+            desc->pData = CO_OD_getDataPointer(SDO, i, (uint8_t)subIndex);
+            desc->pFlags = NULL;
+            desc->length = CO_OD_getLength(SDO, i, (uint8_t)subIndex);
+            desc->attribute = CO_OD_getAttribute(SDO, i, (uint8_t)subIndex);
+        }
+    }
+    SDO->ODDescriptors = ODDescriptors;
+
+    return true;
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_SDO_init(
         CO_SDO_t               *SDO,
@@ -298,6 +457,10 @@ CO_ReturnError_t CO_SDO_init(
         const CO_OD_entry_t     OD[],
         uint16_t                ODSize,
         CO_OD_extension_t      *ODExtensions,
+        uint16_t                ODIndex[],
+        uint16_t                ODIndexSize,
+        CO_OD_descriptor_t      ODDescriptors[],
+        uint16_t                ODDescriptorsSize,
         uint8_t                 nodeId,
         CO_CANmodule_t         *CANdevRx,
         uint16_t                CANdevRxIdx,
@@ -312,18 +475,33 @@ CO_ReturnError_t CO_SDO_init(
     /* configure own object dictionary */
     if(parentSDO == NULL){
         uint16_t i;
+        /* OD index depends only on the OD, keep it on communication reset */
+        bool_t indexValid = SDO->ODIndexSlots != NULL && SDO->ODIndexSlots == ODIndex
+                         && SDO->OD == OD && SDO->ODSize == ODSize;
+        uint16_t position = 0U;
 
         SDO->ownOD = true;
         SDO->OD = OD;
         SDO->ODSize = ODSize;
         SDO->ODExtensions = ODExtensions;
 
-        /* clear pointers in ODExtensions */
+        /* clear pointers in ODExtensions, positions in flattened OD */
         for(i=0U; i<ODSize; i++){
             SDO->ODExtensions[i].pODFunc = NULL;
             SDO->ODExtensions[i].object = NULL;
             SDO->ODExtensions[i].flags = NULL;
+            SDO->ODExtensions[i].descriptor = position;
+            position += OD[i].maxSubIndex + 1U;
         }
+        SDO->ODDirty = &SDO->ODDirtyList;
+
+        /* build OD index, first use is by CO_OD_configure() below */
+        if(!indexValid && !CO_OD_indexBuild(SDO, ODIndex, ODIndexSize)){
+            SDO->ODIndexSlots = NULL;
+        }
+
+        /* flatten OD, flags of descriptors are cleared with the extensions */
+        CO_OD_descriptorsBuild(SDO, ODDescriptors, ODDescriptorsSize);
     }
     /* copy object dictionary from parent */
     else{
@@ -331,6 +509,11 @@ CO_ReturnError_t CO_SDO_init(
         SDO->OD = parentSDO->OD;
         SDO->ODSize = parentSDO->ODSize;
         SDO->ODExtensions = parentSDO->ODExtensions;
+        SDO->ODIndexSlots = parentSDO->ODIndexSlots;
+        SDO->ODIndexDisplacement = parentSDO->ODIndexDisplacement;
+        SDO->ODIndexMask = parentSDO->ODIndexMask;
+        SDO->ODDescriptors = parentSDO->ODDescriptors;
+        SDO->ODDirty = parentSDO->ODDirty;
     }
 
     /* Configure object variables */
@@ -338,6 +521,7 @@ CO_ReturnError_t CO_SDO_init(
     SDO->state = CO_SDO_ST_IDLE;
     CLEAR_CANrxNew(SDO->CANrxNew);
     SDO->pFunctSignal = NULL;
+    SDO->functSignalObject = NULL;
 
 
     /* Configure Object dictionary entry at index 0x1200 */
@@ -377,9 +561,15 @@ CO_ReturnError_t CO_SDO_init(
 /******************************************************************************/
 void CO_SDO_initCallback(
         CO_SDO_t               *SDO,
-        void                  (*pFunctSignal)(void))
+        void                   *object,
+        void                  (*pFunctSignal)(void *object))
 {
     if(SDO != NULL){
+        /* CAN receive may call pFunctSignal meanwhile, so it is set last */
+        SDO->pFunctSignal = NULL;
+        CANrxMemoryBarrier();
+        SDO->functSignalObject = object;
+        CANrxMemoryBarrier();
         SDO->pFunctSignal = pFunctSignal;
     }
 }
@@ -413,12 +603,32 @@ void CO_OD_configure(
         else{
             ext->flags = NULL;
         }
+
+        if(SDO->ODDescriptors != NULL){
+            CO_OD_descriptor_t *desc = &SDO->ODDescriptors[ext->descriptor];
+            uint16_t i;
+
+            for(i=0U; i<=maxSubIndex; i++){
+                desc[i].pFlags = (ext->flags != NULL) ? &ext->flags[i] : NULL;
+            }
+        }
     }
 }
 
 
 /******************************************************************************/
 uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
+    if(SDO->ODIndexSlots != NULL){
+        uint16_t bucket = CO_OD_indexBucket(index, SDO->ODIndexMask >> 2);
+        uint16_t entryNo = SDO->ODIndexSlots[
+                CO_OD_indexSlot(index, SDO->ODIndexDisplacement[bucket], SDO->ODIndexMask)];
+
+        if(entryNo != CO_OD_INDEX_EMPTY && SDO->OD[entryNo].index == index){
+            return entryNo;
+        }
+        return 0xFFFFU;  /* object does not exist in OD */
+    }
+
     /* Fast search in ordered Object Dictionary. If indexes are mixed, this won't work. */
     /* If Object Dictionary has up to 2^N entries, then N is max number of loop passes. */
     uint16_t cur, min, max;
@@ -456,11 +666,17 @@ uint16_t CO_OD_find(CO_SDO_t *SDO, uint16_t index){
 /******************************************************************************/
 uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
     const CO_OD_entry_t* object = &SDO->OD[entryNo];
+    const CO_OD_descriptor_t* desc;
 
     if(entryNo == 0xFFFFU){
         return 0U;
     }
 
+    desc = CO_OD_getDescriptor(SDO, entryNo, subIndex);
+    if(desc != NULL){
+        return desc->length;
+    }
+
     if(object->maxSubIndex == 0U){    /* Object type is Var */
         if(object->pData == 0){ /* data type is domain */
             return CO_SDO_BUFFER_SIZE;
@@ -496,11 +712,17 @@ uint16_t CO_OD_getLength(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
 /******************************************************************************/
 uint16_t CO_OD_getAttribute(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
     const CO_OD_entry_t* object = &SDO->OD[entryNo];
+    const CO_OD_descriptor_t* desc;
 
     if(entryNo == 0xFFFFU){
         return 0U;
     }
 
+    desc = CO_OD_getDescriptor(SDO, entryNo, subIndex);
+    if(desc != NULL){
+        return desc->attribute;
+    }
+
     if(object->maxSubIndex == 0U){   /* Object type is Var */
         return object->attribute;
     }
@@ -530,11 +752,17 @@ uint16_t CO_OD_getAttribute(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
 /******************************************************************************/
 void* CO_OD_getDataPointer(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
     const CO_OD_entry_t* object = &SDO->OD[entryNo];
+    const CO_OD_descriptor_t* desc;
 
     if(entryNo == 0xFFFFU){
         return 0;
     }
 
+    desc = CO_OD_getDescriptor(SDO, entryNo, subIndex);
+    if(desc != NULL){
+        return desc->pData;
+    }
+
     if(object->maxSubIndex == 0U){   /* Object type is Var */
         return object->pData;
     }
@@ -570,13 +798,163 @@ uint8_t* CO_OD_getFlagsPointer(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex
     }
 
     ext = &SDO->ODExtensions[entryNo];
+    if(ext->flags == NULL){
+        return 0;
+    }
 
     return &ext->flags[subIndex];
 }
 
 
+/******************************************************************************/
+uint16_t CO_OD_getDescriptorCount(const CO_OD_entry_t OD[], uint16_t ODSize){
+    uint32_t count = 0U;
+    uint16_t i;
+
+    for(i=0U; i<ODSize; i++){
+        count += OD[i].maxSubIndex + 1U;
+    }
+
+    return (count > 0xFFFFU) ? 0xFFFFU : (uint16_t)count;
+}
+
+
+/******************************************************************************/
+const CO_OD_descriptor_t *CO_OD_getDescriptor(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
+    if((entryNo == 0xFFFFU) || (SDO->ODDescriptors == NULL)
+            || (subIndex > SDO->OD[entryNo].maxSubIndex)){
+        return 0;
+    }
+
+    return &SDO->ODDescriptors[SDO->ODExtensions[entryNo].descriptor + subIndex];
+}
+
+
+/******************************************************************************/
+uint16_t CO_OD_getPosition(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex){
+    if((entryNo == 0xFFFFU) || (SDO->ODExtensions == NULL)
+            || (subIndex > SDO->OD[entryNo].maxSubIndex)){
+        return 0xFFFFU;
+    }
+
+    return SDO->ODExtensions[entryNo].descriptor + subIndex;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_OD_dirtyRegister(
+        CO_SDO_t               *SDO,
+        CO_OD_dirty_t          *dirty,
+        uint32_t                bits[],
+        const uint32_t          mask[],
+        uint16_t                words)
+{
+    uint16_t i;
+
+    if(SDO == NULL || SDO->ODDirty == NULL || dirty == NULL || bits == NULL
+            || words < CO_OD_DIRTY_WORDS(CO_OD_getDescriptorCount(SDO->OD, SDO->ODSize))){
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    for(i=0U; i<words; i++){
+        bits[i] = 0U;
+    }
+    dirty->bits = bits;
+    dirty->mask = mask;
+    dirty->words = words;
+    dirty->next = *SDO->ODDirty;
+    *SDO->ODDirty = dirty;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_OD_dirtyUnregister(CO_SDO_t *SDO, CO_OD_dirty_t *dirty){
+    CO_OD_dirty_t **prev;
+
+    if(SDO == NULL || SDO->ODDirty == NULL){
+        return;
+    }
+
+    for(prev = SDO->ODDirty; *prev != NULL; prev = &(*prev)->next){
+        if(*prev == dirty){
+            *prev = dirty->next;
+            dirty->next = NULL;
+            break;
+        }
+    }
+}
+
+
+/******************************************************************************/
+uint16_t CO_OD_dirtyMaskRange(
+        CO_SDO_t               *SDO,
+        uint32_t                mask[],
+        uint16_t                words,
+        const void             *start,
+        uint32_t                size)
+{
+    const uint8_t *first = (const uint8_t*)start;
+    uint16_t entryNo;
+    uint16_t count = 0U;
+
+    for(entryNo=0U; entryNo<SDO->ODSize; entryNo++){
+        uint16_t subIndex;
+
+        for(subIndex=0U; subIndex<=SDO->OD[entryNo].maxSubIndex; subIndex++){
+            const uint8_t *p = (const uint8_t*)CO_OD_getDataPointer(SDO, entryNo, (uint8_t)subIndex);
+            uint16_t position = CO_OD_getPosition(SDO, entryNo, (uint8_t)subIndex);
+
+            if(p != NULL && p >= first && p < (first + size) && (position / 32U) < words){
+                mask[position / 32U] |= 1UL << (position % 32U);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+/******************************************************************************/
+bool_t CO_OD_markDirty(CO_SDO_t *SDO, uint16_t position){
+    CO_OD_dirty_t *dirty;
+    uint16_t word = position / 32U;
+    uint32_t bit = 1UL << (position % 32U);
+    bool_t marked = false;
+
+    if(SDO->ODDirty == NULL || position == 0xFFFFU){
+        return false;
+    }
+
+    for(dirty = *SDO->ODDirty; dirty != NULL; dirty = dirty->next){
+        if(word < dirty->words && (dirty->mask == NULL || (dirty->mask[word] & bit) != 0U)){
+            dirty->bits[word] |= bit;
+            marked = true;
+        }
+    }
+    return marked;
+}
+
+
+/******************************************************************************/
+bool_t CO_OD_dirtyClear(CO_OD_dirty_t *dirty){
+    uint32_t any = 0U;
+    uint16_t i;
+
+    for(i=0U; i<dirty->words; i++){
+        any |= dirty->bits[i];
+        dirty->bits[i] = 0U;
+    }
+
+    return (any != 0U) ? true : false;
+}
+
+
 /******************************************************************************/
 uint32_t CO_SDO_initTransfer(CO_SDO_t *SDO, uint16_t index, uint8_t subIndex){
+    const CO_OD_descriptor_t *desc;
 
     SDO->ODF_arg.index = index;
     SDO->ODF_arg.subIndex = subIndex;
@@ -594,19 +972,26 @@ uint32_t CO_SDO_initTransfer(CO_SDO_t *SDO, uint16_t index, uint8_t subIndex){
         return CO_SDO_AB_SUB_UNKNOWN;     /* Sub-index does not exist. */
     }
 
-    /* pointer to data in Object dictionary */
-    SDO->ODF_arg.ODdataStorage = CO_OD_getDataPointer(SDO, SDO->entryNo, subIndex);
-
-    /* fill ODF_arg */
+    /* fill ODF_arg, from a single descriptor if OD is flattened */
+    desc = CO_OD_getDescriptor(SDO, SDO->entryNo, subIndex);
+    if(desc != NULL){
+        SDO->ODF_arg.ODdataStorage = desc->pData;
+        SDO->ODF_arg.dataLength = desc->length;
+        SDO->ODF_arg.attribute = desc->attribute;
+        SDO->ODF_arg.pFlags = desc->pFlags;
+    }
+    else{
+        SDO->ODF_arg.ODdataStorage = CO_OD_getDataPointer(SDO, SDO->entryNo, subIndex);
+        SDO->ODF_arg.dataLength = CO_OD_getLength(SDO, SDO->entryNo, subIndex);
+        SDO->ODF_arg.attribute = CO_OD_getAttribute(SDO, SDO->entryNo, subIndex);
+        SDO->ODF_arg.pFlags = CO_OD_getFlagsPointer(SDO, SDO->entryNo, subIndex);
+    }
     SDO->ODF_arg.object = NULL;
     if(SDO->ODExtensions){
         CO_OD_extension_t *ext = &SDO->ODExtensions[SDO->entryNo];
         SDO->ODF_arg.object = ext->object;
     }
     SDO->ODF_arg.data = SDO->databuffer;
-    SDO->ODF_arg.dataLength = CO_OD_getLength(SDO, SDO->entryNo, subIndex);
-    SDO->ODF_arg.attribute = CO_OD_getAttribute(SDO, SDO->entryNo, subIndex);
-    SDO->ODF_arg.pFlags = CO_OD_getFlagsPointer(SDO, SDO->entryNo, subIndex);
 
     SDO->ODF_arg.firstSegment = true;
     SDO->ODF_arg.lastSegment = true;
@@ -641,37 +1026,54 @@ uint32_t CO_SDO_readOD(CO_SDO_t *SDO, uint16_t SDOBufferSize){
         ext = &SDO->ODExtensions[SDO->entryNo];
     }
 
-    CO_LOCK_OD();
+#ifdef CO_OD_READ_SEQUENCE
+    if(ODdata != NULL && (ext == NULL || ext->pODFunc == NULL)){
+        /* plain variable, copy without blocking writers */
+        uint32_t seq;
+        uint16_t i;
 
-    /* copy data from OD to SDO buffer if not domain */
-    if(ODdata != NULL){
-        while(length--) *(SDObuffer++) = *(ODdata++);
-    }
-    /* if domain, Object dictionary function MUST exist */
-    else{
-        if(ext->pODFunc == NULL){
-            CO_UNLOCK_OD();
-            return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
-        }
+        do{
+            seq = CO_OD_READ_BEGIN(SDO->CANdevTx);
+            for(i = 0U; i < length; i++){
+                SDObuffer[i] = ODdata[i];
+            }
+        }while(CO_OD_READ_RETRY(SDO->CANdevTx, seq));
     }
+    else
+#endif
+    {
+        CO_LOCK_OD(SDO->CANdevTx);
 
-    /* call Object dictionary function if registered */
-    SDO->ODF_arg.reading = true;
-    if(ext->pODFunc != NULL){
-        uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
-        if(abortCode != 0U){
-            CO_UNLOCK_OD();
-            return abortCode;
+        /* copy data from OD to SDO buffer if not domain */
+        if(ODdata != NULL){
+            while(length--) *(SDObuffer++) = *(ODdata++);
+        }
+        /* if domain, Object dictionary function MUST exist */
+        else{
+            if(ext->pODFunc == NULL){
+                CO_UNLOCK_OD(SDO->CANdevTx);
+                return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
+            }
         }
 
-        /* dataLength (upadted by pODFunc) must be inside limits */
-        if((SDO->ODF_arg.dataLength == 0U) || (SDO->ODF_arg.dataLength > SDOBufferSize)){
-            CO_UNLOCK_OD();
-            return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
+        /* call Object dictionary function if registered */
+        SDO->ODF_arg.reading = true;
+        if(ext->pODFunc != NULL){
+            uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
+            if(abortCode != 0U){
+                CO_UNLOCK_OD(SDO->CANdevTx);
+                return abortCode;
+            }
+
+            /* dataLength (upadted by pODFunc) must be inside limits */
+            if((SDO->ODF_arg.dataLength == 0U) || (SDO->ODF_arg.dataLength > SDOBufferSize)){
+                CO_UNLOCK_OD(SDO->CANdevTx);
+                return CO_SDO_AB_DEVICE_INCOMPAT;     /* general internal incompatibility in the device */
+            }
         }
-    }
 
-    CO_UNLOCK_OD();
+        CO_UNLOCK_OD(SDO->CANdevTx);
+    }
 
     SDO->ODF_arg.offset += SDO->ODF_arg.dataLength;
     SDO->ODF_arg.firstSegment = false;
@@ -733,7 +1135,7 @@ uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length){
     }
 #endif
 
-    CO_LOCK_OD();
+    CO_LOCK_OD(SDO->CANdevTx);
 
     /* call Object dictionary function if registered */
     SDO->ODF_arg.reading = false;
@@ -743,7 +1145,7 @@ uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length){
         if(ext->pODFunc != NULL){
             uint32_t abortCode = ext->pODFunc(&SDO->ODF_arg);
             if(abortCode != 0U){
-                CO_UNLOCK_OD();
+                CO_UNLOCK_OD(SDO->CANdevTx);
                 return abortCode;
             }
         }
@@ -761,9 +1163,10 @@ uint32_t CO_SDO_writeOD(CO_SDO_t *SDO, uint16_t length){
         while(length--){
             *(ODdata++) = *(SDObuffer++);
         }
+        CO_OD_markDirty(SDO, CO_OD_getPosition(SDO, SDO->entryNo, SDO->ODF_arg.subIndex));
     }
 
-    CO_UNLOCK_OD();
+    CO_UNLOCK_OD(SDO->CANdevTx);
 
     return 0;
 }
@@ -898,6 +1301,10 @@ int8_t CO_SDO_process(
             return -1;
         }
     }
+    else if(timerNext_ms != NULL && *timerNext_ms > (SDOtimeoutTime - SDO->timeoutTimer)){
+        /* Call again at the latest when timeout expires. */
+        *timerNext_ms = SDOtimeoutTime - SDO->timeoutTimer;
+    }
 
     /* return immediately if still idle */
     if(state == CO_SDO_ST_IDLE){
@@ -51,6 +51,12 @@
 extern "C" {
 #endif
 
+#ifndef CANrxMemoryBarrier
+/* Not all drivers provide it. Without it, callback registration relies on the
+ * order of the stores only. */
+#define CANrxMemoryBarrier()
+#endif
+
 /**
  * @defgroup CO_SDO SDO server
  * @ingroup CO_CANopen
@@ -287,13 +293,23 @@ typedef enum{
  * if (p == NULL) {
  *     return;
  * }
- * CO_LOCK_OD();
+ * CO_LOCK_OD(CO->CANmodule[0]);
  * *p = new_data;
- * CO_UNLOCK_OD();
+ * CO_UNLOCK_OD(CO->CANmodule[0]);
  * \endcode
  * 
  * Be aware that accessing the OD directly using CO_OD.h files is more CPU 
  * efficient as CO_OD_find() has to do a search everytime it is called.
+ *
+ * If CO_SDO_init() gets a buffer for the OD index, it builds a perfect hash
+ * over the OD indexes (hash and displace). CO_OD_find() then needs a single
+ * probe, independent of the size of the OD. Without buffer, or if the index
+ * can't be built, CO_OD_find() uses binary search.
+ *
+ * If CO_SDO_init() also gets a buffer for OD descriptors, it flattens the OD
+ * into one #CO_OD_descriptor_t per index and subIndex. The functions above
+ * then read length, attribute and pointers from the descriptor instead of
+ * evaluating the OD entry and its record.
  * 
  */
 
@@ -600,9 +616,57 @@ typedef struct{
     /** Pointer to #CO_SDO_OD_flags_t. If object type is array or record, this
     variable points to array with length equal to number of subindexes. */
     uint8_t            *flags;
+    /** Position of subIndex 0 in the flattened OD, see CO_OD_getPosition().
+    From CO_SDO_init(). */
+    uint16_t            descriptor;
 }CO_OD_extension_t;
 
 
+/**
+ * Descriptor of one subIndex of an @ref CO_SDO_objectDictionary entry.
+ *
+ * Optional table with one descriptor per index and subIndex, built by
+ * CO_SDO_init(). Descriptors of one OD entry are contiguous, so
+ * CO_OD_getDescriptor() answers CO_OD_getDataPointer(), CO_OD_getLength(),
+ * CO_OD_getAttribute() and CO_OD_getFlagsPointer() with a single access,
+ * without distinction of Var, Array and Record.
+ */
+typedef struct{
+    /** Same as CO_OD_getDataPointer() */
+    void               *pData;
+    /** Same as CO_OD_getFlagsPointer(), updated by CO_OD_configure() */
+    uint8_t            *pFlags;
+    /** Same as CO_OD_getLength() */
+    uint16_t            length;
+    /** Same as CO_OD_getAttribute() */
+    uint16_t            attribute;
+}CO_OD_descriptor_t;
+
+
+/**
+ * Consumer of dirty bits of the @ref CO_SDO_objectDictionary.
+ *
+ * Each registered consumer has a bitmap with one bit per index and subIndex,
+ * see CO_OD_getPosition(). Writes by SDO server, RPDO and CO_OD_markDirty()
+ * set the bit in all consumers, each consumer clears its own bitmap with
+ * CO_OD_dirtyClear(). So the cost of change detection depends on the number
+ * of changes, not on the size of the OD.
+ *
+ * Direct writes of the application to OD variables are not seen, they must be
+ * reported with CO_OD_markDirty(). Bits are set and cleared with CO_LOCK_OD().
+ */
+typedef struct CO_OD_dirty{
+    /** Bitmap, bit n of word n / 32 for position n */
+    uint32_t           *bits;
+    /** Only positions set here are recorded, NULL for all */
+    const uint32_t     *mask;
+    /** Number of words of bits and mask */
+    uint16_t            words;
+    /** Next registered consumer */
+    struct CO_OD_dirty *next;
+}CO_OD_dirty_t;
+
+
 /**
  * SDO server object.
  */
@@ -620,6 +684,19 @@ typedef struct{
     /** Pointer to array of CO_OD_extension_t objects. Size of the array is
     equal to ODSize. */
     CO_OD_extension_t  *ODExtensions;
+    /** Slots of the OD index with sequence numbers of OD entries, NULL if OD
+    index is not used. From CO_SDO_init(). */
+    uint16_t           *ODIndexSlots;
+    /** Displacement per bucket of the OD index */
+    uint16_t           *ODIndexDisplacement;
+    /** Number of slots of the OD index minus one */
+    uint16_t            ODIndexMask;
+    /** Table of OD descriptors, NULL if not used. From CO_SDO_init(). */
+    CO_OD_descriptor_t *ODDescriptors;
+    /** List of #CO_OD_dirty_t consumers, kept on communication reset */
+    CO_OD_dirty_t      *ODDirtyList;
+    /** Points to ODDirtyList of the SDO object with own OD */
+    CO_OD_dirty_t     **ODDirty;
     /** Offset in buffer of next data segment being read/written */
     uint16_t            bufferOffset;
     /** Sequence number of OD entry as returned from CO_OD_find() */
@@ -648,7 +725,9 @@ typedef struct{
     /** Variable indicates, if new SDO message received from CAN bus */
     volatile void      *CANrxNew;
     /** From CO_SDO_initCallback() or NULL */
-    void              (*pFunctSignal)(void);
+    void              (*pFunctSignal)(void *object);
+    /** From CO_SDO_initCallback() or NULL */
+    void               *functSignalObject;
     /** From CO_SDO_init() */
     CO_CANmodule_t     *CANdevTx;
     /** CAN transmit buffer inside CANdev for CAN tx message */
@@ -755,6 +834,25 @@ void CO_memcpySwap4(void* dest, const void* src);
 void CO_memcpySwap8(void* dest, const void* src);
 
 
+/** Set all bits below the highest set bit of x, x < 0x10000 */
+#define CO_OD_INDEX_SMEAR(x)    ((x) | ((x) >> 1) | ((x) >> 2) | ((x) >> 3) | ((x) >> 4) \
+                                 | ((x) >> 5) | ((x) >> 6) | ((x) >> 7) | ((x) >> 8) \
+                                 | ((x) >> 9) | ((x) >> 10) | ((x) >> 11) | ((x) >> 12) \
+                                 | ((x) >> 13) | ((x) >> 14) | ((x) >> 15))
+/** Smallest power of two >= n, for 0 < n <= 0x8000 */
+#define CO_OD_INDEX_POW2(n)     (CO_OD_INDEX_SMEAR((n) - 1U) + 1U)
+
+/**
+ * Size of the buffer for the OD index in uint16_t words, see CO_SDO_init().
+ *
+ * One slot per power of two >= n and one displacement per four slots, this
+ * is 2.5 bytes per OD entry on average.
+ *
+ * @param n Number of entries in the @ref CO_SDO_objectDictionary.
+ */
+#define CO_OD_INDEX_SIZE(n)     (CO_OD_INDEX_POW2(n) + CO_OD_INDEX_POW2(n) / 4U + 1U)
+
+
 /**
  * Initialize SDO object.
  *
@@ -772,6 +870,14 @@ void CO_memcpySwap8(void* dest, const void* src);
  * @param ODSize Size of the above array.
  * @param ODExtensions Pointer to the externally defined array of the same size
  * as ODSize.
+ * @param ODIndex Buffer for the OD index, built here for CO_OD_find(). May be
+ * NULL, then CO_OD_find() uses binary search.
+ * @param ODIndexSize Size of the above buffer in uint16_t words, should be
+ * CO_OD_INDEX_SIZE(ODSize).
+ * @param ODDescriptors Buffer for the table of #CO_OD_descriptor_t, built
+ * here. May be NULL, then OD entries are evaluated on every access.
+ * @param ODDescriptorsSize Number of descriptors in the above buffer, should be
+ * CO_OD_getDescriptorCount(OD, ODSize). If smaller, the table is not used.
  * @param nodeId CANopen Node ID of this device.
  * @param CANdevRx CAN device for SDO server reception.
  * @param CANdevRxIdx Index of receive buffer in the above CAN device.
@@ -789,6 +895,10 @@ CO_ReturnError_t CO_SDO_init(
         const CO_OD_entry_t     OD[],
         uint16_t                ODSize,
         CO_OD_extension_t       ODExtensions[],
+        uint16_t                ODIndex[],
+        uint16_t                ODIndexSize,
+        CO_OD_descriptor_t      ODDescriptors[],
+        uint16_t                ODDescriptorsSize,
         uint8_t                 nodeId,
         CO_CANmodule_t         *CANdevRx,
         uint16_t                CANdevRxIdx,
@@ -804,11 +914,13 @@ CO_ReturnError_t CO_SDO_init(
  * which processes mainline CANopen functions.
  *
  * @param SDO This object.
+ * @param object Pointer to object, which will be passed to pFunctSignal(). Can be NULL
  * @param pFunctSignal Pointer to the callback function. Not called if NULL.
  */
 void CO_SDO_initCallback(
         CO_SDO_t               *SDO,
-        void                  (*pFunctSignal)(void));
+        void                   *object,
+        void                  (*pFunctSignal)(void *object));
 
 
 /**
@@ -865,6 +977,8 @@ void CO_OD_configure(
 /**
  * Find object with specific index in Object dictionary.
  *
+ * Uses the OD index from CO_SDO_init() if available, binary search otherwise.
+ *
  * @param SDO This object.
  * @param index Index of the object in Object dictionary.
  *
@@ -924,11 +1038,130 @@ void* CO_OD_getDataPointer(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex);
  * @param entryNo Sequence number of OD entry as returned from CO_OD_find().
  * @param subIndex Sub-index of the object in Object dictionary.
  *
- * @return Pointer to the #CO_SDO_OD_flags_t of the variable.
+ * @return Pointer to the #CO_SDO_OD_flags_t of the variable, NULL if no flags
+ * are configured for the OD entry.
  */
 uint8_t* CO_OD_getFlagsPointer(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex);
 
 
+/**
+ * Get number of descriptors for the table of #CO_OD_descriptor_t.
+ *
+ * @param OD Pointer to @ref CO_SDO_objectDictionary array.
+ * @param ODSize Size of the above array.
+ *
+ * @return Number of subIndexes of all OD entries, 0xFFFF if too many.
+ */
+uint16_t CO_OD_getDescriptorCount(const CO_OD_entry_t OD[], uint16_t ODSize);
+
+
+/**
+ * Get descriptor of the given object with specific subIndex.
+ *
+ * @param SDO This object.
+ * @param entryNo Sequence number of OD entry as returned from CO_OD_find().
+ * @param subIndex Sub-index of the object in Object dictionary.
+ *
+ * @return Pointer to the descriptor, NULL if the table of descriptors is not
+ * used or subIndex does not exist.
+ */
+const CO_OD_descriptor_t *CO_OD_getDescriptor(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex);
+
+
+/**
+ * Get position of the given object with specific subIndex in the flattened OD.
+ *
+ * Positions are numbered through all subIndexes of all OD entries, from 0 to
+ * CO_OD_getDescriptorCount() - 1. They are used for the table of
+ * #CO_OD_descriptor_t and for #CO_OD_dirty_t.
+ *
+ * @param SDO This object.
+ * @param entryNo Sequence number of OD entry as returned from CO_OD_find().
+ * @param subIndex Sub-index of the object in Object dictionary.
+ *
+ * @return Position, 0xFFFF if subIndex does not exist.
+ */
+uint16_t CO_OD_getPosition(CO_SDO_t *SDO, uint16_t entryNo, uint8_t subIndex);
+
+
+/** Number of uint32_t words of a #CO_OD_dirty_t bitmap for n positions */
+#define CO_OD_DIRTY_WORDS(n)    (((uint32_t)(n) + 31U) / 32U)
+
+
+/**
+ * Register consumer of dirty bits.
+ *
+ * Must be called after CO_SDO_init() with CO_LOCK_OD(). Registration is kept
+ * on communication reset.
+ *
+ * @param SDO This object.
+ * @param dirty Consumer object, will be initialized.
+ * @param bits Bitmap of the consumer, will be cleared.
+ * @param mask Only positions set here are recorded, see CO_OD_dirtyMaskRange().
+ * May be NULL.
+ * @param words Size of the above arrays, should be
+ * CO_OD_DIRTY_WORDS(CO_OD_getDescriptorCount(OD, ODSize)).
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO or CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_OD_dirtyRegister(
+        CO_SDO_t               *SDO,
+        CO_OD_dirty_t          *dirty,
+        uint32_t                bits[],
+        const uint32_t          mask[],
+        uint16_t                words);
+
+
+/**
+ * Unregister consumer of dirty bits. Must be called with CO_LOCK_OD().
+ *
+ * @param SDO This object.
+ * @param dirty Consumer object from CO_OD_dirtyRegister().
+ */
+void CO_OD_dirtyUnregister(CO_SDO_t *SDO, CO_OD_dirty_t *dirty);
+
+
+/**
+ * Set mask bits for all subIndexes with data in a memory block, for example
+ * CO_OD_EEPROM.
+ *
+ * @param SDO This object.
+ * @param mask Mask for CO_OD_dirtyRegister(), bits are added.
+ * @param words Size of the above array.
+ * @param start Start of the memory block.
+ * @param size Size of the memory block in bytes.
+ *
+ * @return Number of subIndexes in the memory block.
+ */
+uint16_t CO_OD_dirtyMaskRange(
+        CO_SDO_t               *SDO,
+        uint32_t                mask[],
+        uint16_t                words,
+        const void             *start,
+        uint32_t                size);
+
+
+/**
+ * Mark object as changed for all consumers. Must be called with CO_LOCK_OD().
+ *
+ * @param SDO This object.
+ * @param position Position from CO_OD_getPosition(). 0xFFFF is ignored.
+ *
+ * @return true, if the bit was set for at least one consumer.
+ */
+bool_t CO_OD_markDirty(CO_SDO_t *SDO, uint16_t position);
+
+
+/**
+ * Test and clear bitmap of a consumer. Must be called with CO_LOCK_OD().
+ *
+ * @param dirty Consumer object.
+ *
+ * @return true, if any object was changed since last call.
+ */
+bool_t CO_OD_dirtyClear(CO_OD_dirty_t *dirty);
+
+
 /**
  * Initialize SDO transfer.
  *
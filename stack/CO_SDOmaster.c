@@ -180,7 +180,7 @@ static void CO_SDOclient_receive(void *object, const CO_CANrxMsg_t *msg){
 
         /* Optional signal to RTOS, which can resume task, which handles SDO client. */
         if(IS_CANrxNew(SDO_C->CANrxNew) && SDO_C->pFunctSignal != NULL) {
-            SDO_C->pFunctSignal();
+            SDO_C->pFunctSignal(SDO_C->functSignalObject);
         }
     }
 }
@@ -213,6 +213,7 @@ CO_ReturnError_t CO_SDOclient_init(
     SDO_C->SDOClientPar = SDOClientPar;
 
     SDO_C->pFunctSignal = NULL;
+    SDO_C->functSignalObject = NULL;
 
     SDO_C->CANdevRx = CANdevRx;
     SDO_C->CANdevRxIdx = CANdevRxIdx;
@@ -232,9 +233,17 @@ CO_ReturnError_t CO_SDOclient_init(
 /******************************************************************************/
 void CO_SDOclient_initCallback(
         CO_SDOclient_t         *SDOclient,
-        void                  (*pFunctSignal)(void))
+        void                   *object,
+        void                  (*pFunctSignal)(void *object))
 {
     if(SDOclient != NULL){
+        /* CAN receive may call pFunctSignal concurrently. It must never see
+         * the new function with the old object or vice versa, so the function
+         * is cleared first and set last. */
+        SDOclient->pFunctSignal = NULL;
+        CANrxMemoryBarrier();
+        SDOclient->functSignalObject = object;
+        CANrxMemoryBarrier();
         SDOclient->pFunctSignal = pFunctSignal;
     }
 }
@@ -375,7 +384,7 @@ CO_SDOclient_return_t CO_SDOclientDownloadInitiate(
 
         /* Optional signal to RTOS. We can immediately continue SDO Client */
         if(SDO_C->pFunctSignal != NULL) {
-            SDO_C->pFunctSignal();
+            SDO_C->pFunctSignal(SDO_C->functSignalObject);
         }
 
         return CO_SDOcli_ok_communicationEnd;
@@ -814,7 +823,7 @@ CO_SDOclient_return_t CO_SDOclientUploadInitiate(
 
         /* Optional signal to RTOS. We can immediately continue SDO Client */
         if(SDO_C->pFunctSignal != NULL) {
-            SDO_C->pFunctSignal();
+            SDO_C->pFunctSignal(SDO_C->functSignalObject);
         }
 
         return CO_SDOcli_ok_communicationEnd;
@@ -84,6 +84,9 @@ static void CO_SYNC_receive(void *object, const CO_CANrxMsg_t *msg){
         }
         if(IS_CANrxNew(SYNC->CANrxNew)) {
             SYNC->CANrxToggle = SYNC->CANrxToggle ? false : true;
+#ifdef CO_CANRX_TIMESTAMP
+            SYNC->CANrxTimestamp = msg->timestamp;
+#endif
         }
     }
 }
@@ -318,7 +321,8 @@ CO_ReturnError_t CO_SYNC_init(
 uint8_t CO_SYNC_process(
         CO_SYNC_t              *SYNC,
         uint32_t                timeDifference_us,
-        uint32_t                ObjDict_synchronousWindowLength)
+        uint32_t                ObjDict_synchronousWindowLength,
+        uint32_t               *timerNext_us)
 {
     uint8_t ret = 0;
     uint32_t timerNew;
@@ -366,6 +370,26 @@ uint8_t CO_SYNC_process(
         /* Verify timeout of SYNC */
         if(SYNC->periodTime && SYNC->timer > SYNC->periodTimeoutTime && *SYNC->operatingState == CO_NMT_OPERATIONAL)
             CO_errorReport(SYNC->em, CO_EM_SYNC_TIME_OUT, CO_EMC_COMMUNICATION, SYNC->timer);
+
+        /* Calculate, when the next SYNC is produced, the window ends or the
+         * SYNC times out and lower timerNext_us if necessary. */
+        if(timerNext_us != NULL){
+            uint32_t diff = UINT32_MAX;
+
+            if(SYNC->isProducer && SYNC->periodTime){
+                diff = SYNC->periodTime - SYNC->timer;
+            }
+            else if(SYNC->periodTime && SYNC->timer <= SYNC->periodTimeoutTime){
+                diff = SYNC->periodTimeoutTime - SYNC->timer + 1;
+            }
+            if(ObjDict_synchronousWindowLength && SYNC->curentSyncTimeIsInsideWindow &&
+               diff > ObjDict_synchronousWindowLength - SYNC->timer + 1){
+                diff = ObjDict_synchronousWindowLength - SYNC->timer + 1;
+            }
+            if(*timerNext_us > diff){
+                *timerNext_us = diff;
+            }
+        }
     }
     else {
         CLEAR_CANrxNew(SYNC->CANrxNew);
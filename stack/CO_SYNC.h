@@ -109,6 +109,10 @@ typedef struct{
     volatile void      *CANrxNew;
     /** Variable toggles, if new SYNC message received from CAN bus */
     bool_t              CANrxToggle;
+#ifdef CO_CANRX_TIMESTAMP
+    /** Reception time of last valid SYNC message */
+    struct timespec     CANrxTimestamp;
+#endif
     /** Counter of the SYNC message if counterOverflowValue is different than zero */
     uint8_t             counter;
     /** Timer for the SYNC message in [microseconds].
@@ -166,6 +170,9 @@ CO_ReturnError_t CO_SYNC_init(
  * @param timeDifference_us Time difference from previous function call in [microseconds].
  * @param ObjDict_synchronousWindowLength _Synchronous window length_ variable from
  * Object dictionary (index 0x1007).
+ * @param timerNext_us Return value - info to OS - time until the next SYNC is
+ * produced, the window ends or the SYNC times out. Lowered if necessary,
+ * ignored if NULL.
  *
  * @return 0: No special meaning.
  * @return 1: New SYNC message recently received or was just transmitted.
@@ -174,7 +181,8 @@ CO_ReturnError_t CO_SYNC_init(
 uint8_t CO_SYNC_process(
         CO_SYNC_t              *SYNC,
         uint32_t                timeDifference_us,
-        uint32_t                ObjDict_synchronousWindowLength);
+        uint32_t                ObjDict_synchronousWindowLength,
+        uint32_t               *timerNext_us);
 
 #ifdef __cplusplus
 }
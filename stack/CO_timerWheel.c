@@ -0,0 +1,303 @@
+/*
+ * Hierarchical timer wheel for CANopen timeouts.
+ *
+ * @file        CO_timerWheel.c
+ * @ingroup     CO_timerWheel
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebäudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+
+#include "CO_driver.h"
+#include "CO_timerWheel.h"
+
+/* Mask of the slot index inside one level */
+#define CO_TIMER_WHEEL_MASK     (CO_TIMER_WHEEL_SLOTS - 1U)
+/* Number of ticks covered by the wheel without resorting */
+#define CO_TIMER_WHEEL_RANGE    (1UL << (CO_TIMER_WHEEL_BITS * CO_TIMER_WHEEL_LEVELS))
+
+#if CO_TIMER_WHEEL_BITS > 5U || CO_TIMER_WHEEL_BITS * CO_TIMER_WHEEL_LEVELS > 31U
+#error CO_TIMER_WHEEL_BITS or CO_TIMER_WHEEL_LEVELS too large
+#endif
+
+
+/*
+ * Insert timer into the list, which starts at head.
+ */
+static void CO_timer_link(CO_timer_t **head, CO_timer_t *timer)
+{
+    timer->next = *head;
+    if (timer->next != NULL) {
+        timer->next->pprev = &timer->next;
+    }
+    timer->pprev = head;
+    *head = timer;
+}
+
+
+/*
+ * Remove timer from its list and clear the occupancy bit of an empty slot.
+ */
+static void CO_timer_unlink(CO_timerWheel_t *wheel, CO_timer_t *timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = timer->pprev;
+    }
+    if (timer->state == CO_TIMER_RUNNING &&
+        wheel->slots[timer->level][timer->slot] == NULL) {
+        wheel->occupied[timer->level] &= ~(1UL << timer->slot);
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->state = CO_TIMER_IDLE;
+}
+
+
+/*
+ * Sort timer into the level, which covers its remaining time.
+ */
+static void CO_timerWheel_add(CO_timerWheel_t *wheel, CO_timer_t *timer)
+{
+    uint32_t remaining = timer->expiry - wheel->now;
+    uint32_t t;
+    uint8_t level = 0;
+
+    if ((int32_t)remaining < 0) {
+        /* already overdue, expire with the current slot */
+        remaining = 0;
+    }
+    else if (remaining >= CO_TIMER_WHEEL_RANGE) {
+        /* out of range, resort from the last slot of the highest level */
+        remaining = CO_TIMER_WHEEL_RANGE - 1U;
+    }
+    while (level < (CO_TIMER_WHEEL_LEVELS - 1U) &&
+           remaining >= (1UL << (CO_TIMER_WHEEL_BITS * (level + 1U)))) {
+        level++;
+    }
+    t = wheel->now + remaining;
+
+    timer->level = level;
+    timer->slot = (t >> (CO_TIMER_WHEEL_BITS * level)) & CO_TIMER_WHEEL_MASK;
+    timer->state = CO_TIMER_RUNNING;
+    CO_timer_link(&wheel->slots[level][timer->slot], timer);
+    wheel->occupied[level] |= 1UL << timer->slot;
+}
+
+
+/*
+ * Distance in slots from the current to the next occupied slot of a level,
+ * 1 ... CO_TIMER_WHEEL_SLOTS. Returns 0, if level is empty.
+ */
+static uint32_t CO_timerWheel_nextSlot(const CO_timerWheel_t *wheel, uint8_t level)
+{
+    uint32_t occupied = wheel->occupied[level];
+    uint32_t current = (wheel->now >> (CO_TIMER_WHEEL_BITS * level)) & CO_TIMER_WHEEL_MASK;
+    uint32_t distance;
+
+    if (occupied == 0U) {
+        return 0U;
+    }
+    for (distance = 1U; distance < CO_TIMER_WHEEL_SLOTS; distance++) {
+        if ((occupied & (1UL << ((current + distance) & CO_TIMER_WHEEL_MASK))) != 0U) {
+            break;
+        }
+    }
+    return distance;
+}
+
+
+/*
+ * Time from now until the slot, which is distance slots ahead of the current
+ * slot of a level, is reached.
+ */
+static uint32_t CO_timerWheel_slotTime(const CO_timerWheel_t *wheel, uint8_t level, uint32_t distance)
+{
+    uint8_t shift = CO_TIMER_WHEEL_BITS * level;
+
+    return (((wheel->now >> shift) + distance) << shift) - wheel->now;
+}
+
+
+/******************************************************************************/
+void CO_timerWheel_init(CO_timerWheel_t *wheel)
+{
+    uint8_t level;
+    uint8_t slot;
+
+    for (level = 0; level < CO_TIMER_WHEEL_LEVELS; level++) {
+        for (slot = 0; slot < CO_TIMER_WHEEL_SLOTS; slot++) {
+            wheel->slots[level][slot] = NULL;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->expired = NULL;
+    wheel->now = 0;
+}
+
+
+/******************************************************************************/
+void CO_timer_init(CO_timer_t *timer, void *object)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expiry = 0;
+    timer->object = object;
+    timer->state = CO_TIMER_IDLE;
+    timer->level = 0;
+    timer->slot = 0;
+}
+
+
+/******************************************************************************/
+void CO_timer_start(CO_timerWheel_t *wheel, CO_timer_t *timer, uint32_t ticks)
+{
+    if (timer->state != CO_TIMER_IDLE) {
+        CO_timer_unlink(wheel, timer);
+    }
+    timer->expiry = wheel->now + ticks;
+    CO_timerWheel_add(wheel, timer);
+}
+
+
+/******************************************************************************/
+void CO_timer_stop(CO_timerWheel_t *wheel, CO_timer_t *timer)
+{
+    if (timer->state != CO_TIMER_IDLE) {
+        CO_timer_unlink(wheel, timer);
+    }
+}
+
+
+/******************************************************************************/
+void CO_timerWheel_process(CO_timerWheel_t *wheel, uint32_t timeDifference)
+{
+    for (;;) {
+        uint32_t step = timeDifference;
+        uint32_t slot = wheel->now & CO_TIMER_WHEEL_MASK;
+        uint8_t level;
+
+        /* move all timers of the current slot to the expired list */
+        while (wheel->slots[0][slot] != NULL) {
+            CO_timer_t *timer = wheel->slots[0][slot];
+
+            CO_timer_unlink(wheel, timer);
+            timer->state = CO_TIMER_EXPIRED;
+            CO_timer_link(&wheel->expired, timer);
+        }
+
+        if (timeDifference == 0U) {
+            break;
+        }
+
+        /* jump to the next occupied slot, skip empty ones */
+        for (level = 0; level < CO_TIMER_WHEEL_LEVELS; level++) {
+            uint32_t distance = CO_timerWheel_nextSlot(wheel, level);
+
+            if (distance != 0U) {
+                uint32_t t = CO_timerWheel_slotTime(wheel, level, distance);
+                if (t < step) {
+                    step = t;
+                }
+            }
+        }
+        wheel->now += step;
+        timeDifference -= step;
+
+        /* resort timers of higher level slots, which are reached now */
+        for (level = 1; level < CO_TIMER_WHEEL_LEVELS; level++) {
+            uint8_t shift = CO_TIMER_WHEEL_BITS * level;
+
+            if ((wheel->now & ((1UL << shift) - 1U)) != 0U) {
+                break;
+            }
+            slot = (wheel->now >> shift) & CO_TIMER_WHEEL_MASK;
+            while (wheel->slots[level][slot] != NULL) {
+                CO_timer_t *timer = wheel->slots[level][slot];
+
+                CO_timer_unlink(wheel, timer);
+                CO_timerWheel_add(wheel, timer);
+            }
+        }
+    }
+}
+
+
+/******************************************************************************/
+CO_timer_t *CO_timerWheel_getExpired(CO_timerWheel_t *wheel)
+{
+    CO_timer_t *timer = wheel->expired;
+
+    if (timer != NULL) {
+        CO_timer_unlink(wheel, timer);
+    }
+    return timer;
+}
+
+
+/******************************************************************************/
+uint32_t CO_timerWheel_next(const CO_timerWheel_t *wheel)
+{
+    uint32_t next = UINT32_MAX;
+    uint8_t level;
+
+    if (wheel->expired != NULL) {
+        return 0U;
+    }
+    if (wheel->slots[0][wheel->now & CO_TIMER_WHEEL_MASK] != NULL) {
+        return 0U;
+    }
+    for (level = 0; level < CO_TIMER_WHEEL_LEVELS; level++) {
+        uint32_t distance = CO_timerWheel_nextSlot(wheel, level);
+
+        if (distance != 0U) {
+            /* Slots of one level are in order of time, so only the first
+             * occupied slot matters. A level 0 slot expires at its start.
+             * Timers of higher levels are not searched, the slot start is
+             * when they are sorted in again and the earliest possible
+             * expiry. */
+            uint32_t t = CO_timerWheel_slotTime(wheel, level, distance);
+
+            if (t < next) {
+                next = t;
+            }
+        }
+    }
+    return next;
+}
@@ -0,0 +1,214 @@
+/**
+ * Hierarchical timer wheel for CANopen timeouts.
+ *
+ * @file        CO_timerWheel.h
+ * @ingroup     CO_timerWheel
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebäudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+
+#ifndef CO_TIMER_WHEEL_H
+#define CO_TIMER_WHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup CO_timerWheel Timer wheel
+ * @ingroup CO_CANopen
+ * @{
+ *
+ * Hierarchical timer wheel for objects with many independent timeouts.
+ *
+ * Every timer is sorted into a slot of the wheel when it is started. Level 0
+ * has one slot per tick, every further level covers CO_TIMER_WHEEL_SLOTS
+ * slots of the level below. When the time of a higher level slot is reached,
+ * its timers are redistributed to the lower levels. An occupancy bitmap per
+ * level allows CO_timerWheel_process() to jump directly to the next
+ * occupied slot, so the cost of processing does not depend on the number of
+ * running timers, but only on the number of expiring timers.
+ *
+ * Ticks have no unit; the owner of the wheel defines it by the values it
+ * passes to CO_timerWheel_process(). Expired timers are collected and must be
+ * fetched with CO_timerWheel_getExpired(). Timers are not thread safe, all
+ * functions for one wheel must be called from the same thread.
+ *
+ * Timers longer than the range of the wheel are allowed, they are placed in
+ * the highest level and sorted in again when that slot is reached.
+ */
+
+#ifndef CO_TIMER_WHEEL_BITS
+/** Number of bits per level, max 5. */
+#define CO_TIMER_WHEEL_BITS     4U
+#endif
+#ifndef CO_TIMER_WHEEL_LEVELS
+/** Number of levels. Default covers 65536 ticks without resorting. */
+#define CO_TIMER_WHEEL_LEVELS   4U
+#endif
+/** Number of slots per level */
+#define CO_TIMER_WHEEL_SLOTS    (1U << CO_TIMER_WHEEL_BITS)
+
+/**
+ * State of a timer
+ */
+typedef enum {
+    CO_TIMER_IDLE           = 0x00U,  /**< Timer is not running */
+    CO_TIMER_RUNNING        = 0x01U,  /**< Timer is sorted into the wheel */
+    CO_TIMER_EXPIRED        = 0x02U   /**< Timer has expired, not yet fetched */
+} CO_timer_state_t;
+
+
+/**
+ * One timer.
+ *
+ * Typically embedded into the object which owns the timeout. Initialized by
+ * CO_timer_init().
+ */
+typedef struct CO_timer {
+    struct CO_timer        *next;         /**< Next timer in the same slot */
+    struct CO_timer       **pprev;        /**< Link pointing to this timer */
+    uint32_t                expiry;       /**< Absolute time of expiry in ticks */
+    void                   *object;       /**< From CO_timer_init() */
+    uint8_t                 state;        /**< #CO_timer_state_t */
+    uint8_t                 level;        /**< Level of the wheel, if running */
+    uint8_t                 slot;         /**< Slot inside the level, if running */
+}CO_timer_t;
+
+
+/**
+ * Timer wheel object.
+ *
+ * Object is initialized by CO_timerWheel_init().
+ */
+typedef struct{
+    /** List of timers per slot */
+    CO_timer_t         *slots[CO_TIMER_WHEEL_LEVELS][CO_TIMER_WHEEL_SLOTS];
+    /** One bit for each slot, which contains timers */
+    uint32_t            occupied[CO_TIMER_WHEEL_LEVELS];
+    CO_timer_t         *expired;          /**< List of expired timers */
+    uint32_t            now;              /**< Current time in ticks */
+}CO_timerWheel_t;
+
+
+/**
+ * Initialize timer wheel object.
+ *
+ * Wheel must not contain any timers, when it is initialized again.
+ *
+ * @param wheel This object will be initialized.
+ */
+void CO_timerWheel_init(CO_timerWheel_t *wheel);
+
+/**
+ * Initialize timer.
+ *
+ * Timer must not be running, when it is initialized again.
+ *
+ * @param timer This object will be initialized.
+ * @param object Pointer to object, which owns the timer. Can be retrieved
+ * from the timer returned by CO_timerWheel_getExpired(). Can be NULL.
+ */
+void CO_timer_init(CO_timer_t *timer, void *object);
+
+/**
+ * Start or restart timer.
+ *
+ * If timer is already running or expired, it is removed first.
+ *
+ * @param wheel Timer wheel object.
+ * @param timer Timer object.
+ * @param ticks Time from now until expiry. If 0, timer expires with the next
+ * call to CO_timerWheel_process().
+ */
+void CO_timer_start(CO_timerWheel_t *wheel, CO_timer_t *timer, uint32_t ticks);
+
+/**
+ * Stop timer.
+ *
+ * Removes the timer from the wheel or from the list of expired timers.
+ *
+ * @param wheel Timer wheel object.
+ * @param timer Timer object.
+ */
+void CO_timer_stop(CO_timerWheel_t *wheel, CO_timer_t *timer);
+
+/**
+ * Advance time of the timer wheel.
+ *
+ * Expired timers are moved to the list of expired timers.
+ *
+ * @param wheel This object.
+ * @param timeDifference Time difference from previous function call in ticks.
+ */
+void CO_timerWheel_process(CO_timerWheel_t *wheel, uint32_t timeDifference);
+
+/**
+ * Fetch next expired timer.
+ *
+ * Timer state changes to CO_TIMER_IDLE. It may be started again immediately.
+ *
+ * @param wheel This object.
+ *
+ * @return Pointer to the expired timer or NULL, if there is none.
+ */
+CO_timer_t *CO_timerWheel_getExpired(CO_timerWheel_t *wheel);
+
+/**
+ * Get time until the next timer expires.
+ *
+ * Exact for timers in level 0. If the next timer is in a higher level, the
+ * time may be shorter. Then it is the time when the timers of that slot are
+ * sorted in again, which takes constant time instead of a search of the slot.
+ *
+ * @param wheel This object.
+ *
+ * @return Time in ticks, 0 if there are expired timers not fetched yet,
+ * UINT32_MAX if no timer is running.
+ */
+uint32_t CO_timerWheel_next(const CO_timerWheel_t *wheel);
+
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+/** @} */
+#endif
@@ -272,7 +272,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
         // USBport.printf("BUFF_FULL OVERFLOW\r\n");
     }
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     /* if CAN TX buffer is free, copy message to it */
     if ((MBED_CHECK_TX_BUFFERS) && CANmodule->CANtxCount == 0){
         CANmodule->bufferInhibitFlag = buffer->syncFlag;
@@ -286,7 +286,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
         buffer->bufferFull = true;
         CANmodule->CANtxCount++;
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
     return err;
 }
@@ -296,7 +296,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
 void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule){
     uint32_t tpdoDeleted = 0U;
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     /* Abort message from CAN module, if there is synchronous TPDO.
      * Take special care with this functionality. */
     if (((MBED_CAN_REG->GSR & (1 << 2)) == 0) && CANmodule->bufferInhibitFlag){
@@ -323,7 +323,7 @@ void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule){
             buffer++;
         }
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
 
     if(tpdoDeleted != 0U){
@@ -61,14 +61,14 @@
 
 
 /* Critical sections */
-    #define CO_LOCK_CAN_SEND()
-    #define CO_UNLOCK_CAN_SEND()
+    #define CO_LOCK_CAN_SEND(CAN_MODULE)
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE)
 
-    #define CO_LOCK_EMCY()
-    #define CO_UNLOCK_EMCY()
+    #define CO_LOCK_EMCY(CAN_MODULE)
+    #define CO_UNLOCK_EMCY(CAN_MODULE)
 
-    #define CO_LOCK_OD()
-    #define CO_UNLOCK_OD()
+    #define CO_LOCK_OD(CAN_MODULE)
+    #define CO_UNLOCK_OD(CAN_MODULE)
 
 
 /* Data types */
@@ -392,7 +392,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
         err = CO_ERROR_TX_OVERFLOW;
     }
   
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     
     /* if CAN TX buffer is free, copy message to it */
     TxBuf = Chip_CAN_GetFreeTxBuf(LPC_CAN);
@@ -411,7 +411,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
         buffer->bufferFull = true;
         CANmodule->CANtxCount++;
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
     return err;
 }
@@ -421,7 +421,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
 void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule){
     uint32_t tpdoDeleted = 0U;
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     
     /* Abort message from CAN module, if there is synchronous TPDO.
      * Take special care with this functionality. */
@@ -453,7 +453,7 @@ void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule){
             buffer++;
         }
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
 
     if(tpdoDeleted != 0U){
@@ -313,7 +313,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
                             i++;
                         }
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     /* if CAN TX buffer is free, copy message to it */
     if(i<16){
         MCF_CANMB_CTRL(i)    = 0x0000|MCF_CANMB_CTRL_CODE(0b1000); //Tx MB inactive
@@ -329,7 +329,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
         buffer->bufferFull = true;
         CANmodule->CANtxCount++;
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
     return err;
 }
@@ -338,15 +338,15 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer){
 /******************************************************************************/
 void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule){
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     if(CANmodule->bufferInhibitFlag){
         MCF_CANMB_CTRL14 = MCF_CANMB_CTRL_CODE(0b1000);  //clear TXREQ
             MCF_CANMB_CTRL15 = MCF_CANMB_CTRL_CODE(0b1000);  //clear TXREQ
-        CO_UNLOCK_CAN_SEND();
+        CO_UNLOCK_CAN_SEND(CANmodule);
         CO_errorReport((CO_emergencyReport_t*)CANmodule->em, ERROR_TPDO_OUTSIDE_WINDOW, 0);
     }
     else{
-        CO_UNLOCK_CAN_SEND();
+        CO_UNLOCK_CAN_SEND(CANmodule);
     }
 }
 
@@ -62,14 +62,14 @@
 
 
 /* Critical sections */
-    #define CO_LOCK_CAN_SEND()      asm{ move.w        #0x2700,sr};
-    #define CO_UNLOCK_CAN_SEND()    asm{ move.w        #0x2000,sr};
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) asm{ move.w        #0x2700,sr};
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) asm{ move.w        #0x2000,sr};
 
-    #define CO_LOCK_EMCY()          asm{ move.w        #0x2700,sr};
-    #define CO_UNLOCK_EMCY()        asm{ move.w        #0x2000,sr};
+    #define CO_LOCK_EMCY(CAN_MODULE) asm{ move.w        #0x2700,sr};
+    #define CO_UNLOCK_EMCY(CAN_MODULE) asm{ move.w        #0x2000,sr};
 
-    #define CO_LOCK_OD()            asm{ move.w        #0x2700,sr};
-    #define CO_UNLOCK_OD()          asm{ move.w        #0x2000,sr};
+    #define CO_LOCK_OD(CAN_MODULE)  asm{ move.w        #0x2700,sr};
+    #define CO_UNLOCK_OD(CAN_MODULE) asm{ move.w        #0x2000,sr};
 
 
 /* MACRO : get information from Rx buffer */
@@ -72,14 +72,14 @@
 
 /* Critical sections */
     extern unsigned int CO_interruptStatus;
-    #define CO_LOCK_CAN_SEND()      CO_interruptStatus = __builtin_disable_interrupts()
-    #define CO_UNLOCK_CAN_SEND()    if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) CO_interruptStatus = __builtin_disable_interrupts()
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
 
-    #define CO_LOCK_EMCY()          CO_interruptStatus = __builtin_disable_interrupts()
-    #define CO_UNLOCK_EMCY()        if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
+    #define CO_LOCK_EMCY(CAN_MODULE) CO_interruptStatus = __builtin_disable_interrupts()
+    #define CO_UNLOCK_EMCY(CAN_MODULE) if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
 
-    #define CO_LOCK_OD()            CO_interruptStatus = __builtin_disable_interrupts()
-    #define CO_UNLOCK_OD()          if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
+    #define CO_LOCK_OD(CAN_MODULE)  CO_interruptStatus = __builtin_disable_interrupts()
+    #define CO_UNLOCK_OD(CAN_MODULE) if(CO_interruptStatus & 0x00000001) {__builtin_enable_interrupts();}
 
 
 /* Data types */
@@ -301,7 +301,7 @@ void __ISR(_TIMER_2_VECTOR, IPL3SOFT) CO_TimerInterruptHandler(void){
         int i;
 
         /* Process Sync and read inputs */
-        syncWas = CO_process_SYNC_RPDO(CO, 1000);
+        syncWas = CO_process_SYNC_RPDO(CO, 1000, NULL);
 
         /* Further I/O or nonblocking application code may go here. */
 #if CO_NO_TRACE > 0
@@ -313,7 +313,7 @@ void __ISR(_TIMER_2_VECTOR, IPL3SOFT) CO_TimerInterruptHandler(void){
         program1ms();
 
         /* Write outputs */
-        CO_process_TPDO(CO, syncWas, 1000);
+        CO_process_TPDO(CO, syncWas, 1000, NULL);
 
         /* verify timer overflow */
         if(CO_TMR_ISR_FLAG == 1){
@@ -72,14 +72,14 @@
 
 
 /* Critical sections */
-    #define CO_LOCK_CAN_SEND()      //taskENTER_CRITICAL()
-    #define CO_UNLOCK_CAN_SEND()    //taskEXIT_CRITICAL()
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) //taskENTER_CRITICAL()
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) //taskEXIT_CRITICAL()
 
-    #define CO_LOCK_EMCY()          //taskENTER_CRITICAL()
-    #define CO_UNLOCK_EMCY()        //taskEXIT_CRITICAL()
+    #define CO_LOCK_EMCY(CAN_MODULE) //taskENTER_CRITICAL()
+    #define CO_UNLOCK_EMCY(CAN_MODULE) //taskEXIT_CRITICAL()
 
-    #define CO_LOCK_OD()            //taskENTER_CRITICAL()
-    #define CO_UNLOCK_OD()          //taskEXIT_CRITICAL()
+    #define CO_LOCK_OD(CAN_MODULE)  //taskENTER_CRITICAL()
+    #define CO_UNLOCK_OD(CAN_MODULE) //taskEXIT_CRITICAL()
 
 
 /* Data types */
@@ -66,14 +66,14 @@
     #define TMIDxR_TXRQ  ((uint32_t)0x00000001) /* Transmit mailbox request */
 
 /* Critical sections */
-    #define CO_LOCK_CAN_SEND()      __set_PRIMASK(1);
-    #define CO_UNLOCK_CAN_SEND()    __set_PRIMASK(0);
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) __set_PRIMASK(1);
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) __set_PRIMASK(0);
 
-    #define CO_LOCK_EMCY()          __set_PRIMASK(1);
-    #define CO_UNLOCK_EMCY()        __set_PRIMASK(0);
+    #define CO_LOCK_EMCY(CAN_MODULE) __set_PRIMASK(1);
+    #define CO_UNLOCK_EMCY(CAN_MODULE) __set_PRIMASK(0);
 
-    #define CO_LOCK_OD()            __set_PRIMASK(1);
-    #define CO_UNLOCK_OD()          __set_PRIMASK(0);
+    #define CO_LOCK_OD(CAN_MODULE)  __set_PRIMASK(1);
+    #define CO_UNLOCK_OD(CAN_MODULE) __set_PRIMASK(0);
 
     
 #define CLOCK_CAN                   RCC_APB1Periph_CAN1
@@ -281,7 +281,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
         err = CO_ERROR_TX_OVERFLOW;
     }
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     
     /* First try to transmit the message immediately if mailbox is free.
      * Only one TX mailbox is used of the three available in the hardware */
@@ -293,7 +293,7 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
         buffer->bufferFull = 1;
         CANmodule->CANtxCount++;
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
     return err;
 }
@@ -304,7 +304,7 @@ void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule)
     uint32_t tpdoDeleted = 0U;
     uint8_t state = 0;
 
-    CO_LOCK_CAN_SEND();
+    CO_LOCK_CAN_SEND(CANmodule);
     /* Abort message from CAN module, if there is synchronous TPDO. */
     state = CAN_TransmitStatus(CANmodule->CANbaseAddress, CO_CAN_TXMAILBOX);
     if((state == CAN_TxStatus_Pending) && (CANmodule->bufferInhibitFlag)) {
@@ -328,7 +328,7 @@ void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule)
             buffer++;
         }
     }
-    CO_UNLOCK_CAN_SEND();
+    CO_UNLOCK_CAN_SEND(CANmodule);
 
 
     if(tpdoDeleted != 0U){
@@ -62,14 +62,14 @@
 
 
 /* Critical sections */
-    #define CO_LOCK_CAN_SEND()      asm volatile ("disi #0x3FFF")
-    #define CO_UNLOCK_CAN_SEND()    asm volatile ("disi #0x0000")
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) asm volatile ("disi #0x3FFF")
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) asm volatile ("disi #0x0000")
 
-    #define CO_LOCK_EMCY()          asm volatile ("disi #0x3FFF")
-    #define CO_UNLOCK_EMCY()        asm volatile ("disi #0x0000")
+    #define CO_LOCK_EMCY(CAN_MODULE) asm volatile ("disi #0x3FFF")
+    #define CO_UNLOCK_EMCY(CAN_MODULE) asm volatile ("disi #0x0000")
 
-    #define CO_LOCK_OD()            asm volatile ("disi #0x3FFF")
-    #define CO_UNLOCK_OD()          asm volatile ("disi #0x0000")
+    #define CO_LOCK_OD(CAN_MODULE)  asm volatile ("disi #0x3FFF")
+    #define CO_UNLOCK_OD(CAN_MODULE) asm volatile ("disi #0x0000")
 
 
 /* Data types */
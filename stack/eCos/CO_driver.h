@@ -94,14 +94,14 @@
 // shared data is accessed only from thread level code (not from ISR or DSR)
 // so we simply do a scheduler lock here to prevent access from different
 // threads
-    #define CO_LOCK_CAN_SEND()      cyg_scheduler_lock()
-    #define CO_UNLOCK_CAN_SEND()    cyg_scheduler_unlock()
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) cyg_scheduler_lock()
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) cyg_scheduler_unlock()
 
-    #define CO_LOCK_EMCY()          cyg_scheduler_lock()
-    #define CO_UNLOCK_EMCY()        cyg_scheduler_unlock()
+    #define CO_LOCK_EMCY(CAN_MODULE) cyg_scheduler_lock()
+    #define CO_UNLOCK_EMCY(CAN_MODULE) cyg_scheduler_unlock()
 
-    #define CO_LOCK_OD()            cyg_scheduler_lock()
-    #define CO_UNLOCK_OD()          cyg_scheduler_unlock()
+    #define CO_LOCK_OD(CAN_MODULE)  cyg_scheduler_lock()
+    #define CO_UNLOCK_OD(CAN_MODULE) cyg_scheduler_unlock()
 
 
 
@@ -174,20 +174,28 @@ extern "C" {
  * CO_SYNC_initCallback() function.
  * @{
  */
-#define CO_LOCK_CAN_SEND()      /* not needed */
-#define CO_UNLOCK_CAN_SEND()
+/* There is only one CANopen object, so the mutexes are global and the CAN
+ * module argument is only evaluated. */
+#define CO_LOCK_CAN_SEND(CAN_MODULE)    /* not needed */
+#define CO_UNLOCK_CAN_SEND(CAN_MODULE)
 
 extern SemaphoreHandle_t CO_EMCY_mtx;
 /** Lock critical section in CO_errorReport() or CO_errorReset() */
-static inline void CO_LOCK_EMCY(void) { (void)xSemaphoreTake(CO_EMCY_mtx, portMAX_DELAY); }
+#define CO_LOCK_EMCY(CAN_MODULE) ((void)(CAN_MODULE), (void)xSemaphoreTake(CO_EMCY_mtx, portMAX_DELAY))
 /** Unlock critical section in CO_errorReport() or CO_errorReset() */
-static inline void CO_UNLOCK_EMCY(void) { (void)xSemaphoreGive(CO_EMCY_mtx); }
+#define CO_UNLOCK_EMCY(CAN_MODULE) ((void)(CAN_MODULE), (void)xSemaphoreGive(CO_EMCY_mtx))
 
 extern SemaphoreHandle_t CO_OD_mtx;
 /** Lock critical section when accessing Object Dictionary */
-static inline void CO_LOCK_OD(void) { (void)xSemaphoreTake(CO_OD_mtx, portMAX_DELAY); }
+#define CO_LOCK_OD(CAN_MODULE) ((void)(CAN_MODULE), (void)xSemaphoreTake(CO_OD_mtx, portMAX_DELAY))
 /** Unock critical section when accessing Object Dictionary */
-static inline void CO_UNLOCK_OD(void) { (void)xSemaphoreGive(CO_OD_mtx); }
+#define CO_UNLOCK_OD(CAN_MODULE) ((void)(CAN_MODULE), (void)xSemaphoreGive(CO_OD_mtx))
+/** Begin reading Object Dictionary, takes lock */
+#define CO_OD_READ_BEGIN(CAN_MODULE) (CO_LOCK_OD(CAN_MODULE), (uint32_t)0)
+/** End reading Object Dictionary, releases lock. Never needs a retry. */
+#define CO_OD_READ_RETRY(CAN_MODULE, seq) ((void)(seq), CO_UNLOCK_OD(CAN_MODULE), false)
+/** Driver provides CO_OD_READ_BEGIN() and CO_OD_READ_RETRY() */
+#define CO_OD_READ_SEQUENCE
 /** @} */
 
 /**
@@ -43,11 +43,14 @@
  * to do so, delete this exception statement from your version.
  */
 
+#include <string.h>
+
 #include "os/freertos/include/FreeRTOS.h"
 #include "os/freertos/include/task.h"
 
 #include "CO_driver.h"
 #include "CANopen.h"
+#include "CO_freertos_threads.h"
 
 /* Mainline thread (threadMain) ***************************************************/
 static struct
@@ -61,8 +64,9 @@ static struct
 /**
  * This function resumes the main thread after an SDO event happened
  */
-static void threadMain_resumeCallback(void)
+static void threadMain_resumeCallback(void *object)
 {
+  (void)object;
   if (threadMain.id != 0) {
     xTaskAbortDelay(threadMain.id);
   }
@@ -74,8 +78,8 @@ void threadMain_init(uint16_t interval, TaskHandle_t threadMainID)
   threadMain.interval_next = 1; /* do not block the first time. 0 is not allowed by the OS */
   threadMain.interval_start = xTaskGetTickCount();
   threadMain.id = threadMainID;
-  CO_SDO_initCallback(CO->SDO[0], threadMain_resumeCallback);
-  CO_EM_initCallback(CO->em, threadMain_resumeCallback);
+  CO_SDO_initCallback(CO->SDO[0], NULL, threadMain_resumeCallback);
+  CO_EM_initCallback(CO->em, NULL, threadMain_resumeCallback);
 }
 
 void threadMain_close(void)
@@ -119,12 +123,34 @@ void threadMain_process(CO_NMT_reset_cmd_t *reset)
 static struct {
   int16_t interval;          /* max timer interval */
   TickType_t interval_time;  /* time value CO_process() was called last time */
+  CANrx_threadTmr_stats_t stats; /* written by realtime thread only */
+  bool_t statsReset;         /* reset of statistics requested */
 } threadRT;
 
+/* Add value to log-scale histogram. Realtime thread is the only writer,
+ * readers use atomic loads. */
+static void CANrx_threadTmr_record(CANrx_threadTmr_histogram_t *histogram, TickType_t ticks)
+{
+  uint32_t us;
+  uint32_t bin;
+
+  us = ticks * portTICK_PERIOD_MS * 1000;
+  bin = (us < 2) ? 0 : 31 - __builtin_clz(us);
+  if (bin >= CANRX_THREADTMR_HISTOGRAM_BINS) {
+    bin = CANRX_THREADTMR_HISTOGRAM_BINS - 1;
+  }
+  __atomic_store_n(&histogram->bins[bin], histogram->bins[bin] + 1, __ATOMIC_RELAXED);
+  if (us > histogram->max_us) {
+    __atomic_store_n(&histogram->max_us, us, __ATOMIC_RELAXED);
+  }
+}
+
 void CANrx_threadTmr_init(uint16_t interval)
 {
   threadRT.interval = interval;
   threadRT.interval_time = xTaskGetTickCount(); /* Processing is due now */
+  memset(&threadRT.stats, 0, sizeof(threadRT.stats));
+  threadRT.statsReset = false;
 }
 
 void CANrx_threadTmr_close(void)
@@ -137,6 +163,9 @@ void CANrx_threadTmr_process(void)
   int16_t timeout;
   uint32_t us_interval;
   TickType_t now;
+  TickType_t start;
+  TickType_t late;
+  TickType_t skipped;
   bool_t syncWas;
   CO_ReturnError_t result;
 
@@ -154,24 +183,57 @@ void CANrx_threadTmr_process(void)
   result = CO_CANrxWait(CO->CANmodule[0], timeout);
   switch (result) {
     case CO_ERROR_TIMEOUT:
-      CO_LOCK_OD();
+      start = xTaskGetTickCount();
+      if (__atomic_exchange_n(&threadRT.statsReset, false, __ATOMIC_ACQUIRE)) {
+        memset(&threadRT.stats, 0, sizeof(threadRT.stats));
+      }
+
+      /* Each call does one regular pass. After a stall, all but
+       * CANRX_THREADTMR_MAX_BURST overdue intervals are covered by one
+       * catch-up step, so no burst of passes and no TPDO storm follows. */
+      skipped = (start - threadRT.interval_time) / (TickType_t)threadRT.interval;
+      skipped = (skipped > CANRX_THREADTMR_MAX_BURST) ? skipped - CANRX_THREADTMR_MAX_BURST : 0;
+      us_interval = threadRT.interval * 1000;
+
+      CO_LOCK_OD(CO->CANmodule[0]);
 
       if(CO->CANmodule[0]->CANnormal == true) {
 
-        us_interval = threadRT.interval * 1000;
+        if (skipped > 0) {
+          CO_process_catchUp(CO, skipped * us_interval);
+        }
 
         /* Process Sync and read inputs */
-        syncWas = CO_process_SYNC_RPDO(CO, us_interval);
+        syncWas = CO_process_SYNC_RPDO(CO, us_interval, NULL);
 
         /* Write outputs */
-        CO_process_TPDO(CO, syncWas, us_interval);
+        CO_process_TPDO(CO, syncWas, us_interval, NULL);
+      }
+
+      CO_UNLOCK_OD(CO->CANmodule[0]);
+
+      /* start of processing after due time, processing time */
+      late = start - threadRT.interval_time;
+      late = (late > (TickType_t)threadRT.interval) ? late - threadRT.interval : 0;
+      CANrx_threadTmr_record(&threadRT.stats.latency, late);
+      CANrx_threadTmr_record(&threadRT.stats.processing, xTaskGetTickCount() - start);
+      __atomic_store_n(&threadRT.stats.cycles, threadRT.stats.cycles + 1,
+                       __ATOMIC_RELAXED);
+      if (late >= (TickType_t)threadRT.interval) {
+        __atomic_store_n(&threadRT.stats.overruns, threadRT.stats.overruns + 1,
+                         __ATOMIC_RELAXED);
       }
 
-      CO_UNLOCK_OD();
+      if (skipped > 0) {
+        __atomic_store_n(&threadRT.stats.catchUps, threadRT.stats.catchUps + 1,
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&threadRT.stats.skipped, threadRT.stats.skipped + skipped,
+                         __ATOMIC_RELAXED);
+      }
 
       /* Calculate time of next execution. This ist done by adding interval to
        * now */
-      threadRT.interval_time = threadRT.interval_time + threadRT.interval;
+      threadRT.interval_time = threadRT.interval_time + (skipped + 1) * threadRT.interval;
       break;
     case CO_ERROR_NO:
     default:
@@ -180,6 +242,29 @@ void CANrx_threadTmr_process(void)
   }
 }
 
+void CANrx_threadTmr_wakeup(void)
+{
+  /* periodic thread detects Change of State with next interval */
+}
+
+void CANrx_threadTmr_getStats(CANrx_threadTmr_stats_t *stats)
+{
+  uint32_t *dst = (uint32_t*)stats;
+  uint32_t *src = (uint32_t*)&threadRT.stats;
+  size_t i;
+
+  /* only 32 bit members, each is consistent */
+  for (i = 0; i < sizeof(*stats) / sizeof(uint32_t); i++) {
+    dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+  }
+}
+
+void CANrx_threadTmr_resetStats(void)
+{
+  /* done by realtime thread with next cycle */
+  __atomic_store_n(&threadRT.statsReset, true, __ATOMIC_RELEASE);
+}
+
 /**
  * @}
  **/
@@ -56,6 +56,39 @@ extern "C" {
  * Like the CO socketCAN driver implementation, this driver uses the global CO
  * object and has one thread-local struct for variables. */
 
+/** Maximum number of regular SYNC/RPDO/TPDO passes in one cycle of the
+ * realtime thread. If more intervals are overdue, the excess ones are covered
+ * by one #CO_process_catchUp() step. */
+#ifndef CANRX_THREADTMR_MAX_BURST
+#define CANRX_THREADTMR_MAX_BURST 4
+#endif
+
+/** Number of histogram bins. Bin 0 counts values below 2us, bin i values from
+ * 2^i to 2^(i+1)-1 us, the last bin all larger values. */
+#define CANRX_THREADTMR_HISTOGRAM_BINS 16
+
+/**
+ * Log-scale histogram of a time in us
+ */
+typedef struct {
+  uint32_t bins[CANRX_THREADTMR_HISTOGRAM_BINS]; /**< number of values per bin */
+  uint32_t max_us;         /**< largest value */
+} CANrx_threadTmr_histogram_t;
+
+/**
+ * Cycle statistics of realtime thread, see #CANrx_threadTmr_getStats(). Times
+ * have tick resolution.
+ */
+typedef struct {
+  CANrx_threadTmr_histogram_t latency;    /**< start of processing after due time */
+  CANrx_threadTmr_histogram_t processing; /**< time for SYNC, RPDO and TPDO processing */
+  uint32_t cycles;         /**< number of processing cycles */
+  uint32_t overruns;       /**< cycles started one interval or more too late */
+  uint32_t catchUps;       /**< cycles with a catch-up step */
+  uint32_t skipped;        /**< intervals covered by catch-up steps instead of
+                                regular passes */
+} CANrx_threadTmr_stats_t;
+
 /**
  * Initialize mainline thread.
  *
@@ -110,6 +143,30 @@ extern void CANrx_threadTmr_close(void);
  */
 extern void CANrx_threadTmr_process(void);
 
+/**
+ * Request a processing pass of the realtime thread.
+ *
+ * Same interface as the Linux port, where a tickless realtime thread must be
+ * woken after the application wrote OD variables mapped to TPDOs. This thread
+ * processes every interval, so nothing is done.
+ */
+extern void CANrx_threadTmr_wakeup(void);
+
+/**
+ * Get cycle statistics of realtime thread. May be called from any thread, it
+ * doesn't block the realtime thread. Counters are read one by one, so they may
+ * be from different cycles.
+ *
+ * @param [out] stats statistics since init or last reset
+ */
+extern void CANrx_threadTmr_getStats(CANrx_threadTmr_stats_t *stats);
+
+/**
+ * Reset cycle statistics of realtime thread. Done by the realtime thread at
+ * the beginning of the next cycle.
+ */
+extern void CANrx_threadTmr_resetStats(void);
+
 /**
  * Disable CAN receive thread temporary.
  *
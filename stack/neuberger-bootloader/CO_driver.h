@@ -166,17 +166,22 @@
  * After presence of SYNC message on CANopen bus, CANrx should be temporary
  * disabled until all receive PDOs are processed. See also CO_SYNC.h file and
  * CO_SYNC_initCallback() function.
+ *
+ * ####CAN module argument.
+ * All macros get the CAN module (CO_CANmodule_t *), whose objects are
+ * protected. Drivers, which run more CANopen objects in one program, may
+ * keep mutexes in the CAN module. Others may ignore the argument.
  * @{
  */
     /* no multi-threding and no interrupts inside bootloader */
-    #define CO_LOCK_CAN_SEND()  /**< Lock critical section in CO_CANsend() */
-    #define CO_UNLOCK_CAN_SEND()/**< Unlock critical section in CO_CANsend() */
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) /**< Lock critical section in CO_CANsend() */
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE) /**< Unlock critical section in CO_CANsend() */
 
-    #define CO_LOCK_EMCY()      /**< Lock critical section in CO_errorReport() or CO_errorReset() */
-    #define CO_UNLOCK_EMCY()    /**< Unlock critical section in CO_errorReport() or CO_errorReset() */
+    #define CO_LOCK_EMCY(CAN_MODULE) /**< Lock critical section in CO_errorReport() or CO_errorReset() */
+    #define CO_UNLOCK_EMCY(CAN_MODULE) /**< Unlock critical section in CO_errorReport() or CO_errorReset() */
 
-    #define CO_LOCK_OD()        /**< Lock critical section when accessing Object Dictionary */
-    #define CO_UNLOCK_OD()      /**< Unock critical section when accessing Object Dictionary */
+    #define CO_LOCK_OD(CAN_MODULE) /**< Lock critical section when accessing Object Dictionary */
+    #define CO_UNLOCK_OD(CAN_MODULE) /**< Unock critical section when accessing Object Dictionary */
 /** @} */
 
 /**
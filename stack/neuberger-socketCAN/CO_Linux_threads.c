@@ -43,12 +43,31 @@
  * to do so, delete this exception statement from your version.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* for CPU_SET() */
+#endif
+
 #include <sys/timerfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <malloc.h>
+#include <alloca.h>
 
 #include "CO_driver.h"
 #include "CANopen.h"
+#include "CO_Linux_threads.h"
+
+#if defined CO_DRIVER_ERROR_REPORTING && __has_include("syslog/log.h")
+  #include "syslog/log.h"
+  #include "msgs.h"
+#else
+  #define log_printf(macropar_prio, macropar_message, ...)
+#endif
 
 /* Helper function - get monotonic clock time in ms */
 static uint64_t CO_LinuxThreads_clock_gettime_ms(void)
@@ -59,127 +78,678 @@ static uint64_t CO_LinuxThreads_clock_gettime_ms(void)
   return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 }
 
-/* Mainline thread (threadMain) ***************************************************/
-static struct
+/* Realtime properties ************************************************************/
+
+/* struct sched_attr from linux/sched/types.h, which conflicts with sched.h */
+struct CO_LinuxThreads_schedAttr {
+  uint32_t size;
+  uint32_t sched_policy;
+  uint64_t sched_flags;
+  int32_t  sched_nice;
+  uint32_t sched_priority;
+  uint64_t sched_runtime;
+  uint64_t sched_deadline;
+  uint64_t sched_period;
+};
+
+/* Read locked memory of process from /proc, in KiB */
+static uint64_t CO_LinuxThreads_lockedKiB(void)
 {
-  uint64_t  start;                  /* time value CO_process() was called last time in ms */
-  void    (*pFunct)(void* object);  /* Callback function */
-  void     *object;
-} threadMain;
+  FILE *f;
+  char line[128];
+  unsigned long long kib = 0;
+
+  f = fopen("/proc/self/status", "r");
+  if (f == NULL) {
+    return 0;
+  }
+  while (fgets(line, sizeof(line), f) != NULL) {
+    if (sscanf(line, "VmLck: %llu kB", &kib) == 1) {
+      break;
+    }
+  }
+  (void)fclose(f);
+  return kib;
+}
+
+/* Touch stack pages, so they are mapped (and locked) before realtime work */
+static void CO_LinuxThreads_prefaultStack(size_t size)
+{
+  volatile uint8_t *stack = alloca(size);
+  size_t i;
+
+  for (i = 0; i < size; i += 4096) {
+    stack[i] = 0;
+  }
+}
+
+CO_ReturnError_t CO_LinuxThreads_setRealtime(
+        const CO_LinuxThreads_rtConfig_t *config,
+        CO_LinuxThreads_rtCheck_t *check)
+{
+  struct CO_LinuxThreads_schedAttr attr;
+  CO_LinuxThreads_rtCheck_t result;
+  cpu_set_t cpus;
+
+  if ((config == NULL) ||
+      ((config->policy != SCHED_OTHER) && (config->policy != SCHED_FIFO) &&
+       (config->policy != SCHED_DEADLINE)) ||
+      ((config->policy == SCHED_FIFO) &&
+       ((config->priority < 1) || (config->priority > 99))) ||
+      ((config->cpu < -1) || (config->cpu >= CPU_SETSIZE)) ||
+      /* kernel refuses SCHED_DEADLINE for threads with narrowed affinity (EPERM) */
+      ((config->policy == SCHED_DEADLINE) && (config->cpu >= 0))) {
+    return CO_ERROR_ILLEGAL_ARGUMENT;
+  }
+
+  /* memory first, so the following steps don't fault later */
+  if (config->lockMemory) {
+    /* freed memory stays mapped, malloc() doesn't use mmap() */
+    (void)mallopt(M_TRIM_THRESHOLD, -1);
+    (void)mallopt(M_MMAP_MAX, 0);
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+      log_printf(LOG_DEBUG, DBG_ERRNO, "mlockall()");
+    }
+  }
+  if (config->stackPrefault > 0) {
+    CO_LinuxThreads_prefaultStack(config->stackPrefault);
+  }
+
+  /* affinity before policy, so the thread never runs with realtime priority
+   * on another CPU */
+  if (config->cpu >= 0) {
+    CPU_ZERO(&cpus);
+    CPU_SET(config->cpu, &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) < 0) {
+      log_printf(LOG_DEBUG, DBG_ERRNO, "sched_setaffinity()");
+    }
+  }
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.sched_policy = config->policy;
+  if (config->policy == SCHED_FIFO) {
+    attr.sched_priority = config->priority;
+  }
+  else if (config->policy == SCHED_DEADLINE) {
+    attr.sched_runtime = config->runtime_ns;
+    attr.sched_deadline = config->deadline_ns;
+    attr.sched_period = config->period_ns;
+  }
+  if (syscall(SYS_sched_setattr, 0, &attr, 0) < 0) {
+    log_printf(LOG_DEBUG, DBG_ERRNO, "sched_setattr()");
+  }
+
+  /* self check, read back what the kernel granted */
+  memset(&result, 0, sizeof(result));
+  memset(&attr, 0, sizeof(attr));
+  if (syscall(SYS_sched_getattr, 0, &attr, sizeof(attr), 0) == 0) {
+    result.policy = attr.sched_policy;
+    result.priority = attr.sched_priority;
+    result.policyGranted = (attr.sched_policy == (uint32_t)config->policy);
+    if (config->policy == SCHED_FIFO) {
+      result.policyGranted = result.policyGranted &&
+                             (attr.sched_priority == (uint32_t)config->priority);
+    }
+    else if (config->policy == SCHED_DEADLINE) {
+      result.policyGranted = result.policyGranted &&
+                             (attr.sched_runtime == config->runtime_ns) &&
+                             (attr.sched_deadline == config->deadline_ns) &&
+                             (attr.sched_period == config->period_ns);
+    }
+  }
+  result.affinityGranted = true;
+  if (config->cpu >= 0) {
+    result.affinityGranted =
+      (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) &&
+      (CPU_COUNT(&cpus) == 1) && CPU_ISSET(config->cpu, &cpus);
+  }
+  result.lockedKiB = CO_LinuxThreads_lockedKiB();
+  result.memoryLocked = !config->lockMemory || (result.lockedKiB > 0);
+
+  if (check != NULL) {
+    *check = result;
+  }
+  if (!result.policyGranted || !result.affinityGranted || !result.memoryLocked) {
+    return CO_ERROR_SYSCALL;
+  }
+  return CO_ERROR_NO;
+}
+
+/* Mainline thread (threadMain) ***************************************************/
+
+/* Threads of the global CANopen object, for functions without CO_LinuxThreads_t argument */
+static CO_LinuxThreads_t CO_LinuxThreads_global;
 
 /**
  * This function notifies the user application after an event happened
  *
- * This is necessary because not all stack callbacks support object pointers.
- * It is not used for those callbacks that have this pointer!
+ * Notifications are coalesced: the application callback is only called if
+ * the previous one was already followed by CO_LinuxThreads_mainProcess(). Each
+ * notification is counted by its source.
  */
-static void threadMain_resumeCallback(void)
+static void threadMain_resumeCallback(CO_LinuxThreads_t *threads,
+                                      CO_NotifySource_t source)
 {
-  if (threadMain.pFunct != NULL) {
-    threadMain.pFunct(threadMain.object);
+  __atomic_fetch_add(&threads->main.notifyStats.signals[source], 1, __ATOMIC_RELAXED);
+  if (__atomic_exchange_n(&threads->main.pending, true, __ATOMIC_ACQ_REL)) {
+    __atomic_fetch_add(&threads->main.notifyStats.coalesced, 1, __ATOMIC_RELAXED);
+    return;
   }
+  __atomic_fetch_add(&threads->main.notifyStats.notified, 1, __ATOMIC_RELAXED);
+  if (threads->main.pFunct != NULL) {
+    threads->main.pFunct(threads->main.object);
+  }
+}
+
+/* Stack callbacks get the threads object, one per source */
+static void threadMain_resumeSDOserver(void *object)
+{
+  threadMain_resumeCallback((CO_LinuxThreads_t*)object, CO_NOTIFY_SOURCE_SDO_SERVER);
 }
 
+static void threadMain_resumeEMCY(void *object)
+{
+  threadMain_resumeCallback((CO_LinuxThreads_t*)object, CO_NOTIFY_SOURCE_EMCY);
+}
+
+#if CO_NO_LSS_CLIENT == 1
+static void threadMain_resumeLSS(void *object)
+{
+  threadMain_resumeCallback((CO_LinuxThreads_t*)object, CO_NOTIFY_SOURCE_LSS);
+}
+#endif
+
+#if CO_DAISY_CONSUMER == 1
+static void threadMain_resumeDaisy(void *object)
+{
+  threadMain_resumeCallback((CO_LinuxThreads_t*)object, CO_NOTIFY_SOURCE_DAISY);
+}
+#endif
+
+#if CO_NO_SDO_CLIENT != 0
+static void threadMain_resumeSDOclient(void *object)
+{
+  threadMain_resumeCallback((CO_LinuxThreads_t*)object, CO_NOTIFY_SOURCE_SDO_CLIENT);
+}
+#endif
+
 void threadMain_init(void (*callback)(void*), void *object)
 {
-  threadMain.start = CO_LinuxThreads_clock_gettime_ms();
-  threadMain.pFunct = callback;
-  threadMain.object = object;
+  CO_LinuxThreads_mainInit(&CO_LinuxThreads_global, CO, callback, object);
+}
+
+void CO_LinuxThreads_mainInit(CO_LinuxThreads_t *threads, CO_t *CO,
+                              void (*callback)(void*), void *object)
+{
+  threads->CO = CO;
+  threads->main.start = CO_LinuxThreads_clock_gettime_ms();
+#ifdef CO_DRIVER_TICKLESS
+  threads->main.deadline = threads->main.start;
+#endif
+  threads->main.pFunct = callback;
+  threads->main.object = object;
+  threads->main.pending = false;
+  memset(&threads->main.notifyStats, 0, sizeof(threads->main.notifyStats));
 
-  CO_SDO_initCallback(CO->SDO[0], threadMain_resumeCallback);
-  CO_EM_initCallback(CO->em, threadMain_resumeCallback);
+  CO_SDO_initCallback(CO->SDO[0], threads, threadMain_resumeSDOserver);
+  CO_EM_initCallback(CO->em, threads, threadMain_resumeEMCY);
 #if CO_NO_LSS_CLIENT == 1
-  CO_LSSmaster_initCallback(CO->LSSmaster, threadMain.object, threadMain.pFunct);
+  CO_LSSmaster_initCallback(CO->LSSmaster, threads, threadMain_resumeLSS);
 #endif
 #if CO_DAISY_CONSUMER == 1
-  CO_DaisyConsumer_initCallback(CO->DaisyConsumer, threadMain.object, threadMain.pFunct);
+  CO_DaisyConsumer_initCallback(CO->DaisyConsumer, threads, threadMain_resumeDaisy);
 #endif
 #if CO_NO_SDO_CLIENT != 0
   for (int i = 0; i < CO_NO_SDO_CLIENT; i++) {
-    CO_SDOclient_initCallback(CO->SDOclient[i], threadMain_resumeCallback);
+    CO_SDOclient_initCallback(CO->SDOclient[i], threads, threadMain_resumeSDOclient);
   }
 #endif
 }
 
 void threadMain_close(void)
 {
-  threadMain.pFunct = NULL;
-  threadMain.object = NULL;
+  CO_LinuxThreads_mainClose(&CO_LinuxThreads_global);
+}
+
+void CO_LinuxThreads_mainClose(CO_LinuxThreads_t *threads)
+{
+  threads->main.pFunct = NULL;
+  threads->main.object = NULL;
 }
 
 void threadMain_process(CO_NMT_reset_cmd_t *reset)
+{
+  CO_LinuxThreads_mainProcess(&CO_LinuxThreads_global, reset);
+}
+
+void CO_LinuxThreads_mainProcess(CO_LinuxThreads_t *threads, CO_NMT_reset_cmd_t *reset)
 {
   uint16_t finished;
   uint16_t diff;
   uint64_t now;
+#ifdef CO_DRIVER_TICKLESS
+  uint64_t deadline;
+#endif
+
+  /* events from here on notify the application again */
+  if (__atomic_exchange_n(&threads->main.pending, false, __ATOMIC_ACQ_REL)) {
+    __atomic_fetch_add(&threads->main.notifyStats.wakeups, 1, __ATOMIC_RELAXED);
+  }
 
   now = CO_LinuxThreads_clock_gettime_ms();
-  diff = (uint16_t)(now - threadMain.start);
+  diff = (uint16_t)(now - threads->main.start);
+
+#ifdef CO_DRIVER_TICKLESS
+  /* timerNext_ms of CO_process() is 0 as long as processing isn't finished,
+   * then it is the time to the next deadline. The realtime thread calls the
+   * callback when it is reached. */
+  do {
+    finished = UINT16_MAX;
+    *reset = CO_process(threads->CO, diff, &finished);
+    diff = 0;
+  } while ((*reset == CO_RESET_NOT) && (finished == 0));
 
+  /* NMT state or OD variables mapped to TPDOs may have changed, the realtime
+   * thread doesn't poll for that. This also rearms its timer. */
+  deadline = now + finished;
+  __atomic_store_n(&threads->main.deadline, deadline, __ATOMIC_RELAXED);
+  CO_LinuxThreads_rtWakeup(threads);
+#else
   /* we use timerNext_ms in CO_process() as indication if processing is
    * finished. We ignore any calculated values for maximum delay times. */
   do {
     finished = 1;
-    *reset = CO_process(CO, diff, &finished);
+    *reset = CO_process(threads->CO, diff, &finished);
     diff = 0;
   } while ((*reset == CO_RESET_NOT) && (finished == 0));
+#endif
 
   /* prepare next call */
-  threadMain.start = now;
+  threads->main.start = now;
+}
+
+void threadMain_getNotifyStats(CO_NotifyStats_t *stats)
+{
+  CO_LinuxThreads_mainGetNotifyStats(&CO_LinuxThreads_global, stats);
+}
+
+void CO_LinuxThreads_mainGetNotifyStats(CO_LinuxThreads_t *threads, CO_NotifyStats_t *stats)
+{
+  for (int i = 0; i < CO_NOTIFY_SOURCE_COUNT; i++) {
+    stats->signals[i] = __atomic_load_n(&threads->main.notifyStats.signals[i], __ATOMIC_RELAXED);
+  }
+  stats->notified = __atomic_load_n(&threads->main.notifyStats.notified, __ATOMIC_RELAXED);
+  stats->coalesced = __atomic_load_n(&threads->main.notifyStats.coalesced, __ATOMIC_RELAXED);
+  stats->wakeups = __atomic_load_n(&threads->main.notifyStats.wakeups, __ATOMIC_RELAXED);
+}
+
+void threadMain_resetNotifyStats(void)
+{
+  CO_LinuxThreads_mainResetNotifyStats(&CO_LinuxThreads_global);
+}
+
+void CO_LinuxThreads_mainResetNotifyStats(CO_LinuxThreads_t *threads)
+{
+  for (int i = 0; i < CO_NOTIFY_SOURCE_COUNT; i++) {
+    __atomic_store_n(&threads->main.notifyStats.signals[i], 0, __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&threads->main.notifyStats.notified, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&threads->main.notifyStats.coalesced, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&threads->main.notifyStats.wakeups, 0, __ATOMIC_RELAXED);
 }
 
 /* Realtime thread (threadRT) *****************************************************/
-static struct {
-  uint32_t us_interval;         /* configured interval in us */
-  int interval_fd;              /* timer fd */
-} threadRT;
+
+/* Add timespan in us to timespec */
+static void CO_LinuxThreads_timespecAdd(struct timespec *ts, uint64_t us)
+{
+  uint64_t ns = ts->tv_nsec + (us % 1000000) * 1000;
+
+  ts->tv_sec += us / 1000000 + ns / 1000000000;
+  ts->tv_nsec = ns % 1000000000;
+}
+
+/* Time from _start_ to _end_ in us, 0 if negative */
+static uint32_t CO_LinuxThreads_timespecDiff_us(const struct timespec *start,
+                                                const struct timespec *end)
+{
+  int64_t us = (int64_t)(end->tv_sec - start->tv_sec) * 1000000 +
+               (end->tv_nsec - start->tv_nsec) / 1000;
+
+  if (us < 0) {
+    return 0;
+  }
+  return (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+/* Add value to log-scale histogram. Realtime thread is the only writer,
+ * readers use atomic loads. */
+static void CANrx_threadTmr_record(CANrx_threadTmr_histogram_t *histogram, uint32_t us)
+{
+  uint32_t bin;
+
+  bin = (us < 2) ? 0 : 31 - __builtin_clz(us);
+  if (bin >= CANRX_THREADTMR_HISTOGRAM_BINS) {
+    bin = CANRX_THREADTMR_HISTOGRAM_BINS - 1;
+  }
+  __atomic_store_n(&histogram->bins[bin], histogram->bins[bin] + 1, __ATOMIC_RELAXED);
+  if (us > histogram->max_us) {
+    __atomic_store_n(&histogram->max_us, us, __ATOMIC_RELAXED);
+  }
+}
+
+#ifdef CO_DRIVER_TICKLESS
+/* Sum of received messages of all interfaces */
+static uint32_t CANrx_threadTmr_rxFrames(CO_LinuxThreads_t *threads)
+{
+  uint32_t i;
+  uint32_t rxFrames = 0;
+
+  for (i = 0; i < threads->CO->CANmodule[0]->CANinterfaceCount; i++) {
+    rxFrames += threads->CO->CANmodule[0]->CANinterfaces[i].rxFrames;
+  }
+  return rxFrames;
+}
+
+/* Compare timespecs */
+static bool_t CO_LinuxThreads_timespecBefore(const struct timespec *a,
+                                             const struct timespec *b)
+{
+  return (a->tv_sec < b->tv_sec) ||
+         ((a->tv_sec == b->tv_sec) && (a->tv_nsec < b->tv_nsec));
+}
+#endif
 
 void CANrx_threadTmr_init(uint16_t interval)
+{
+  CO_LinuxThreads_rtInit(&CO_LinuxThreads_global, CO, interval);
+}
+
+void CO_LinuxThreads_rtInit(CO_LinuxThreads_t *threads, CO_t *CO, uint16_t interval)
 {
   struct itimerspec itval;
 
-  threadRT.us_interval = interval * 1000;
-  /* set up non-blocking interval timer */
-  threadRT.interval_fd = timerfd_create(CLOCK_MONOTONIC, 0);
-  (void)fcntl(threadRT.interval_fd, F_SETFL, O_NONBLOCK);
+  threads->CO = CO;
+  threads->rt.us_interval = interval * 1000;
+  memset(&threads->rt.stats, 0, sizeof(threads->rt.stats));
+  threads->rt.statsReset = false;
+  /* set up non-blocking interval timer. Start time is absolute, so the time
+   * of each expiration is known. */
+  threads->rt.interval_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+  (void)fcntl(threads->rt.interval_fd, F_SETFL, O_NONBLOCK);
+  (void)clock_gettime(CLOCK_MONOTONIC, &threads->rt.expected);
   itval.it_interval.tv_sec = 0;
   itval.it_interval.tv_nsec = interval * 1000000;
-  itval.it_value = itval.it_interval;
-  (void)timerfd_settime(threadRT.interval_fd, 0, &itval, NULL);
+  itval.it_value = threads->rt.expected;
+  CO_LinuxThreads_timespecAdd(&itval.it_value, threads->rt.us_interval);
+#ifdef CO_DRIVER_TICKLESS
+  /* one shot timer, first pass after one interval */
+  itval.it_interval.tv_nsec = 0;
+  threads->rt.lastPass = threads->rt.expected;
+  threads->rt.passDeadline = itval.it_value;
+  threads->rt.armed = itval.it_value;
+  threads->rt.rxFrames = CANrx_threadTmr_rxFrames(threads);
+  threads->rt.requested = false;
+  threads->rt.rxPending = false;
+  threads->rt.wakeup = false;
+#endif
+  (void)timerfd_settime(threads->rt.interval_fd, TFD_TIMER_ABSTIME, &itval, NULL);
 }
 
 void CANrx_threadTmr_close(void)
 {
-  (void)close(threadRT.interval_fd);
-  threadRT.interval_fd = -1;
+  CO_LinuxThreads_rtClose(&CO_LinuxThreads_global);
 }
 
-void CANrx_threadTmr_process(void)
+void CO_LinuxThreads_rtClose(CO_LinuxThreads_t *threads)
+{
+  (void)close(threads->rt.interval_fd);
+  threads->rt.interval_fd = -1;
+}
+
+#ifdef CO_DRIVER_TICKLESS
+void CO_LinuxThreads_rtProcess(CO_LinuxThreads_t *threads)
+{
+  bool_t due;
+  bool_t syncWas;
+  uint32_t rxFrames;
+  uint32_t elapsed_us;
+  uint32_t timerNext_us = UINT32_MAX;
+  uint64_t mainDeadline;
+  uint64_t now_ms;
+  struct timespec now;
+  struct timespec end;
+  struct timespec next;
+  struct itimerspec itval;
+
+  if (CO_CANrxWait(threads->CO->CANmodule[0], threads->rt.interval_fd, NULL) < 0) {
+    if (CO_CANrxTimerRead(threads->CO->CANmodule[0], threads->rt.interval_fd) > 0) {
+      /* one shot timer expired, must be armed again */
+      threads->rt.armed.tv_sec = 0;
+      threads->rt.armed.tv_nsec = 0;
+    }
+  }
+  (void)clock_gettime(CLOCK_MONOTONIC, &now);
+
+  /* received messages and the application request a pass */
+  rxFrames = CANrx_threadTmr_rxFrames(threads);
+  if (rxFrames != threads->rt.rxFrames) {
+    threads->rt.rxFrames = rxFrames;
+    threads->rt.rxPending = true;
+    threads->rt.requested = true;
+  }
+  if (__atomic_exchange_n(&threads->rt.wakeup, false, __ATOMIC_ACQUIRE)) {
+    threads->rt.requested = true;
+  }
+
+  /* mainline thread is due, notify it once */
+  now_ms = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+  mainDeadline = __atomic_load_n(&threads->main.deadline, __ATOMIC_RELAXED);
+  if ((now_ms >= mainDeadline) &&
+      __atomic_compare_exchange_n(&threads->main.deadline, &mainDeadline, UINT64_MAX,
+                                  false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    threadMain_resumeCallback(threads, CO_NOTIFY_SOURCE_DEADLINE);
+  }
+
+  /* processing pass, at most one per interval */
+  due = !CO_LinuxThreads_timespecBefore(&now, &threads->rt.passDeadline);
+  elapsed_us = CO_LinuxThreads_timespecDiff_us(&threads->rt.lastPass, &now);
+  if ((due || threads->rt.requested) && (elapsed_us >= threads->rt.us_interval)) {
+    if (__atomic_exchange_n(&threads->rt.statsReset, false, __ATOMIC_ACQUIRE)) {
+      memset(&threads->rt.stats, 0, sizeof(threads->rt.stats));
+    }
+
+    CO_LOCK_OD(threads->CO->CANmodule[0]);
+#ifdef CO_DRIVER_TX_BATCH
+    CO_CANtxBatchBegin(threads->CO->CANmodule[0]);
+#endif
+
+    if(threads->CO->CANmodule[0]->CANnormal == true) {
+      /* advance timers first, so everything due now is sent in this pass */
+      CO_process_catchUp(threads->CO, elapsed_us);
+
+      /* Process Sync and read inputs */
+      syncWas = CO_process_SYNC_RPDO(threads->CO, 0, &timerNext_us);
+
+      /* Write outputs */
+      CO_process_TPDO(threads->CO, syncWas, 0, &timerNext_us);
+    }
+
+    CO_UNLOCK_OD(threads->CO->CANmodule[0]);
+#ifdef CO_DRIVER_TX_BATCH
+    CO_CANtxBatchFlush(threads->CO->CANmodule[0]);
+#endif
+
+    /* latency only for passes started by the timer */
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    if (due) {
+      CANrx_threadTmr_record(&threads->rt.stats.latency,
+                             CO_LinuxThreads_timespecDiff_us(&threads->rt.passDeadline, &now));
+    }
+    CANrx_threadTmr_record(&threads->rt.stats.processing,
+                           CO_LinuxThreads_timespecDiff_us(&now, &end));
+    __atomic_store_n(&threads->rt.stats.cycles, threads->rt.stats.cycles + 1,
+                     __ATOMIC_RELAXED);
+
+    if (threads->rt.rxPending) {
+      /* messages may be for objects of mainline thread */
+      threadMain_resumeCallback(threads, CO_NOTIFY_SOURCE_RX);
+    }
+    threads->rt.rxPending = false;
+    threads->rt.requested = false;
+    threads->rt.lastPass = now;
+    threads->rt.passDeadline = now;
+    CO_LinuxThreads_timespecAdd(&threads->rt.passDeadline,
+                                (timerNext_us > threads->rt.us_interval) ? timerNext_us : threads->rt.us_interval);
+  }
+
+  /* arm timer for earliest deadline */
+  next = threads->rt.passDeadline;
+  if (threads->rt.requested) {
+    /* pass was limited by interval */
+    next = threads->rt.lastPass;
+    CO_LinuxThreads_timespecAdd(&next, threads->rt.us_interval);
+  }
+  mainDeadline = __atomic_load_n(&threads->main.deadline, __ATOMIC_RELAXED);
+  if (mainDeadline < (uint64_t)next.tv_sec * 1000 + next.tv_nsec / 1000000) {
+    next.tv_sec = mainDeadline / 1000;
+    next.tv_nsec = (mainDeadline % 1000) * 1000000;
+  }
+  if ((next.tv_sec != threads->rt.armed.tv_sec) || (next.tv_nsec != threads->rt.armed.tv_nsec)) {
+    threads->rt.armed = next;
+    itval.it_interval.tv_sec = 0;
+    itval.it_interval.tv_nsec = 0;
+    itval.it_value = next;
+    (void)timerfd_settime(threads->rt.interval_fd, TFD_TIMER_ABSTIME, &itval, NULL);
+  }
+}
+
+void CO_LinuxThreads_rtWakeup(CO_LinuxThreads_t *threads)
+{
+  __atomic_store_n(&threads->rt.wakeup, true, __ATOMIC_RELEASE);
+  CO_NotifyPipeSendFrom(threads->CO->CANmodule[0]->pipe, CO_NOTIFY_SOURCE_MAINLINE);
+}
+#else
+void CO_LinuxThreads_rtProcess(CO_LinuxThreads_t *threads)
 {
   int32_t result;
-  int32_t i;
+  unsigned long long i;
   bool_t syncWas;
   unsigned long long missed;
+  unsigned long long passes;
+  unsigned long long skipped = 0;
+  unsigned long long catchUp_us;
+  struct timespec start;
+  struct timespec end;
 
-  result = CO_CANrxWait(CO->CANmodule[0], threadRT.interval_fd, NULL);
+  result = CO_CANrxWait(threads->CO->CANmodule[0], threads->rt.interval_fd, NULL);
   if (result < 0) {
-    result = read(threadRT.interval_fd, &missed, sizeof(missed));
-    if (result > 0) {
+    missed = CO_CANrxTimerRead(threads->CO->CANmodule[0], threads->rt.interval_fd);
+    if (missed > 0) {
       /* at least one timer interval occured */
-      CO_LOCK_OD();
+      (void)clock_gettime(CLOCK_MONOTONIC, &start);
+      CO_LinuxThreads_timespecAdd(&threads->rt.expected, missed * threads->rt.us_interval);
+      if (__atomic_exchange_n(&threads->rt.statsReset, false, __ATOMIC_ACQUIRE)) {
+        memset(&threads->rt.stats, 0, sizeof(threads->rt.stats));
+      }
+
+      CO_LOCK_OD(threads->CO->CANmodule[0]);
+#ifdef CO_DRIVER_TX_BATCH
+      /* TPDOs are staged and sent together at the end of this cycle */
+      CO_CANtxBatchBegin(threads->CO->CANmodule[0]);
+#endif
 
-      if(CO->CANmodule[0]->CANnormal == true) {
+      if(threads->CO->CANmodule[0]->CANnormal == true) {
 
-        for (i = 0; i <= missed; i++) {
+        /* one pass per expired interval. After a stall, the excess intervals
+         * are covered by one catch-up step, so the OD lock isn't held for a
+         * long burst and no TPDO storm is sent. */
+        passes = missed;
+        if (passes > CANRX_THREADTMR_MAX_BURST) {
+          skipped = passes - CANRX_THREADTMR_MAX_BURST;
+          passes = CANRX_THREADTMR_MAX_BURST;
+          catchUp_us = skipped * threads->rt.us_interval;
+          CO_process_catchUp(threads->CO, (catchUp_us > UINT32_MAX) ? UINT32_MAX : (uint32_t)catchUp_us);
+        }
+
+        for (i = 0; i < passes; i++) {
           /* Process Sync and read inputs */
-          syncWas = CO_process_SYNC_RPDO(CO, threadRT.us_interval);
+          syncWas = CO_process_SYNC_RPDO(threads->CO, threads->rt.us_interval, NULL);
 
           /* Write outputs */
-          CO_process_TPDO(CO, syncWas, threadRT.us_interval);
+          CO_process_TPDO(threads->CO, syncWas, threads->rt.us_interval, NULL);
         }
       }
 
-      CO_UNLOCK_OD();
+      CO_UNLOCK_OD(threads->CO->CANmodule[0]);
+#ifdef CO_DRIVER_TX_BATCH
+      CO_CANtxBatchFlush(threads->CO->CANmodule[0]);
+#endif
+
+      /* wakeup latency relative to last expiration, processing time */
+      (void)clock_gettime(CLOCK_MONOTONIC, &end);
+      CANrx_threadTmr_record(&threads->rt.stats.latency,
+                             CO_LinuxThreads_timespecDiff_us(&threads->rt.expected, &start));
+      CANrx_threadTmr_record(&threads->rt.stats.processing,
+                             CO_LinuxThreads_timespecDiff_us(&start, &end));
+      __atomic_store_n(&threads->rt.stats.cycles, threads->rt.stats.cycles + 1,
+                       __ATOMIC_RELAXED);
+      __atomic_store_n(&threads->rt.stats.overruns,
+                       threads->rt.stats.overruns + (uint32_t)(missed - 1),
+                       __ATOMIC_RELAXED);
+      if (skipped > 0) {
+        __atomic_store_n(&threads->rt.stats.catchUps, threads->rt.stats.catchUps + 1,
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&threads->rt.stats.skipped,
+                         threads->rt.stats.skipped + (uint32_t)skipped,
+                         __ATOMIC_RELAXED);
+      }
     }
   }
 }
+
+void CO_LinuxThreads_rtWakeup(CO_LinuxThreads_t *threads)
+{
+  /* realtime thread runs every interval anyway */
+  (void)threads;
+}
+#endif
+
+void CANrx_threadTmr_process(void)
+{
+  CO_LinuxThreads_rtProcess(&CO_LinuxThreads_global);
+}
+
+void CANrx_threadTmr_wakeup(void)
+{
+  CO_LinuxThreads_rtWakeup(&CO_LinuxThreads_global);
+}
+
+void CANrx_threadTmr_getStats(CANrx_threadTmr_stats_t *stats)
+{
+  CO_LinuxThreads_rtGetStats(&CO_LinuxThreads_global, stats);
+}
+
+void CO_LinuxThreads_rtGetStats(CO_LinuxThreads_t *threads, CANrx_threadTmr_stats_t *stats)
+{
+  uint32_t *dst = (uint32_t*)stats;
+  uint32_t *src = (uint32_t*)&threads->rt.stats;
+  size_t i;
+
+  /* only 32 bit members, each is consistent */
+  for (i = 0; i < sizeof(*stats) / sizeof(uint32_t); i++) {
+    dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+  }
+}
+
+void CANrx_threadTmr_resetStats(void)
+{
+  CO_LinuxThreads_rtResetStats(&CO_LinuxThreads_global);
+}
+
+void CO_LinuxThreads_rtResetStats(CO_LinuxThreads_t *threads)
+{
+  /* done by realtime thread with next cycle */
+  __atomic_store_n(&threads->rt.statsReset, true, __ATOMIC_RELEASE);
+}
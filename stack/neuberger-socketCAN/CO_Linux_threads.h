@@ -50,12 +50,141 @@
 extern "C" {
 #endif
 
+#include <sched.h>
+#include <time.h>
+#include "CO_notify_pipe.h"
+
 /* This driver is loosely based upon the CO socketCAN driver
  * The "threads" inside this driver do not fork threads themselve, but require
  * that two threads are provided by the calling application.
  *
- * Like the CO socketCAN driver implementation, this driver uses the global CO
- * object and has one thread-local struct for variables. */
+ * The state of both threads of one CANopen object is kept in a
+ * #CO_LinuxThreads_t. The threadMain_xxx() and CANrx_threadTmr_xxx() functions
+ * use the global CO object and an internal #CO_LinuxThreads_t, the
+ * CO_LinuxThreads_xxx() functions are for objects created with
+ * #CO_newInstance(). */
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+/**
+ * Realtime properties for a CANopen thread, see #CO_LinuxThreads_setRealtime()
+ */
+typedef struct {
+  int policy;              /**< SCHED_OTHER, SCHED_FIFO or SCHED_DEADLINE */
+  int priority;            /**< SCHED_FIFO priority, 1 (low) to 99 (high) */
+  uint64_t runtime_ns;     /**< SCHED_DEADLINE runtime per period */
+  uint64_t deadline_ns;    /**< SCHED_DEADLINE relative deadline */
+  uint64_t period_ns;      /**< SCHED_DEADLINE period */
+  int cpu;                 /**< CPU to pin thread to, -1 for no pinning. Must
+                                be -1 with SCHED_DEADLINE */
+  bool_t lockMemory;       /**< lock current and future pages of the process
+                                into RAM (mlockall) */
+  size_t stackPrefault;    /**< bytes of stack to touch in advance, 0 for none */
+} CO_LinuxThreads_rtConfig_t;
+
+/**
+ * Realtime properties actually granted by the kernel, result of the self check
+ * in #CO_LinuxThreads_setRealtime()
+ */
+typedef struct {
+  bool_t policyGranted;    /**< scheduling policy and parameters are set */
+  bool_t affinityGranted;  /**< thread runs only on requested CPU */
+  bool_t memoryLocked;     /**< process memory is locked */
+  int policy;              /**< current scheduling policy */
+  int priority;            /**< current SCHED_FIFO priority */
+  uint64_t lockedKiB;      /**< locked memory of process (VmLck) */
+} CO_LinuxThreads_rtCheck_t;
+
+/**
+ * Set realtime properties of the calling thread.
+ *
+ * The threads are provided by the application, so this must be called from
+ * inside the thread that runs #threadMain_process() or
+ * #CANrx_threadTmr_process(), before the respective init function. Each
+ * property is applied even if a previous one failed. Afterwards, the properties
+ * are read back from the kernel and reported in _check_. Usually, root or
+ * CAP_SYS_NICE / CAP_IPC_LOCK (or matching rlimits) are needed.
+ *
+ * @param config requested properties
+ * @param [out] check granted properties, may be NULL
+ * @return CO_ERROR_NO if everything was granted, CO_ERROR_SYSCALL if some
+ * property was not granted, CO_ERROR_ILLEGAL_ARGUMENT for invalid values or
+ * SCHED_DEADLINE combined with _cpu_ >= 0 (kernel requires the full root
+ * domain for deadline threads, use cpusets instead).
+ */
+extern CO_ReturnError_t CO_LinuxThreads_setRealtime(
+        const CO_LinuxThreads_rtConfig_t *config,
+        CO_LinuxThreads_rtCheck_t *check);
+
+/** Maximum number of regular SYNC/RPDO/TPDO passes in one cycle of the
+ * realtime thread. If more intervals are overdue, the excess ones are covered
+ * by one #CO_process_catchUp() step. */
+#ifndef CANRX_THREADTMR_MAX_BURST
+#define CANRX_THREADTMR_MAX_BURST 4
+#endif
+
+/** Number of histogram bins. Bin 0 counts values below 2us, bin i values from
+ * 2^i to 2^(i+1)-1 us, the last bin all larger values. */
+#define CANRX_THREADTMR_HISTOGRAM_BINS 16
+
+/**
+ * Log-scale histogram of a time in us
+ */
+typedef struct {
+  uint32_t bins[CANRX_THREADTMR_HISTOGRAM_BINS]; /**< number of values per bin */
+  uint32_t max_us;         /**< largest value */
+} CANrx_threadTmr_histogram_t;
+
+/**
+ * Cycle statistics of realtime thread, see #CANrx_threadTmr_getStats()
+ */
+typedef struct {
+  CANrx_threadTmr_histogram_t latency;    /**< wakeup latency after timer expiration */
+  CANrx_threadTmr_histogram_t processing; /**< time for SYNC, RPDO and TPDO processing */
+  uint32_t cycles;         /**< number of processing cycles */
+  uint32_t overruns;       /**< timer intervals that expired without own cycle */
+  uint32_t catchUps;       /**< cycles with a catch-up step */
+  uint32_t skipped;        /**< intervals covered by catch-up steps instead of
+                                regular passes */
+} CANrx_threadTmr_stats_t;
+
+/**
+ * State of mainline and realtime thread of one CANopen object.
+ *
+ * Must be zero initialized before the init functions are called.
+ */
+typedef struct {
+  CO_t *CO;                         /**< CANopen object processed by the threads */
+  struct {
+    uint64_t  start;                /**< time CO_process() was called last time in ms */
+    void    (*pFunct)(void* object); /**< Callback function */
+    void     *object;               /**< Object for pFunct */
+    bool_t    pending;              /**< pFunct called, CO_LinuxThreads_mainProcess() not yet */
+    CO_NotifyStats_t notifyStats;   /**< notifications of pFunct by source */
+#ifdef CO_DRIVER_TICKLESS
+    uint64_t  deadline;             /**< time in ms CO_process() is due, UINT64_MAX
+                                         if callback was already called */
+#endif
+  } main;                           /**< mainline thread */
+  struct {
+    uint32_t us_interval;           /**< configured interval in us */
+    int interval_fd;                /**< timer fd */
+    struct timespec expected;       /**< time of last timer expiration */
+    CANrx_threadTmr_stats_t stats;  /**< written by realtime thread only */
+    bool_t statsReset;              /**< reset of statistics requested */
+#ifdef CO_DRIVER_TICKLESS
+    struct timespec lastPass;       /**< time of last processing pass */
+    struct timespec passDeadline;   /**< next deadline of SYNC and TPDOs */
+    struct timespec armed;          /**< expiration time timerfd is armed for */
+    uint32_t rxFrames;              /**< received messages at last check */
+    bool_t requested;               /**< pass requested by messages or application */
+    bool_t rxPending;               /**< messages received since last pass */
+    bool_t wakeup;                  /**< set by CO_LinuxThreads_rtWakeup() */
+#endif
+  } rt;                             /**< realtime thread */
+} CO_LinuxThreads_t;
 
 /**
  * Initialize mainline thread.
@@ -65,6 +194,10 @@ extern "C" {
  * is indicated by the callback function.
  * This thread processes CO_process() function from CANopen.c file.
  *
+ * With CO_DRIVER_TICKLESS, the realtime thread calls the callback when the
+ * deadline reported by CO_process() is reached or CAN messages were received,
+ * so cyclic calls are not needed.
+ *
  * @param callback this function is called to indicate #threadMain_process() has
  * work to do
  * @param object this pointer is given to _callback()_
@@ -85,6 +218,24 @@ extern void threadMain_close(void);
  */
 extern void threadMain_process(CO_NMT_reset_cmd_t *reset);
 
+/**
+ * Get notification statistics of mainline thread.
+ *
+ * Counts stack events by source. Events while a notification is pending, i.e.
+ * the callback was called but #threadMain_process() not yet, don't call the
+ * callback again and are counted as coalesced. wakeups counts calls of
+ * #threadMain_process() that followed a notification. May be called from any
+ * thread.
+ *
+ * @param [out] stats statistics since init or last reset
+ */
+extern void threadMain_getNotifyStats(CO_NotifyStats_t *stats);
+
+/**
+ * Reset notification statistics of mainline thread.
+ */
+extern void threadMain_resetNotifyStats(void);
+
 /**
  * Initialize realtime thread.
  *
@@ -95,18 +246,47 @@ extern void threadMain_process(CO_NMT_reset_cmd_t *reset);
  * CANrx_threadTmr uses CAN socket from CO_driver.c
  *
  * @remark If realtime is required, this thread must be registred as such in the Linux
- * kernel.
+ * kernel, see #CO_LinuxThreads_setRealtime().
+ *
+ * With CO_DRIVER_TICKLESS, the thread doesn't wake periodically. A processing
+ * pass is done when the next SYNC, TPDO or mainline deadline is reached, after
+ * CAN messages were received and on #CANrx_threadTmr_wakeup(), but not more
+ * often than once per interval.
  *
  * @param interval Interval of periodic timer in ms, recommended value for
  *                 realtime response: 1ms
  */
 extern void CANrx_threadTmr_init(uint16_t interval);
 
+/**
+ * Request a processing pass of the realtime thread.
+ *
+ * With CO_DRIVER_TICKLESS, Change of State of TPDOs is only detected in
+ * processing passes. Call this after the application wrote OD variables mapped
+ * to event driven TPDOs. Does nothing otherwise.
+ */
+extern void CANrx_threadTmr_wakeup(void);
+
 /**
  * Terminate realtime thread.
  */
 extern void CANrx_threadTmr_close(void);
 
+/**
+ * Get cycle statistics of realtime thread. May be called from any thread, it
+ * doesn't block the realtime thread. Counters are read one by one, so they may
+ * be from different cycles.
+ *
+ * @param [out] stats statistics since init or last reset
+ */
+extern void CANrx_threadTmr_getStats(CANrx_threadTmr_stats_t *stats);
+
+/**
+ * Reset cycle statistics of realtime thread. Done by the realtime thread at
+ * the beginning of the next cycle.
+ */
+extern void CANrx_threadTmr_resetStats(void);
+
 /**
  * Process realtime thread.
  *
@@ -115,6 +295,43 @@ extern void CANrx_threadTmr_close(void);
  */
 extern void CANrx_threadTmr_process();
 
+/**
+ * @name Threads of a CANopen object
+ *
+ * Same as the threadMain_xxx() and CANrx_threadTmr_xxx() functions, but for the
+ * given CANopen object. Each object needs its own #CO_LinuxThreads_t and its
+ * own pair of threads. Each object has its own OD lock in its CAN module.
+ * @{
+ */
+/** See #threadMain_init() */
+extern void CO_LinuxThreads_mainInit(CO_LinuxThreads_t *threads, CO_t *CO,
+                                     void (*callback)(void*), void *object);
+/** See #threadMain_close() */
+extern void CO_LinuxThreads_mainClose(CO_LinuxThreads_t *threads);
+/** See #threadMain_process() */
+extern void CO_LinuxThreads_mainProcess(CO_LinuxThreads_t *threads,
+                                        CO_NMT_reset_cmd_t *reset);
+/** See #threadMain_getNotifyStats() */
+extern void CO_LinuxThreads_mainGetNotifyStats(CO_LinuxThreads_t *threads,
+                                               CO_NotifyStats_t *stats);
+/** See #threadMain_resetNotifyStats() */
+extern void CO_LinuxThreads_mainResetNotifyStats(CO_LinuxThreads_t *threads);
+/** See #CANrx_threadTmr_init() */
+extern void CO_LinuxThreads_rtInit(CO_LinuxThreads_t *threads, CO_t *CO,
+                                   uint16_t interval);
+/** See #CANrx_threadTmr_close() */
+extern void CO_LinuxThreads_rtClose(CO_LinuxThreads_t *threads);
+/** See #CANrx_threadTmr_process() */
+extern void CO_LinuxThreads_rtProcess(CO_LinuxThreads_t *threads);
+/** See #CANrx_threadTmr_wakeup() */
+extern void CO_LinuxThreads_rtWakeup(CO_LinuxThreads_t *threads);
+/** See #CANrx_threadTmr_getStats() */
+extern void CO_LinuxThreads_rtGetStats(CO_LinuxThreads_t *threads,
+                                       CANrx_threadTmr_stats_t *stats);
+/** See #CANrx_threadTmr_resetStats() */
+extern void CO_LinuxThreads_rtResetStats(CO_LinuxThreads_t *threads);
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -45,6 +45,10 @@
  * to do so, delete this exception statement from your version.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* for recvmmsg(), sendmmsg() */
+#endif
+
 #include <string.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -57,6 +61,28 @@
 
 #include "CO_driver.h"
 
+#ifdef CO_DRIVER_RX_FILTER_BPF
+  #include <linux/filter.h>
+#endif
+
+#ifdef CO_DRIVER_IO_URING
+  #include <poll.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <sys/timerfd.h>
+#endif
+
+#ifdef CO_DRIVER_RX_THREADS
+  #include <sys/eventfd.h>
+#endif
+
+#ifdef CO_DRIVER_RX_RING
+  #include <sys/mman.h>
+  #include <arpa/inet.h>
+  #include <linux/if_ether.h>
+  #include <linux/if_packet.h>
+#endif
+
 #if defined CO_DRIVER_ERROR_REPORTING && __has_include("syslog/log.h")
   #include "syslog/log.h"
   #include "msgs.h"
@@ -69,11 +95,50 @@
   #define USE_EMERGENCY_OBJECT
 #endif
 
-pthread_mutex_t CO_EMCY_mutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_mutex_t CO_OD_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 #ifndef CO_DRIVER_MULTI_INTERFACE
-static CO_ReturnError_t CO_CANmodule_addInterface(CO_CANmodule_t *CANmodule, int32_t CANbaseAddress);
+static CO_ReturnError_t CO_CANmodule_addInterfaceBackend(CO_CANmodule_t *CANmodule,
+        int32_t CANbaseAddress, CO_CANrxBackend_t rxBackend);
+#endif
+
+#ifdef CO_DRIVER_RX_THREADS
+static CO_ReturnError_t CO_CANrxThreadsStart(CO_CANmodule_t *CANmodule);
+static void CO_CANrxThreadsStop(CO_CANmodule_t *CANmodule);
+
+/* Receive threads search the dispatch table while CO_CANrxBufferInit() may
+ * rebuild it from another thread (SDO access to PDO COB IDs, SDO client setup) */
+static pthread_rwlock_t CO_CANrxDispatch_rwlock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* messages read with one recvmmsg() call in receive thread */
+#define CO_CANRX_THREAD_BATCH   16
+/* receive thread checks for termination at least this often */
+#define CO_CANRX_THREAD_TIMEOUT_MS 100
+#endif
+
+#ifdef CO_DRIVER_RX_RING
+/* TPACKET_V3 ring geometry. Each CAN message takes about 100 bytes. */
+#define CO_CANRX_RING_BLOCK_SIZE (1 << 14)
+#define CO_CANRX_RING_BLOCK_NR   16
+#define CO_CANRX_RING_FRAME_SIZE (1 << 7)
+#endif
+
+/* Filter keys: 11 bit identifier, RTR in bit 11 */
+#define CO_CANRX_KEY_RTR        0x800
+#define CO_CANRX_KEY_MASK       0xfff
+#define CO_CANRX_KEY_COUNT      (CO_CANRX_KEY_MASK + 1)
+
+#ifdef CO_DRIVER_IO_URING
+#define CO_CANURING_ENTRIES     64
+#define CO_CANURING_BUF_GROUP   0
+/* receive buffer: recvmsg header, control messages, CAN message */
+#define CO_CANURING_BUF_SIZE    ((sizeof(struct io_uring_recvmsg_out) + \
+                                  CO_CANRX_CTRLMSG_SIZE + CAN_MTU + 63) & ~63)
+/* user_data of requests: request type and interface index */
+#define CO_CANURING_RECV        1
+#define CO_CANURING_POLLRX      2
+#define CO_CANURING_POLLTX      3
+#define CO_CANURING_NOTIFY      4
+#define CO_CANURING_TIMER       5
+#define CO_CANURING_DATA(type, index) (((uint64_t)(type) << 16) | (index))
 #endif
 
 #ifdef CO_DRIVER_MULTI_INTERFACE
@@ -126,6 +191,121 @@ static uint32_t CO_CANgetIndexFromIdent(
 #endif
 
 
+static const uint16_t CO_CANRX_DISPATCH_NONE = 0xffff;
+
+/* maximum number of events taken from one epoll_wait() call */
+#define CO_CANRX_EPOLL_EVENTS 8
+
+/** Check if rx buffer matches exactly one 11 bit identifier ******************/
+static bool_t CO_CANrxIsExact(const CO_CANrx_t *buffer)
+{
+    /* mask must cover the 11 bit identifier and nothing else from the
+     * received identifier. Flags inside ident would never match. */
+    return ((buffer->mask & CAN_EFF_MASK) == CAN_SFF_MASK) &&
+           ((buffer->ident & buffer->mask & ~CAN_SFF_MASK) == 0);
+}
+
+/** epoll events to read CAN socket, 0 if socket isn't read by CO_CANrxWait() */
+static uint32_t CO_CANrxEpollEvents(const CO_CANinterface_t *interface)
+{
+#ifndef CO_DRIVER_RX_THREADS
+    /* with receive threads, the socket is read there */
+    if (interface->rxBackend == CO_CANRX_BACKEND_SOCKET) {
+        return EPOLLIN;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Get rxArray index for the CAN-ID from dispatch table. Masked buffers with
+ * lower index take precedence, so the result is the same as with a linear
+ * search over rxArray.
+ *
+ * @return index or CO_CANRX_DISPATCH_NONE
+ */
+static uint16_t CO_CANrxLookup(const CO_CANmodule_t *CANmodule, uint32_t ident)
+{
+    uint16_t index;
+    uint16_t i;
+
+    index = CANmodule->rxDispatch[ident & CAN_SFF_MASK];
+    for (i = 0; i < CANmodule->rxMaskCount; i ++) {
+        uint16_t maskIndex = CANmodule->rxMaskIndex[i];
+
+        if (maskIndex >= index) {
+            break;
+        }
+        if(((ident ^ CANmodule->rxArray[maskIndex].ident) &
+            CANmodule->rxArray[maskIndex].mask) == 0U){
+            index = maskIndex;
+            break;
+        }
+    }
+    return index;
+}
+
+/** Remove rx buffer from dispatch table or mask list *************************/
+static void CO_CANrxDispatchRemove(CO_CANmodule_t *CANmodule, uint16_t index)
+{
+    CO_CANrx_t *buffer = &CANmodule->rxArray[index];
+    uint16_t i;
+
+    if (CO_CANrxIsExact(buffer)) {
+        uint32_t ident = buffer->ident & CAN_SFF_MASK;
+
+        if (CANmodule->rxDispatch[ident] == index) {
+            /* another buffer with the same identifier takes over */
+            CANmodule->rxDispatch[ident] = CO_CANRX_DISPATCH_NONE;
+            for (i = index + 1; i < CANmodule->rxSize; i ++) {
+                if (CO_CANrxIsExact(&CANmodule->rxArray[i]) &&
+                    (CANmodule->rxArray[i].ident & CAN_SFF_MASK) == ident) {
+                    CANmodule->rxDispatch[ident] = i;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        for (i = 0; i < CANmodule->rxMaskCount; i ++) {
+            if (CANmodule->rxMaskIndex[i] == index) {
+                CANmodule->rxMaskCount --;
+                memmove(&CANmodule->rxMaskIndex[i], &CANmodule->rxMaskIndex[i + 1],
+                        (CANmodule->rxMaskCount - i) * sizeof(CANmodule->rxMaskIndex[0]));
+                break;
+            }
+        }
+    }
+}
+
+/** Add rx buffer to dispatch table or mask list ******************************/
+static void CO_CANrxDispatchAdd(CO_CANmodule_t *CANmodule, uint16_t index)
+{
+    CO_CANrx_t *buffer = &CANmodule->rxArray[index];
+    uint16_t i;
+
+    if (CO_CANrxIsExact(buffer)) {
+        uint32_t ident = buffer->ident & CAN_SFF_MASK;
+
+        /* lowest index wins, like in a linear search */
+        if (CANmodule->rxDispatch[ident] == CO_CANRX_DISPATCH_NONE ||
+            CANmodule->rxDispatch[ident] > index) {
+            CANmodule->rxDispatch[ident] = index;
+        }
+    }
+    else {
+        /* keep list sorted */
+        i = CANmodule->rxMaskCount;
+        while (i > 0 && CANmodule->rxMaskIndex[i - 1] > index) {
+            CANmodule->rxMaskIndex[i] = CANmodule->rxMaskIndex[i - 1];
+            i --;
+        }
+        CANmodule->rxMaskIndex[i] = index;
+        CANmodule->rxMaskCount ++;
+    }
+}
+
+
 /** Disable socketCAN rx *****************************************************/
 static CO_ReturnError_t disableRx(CO_CANmodule_t *CANmodule)
 {
@@ -136,6 +316,10 @@ static CO_ReturnError_t disableRx(CO_CANmodule_t *CANmodule)
     /* insert a filter that doesn't match any messages */
     retval = CO_ERROR_NO;
     for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        if (CANmodule->CANinterfaces[i].rxBackend == CO_CANRX_BACKEND_EXTERNAL) {
+            /* socket is shared, rx is up to the application */
+            continue;
+        }
         ret = setsockopt(CANmodule->CANinterfaces[i].fd, SOL_CAN_RAW, CAN_RAW_FILTER,
                          NULL, 0);
         if(ret < 0){
@@ -149,6 +333,243 @@ static CO_ReturnError_t disableRx(CO_CANmodule_t *CANmodule)
     return retval;
 }
 
+/** socketCAN filter to filter key *******************************************/
+static uint16_t CO_CANrxFilterKey(canid_t id)
+{
+    return (id & CAN_SFF_MASK) | (((id & CAN_RTR_FLAG) != 0) ? CO_CANRX_KEY_RTR : 0);
+}
+
+/** filter key to socketCAN filter *******************************************/
+static canid_t CO_CANrxFilterId(uint16_t key)
+{
+    return (key & CAN_SFF_MASK) | (((key & CO_CANRX_KEY_RTR) != 0) ? CAN_RTR_FLAG : 0);
+}
+
+/**
+ * Mark all keys passing filter _id_/_mask_ in _passing_ bitmap.
+ *
+ * @return number of keys that were not marked before.
+ */
+static uint16_t CO_CANrxFilterMark(uint16_t id, uint16_t mask, uint32_t *passing, bool_t mark)
+{
+    uint16_t free = ~mask & CO_CANRX_KEY_MASK;
+    uint16_t sub = 0;
+    uint16_t key;
+    uint16_t count = 0;
+
+    /* iterate over all combinations of free bits */
+    do {
+        key = (id & mask) | sub;
+        if ((passing[key >> 5] & (1UL << (key & 31))) == 0) {
+            count ++;
+            if (mark) {
+                passing[key >> 5] |= 1UL << (key & 31);
+            }
+        }
+        sub = (sub - free) & free;
+    } while (sub != 0);
+
+    return count;
+}
+
+/**
+ * Compact socketCAN filter list in place.
+ *
+ * Filters covered by another filter are removed. Filters the kernel checks one
+ * by one (not exact 11 bit) are merged pairwise, the merge that lets the
+ * fewest additional keys pass first, until _budget_ is used up.
+ *
+ * @return new number of filters
+ */
+static int CO_CANrxFilterCompact(struct can_filter *filter, int count, uint32_t budget)
+{
+    int i;
+    int j;
+    int n;
+    int bestI;
+    int bestJ;
+    uint16_t cost;
+    uint16_t bestCost;
+    uint16_t id[count];
+    uint16_t mask[count];
+    bool_t removed[count];
+    uint32_t passing[CO_CANRX_KEY_COUNT / 32];
+
+    memset(passing, 0, sizeof(passing));
+    for (i = 0; i < count; i ++) {
+        mask[i] = CO_CANrxFilterKey(filter[i].can_mask);
+        id[i] = CO_CANrxFilterKey(filter[i].can_id) & mask[i];
+        removed[i] = false;
+        CO_CANrxFilterMark(id[i], mask[i], passing, true);
+    }
+
+    for (;;) {
+        /* remove covered filters. Of two identical ones, the first is kept */
+        for (i = 0; i < count; i ++) {
+            for (j = 0; j < count && !removed[i]; j ++) {
+                if (j == i || removed[j] ||
+                    (mask[i] & mask[j]) != mask[j] || ((id[i] ^ id[j]) & mask[j]) != 0) {
+                    continue;
+                }
+                if (mask[i] != mask[j] || j < i) {
+                    removed[i] = true;
+                }
+            }
+        }
+
+        /* find cheapest merge of two linear checked filters */
+        bestI = -1;
+        bestJ = -1;
+        bestCost = 0;
+        for (i = 0; i < count; i ++) {
+            if (removed[i] || (mask[i] == CO_CANRX_KEY_MASK && (id[i] & CO_CANRX_KEY_RTR) == 0)) {
+                continue;
+            }
+            for (j = i + 1; j < count; j ++) {
+                uint16_t m;
+
+                if (removed[j] || (mask[j] == CO_CANRX_KEY_MASK && (id[j] & CO_CANRX_KEY_RTR) == 0)) {
+                    continue;
+                }
+                m = mask[i] & mask[j] & ~(id[i] ^ id[j]);
+                cost = CO_CANrxFilterMark(id[i], m, passing, false);
+                if (cost <= budget && (bestI < 0 || cost < bestCost)) {
+                    bestI = i;
+                    bestJ = j;
+                    bestCost = cost;
+                }
+            }
+        }
+        if (bestI < 0) {
+            break;
+        }
+
+        mask[bestI] &= mask[bestJ] & ~(id[bestI] ^ id[bestJ]);
+        id[bestI] &= mask[bestI];
+        removed[bestJ] = true;
+        budget -= CO_CANrxFilterMark(id[bestI], mask[bestI], passing, true);
+    }
+
+    n = 0;
+    for (i = 0; i < count; i ++) {
+        if (!removed[i]) {
+            filter[n].can_id = CO_CANrxFilterId(id[i]);
+            filter[n].can_mask = CO_CANrxFilterId(mask[i]) | CAN_EFF_FLAG;
+            n ++;
+        }
+    }
+    return n;
+}
+
+#ifdef CO_DRIVER_RX_FILTER_BPF
+
+/* byte offsets in can_id */
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define CO_CANRX_BPF_ID_LOW     0
+#define CO_CANRX_BPF_ID_HIGH    1
+#define CO_CANRX_BPF_FLAGS      3
+#else
+#define CO_CANRX_BPF_ID_LOW     3
+#define CO_CANRX_BPF_ID_HIGH    2
+#define CO_CANRX_BPF_FLAGS      0
+#endif
+#define CO_CANRX_BPF_ACCEPT     0xffffffff
+
+/** Emit binary search over sorted exact keys, key is in A *******************/
+static void CO_CANrxBpfSearch(
+        struct sock_filter     *prog,
+        uint16_t               *len,
+        const uint16_t         *keys,
+        uint16_t                count)
+{
+    uint16_t i;
+    uint16_t jump;
+
+    if (count <= 4) {
+        for (i = 0; i < count; i ++) {
+            prog[(*len) ++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, keys[i], 0, 1);
+            prog[(*len) ++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, CO_CANRX_BPF_ACCEPT);
+        }
+        prog[(*len) ++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+        return;
+    }
+
+    /* upper half is reached with a long jump over the lower half */
+    prog[(*len) ++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JGT | BPF_K, keys[count / 2 - 1], 0, 1);
+    jump = (*len) ++;
+    CO_CANrxBpfSearch(prog, len, keys, count / 2);
+    prog[jump] = (struct sock_filter)BPF_STMT(BPF_JMP | BPF_JA, *len - jump - 1);
+    CO_CANrxBpfSearch(prog, len, keys + count / 2, count - count / 2);
+}
+
+/** Build and attach BPF program for (compacted) filter list *****************/
+static int CO_CANrxBpfAttach(int fd, const struct can_filter *filter, int count)
+{
+    int ret;
+    int i;
+    int j;
+    uint16_t len = 0;
+    uint16_t key;
+    uint16_t keyCount = 0;
+    uint16_t keys[count];
+    struct sock_filter *prog;
+    struct sock_fprog fprog;
+
+    prog = malloc((20 + 5 * count) * sizeof(struct sock_filter));
+    if (prog == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    /* accept error messages, drop extended frames */
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_B | BPF_ABS, CO_CANRX_BPF_FLAGS);
+    prog[len ++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, CAN_ERR_FLAG >> 24, 0, 1);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, CO_CANRX_BPF_ACCEPT);
+    prog[len ++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, CAN_EFF_FLAG >> 24, 0, 1);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, 0);
+    /* X = key */
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_AND | BPF_K, CAN_RTR_FLAG >> 24);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 5);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_MISC | BPF_TAX, 0);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_B | BPF_ABS, CO_CANRX_BPF_ID_HIGH);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_AND | BPF_K, CAN_SFF_MASK >> 8);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 8);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_MISC | BPF_TAX, 0);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_LD | BPF_B | BPF_ABS, CO_CANRX_BPF_ID_LOW);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0);
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_MISC | BPF_TAX, 0);
+
+    /* filters with mask one by one, collect exact keys sorted */
+    for (i = 0; i < count; i ++) {
+        uint16_t mask = CO_CANrxFilterKey(filter[i].can_mask);
+
+        key = CO_CANrxFilterKey(filter[i].can_id) & mask;
+        if (mask == CO_CANRX_KEY_MASK) {
+            for (j = keyCount; j > 0 && keys[j - 1] > key; j --) {
+                keys[j] = keys[j - 1];
+            }
+            keys[j] = key;
+            keyCount ++;
+            continue;
+        }
+        prog[len ++] = (struct sock_filter)BPF_STMT(BPF_MISC | BPF_TXA, 0);
+        prog[len ++] = (struct sock_filter)BPF_STMT(BPF_ALU | BPF_AND | BPF_K, mask);
+        prog[len ++] = (struct sock_filter)BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, key, 0, 1);
+        prog[len ++] = (struct sock_filter)BPF_STMT(BPF_RET | BPF_K, CO_CANRX_BPF_ACCEPT);
+    }
+    prog[len ++] = (struct sock_filter)BPF_STMT(BPF_MISC | BPF_TXA, 0);
+    CO_CANrxBpfSearch(prog, &len, keys, keyCount);
+
+    fprog.len = len;
+    fprog.filter = prog;
+    ret = setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog));
+    free(prog);
+    return ret;
+}
+
+#endif
+
 /** Set up or update socketCAN rx filters *************************************/
 static CO_ReturnError_t setRxFilters(CO_CANmodule_t *CANmodule)
 {
@@ -156,6 +577,9 @@ static CO_ReturnError_t setRxFilters(CO_CANmodule_t *CANmodule)
     int i;
     int count;
     CO_ReturnError_t retval;
+#ifdef CO_DRIVER_RX_FILTER_BPF
+    const struct can_filter passAll = {0, 0};
+#endif
 
     struct can_filter rxFiltersCpy[CANmodule->rxSize];
 
@@ -174,13 +598,35 @@ static CO_ReturnError_t setRxFilters(CO_CANmodule_t *CANmodule)
 
     if (count == 0) {
         /* No filter is set, disable RX */
+        CANmodule->rxFilterCount = 0;
         return disableRx(CANmodule);
     }
 
+#ifdef CO_DRIVER_RX_FILTER_BPF
+    /* BPF program has no false positives */
+    count = CO_CANrxFilterCompact(rxFiltersCpy, count, 0);
+#else
+    count = CO_CANrxFilterCompact(rxFiltersCpy, count, CO_DRIVER_RX_FILTER_BUDGET);
+#endif
+    CANmodule->rxFilterCount = count;
+
     retval = CO_ERROR_NO;
     for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+      if (CANmodule->CANinterfaces[i].rxBackend != CO_CANRX_BACKEND_SOCKET) {
+          /* socket rx stays disabled, messages are filtered by driver */
+          continue;
+      }
+#ifdef CO_DRIVER_RX_FILTER_BPF
+      /* program is attached before socket filter lets everything pass */
+      ret = CO_CANrxBpfAttach(CANmodule->CANinterfaces[i].fd, rxFiltersCpy, count);
+      if (ret == 0) {
+          ret = setsockopt(CANmodule->CANinterfaces[i].fd, SOL_CAN_RAW, CAN_RAW_FILTER,
+                           &passAll, sizeof(passAll));
+      }
+#else
       ret = setsockopt(CANmodule->CANinterfaces[i].fd, SOL_CAN_RAW, CAN_RAW_FILTER,
                        rxFiltersCpy, sizeof(struct can_filter) * count);
+#endif
       if(ret < 0){
           log_printf(LOG_ERR, CAN_FILTER_FAILED,
                      CANmodule->CANinterfaces[i].ifName);
@@ -209,6 +655,11 @@ void CO_CANsetNormalMode(CO_CANmodule_t *CANmodule)
 
     if(CANmodule != NULL) {
         ret = setRxFilters(CANmodule);
+#ifdef CO_DRIVER_RX_THREADS
+        if (ret == CO_ERROR_NO) {
+            ret = CO_CANrxThreadsStart(CANmodule);
+        }
+#endif
         if (ret == CO_ERROR_NO) {
             /* Put CAN module in normal mode */
             CANmodule->CANnormal = true;
@@ -217,6 +668,170 @@ void CO_CANsetNormalMode(CO_CANmodule_t *CANmodule)
 }
 
 
+/** Measure offset between socket timestamps and monotonic clock **************/
+static void CO_CANrxClockOffsetUpdate(CO_CANmodule_t *CANmodule)
+{
+    struct timespec real;
+    struct timespec mono;
+
+    (void)clock_gettime(CLOCK_REALTIME, &real);
+    (void)clock_gettime(CLOCK_MONOTONIC, &mono);
+    CANmodule->rxClockOffset.tv_sec = real.tv_sec - mono.tv_sec;
+    CANmodule->rxClockOffset.tv_nsec = real.tv_nsec - mono.tv_nsec;
+    if (CANmodule->rxClockOffset.tv_nsec < 0) {
+        CANmodule->rxClockOffset.tv_sec --;
+        CANmodule->rxClockOffset.tv_nsec += 1000000000L;
+    }
+}
+
+#ifdef CO_DRIVER_IO_URING
+
+/** Put receive buffer back to provided buffer ring ***************************/
+static void CO_CANuringBufferRelease(CO_CANuring_t *uring, uint16_t bid)
+{
+    struct io_uring_buf *buf;
+
+    buf = &uring->bufRing->bufs[uring->bufTail & (CO_DRIVER_IO_URING_BUFFERS - 1)];
+    buf->addr = (uintptr_t)(uring->buf + bid * CO_CANURING_BUF_SIZE);
+    buf->len = CO_CANURING_BUF_SIZE;
+    buf->bid = bid;
+    uring->bufTail ++;
+    __atomic_store_n(&uring->bufRing->tail, uring->bufTail, __ATOMIC_RELEASE);
+}
+
+/** Set up io_uring, map rings and register receive buffers *******************/
+static CO_ReturnError_t CO_CANuringInit(CO_CANmodule_t *CANmodule)
+{
+    int32_t ret;
+    uint16_t i;
+    struct io_uring_params params;
+    struct io_uring_buf_reg reg;
+    CO_CANuring_t *uring = &CANmodule->uring;
+
+    memset(uring, 0, sizeof(*uring));
+    uring->fd = -1;
+
+    memset(&params, 0, sizeof(params));
+    ret = syscall(__NR_io_uring_setup, CO_CANURING_ENTRIES, &params);
+    if (ret < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "io_uring_setup()");
+        return CO_ERROR_SYSCALL;
+    }
+    uring->fd = ret;
+
+    uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        if (uring->cqRingSize > uring->sqRingSize) {
+            uring->sqRingSize = uring->cqRingSize;
+        }
+        uring->cqRingSize = uring->sqRingSize;
+    }
+    uring->sqRing = mmap(NULL, uring->sqRingSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQ_RING);
+    if (uring->sqRing == MAP_FAILED) {
+        uring->sqRing = NULL;
+        log_printf(LOG_DEBUG, DBG_ERRNO, "mmap(sq)");
+        return CO_ERROR_SYSCALL;
+    }
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        uring->cqRing = uring->sqRing;
+    }
+    else {
+        uring->cqRing = mmap(NULL, uring->cqRingSize, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_CQ_RING);
+        if (uring->cqRing == MAP_FAILED) {
+            uring->cqRing = NULL;
+            log_printf(LOG_DEBUG, DBG_ERRNO, "mmap(cq)");
+            return CO_ERROR_SYSCALL;
+        }
+    }
+    uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = mmap(NULL, uring->sqesSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, uring->fd, IORING_OFF_SQES);
+    if (uring->sqes == MAP_FAILED) {
+        uring->sqes = NULL;
+        log_printf(LOG_DEBUG, DBG_ERRNO, "mmap(sqes)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    uring->sqHead = (uint32_t *)(uring->sqRing + params.sq_off.head);
+    uring->sqTail = (uint32_t *)(uring->sqRing + params.sq_off.tail);
+    uring->sqArray = (uint32_t *)(uring->sqRing + params.sq_off.array);
+    uring->sqMask = *(uint32_t *)(uring->sqRing + params.sq_off.ring_mask);
+    uring->cqHead = (uint32_t *)(uring->cqRing + params.cq_off.head);
+    uring->cqTail = (uint32_t *)(uring->cqRing + params.cq_off.tail);
+    uring->cqes = (struct io_uring_cqe *)(uring->cqRing + params.cq_off.cqes);
+    uring->cqMask = *(uint32_t *)(uring->cqRing + params.cq_off.ring_mask);
+
+    /* receive buffers, selected by kernel from provided buffer ring */
+    uring->bufRing = mmap(NULL, CO_DRIVER_IO_URING_BUFFERS * sizeof(struct io_uring_buf),
+                          PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (uring->bufRing == MAP_FAILED) {
+        uring->bufRing = NULL;
+        log_printf(LOG_DEBUG, DBG_ERRNO, "mmap(buf)");
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    uring->buf = malloc(CO_DRIVER_IO_URING_BUFFERS * CO_CANURING_BUF_SIZE);
+    if (uring->buf == NULL) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "malloc()");
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uintptr_t)uring->bufRing;
+    reg.ring_entries = CO_DRIVER_IO_URING_BUFFERS;
+    reg.bgid = CO_CANURING_BUF_GROUP;
+    ret = syscall(__NR_io_uring_register, uring->fd, IORING_REGISTER_PBUF_RING, &reg, 1);
+    if (ret < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "io_uring_register(buf)");
+        return CO_ERROR_SYSCALL;
+    }
+    for (i = 0; i < CO_DRIVER_IO_URING_BUFFERS; i ++) {
+        CO_CANuringBufferRelease(uring, i);
+    }
+    uring->bufUsed = 0;
+
+    /* Multishot recvmsg() puts header, control messages and payload into one
+     * receive buffer */
+    uring->rxMsg.msg_controllen = CO_CANRX_CTRLMSG_SIZE;
+
+    return CO_ERROR_NO;
+}
+
+/** Close io_uring, pending requests are cancelled ****************************/
+static void CO_CANuringDisable(CO_CANmodule_t *CANmodule)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+
+    if (uring->fd >= 0) {
+        close(uring->fd);
+    }
+    uring->fd = -1;
+    if (uring->sqes != NULL) {
+        munmap(uring->sqes, uring->sqesSize);
+    }
+    uring->sqes = NULL;
+    if (uring->cqRing != NULL && uring->cqRing != uring->sqRing) {
+        munmap(uring->cqRing, uring->cqRingSize);
+    }
+    uring->cqRing = NULL;
+    if (uring->sqRing != NULL) {
+        munmap(uring->sqRing, uring->sqRingSize);
+    }
+    uring->sqRing = NULL;
+    if (uring->bufRing != NULL) {
+        munmap(uring->bufRing, CO_DRIVER_IO_URING_BUFFERS * sizeof(struct io_uring_buf));
+    }
+    uring->bufRing = NULL;
+    if (uring->buf != NULL) {
+        free(uring->buf);
+    }
+    uring->buf = NULL;
+}
+
+#endif
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_CANmodule_init(
         CO_CANmodule_t         *CANmodule,
@@ -236,6 +851,29 @@ CO_ReturnError_t CO_CANmodule_init(
         return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
+    /* mutexes stay, if module is initialized again on communication reset */
+    if (!CANmodule->locks.initialized) {
+        if (pthread_mutex_init(&CANmodule->locks.CANsend, NULL) != 0 ||
+            pthread_mutex_init(&CANmodule->locks.EMCY, NULL) != 0 ||
+            pthread_mutex_init(&CANmodule->locks.OD, NULL) != 0) {
+            log_printf(LOG_DEBUG, DBG_ERRNO, "pthread_mutex_init()");
+            return CO_ERROR_SYSCALL;
+        }
+#ifdef CO_DRIVER_OD_SEQLOCK
+        CANmodule->locks.ODsequence = 0;
+#endif
+        CANmodule->locks.initialized = true;
+    }
+    CANmodule->rxWaitUsed = false;
+#ifdef CO_DRIVER_IO_URING
+    CANmodule->uring.fd = -1;
+#endif
+#ifdef CO_DRIVER_RX_THREADS
+    CANmodule->fdRxThreads = -1;
+    CANmodule->rxThreadBudget = 0;
+    CANmodule->rxThreadSequence = 0;
+#endif
+
     /* Create epoll FD */
     CANmodule->fdEpoll = epoll_create(1);
     if(CANmodule->fdEpoll < 0){
@@ -261,6 +899,31 @@ CO_ReturnError_t CO_CANmodule_init(
         return CO_ERROR_SYSCALL;
     }
 
+#ifdef CO_DRIVER_RX_THREADS
+    /* receive threads signal new messages with eventfd */
+    CANmodule->fdRxThreads = eventfd(0, EFD_NONBLOCK);
+    if (CANmodule->fdRxThreads < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "eventfd()");
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+    ev.events = EPOLLIN;
+    ev.data.fd = CANmodule->fdRxThreads;
+    ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    if(ret < 0){
+        log_printf(LOG_DEBUG, DBG_ERRNO, "epoll_ctl(eventfd)");
+        CO_CANmodule_disable(CANmodule);
+        return CO_ERROR_SYSCALL;
+    }
+#endif
+
+#ifdef CO_DRIVER_IO_URING
+    /* io_uring event engine. epoll is set up anyway, it is used as fallback */
+    if (CO_CANuringInit(CANmodule) != CO_ERROR_NO) {
+        CO_CANuringDisable(CANmodule);
+    }
+#endif
+
     /* Configure object variables */
     CANmodule->CANinterfaces = NULL;
     CANmodule->CANinterfaceCount = 0;
@@ -271,12 +934,18 @@ CO_ReturnError_t CO_CANmodule_init(
     CANmodule->CANnormal = false;
     CANmodule->em = NULL; //this is set inside CO_Emergency.c init function!
     CANmodule->fdTimerRead = -1;
-#ifdef CO_DRIVER_MULTI_INTERFACE
+    CANmodule->rxFilterCount = 0;
+    CANmodule->rxDropCount = 0;
+    CANmodule->rxUnmatched = 0;
+    CO_CANrxClockOffsetUpdate(CANmodule);
+    CANmodule->rxNotifyReady = false;
+    CANmodule->rxServiceNext = 0;
     for (i = 0; i < CO_CAN_MSG_SFF_MAX_COB_ID; i++) {
-        CANmodule->rxIdentToIndex[i] = CO_INVALID_COB_ID;
+        CANmodule->rxDispatch[i] = CO_CANRX_DISPATCH_NONE;
+#ifdef CO_DRIVER_MULTI_INTERFACE
         CANmodule->txIdentToIndex[i] = CO_INVALID_COB_ID;
-    }
 #endif
+    }
 
     /* initialize socketCAN filters
      * CAN module filters will be configured with CO_CANrxBufferInit()
@@ -287,6 +956,37 @@ CO_ReturnError_t CO_CANmodule_init(
         return CO_ERROR_OUT_OF_MEMORY;
     }
 
+    /* initialize dispatch mask list. Unconfigured buffers are stored here */
+    CANmodule->rxMaskIndex = calloc(CANmodule->rxSize, sizeof(uint16_t));
+    if(CANmodule->rxMaskIndex == NULL){
+        log_printf(LOG_DEBUG, DBG_ERRNO, "malloc()");
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    CANmodule->rxMaskCount = 0;
+
+#ifdef CO_DRIVER_RX_BATCH
+    CANmodule->rxBatchHdr = calloc(CO_DRIVER_RX_BATCH, sizeof(struct mmsghdr));
+    if(CANmodule->rxBatchHdr == NULL){
+        log_printf(LOG_DEBUG, DBG_ERRNO, "malloc()");
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    CANmodule->rxBatchInterface = NULL;
+    CANmodule->rxBatchCount = 0;
+    CANmodule->rxBatchNext = 0;
+#endif
+#ifdef CO_DRIVER_TX_BATCH
+    CANmodule->txBatchHdr = calloc(CO_DRIVER_TX_BATCH, sizeof(struct mmsghdr));
+    if(CANmodule->txBatchHdr == NULL){
+        log_printf(LOG_DEBUG, DBG_ERRNO, "malloc()");
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    CANmodule->txBatchCount = 0;
+    CANmodule->txBatchActive = false;
+#endif
+#ifdef CO_DRIVER_TX_QUEUE
+    CANmodule->txQueueCount = 0;
+#endif
+
     for(i=0U; i<rxSize; i++){
         rxArray[i].ident = 0U;
         rxArray[i].mask = 0xFFFFFFFFU;
@@ -297,11 +997,18 @@ CO_ReturnError_t CO_CANmodule_init(
         rxArray[i].timestamp.tv_sec = 0;
         rxArray[i].timestamp.tv_nsec = 0;
 #endif
+        CO_CANrxDispatchAdd(CANmodule, i);
     }
 
 #ifndef CO_DRIVER_MULTI_INTERFACE
     /* add one interface */
-    ret = CO_CANmodule_addInterface(CANmodule, CANbaseAddress);
+#ifdef CO_DRIVER_RX_RING
+    ret = CO_CANmodule_addInterfaceBackend(CANmodule, CANbaseAddress,
+                                           CO_CANRX_BACKEND_RING);
+#else
+    ret = CO_CANmodule_addInterfaceBackend(CANmodule, CANbaseAddress,
+                                           CO_CANRX_BACKEND_SOCKET);
+#endif
     if (ret != CO_ERROR_NO) {
         CO_CANmodule_disable(CANmodule);
     }
@@ -312,32 +1019,156 @@ CO_ReturnError_t CO_CANmodule_init(
 }
 
 
-/** enable socketCAN *********************************************************/
-#ifndef CO_DRIVER_MULTI_INTERFACE
-static
-#endif
-CO_ReturnError_t CO_CANmodule_addInterface(
+#ifdef CO_DRIVER_RX_RING
+
+/** Set up TPACKET_V3 rx ring *************************************************/
+static CO_ReturnError_t CO_CANringInit(
         CO_CANmodule_t         *CANmodule,
-        int32_t                 CANbaseAddress)
+        CO_CANinterface_t      *interface)
 {
     int32_t ret;
     int32_t tmp;
-    int32_t bytes;
-    char *ifName;
-    socklen_t sLen;
-    CO_CANinterface_t *interface;
-    struct sockaddr_can sockAddr;
+    struct tpacket_req3 req;
+    struct sockaddr_ll sockAddr;
     struct epoll_event ev;
-#ifdef CO_DRIVER_ERROR_REPORTING
-    can_err_mask_t err_mask;
+
+    interface->fdRing = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_CAN));
+    if (interface->fdRing < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "socket(packet)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    tmp = TPACKET_V3;
+    ret = setsockopt(interface->fdRing, SOL_PACKET, PACKET_VERSION, &tmp, sizeof(tmp));
+    if (ret < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "setsockopt(version)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = CO_CANRX_RING_BLOCK_SIZE;
+    req.tp_block_nr = CO_CANRX_RING_BLOCK_NR;
+    req.tp_frame_size = CO_CANRX_RING_FRAME_SIZE;
+    req.tp_frame_nr = (CO_CANRX_RING_BLOCK_SIZE / CO_CANRX_RING_FRAME_SIZE) *
+                      CO_CANRX_RING_BLOCK_NR;
+    req.tp_retire_blk_tov = CO_DRIVER_RX_RING_TIMEOUT;
+    ret = setsockopt(interface->fdRing, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+    if (ret < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "setsockopt(ring)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    interface->ring = mmap(NULL, CO_CANRX_RING_BLOCK_SIZE * CO_CANRX_RING_BLOCK_NR,
+                           PROT_READ | PROT_WRITE, MAP_SHARED, interface->fdRing, 0);
+    if (interface->ring == MAP_FAILED) {
+        interface->ring = NULL;
+        log_printf(LOG_DEBUG, DBG_ERRNO, "mmap(ring)");
+        return CO_ERROR_SYSCALL;
+    }
+    interface->ringBlock = 0;
+    interface->ringPkt = NULL;
+    interface->ringPktLeft = 0;
+
+    memset(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.sll_family = AF_PACKET;
+    sockAddr.sll_protocol = htons(ETH_P_CAN);
+    sockAddr.sll_ifindex = interface->CANbaseAddress;
+    ret = bind(interface->fdRing, (struct sockaddr*)&sockAddr, sizeof(sockAddr));
+    if (ret < 0) {
+        log_printf(LOG_ERR, CAN_BINDING_FAILED, interface->ifName);
+        log_printf(LOG_DEBUG, DBG_ERRNO, "bind(packet)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    /* Add ring socket to epoll */
+    ev.events = EPOLLIN;
+    ev.data.fd = interface->fdRing;
+    ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    if (ret < 0) {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "epoll_ctl(packet)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    return CO_ERROR_NO;
+}
+
+/** Remove TPACKET_V3 rx ring *************************************************/
+static void CO_CANringDisable(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface)
+{
+    if (interface->ring != NULL) {
+        munmap(interface->ring, CO_CANRX_RING_BLOCK_SIZE * CO_CANRX_RING_BLOCK_NR);
+        interface->ring = NULL;
+    }
+    if (interface->fdRing >= 0) {
+        epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_DEL, interface->fdRing, NULL);
+        close(interface->fdRing);
+        interface->fdRing = -1;
+    }
+}
+
+#endif
+
+
+#ifdef CO_DRIVER_RX_THREADS
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANmodule_setRxThreadCpu(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        int32_t                 cpu)
+{
+    uint32_t i;
+
+    if (CANmodule == NULL || cpu < -1 || cpu >= CPU_SETSIZE) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    if (CANmodule->CANnormal != false) {
+        /* threads are running */
+        return CO_ERROR_INVALID_STATE;
+    }
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        if (CANmodule->CANinterfaces[i].CANbaseAddress == CANbaseAddress) {
+            CANmodule->CANinterfaces[i].rxThreadCpu = cpu;
+            return CO_ERROR_NO;
+        }
+    }
+    return CO_ERROR_ILLEGAL_ARGUMENT;
+}
+
+#endif
+
+#ifdef CO_DRIVER_MULTI_INTERFACE
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANmodule_addInterface(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress)
+{
+    return CO_CANmodule_addInterfaceBackend(CANmodule, CANbaseAddress,
+                                            CO_CANRX_BACKEND_SOCKET);
+}
+
 #endif
 
+
+/** Append interface to interface list **************************************/
+static CO_ReturnError_t CO_CANmodule_appendInterface(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        CO_CANrxBackend_t       rxBackend,
+        CO_CANinterface_t     **pInterface)
+{
+    char *ifName;
+    CO_CANinterface_t *interface;
+
     if (CANmodule->CANnormal != false) {
         /* can't change config now! */
         return CO_ERROR_INVALID_STATE;
     }
 
-    /* Add interface to interface list */
     CANmodule->CANinterfaceCount ++;
     CANmodule->CANinterfaces = realloc(CANmodule->CANinterfaces,
         ((CANmodule->CANinterfaceCount) * sizeof(*CANmodule->CANinterfaces)));
@@ -346,14 +1177,80 @@ CO_ReturnError_t CO_CANmodule_addInterface(
         return CO_ERROR_OUT_OF_MEMORY;
     }
     interface = &CANmodule->CANinterfaces[CANmodule->CANinterfaceCount - 1];
+    *pInterface = interface;
 
     interface->CANbaseAddress = CANbaseAddress;
+    interface->rxBackend = rxBackend;
+#ifdef CO_DRIVER_IO_URING
+    interface->uringRxHead = 0;
+    interface->uringRxCount = 0;
+    interface->uringRxArmed = false;
+    interface->uringTxArmed = false;
+#endif
+#ifdef CO_DRIVER_RX_RING
+    interface->fdRing = -1;
+    interface->ring = NULL;
+#endif
+#ifdef CO_DRIVER_RX_THREADS
+    interface->rxThreadCpu = -1;
+    interface->rxThread = NULL;
+#endif
+#ifdef CO_DRIVER_TX_QUEUE
+    interface->txEpollOut = false;
+#endif
+    interface->rxReady = false;
+    interface->rxBudget = 0;
+    interface->rxWakeups = 0;
+    interface->rxFrames = 0;
+    interface->txFrames = 0;
+    interface->rxDropCount = 0;
+    interface->fd = -1;
     ifName = if_indextoname(CANbaseAddress, interface->ifName);
     if (ifName == NULL) {
         log_printf(LOG_DEBUG, DBG_ERRNO, "if_indextoname()");
         return CO_ERROR_ILLEGAL_ARGUMENT;
     }
 
+    return CO_ERROR_NO;
+}
+
+/** enable socketCAN *********************************************************/
+#ifndef CO_DRIVER_MULTI_INTERFACE
+static
+#endif
+CO_ReturnError_t CO_CANmodule_addInterfaceBackend(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        CO_CANrxBackend_t       rxBackend)
+{
+    int32_t ret;
+    int32_t tmp;
+    int32_t bytes;
+    socklen_t sLen;
+    CO_CANinterface_t *interface;
+    struct sockaddr_can sockAddr;
+    struct epoll_event ev;
+#ifdef CO_DRIVER_ERROR_REPORTING
+    can_err_mask_t err_mask;
+#endif
+
+#ifdef CO_DRIVER_RX_RING
+    if (rxBackend == CO_CANRX_BACKEND_EXTERNAL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+#else
+    if (rxBackend != CO_CANRX_BACKEND_SOCKET) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+#endif
+
+    /* Add interface to interface list */
+    ret = CO_CANmodule_appendInterface(CANmodule, CANbaseAddress, rxBackend,
+                                       &interface);
+    if (ret != CO_ERROR_NO) {
+        return ret;
+    }
+
     /* Create socket */
     interface->fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
     if(interface->fd < 0){
@@ -368,9 +1265,9 @@ CO_ReturnError_t CO_CANmodule_addInterface(
         log_printf(LOG_DEBUG, DBG_ERRNO, "setsockopt(ovfl)");
         return CO_ERROR_SYSCALL;
     }
-#ifdef CO_DRIVER_MULTI_INTERFACE
     /* enable software time stamp mode (hardware timestamps do not work properly
-     * on all devices)*/
+     * on all devices). The reception time is taken by the kernel, so it
+     * doesn't depend on when CO_CANrxWait() gets to the message. */
     tmp = (SOF_TIMESTAMPING_SOFTWARE |
            SOF_TIMESTAMPING_RX_SOFTWARE);
     ret = setsockopt(interface->fd, SOL_SOCKET, SO_TIMESTAMPING, &tmp, sizeof(tmp));
@@ -378,7 +1275,6 @@ CO_ReturnError_t CO_CANmodule_addInterface(
         log_printf(LOG_DEBUG, DBG_ERRNO, "setsockopt(timestamping)");
         return CO_ERROR_SYSCALL;
     }
-#endif
 
     //todo - modify rx buffer size? first one needs root
     //ret = setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, (void *)&bytes, sLen);
@@ -413,6 +1309,10 @@ CO_ReturnError_t CO_CANmodule_addInterface(
 #else
     err_mask = CAN_ERR_ACK | CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_BUSERROR;
 #endif
+    if (rxBackend != CO_CANRX_BACKEND_SOCKET) {
+        /* error frames are received from rx ring */
+        err_mask = 0;
+    }
     ret = setsockopt(interface->fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &err_mask,
                      sizeof(err_mask));
     if(ret < 0){
@@ -422,8 +1322,9 @@ CO_ReturnError_t CO_CANmodule_addInterface(
     }
 #endif
 
-    /* Add socket to epoll */
-    ev.events = EPOLLIN;
+    /* Add socket to epoll. If the socket isn't read here, it is only used to
+     * detect errors and tx queue space. */
+    ev.events = CO_CANrxEpollEvents(interface);
     ev.data.fd = interface->fd;
     ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
     if(ret < 0){
@@ -431,12 +1332,64 @@ CO_ReturnError_t CO_CANmodule_addInterface(
         return CO_ERROR_SYSCALL;
     }
 
+#ifdef CO_DRIVER_RX_RING
+    if (rxBackend == CO_CANRX_BACKEND_RING) {
+        ret = CO_CANringInit(CANmodule, interface);
+        if (ret != CO_ERROR_NO) {
+            return ret;
+        }
+    }
+#endif
+
     /* rx is started by calling #CO_CANsetNormalMode() */
     ret = disableRx(CANmodule);
 
     return ret;
 }
 
+#ifdef CO_DRIVER_MULTI_INTERFACE
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANmodule_addInterfaceExternal(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        int                     fd)
+{
+    int32_t ret;
+    CO_CANinterface_t *interface;
+    struct epoll_event ev;
+
+    if (CANmodule == NULL || fd < 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    ret = CO_CANmodule_appendInterface(CANmodule, CANbaseAddress,
+                                       CO_CANRX_BACKEND_EXTERNAL, &interface);
+    if (ret != CO_ERROR_NO) {
+        return ret;
+    }
+    interface->fd = fd;
+
+#ifdef CO_DRIVER_ERROR_REPORTING
+    /* error frames are passed by the application, if it wants to */
+    CO_CANerror_init(&interface->errorhandler, interface->fd, interface->ifName);
+#endif
+
+    /* socket is not read here, epoll is only needed to wait for tx queue
+     * space. Many CAN modules may watch the same socket. */
+    ev.events = CO_CANrxEpollEvents(interface);
+    ev.data.fd = interface->fd;
+    ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    if(ret < 0){
+        log_printf(LOG_DEBUG, DBG_ERRNO, "epoll_ctl(can)");
+        return CO_ERROR_SYSCALL;
+    }
+
+    return CO_ERROR_NO;
+}
+
+#endif
+
 
 /******************************************************************************/
 void CO_CANmodule_disable(CO_CANmodule_t *CANmodule)
@@ -448,6 +1401,11 @@ void CO_CANmodule_disable(CO_CANmodule_t *CANmodule)
         return;
     }
 
+#ifdef CO_DRIVER_RX_THREADS
+    /* receive threads use the sockets */
+    CO_CANrxThreadsStop(CANmodule);
+#endif
+
     /* clear interfaces */
     for (i = 0; i < CANmodule->CANinterfaceCount; i++) {
         CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
@@ -455,9 +1413,14 @@ void CO_CANmodule_disable(CO_CANmodule_t *CANmodule)
 #ifdef CO_DRIVER_ERROR_REPORTING
         CO_CANerror_disable(&interface->errorhandler);
 #endif
+#ifdef CO_DRIVER_RX_RING
+        CO_CANringDisable(CANmodule, interface);
+#endif
 
         epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_DEL, interface->fd, NULL);
-        close(interface->fd);
+        if (interface->rxBackend != CO_CANRX_BACKEND_EXTERNAL) {
+            close(interface->fd);
+        }
         interface->fd = -1;
     }
     if (CANmodule->CANinterfaces != NULL) {
@@ -467,13 +1430,25 @@ void CO_CANmodule_disable(CO_CANmodule_t *CANmodule)
 
     /* cancel rx */
     if (CANmodule->pipe != NULL) {
-        CO_NotifyPipeSend(CANmodule->pipe);
-        /* give some time for delivery */
-        wait.tv_sec = 0;
-        wait.tv_nsec = 50 /* ms */ * 1000000;
-        nanosleep(&wait, NULL);
+        if (CANmodule->rxWaitUsed) {
+            CO_NotifyPipeSend(CANmodule->pipe);
+            /* give some time for delivery */
+            wait.tv_sec = 0;
+            wait.tv_nsec = 50 /* ms */ * 1000000;
+            nanosleep(&wait, NULL);
+        }
         CO_NotifyPipeFree(CANmodule->pipe);
+        CANmodule->pipe = NULL;
+    }
+#ifdef CO_DRIVER_IO_URING
+    CO_CANuringDisable(CANmodule);
+#endif
+#ifdef CO_DRIVER_RX_THREADS
+    if (CANmodule->fdRxThreads >= 0) {
+        close(CANmodule->fdRxThreads);
     }
+    CANmodule->fdRxThreads = -1;
+#endif
 
     if (CANmodule->fdEpoll >= 0) {
         close(CANmodule->fdEpoll);
@@ -484,6 +1459,42 @@ void CO_CANmodule_disable(CO_CANmodule_t *CANmodule)
         free(CANmodule->rxFilter);
     }
     CANmodule->rxFilter = NULL;
+
+    if (CANmodule->rxMaskIndex != NULL) {
+        free(CANmodule->rxMaskIndex);
+    }
+    CANmodule->rxMaskIndex = NULL;
+    CANmodule->rxMaskCount = 0;
+
+#ifdef CO_DRIVER_RX_BATCH
+    if (CANmodule->rxBatchHdr != NULL) {
+        free(CANmodule->rxBatchHdr);
+    }
+    CANmodule->rxBatchHdr = NULL;
+    CANmodule->rxBatchInterface = NULL;
+    CANmodule->rxBatchCount = 0;
+    CANmodule->rxBatchNext = 0;
+#endif
+#ifdef CO_DRIVER_TX_BATCH
+    if (CANmodule->txBatchHdr != NULL) {
+        free(CANmodule->txBatchHdr);
+    }
+    CANmodule->txBatchHdr = NULL;
+    CANmodule->txBatchCount = 0;
+    CANmodule->txBatchActive = false;
+#endif
+#ifdef CO_DRIVER_TX_QUEUE
+    CO_LOCK_CAN_SEND(CANmodule);
+    CANmodule->txQueueCount = 0;
+    CO_UNLOCK_CAN_SEND(CANmodule);
+#endif
+
+    if (CANmodule->locks.initialized) {
+        (void)pthread_mutex_destroy(&CANmodule->locks.CANsend);
+        (void)pthread_mutex_destroy(&CANmodule->locks.EMCY);
+        (void)pthread_mutex_destroy(&CANmodule->locks.OD);
+        CANmodule->locks.initialized = false;
+    }
 }
 
 
@@ -525,10 +1536,10 @@ CO_ReturnError_t CO_CANrxBufferInit(
             /* buffer, which will be configured */
             buffer = &CANmodule->rxArray[index];
 
-#ifdef CO_DRIVER_MULTI_INTERFACE
-            CO_CANsetIdentToIndex(CANmodule->rxIdentToIndex, index, ident,
-                                  buffer->ident);
+#ifdef CO_DRIVER_RX_THREADS
+            (void)pthread_rwlock_wrlock(&CO_CANrxDispatch_rwlock);
 #endif
+            CO_CANrxDispatchRemove(CANmodule, index);
 
             /* Configure object variables */
             buffer->object = object;
@@ -546,6 +1557,11 @@ CO_ReturnError_t CO_CANrxBufferInit(
             }
             buffer->mask = (mask & CAN_SFF_MASK) | CAN_EFF_FLAG | CAN_RTR_FLAG;
 
+            CO_CANrxDispatchAdd(CANmodule, index);
+#ifdef CO_DRIVER_RX_THREADS
+            (void)pthread_rwlock_unlock(&CO_CANrxDispatch_rwlock);
+#endif
+
             /* Set CAN hardware module filter and mask. */
             CANmodule->rxFilter[index].can_id = buffer->ident;
             CANmodule->rxFilter[index].can_mask = buffer->mask;
@@ -574,8 +1590,11 @@ bool_t CO_CANrxBuffer_getInterface(
         uint32_t index;
         CO_CANrx_t *buffer;
 
-        index = CO_CANgetIndexFromIdent(CANmodule->rxIdentToIndex, ident);
-        if ((index == CO_INVALID_COB_ID) || (index > CANmodule->rxSize)) {
+        if (ident >= CO_CAN_MSG_SFF_MAX_COB_ID) {
+            return false;
+        }
+        index = CANmodule->rxDispatch[ident];
+        if ((index == CO_CANRX_DISPATCH_NONE) || (index >= CANmodule->rxSize)) {
             return false;
         }
         buffer = &CANmodule->rxArray[index];
@@ -659,349 +1678,1996 @@ CO_ReturnError_t CO_CANtxBuffer_setInterface(
 
 #endif
 
-/******************************************************************************/
-static CO_ReturnError_t CO_CANCheckSendInterface(
-        CO_CANmodule_t         *CANmodule,
-        CO_CANtx_t             *buffer,
-        CO_CANinterface_t      *interface)
+/** Write one message to socket, returns 0 or errno ***************************/
+static int CO_CANsendFrame(CO_CANinterface_t *interface, const void *frame)
 {
-    CO_ReturnError_t err = CO_ERROR_NO;
-#ifdef CO_DRIVER_ERROR_REPORTING
-    CO_CANinterfaceState_t ifState;
-#endif
     ssize_t n;
 
-    if (CANmodule==NULL || interface==NULL || interface->fd < 0) {
-        return CO_ERROR_PARAMETERS;
-    }
-
-#ifdef CO_DRIVER_ERROR_REPORTING
-    ifState = CO_CANerror_txMsg(&interface->errorhandler);
-    switch (ifState) {
-        case CO_INTERFACE_ACTIVE:
-            /* continue */
-            break;
-        case CO_INTERFACE_LISTEN_ONLY:
-            /* silently drop message */
-            return CO_ERROR_NO;
-        default:
-            return CO_ERROR_INVALID_STATE;
-    }
-#endif
-
     do {
         errno = 0;
-        n = send(interface->fd, buffer, CAN_MTU, MSG_DONTWAIT);
-        if (errno == EINTR) {
-            /* try again */
-            continue;
-        }
-        else if (errno == EAGAIN) {
-            /* socket queue full */
-            break;
-        }
-        else if (errno == ENOBUFS) {
-            /* socketCAN doesn't support blocking write. You can wait here for
-             * a few hundred us and then try again */
-            return CO_ERROR_TX_BUSY;
-        }
-        else if (n != CAN_MTU) {
-            break;
-        }
-    } while (errno != 0);
+        n = send(interface->fd, frame, CAN_MTU, MSG_DONTWAIT);
+    } while (errno == EINTR);
 
-    if(n != CAN_MTU){
-#ifdef USE_EMERGENCY_OBJECT
-        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
-#endif
-        log_printf(LOG_ERR, DBG_CAN_TX_FAILED, buffer->ident, interface->ifName);
-        log_printf(LOG_DEBUG, DBG_ERRNO, "send()");
-        err = CO_ERROR_TX_OVERFLOW;
+    if (n == CAN_MTU) {
+        interface->txFrames ++;
+        return 0;
     }
-
-    return err;
+    return (errno != 0) ? errno : EIO;
 }
 
+#ifdef CO_DRIVER_TX_QUEUE
 
-/******************************************************************************/
-CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
+/** Enable/disable EPOLLOUT for interface *************************************/
+static void CO_CANtxQueueEpollOut(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        bool_t                  enable)
 {
-    CO_ReturnError_t err;
-    err = CO_CANCheckSend(CANmodule, buffer);
-    if (err == CO_ERROR_TX_BUSY) {
-        /* send doesn't have "busy" */
-#ifdef USE_EMERGENCY_OBJECT
-        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
-#endif
-        log_printf(LOG_ERR, DBG_CAN_TX_FAILED, buffer->ident, "CANx");
-        log_printf(LOG_DEBUG, DBG_ERRNO, "send()");
-        err = CO_ERROR_TX_OVERFLOW;
+    struct epoll_event ev;
+
+    if (interface->txEpollOut == enable) {
+        return;
     }
-    return err;
-}
 
+    ev.events = CO_CANrxEpollEvents(interface);
+    if (enable) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.fd = interface->fd;
+    if (epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_MOD, interface->fd, &ev) == 0) {
+        interface->txEpollOut = enable;
+    }
+    else {
+        log_printf(LOG_DEBUG, DBG_ERRNO, "epoll_ctl(can)");
+    }
+}
 
-/******************************************************************************/
-CO_ReturnError_t CO_CANCheckSend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
+/** Remove entry from tx queue, CO_LOCK_CAN_SEND() must be held ***************/
+static void CO_CANtxQueueRemove(CO_CANmodule_t *CANmodule, uint16_t pos)
 {
-    uint32_t i;
-    CO_ReturnError_t err = CO_ERROR_NO;
+    uint16_t txIndex = CANmodule->txQueue[pos].txIndex;
+    uint16_t i;
+
+    CANmodule->txQueueCount --;
+    memmove(&CANmodule->txQueue[pos], &CANmodule->txQueue[pos + 1],
+            (CANmodule->txQueueCount - pos) * sizeof(CANmodule->txQueue[0]));
+
+    /* buffer may still be queued for other interfaces */
+    for (i = 0; i < CANmodule->txQueueCount; i ++) {
+        if (CANmodule->txQueue[i].txIndex == txIndex) {
+            return;
+        }
+    }
+    CANmodule->txArray[txIndex].bufferFull = false;
+}
+
+/** Add entry to tx queue, CO_LOCK_CAN_SEND() must be held ********************/
+static bool_t CO_CANtxQueueAdd(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                txIndex,
+        uint16_t                interfaceIndex)
+{
+    uint32_t ident = CANmodule->txArray[txIndex].ident & CAN_SFF_MASK;
+    uint16_t i;
+
+    if (CANmodule->txQueueCount >= CO_DRIVER_TX_QUEUE) {
+        return false;
+    }
+
+    /* lower COB ID has higher priority. Messages with same COB ID keep their
+     * order. */
+    i = CANmodule->txQueueCount;
+    while (i > 0 &&
+           (CANmodule->txArray[CANmodule->txQueue[i - 1].txIndex].ident & CAN_SFF_MASK) > ident) {
+        CANmodule->txQueue[i] = CANmodule->txQueue[i - 1];
+        i --;
+    }
+    CANmodule->txQueue[i].txIndex = txIndex;
+    CANmodule->txQueue[i].interfaceIndex = interfaceIndex;
+    CANmodule->txQueueCount ++;
+    CANmodule->txArray[txIndex].bufferFull = true;
+
+    return true;
+}
+
+/** Send queued messages for one interface, CO_LOCK_CAN_SEND() must be held ***/
+static void CO_CANtxQueueDrain(CO_CANmodule_t *CANmodule, uint16_t interfaceIndex)
+{
+    CO_CANinterface_t *interface = &CANmodule->CANinterfaces[interfaceIndex];
+    bool_t waitWritable = false;
+    uint16_t i;
+    int ret;
+
+    i = 0;
+    while (i < CANmodule->txQueueCount) {
+        CO_CANtx_t *buffer;
+
+        if (CANmodule->txQueue[i].interfaceIndex != interfaceIndex) {
+            i ++;
+            continue;
+        }
+        buffer = &CANmodule->txArray[CANmodule->txQueue[i].txIndex];
+
+        ret = CO_CANsendFrame(interface, buffer);
+        if (ret == EAGAIN) {
+            /* socket queue full, continue when socket is writable again */
+            waitWritable = true;
+            break;
+        }
+        else if (ret == ENOBUFS) {
+            /* device queue full. This is not signalled by epoll, retry on
+             * next call of CO_CANrxWait() */
+            break;
+        }
+        else if (ret != 0) {
+#ifdef USE_EMERGENCY_OBJECT
+            CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
+#endif
+            log_printf(LOG_ERR, DBG_CAN_TX_FAILED, buffer->ident, interface->ifName);
+            log_printf(LOG_DEBUG, DBG_ERRNO, "send()");
+        }
+        CO_CANtxQueueRemove(CANmodule, i);
+    }
+
+    CO_CANtxQueueEpollOut(CANmodule, interface, waitWritable);
+}
+
+/** Send queued messages for all interfaces ***********************************/
+static void CO_CANtxQueueDrainAll(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+
+    CO_LOCK_CAN_SEND(CANmodule);
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANtxQueueDrain(CANmodule, i);
+    }
+    CO_UNLOCK_CAN_SEND(CANmodule);
+}
+
+#endif
+
+#ifdef CO_DRIVER_TX_BATCH
+
+/** Report staged message, that could not be sent *****************************/
+static void CO_CANtxBatchReport(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        const struct iovec     *iov)
+{
+#ifdef USE_EMERGENCY_OBJECT
+    CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
+#endif
+    log_printf(LOG_ERR, DBG_CAN_TX_FAILED,
+               ((const struct can_frame*)iov->iov_base)->can_id, interface->ifName);
+    log_printf(LOG_DEBUG, DBG_ERRNO, "sendmmsg()");
+}
+
+#ifdef CO_DRIVER_TX_QUEUE
+
+/** Check for queued messages of interface, CO_LOCK_CAN_SEND() must be held ***/
+static bool_t CO_CANtxQueuePending(CO_CANmodule_t *CANmodule, uint16_t interfaceIndex)
+{
+    uint16_t i;
+
+    for (i = 0; i < CANmodule->txQueueCount; i ++) {
+        if (CANmodule->txQueue[i].interfaceIndex == interfaceIndex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Move staged messages _first_ ... _count_-1 of the interface to the tx queue
+ * and drain it, CO_LOCK_CAN_SEND() must be held.
+ *
+ * The queue sends the current data of the tx buffer, like for messages
+ * queued by CO_CANsend(). A buffer already queued for the interface is not
+ * added again. If the queue is full, the rest is dropped with one report.
+ */
+static void CO_CANtxBatchRequeue(
+        CO_CANmodule_t         *CANmodule,
+        uint16_t                interfaceIndex,
+        uint16_t                first,
+        uint16_t                count)
+{
+    const struct iovec *lost = NULL;
+    uint16_t k;
+    uint16_t i;
+
+    for (k = first; k < count; k ++) {
+        const struct iovec *iov = &CANmodule->txBatchIov[k];
+        uint16_t txIndex = CANmodule->txBatchTxIndex[
+                (const struct can_frame*)iov->iov_base - CANmodule->txBatchMsg];
+
+        for (i = 0; i < CANmodule->txQueueCount; i ++) {
+            if (CANmodule->txQueue[i].txIndex == txIndex &&
+                CANmodule->txQueue[i].interfaceIndex == interfaceIndex) {
+                break;
+            }
+        }
+        if (i < CANmodule->txQueueCount) {
+            continue;
+        }
+        if (!CO_CANtxQueueAdd(CANmodule, txIndex, interfaceIndex) && lost == NULL) {
+            lost = iov;
+        }
+    }
+    if (lost != NULL) {
+        CO_CANtxBatchReport(CANmodule, &CANmodule->CANinterfaces[interfaceIndex], lost);
+    }
+    CO_CANtxQueueDrain(CANmodule, interfaceIndex);
+}
+
+#endif
+
+/** Send staged messages for one interface ************************************/
+static void CO_CANtxBatchFlushInterface(
+        CO_CANmodule_t         *CANmodule,
+        uint32_t                interfaceIndex)
+{
+    CO_CANinterface_t *interface = &CANmodule->CANinterfaces[interfaceIndex];
+    uint16_t i;
+    uint16_t count;
+    uint16_t sent;
+    int32_t n;
+
+    /* collect messages for this interface, keep order */
+    count = 0;
+    for (i = 0; i < CANmodule->txBatchCount; i ++) {
+        if (CANmodule->txBatchInterface[i] == interfaceIndex) {
+            struct mmsghdr *hdr = &CANmodule->txBatchHdr[count];
+
+            CANmodule->txBatchIov[count].iov_base = &CANmodule->txBatchMsg[i];
+            CANmodule->txBatchIov[count].iov_len = CAN_MTU;
+
+            memset(hdr, 0, sizeof(*hdr));
+            hdr->msg_hdr.msg_iov = &CANmodule->txBatchIov[count];
+            hdr->msg_hdr.msg_iovlen = 1;
+
+            count ++;
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+
+#ifdef CO_DRIVER_TX_QUEUE
+    CO_LOCK_CAN_SEND(CANmodule);
+    if (CO_CANtxQueuePending(CANmodule, interfaceIndex)) {
+        /* older messages wait for the socket, don't overtake them */
+        CO_CANtxBatchRequeue(CANmodule, interfaceIndex, 0, count);
+        CO_UNLOCK_CAN_SEND(CANmodule);
+        return;
+    }
+#endif
+
+    sent = 0;
+    while (sent < count) {
+        errno = 0;
+        n = sendmmsg(interface->fd, &CANmodule->txBatchHdr[sent], count - sent,
+                     MSG_DONTWAIT);
+        if (n > 0) {
+            sent += n;
+            interface->txFrames += n;
+        }
+        else if (errno == EINTR) {
+            /* try again */
+        }
+        else if (errno == EAGAIN || errno == ENOBUFS) {
+            /* socket or device queue full, the rest would fail as well */
+#ifdef CO_DRIVER_TX_QUEUE
+            CO_CANtxBatchRequeue(CANmodule, interfaceIndex, sent, count);
+#else
+            /* CO_CANsend() already returned successfully, so report like
+             * CO_CANsend() does, once for all dropped messages */
+            CO_CANtxBatchReport(CANmodule, interface, &CANmodule->txBatchIov[sent]);
+#endif
+            break;
+        }
+        else {
+            /* this message is refused, report it and continue with next */
+            CO_CANtxBatchReport(CANmodule, interface, &CANmodule->txBatchIov[sent]);
+            sent ++;
+        }
+    }
+
+#ifdef CO_DRIVER_TX_QUEUE
+    CO_UNLOCK_CAN_SEND(CANmodule);
+#endif
+}
+
+
+/** Stage message for transmission ********************************************/
+static CO_ReturnError_t CO_CANtxBatchStage(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANtx_t             *buffer,
+        CO_CANinterface_t      *interface)
+{
+    if (CANmodule->txBatchCount >= CO_DRIVER_TX_BATCH) {
+        uint32_t i;
+
+        /* queue full, send what we have so far */
+        for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+            CO_CANtxBatchFlushInterface(CANmodule, i);
+        }
+        CANmodule->txBatchCount = 0;
+    }
+
+    /* CANopenNode tx buffer is binary compatible to socketCAN frame */
+    memcpy(&CANmodule->txBatchMsg[CANmodule->txBatchCount], buffer, CAN_MTU);
+    CANmodule->txBatchInterface[CANmodule->txBatchCount] =
+            interface - CANmodule->CANinterfaces;
+    CANmodule->txBatchTxIndex[CANmodule->txBatchCount] = buffer - CANmodule->txArray;
+    CANmodule->txBatchCount ++;
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_CANtxBatchBegin(CO_CANmodule_t *CANmodule)
+{
+    if (CANmodule == NULL || CANmodule->txBatchHdr == NULL) {
+        return;
+    }
+
+    CANmodule->txBatchThread = pthread_self();
+    CANmodule->txBatchCount = 0;
+    CANmodule->txBatchActive = true;
+}
+
+
+/******************************************************************************/
+void CO_CANtxBatchFlush(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+
+    if (CANmodule == NULL || !CANmodule->txBatchActive) {
+        return;
+    }
+
+    CANmodule->txBatchActive = false;
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANtxBatchFlushInterface(CANmodule, i);
+    }
+    CANmodule->txBatchCount = 0;
+}
+
+#endif
+
+/******************************************************************************/
+static CO_ReturnError_t CO_CANCheckSendInterface(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANtx_t             *buffer,
+        CO_CANinterface_t      *interface)
+{
+    CO_ReturnError_t err = CO_ERROR_NO;
+#ifdef CO_DRIVER_ERROR_REPORTING
+    CO_CANinterfaceState_t ifState;
+#endif
+    int ret;
+
+    if (CANmodule==NULL || interface==NULL || interface->fd < 0) {
+        return CO_ERROR_PARAMETERS;
+    }
+
+#ifdef CO_DRIVER_ERROR_REPORTING
+    ifState = CO_CANerror_txMsg(&interface->errorhandler);
+    switch (ifState) {
+        case CO_INTERFACE_ACTIVE:
+            /* continue */
+            break;
+        case CO_INTERFACE_LISTEN_ONLY:
+            /* silently drop message */
+            return CO_ERROR_NO;
+        default:
+            return CO_ERROR_INVALID_STATE;
+    }
+#endif
+
+#ifdef CO_DRIVER_TX_BATCH
+    if (CANmodule->txBatchActive &&
+        pthread_equal(CANmodule->txBatchThread, pthread_self())) {
+        /* processing cycle of this thread is active, send later */
+        return CO_CANtxBatchStage(CANmodule, buffer, interface);
+    }
+#endif
+
+#ifdef CO_DRIVER_TX_QUEUE
+    /* queue message and send all queued messages in order of priority. If
+     * the socket can't take them, they are sent later by CO_CANrxWait() */
+    CO_LOCK_CAN_SEND(CANmodule);
+    if (CO_CANtxQueueAdd(CANmodule, buffer - CANmodule->txArray,
+                         interface - CANmodule->CANinterfaces)) {
+        CO_CANtxQueueDrain(CANmodule, interface - CANmodule->CANinterfaces);
+        ret = 0;
+    }
+    else {
+        ret = ENOBUFS;
+    }
+    CO_UNLOCK_CAN_SEND(CANmodule);
+#else
+    ret = CO_CANsendFrame(interface, buffer);
+    if (ret == ENOBUFS) {
+        /* socketCAN doesn't support blocking write. You can wait here for
+         * a few hundred us and then try again */
+        return CO_ERROR_TX_BUSY;
+    }
+#endif
+
+    if(ret != 0){
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
+#endif
+        log_printf(LOG_ERR, DBG_CAN_TX_FAILED, buffer->ident, interface->ifName);
+        log_printf(LOG_DEBUG, DBG_ERRNO, "send()");
+        err = CO_ERROR_TX_OVERFLOW;
+    }
+
+    return err;
+}
+
+
+/******************************************************************************/
+static CO_ReturnError_t CO_CANsendInterfaces(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
+{
+    uint32_t i;
+    CO_ReturnError_t err = CO_ERROR_NO;
 
     /* check on which interfaces to send this messages */
     for (i = 0; i < CANmodule->CANinterfaceCount; i++) {
         CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
 
-        if (buffer->CANbaseAddress < 0 ||
-            buffer->CANbaseAddress == interface->CANbaseAddress) {
+        if (buffer->CANbaseAddress < 0 ||
+            buffer->CANbaseAddress == interface->CANbaseAddress) {
+
+            CO_ReturnError_t tmp;
+
+            /* match, use this one */
+            tmp = CO_CANCheckSendInterface(CANmodule, buffer, interface);
+            if (tmp) {
+                /* only last error is returned to callee */
+                err = tmp;
+            }
+        }
+    }
+
+    return err;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
+{
+    CO_ReturnError_t err;
+#ifdef CO_DRIVER_TX_QUEUE
+    bool_t bufferFull;
+
+    /* cleared by the queue drain of other threads, read it under the lock */
+    CO_LOCK_CAN_SEND(CANmodule);
+    bufferFull = buffer->bufferFull;
+    CO_UNLOCK_CAN_SEND(CANmodule);
+    if (bufferFull) {
+        /* previous message is still queued, it will be sent with new data */
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, buffer->ident);
+#endif
+        return CO_ERROR_TX_OVERFLOW;
+    }
+    err = CO_CANsendInterfaces(CANmodule, buffer);
+#else
+    err = CO_CANCheckSend(CANmodule, buffer);
+#endif
+    if (err == CO_ERROR_TX_BUSY) {
+        /* send doesn't have "busy" */
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_TX_OVERFLOW, CO_EMC_CAN_OVERRUN, 0);
+#endif
+        log_printf(LOG_ERR, DBG_CAN_TX_FAILED, buffer->ident, "CANx");
+        log_printf(LOG_DEBUG, DBG_ERRNO, "send()");
+        err = CO_ERROR_TX_OVERFLOW;
+    }
+    return err;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_CANCheckSend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer)
+{
+#ifdef CO_DRIVER_TX_QUEUE
+    uint16_t count;
+    bool_t bufferFull;
+
+    /* keep space in queue for more important messages */
+    CO_LOCK_CAN_SEND(CANmodule);
+    count = CANmodule->txQueueCount;
+    bufferFull = buffer->bufferFull;
+    CO_UNLOCK_CAN_SEND(CANmodule);
+    if (bufferFull ||
+        (CO_DRIVER_TX_QUEUE - count) <= 1 ||
+        count >= (CO_DRIVER_TX_QUEUE / 2)) {
+        return CO_ERROR_TX_BUSY;
+    }
+#endif
+
+    return CO_CANsendInterfaces(CANmodule, buffer);
+}
+
+
+/******************************************************************************/
+void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule)
+{
+#ifdef CO_DRIVER_TX_QUEUE
+    uint32_t tpdoDeleted = 0U;
+    uint16_t i;
+
+    /* delete pending synchronous TPDOs from software queue. Messages already
+     * written to the socket can't be aborted. */
+    CO_LOCK_CAN_SEND(CANmodule);
+    i = 0;
+    while (i < CANmodule->txQueueCount) {
+        if (CANmodule->txArray[CANmodule->txQueue[i].txIndex].syncFlag) {
+            CO_CANtxQueueRemove(CANmodule, i);
+            tpdoDeleted = 2U;
+        }
+        else {
+            i ++;
+        }
+    }
+    CO_UNLOCK_CAN_SEND(CANmodule);
+
+#ifdef USE_EMERGENCY_OBJECT
+    if(tpdoDeleted != 0U){
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_TPDO_OUTSIDE_WINDOW, CO_EMC_COMMUNICATION, tpdoDeleted);
+    }
+#endif
+#else
+    /* Messages are either written to the socket queue or dropped */
+#endif
+}
+
+
+/******************************************************************************/
+void CO_CANverifyErrors(CO_CANmodule_t *CANmodule)
+{
+  /* socketCAN doesn't support microcontroller-like error counters. If an
+   * error has occured, a special can message is created by the driver and
+   * received by the application like a regular message.
+   * Therefore, error counter evaluation is included in rx function.*/
+}
+
+/** Report messages dropped on rx socket queue, counter from SO_RXQ_OVFL *****/
+static void CO_CANrxDropped(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        uint32_t                dropped)
+{
+    if (dropped > interface->rxDropCount) {
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                       CO_EMC_COMMUNICATION, 0);
+#endif
+        log_printf(LOG_ERR, CAN_RX_SOCKET_QUEUE_OVERFLOW,
+                   interface->ifName, dropped);
+        CANmodule->rxDropCount += dropped - interface->rxDropCount;
+    }
+    interface->rxDropCount = dropped;
+}
+
+/**
+ * Get timestamp and dropped messages counter from control messages. Doesn't
+ * touch the CANopen objects, so it may be called from receive threads.
+ *
+ * @return true if _dropped_ was set.
+ */
+static bool_t CO_CANreadCtrlMsgParse(
+        struct msghdr          *msghdr,
+        struct timespec        *timestamp,
+        uint32_t               *dropped)
+{
+    bool_t droppedValid = false;
+    struct cmsghdr *cmsg;
+
+    /* 0 if timestamp is not available */
+    timestamp->tv_sec = 0;
+    timestamp->tv_nsec = 0;
+
+    /* check for rx queue overflow, get rx time */
+    for (cmsg = CMSG_FIRSTHDR(msghdr);
+         cmsg && (cmsg->cmsg_level == SOL_SOCKET);
+         cmsg = CMSG_NXTHDR(msghdr, cmsg)) {
+        if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+            /* this is system time, not monotonic time! */
+            *timestamp = ((struct timespec*)CMSG_DATA(cmsg))[0];
+        }
+        else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+            *dropped = *(uint32_t*)CMSG_DATA(cmsg);
+            droppedValid = true;
+        }
+    }
+    return droppedValid;
+}
+
+/******************************************************************************/
+static void CO_CANreadCtrlMsg(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        struct msghdr          *msghdr,
+        struct timespec        *timestamp)
+{
+    uint32_t dropped;
+
+    if (CO_CANreadCtrlMsgParse(msghdr, timestamp, &dropped)) {
+        CO_CANrxDropped(CANmodule, interface, dropped);
+    }
+}
+
+#ifdef CO_DRIVER_RX_THREADS
+
+/**
+ * Receive thread of one interface. Reads messages from socket and hands them
+ * over to CO_CANrxWait() through single producer/single consumer ring.
+ */
+static void *CO_CANrxThread(void *arg)
+{
+    CO_CANrxThread_t *rxThread = (CO_CANrxThread_t*)arg;
+    CO_CANmodule_t *CANmodule = (CO_CANmodule_t*)rxThread->CANmodule;
+    CO_CANinterface_t *interface = &CANmodule->CANinterfaces[rxThread->interfaceIndex];
+    struct mmsghdr hdr[CO_CANRX_THREAD_BATCH];
+    struct iovec iov[CO_CANRX_THREAD_BATCH];
+    struct can_frame msg[CO_CANRX_THREAD_BATCH];
+    char ctrlmsg[CO_CANRX_THREAD_BATCH][CO_CANRX_CTRLMSG_SIZE];
+    CO_CANrxThreadEntry_t *entry;
+    uint32_t head;
+    uint32_t tail;
+    uint64_t notify = 1;
+    uint32_t sequence;
+    uint32_t dropped;
+    int32_t n;
+    int32_t i;
+
+    head = __atomic_load_n(&rxThread->head, __ATOMIC_ACQUIRE);
+    tail = rxThread->tail;
+
+    while (!rxThread->stop) {
+        for (i = 0; i < CO_CANRX_THREAD_BATCH; i ++) {
+            iov[i].iov_base = &msg[i];
+            iov[i].iov_len = sizeof(msg[i]);
+
+            hdr[i].msg_hdr.msg_name = NULL;
+            hdr[i].msg_hdr.msg_namelen = 0;
+            hdr[i].msg_hdr.msg_iov = &iov[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+            hdr[i].msg_hdr.msg_control = ctrlmsg[i];
+            hdr[i].msg_hdr.msg_controllen = sizeof(ctrlmsg[i]);
+            hdr[i].msg_hdr.msg_flags = 0;
+            hdr[i].msg_len = 0;
+        }
+
+        /* block until the first message or timeout, then take what's there */
+        n = recvmmsg(interface->fd, hdr, CO_CANRX_THREAD_BATCH, MSG_WAITFORONE, NULL);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+                log_printf(LOG_DEBUG, DBG_ERRNO, "recvmmsg()");
+            }
+            continue;
+        }
+
+        /* numbers for the whole batch, filtered messages leave gaps */
+        sequence = __atomic_fetch_add(&CANmodule->rxThreadSequence, (uint32_t)n,
+                                      __ATOMIC_RELAXED);
+
+        /* dispatch table is stable for the whole batch */
+        (void)pthread_rwlock_rdlock(&CO_CANrxDispatch_rwlock);
+        for (i = 0; i < n; i ++) {
+            if (hdr[i].msg_len != CAN_MTU) {
+                log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+                continue;
+            }
+            /* Drop messages without rx buffer. The dispatch table may change
+             * until CO_CANrxWait() takes the message, it searches again. */
+            if ((msg[i].can_id & CAN_ERR_FLAG) == 0 &&
+                CO_CANrxLookup(CANmodule, msg[i].can_id & CAN_EFF_MASK) ==
+                CO_CANRX_DISPATCH_NONE) {
+                rxThread->unmatched ++;
+                continue;
+            }
+
+            if (tail - head >= CO_DRIVER_RX_THREAD_RING) {
+                head = __atomic_load_n(&rxThread->head, __ATOMIC_ACQUIRE);
+                if (tail - head >= CO_DRIVER_RX_THREAD_RING) {
+                    /* CO_CANrxWait() doesn't keep up, it reports this */
+                    __atomic_store_n(&rxThread->overflows, rxThread->overflows + 1,
+                                     __ATOMIC_RELAXED);
+                    continue;
+                }
+            }
+
+            entry = &rxThread->ring[tail & (CO_DRIVER_RX_THREAD_RING - 1)];
+            entry->msg = msg[i];
+            entry->sequence = sequence + (uint32_t)i;
+            if (CO_CANreadCtrlMsgParse(&hdr[i].msg_hdr, &entry->timestamp, &dropped)) {
+                __atomic_store_n(&rxThread->socketDropped, dropped, __ATOMIC_RELAXED);
+            }
+            tail ++;
+        }
+        (void)pthread_rwlock_unlock(&CO_CANrxDispatch_rwlock);
+
+        if (tail != rxThread->tail) {
+            __atomic_store_n(&rxThread->tail, tail, __ATOMIC_RELEASE);
+            if (write(CANmodule->fdRxThreads, &notify, sizeof(notify)) < 0) {
+                /* eventfd counter is saturated, CO_CANrxWait() is woken anyway */
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/** Start receive threads for all interfaces read from socket *****************/
+static CO_ReturnError_t CO_CANrxThreadsStart(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+    int ret;
+    pthread_attr_t attr;
+    cpu_set_t cpus;
+    struct timeval timeout;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
+        CO_CANrxThread_t *rxThread;
+
+        if (interface->rxBackend != CO_CANRX_BACKEND_SOCKET ||
+            interface->rxThread != NULL) {
+            continue;
+        }
+
+        /* blocking receive returns regularly, so the thread can terminate */
+        timeout.tv_sec = 0;
+        timeout.tv_usec = CO_CANRX_THREAD_TIMEOUT_MS * 1000;
+        ret = setsockopt(interface->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+                         sizeof(timeout));
+        if (ret < 0) {
+            log_printf(LOG_DEBUG, DBG_ERRNO, "setsockopt(rcvtimeo)");
+            return CO_ERROR_SYSCALL;
+        }
+
+        /* head and tail are aligned to cache lines */
+        ret = posix_memalign((void**)&rxThread, CO_DRIVER_CACHE_LINE, sizeof(*rxThread));
+        if (ret != 0) {
+            errno = ret;
+            log_printf(LOG_DEBUG, DBG_ERRNO, "posix_memalign()");
+            return CO_ERROR_OUT_OF_MEMORY;
+        }
+        memset(rxThread, 0, sizeof(*rxThread));
+        rxThread->CANmodule = CANmodule;
+        rxThread->interfaceIndex = i;
+        rxThread->stop = false;
+
+        pthread_attr_init(&attr);
+        if (interface->rxThreadCpu >= 0) {
+            CPU_ZERO(&cpus);
+            CPU_SET(interface->rxThreadCpu, &cpus);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+        }
+        ret = pthread_create(&rxThread->thread, &attr, CO_CANrxThread, rxThread);
+        pthread_attr_destroy(&attr);
+        if (ret != 0) {
+            errno = ret;
+            log_printf(LOG_DEBUG, DBG_ERRNO, "pthread_create()");
+            free(rxThread);
+            return CO_ERROR_SYSCALL;
+        }
+        interface->rxThread = rxThread;
+    }
+
+    return CO_ERROR_NO;
+}
+
+/** Stop receive threads, messages left in rings are dropped ******************/
+static void CO_CANrxThreadsStop(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANrxThread_t *rxThread = CANmodule->CANinterfaces[i].rxThread;
+
+        if (rxThread != NULL) {
+            rxThread->stop = true;
+        }
+    }
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANrxThread_t *rxThread = CANmodule->CANinterfaces[i].rxThread;
+
+        if (rxThread != NULL) {
+            pthread_join(rxThread->thread, NULL);
+            free(rxThread);
+            CANmodule->CANinterfaces[i].rxThread = NULL;
+        }
+    }
+    CANmodule->rxThreadBudget = 0;
+}
+
+/** Check if receive thread rings contain messages ****************************/
+static bool_t CO_CANrxThreadsPending(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANrxThread_t *rxThread = CANmodule->CANinterfaces[i].rxThread;
+
+        if (rxThread != NULL &&
+            __atomic_load_n(&rxThread->tail, __ATOMIC_ACQUIRE) != rxThread->head) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Report overflows counted by the receive threads. Called by CO_CANrxWait(),
+ * so the emergency object is only used from there.
+ */
+static void CO_CANrxThreadsErrors(CO_CANmodule_t *CANmodule)
+{
+    uint32_t i;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
+        CO_CANrxThread_t *rxThread = interface->rxThread;
+        uint32_t overflows;
+
+        if (rxThread == NULL) {
+            continue;
+        }
+        CO_CANrxDropped(CANmodule, interface,
+                        __atomic_load_n(&rxThread->socketDropped, __ATOMIC_RELAXED));
+        overflows = __atomic_load_n(&rxThread->overflows, __ATOMIC_RELAXED);
+        if (overflows != rxThread->overflowsReported) {
+            rxThread->overflowsReported = overflows;
+#ifdef USE_EMERGENCY_OBJECT
+            CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                           CO_EMC_COMMUNICATION, overflows);
+#endif
+            log_printf(LOG_ERR, CAN_RX_SOCKET_QUEUE_OVERFLOW,
+                       interface->ifName, overflows);
+        }
+    }
+}
+
+/**
+ * Take oldest message from receive thread rings, the one with the lowest
+ * sequence number. Each ring is in order of reception, so messages with the
+ * same identifier keep their order.
+ *
+ * @return interface the message was received from, NULL if rings are empty.
+ */
+static CO_CANinterface_t *CO_CANrxThreadsTake(
+        CO_CANmodule_t         *CANmodule,
+        struct can_frame       *msg,
+        struct timespec        *timestamp)
+{
+    uint32_t i;
+    CO_CANinterface_t *interface = NULL;
+    CO_CANrxThreadEntry_t *oldest = NULL;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANrxThread_t *rxThread = CANmodule->CANinterfaces[i].rxThread;
+        CO_CANrxThreadEntry_t *entry;
+
+        if (rxThread == NULL ||
+            __atomic_load_n(&rxThread->tail, __ATOMIC_ACQUIRE) == rxThread->head) {
+            continue;
+        }
+        entry = &rxThread->ring[rxThread->head & (CO_DRIVER_RX_THREAD_RING - 1)];
+        /* sequence numbers wrap around */
+        if (oldest == NULL || (int32_t)(entry->sequence - oldest->sequence) < 0) {
+            oldest = entry;
+            interface = &CANmodule->CANinterfaces[i];
+        }
+    }
+
+    if (interface != NULL) {
+        *msg = oldest->msg;
+        *timestamp = oldest->timestamp;
+        __atomic_store_n(&interface->rxThread->head, interface->rxThread->head + 1,
+                         __ATOMIC_RELEASE);
+    }
+    return interface;
+}
+
+#endif
+
+#ifdef CO_DRIVER_RX_RING
+
+/** Update dropped messages counter from ring socket statistics ***************/
+static void CO_CANreadRingStatistics(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface)
+{
+    struct tpacket_stats_v3 stats;
+    socklen_t sLen = sizeof(stats);
+
+    /* kernel resets statistics on every read */
+    if (getsockopt(interface->fdRing, SOL_PACKET, PACKET_STATISTICS, &stats, &sLen) < 0) {
+        return;
+    }
+    if (stats.tp_drops > 0) {
+        interface->rxDropCount += stats.tp_drops;
+        CANmodule->rxDropCount += stats.tp_drops;
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                       CO_EMC_COMMUNICATION, 0);
+#endif
+        log_printf(LOG_ERR, CAN_RX_SOCKET_QUEUE_OVERFLOW,
+                   interface->ifName, interface->rxDropCount);
+    }
+}
+
+/**
+ * Get next message from TPACKET_V3 rx ring. The message is not copied, _msg_
+ * points into the ring block. The block is given back to the kernel by the
+ * next call for this interface, so the message is valid until then.
+ */
+static CO_ReturnError_t CO_CANreadRing(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        const struct can_frame **msg,
+        struct timespec        *timestamp)
+{
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *pkt;
+    struct sockaddr_ll *addr;
+
+    for (;;) {
+        block = (struct tpacket_block_desc *)(interface->ring +
+                interface->ringBlock * CO_CANRX_RING_BLOCK_SIZE);
+
+        if (interface->ringPktLeft == 0) {
+            if (interface->ringPkt != NULL) {
+                /* block finished, give it back to kernel */
+                CANrxMemoryBarrier();
+                block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+                interface->ringPkt = NULL;
+                interface->ringBlock = (interface->ringBlock + 1) % CO_CANRX_RING_BLOCK_NR;
+                CO_CANreadRingStatistics(CANmodule, interface);
+                continue;
+            }
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+                /* no message available */
+                return CO_ERROR_TIMEOUT;
+            }
+            CANrxMemoryBarrier();
+            interface->ringPkt = (uint8_t *)block + block->hdr.bh1.offset_to_first_pkt;
+            interface->ringPktLeft = block->hdr.bh1.num_pkts;
+            continue;
+        }
+
+        pkt = (struct tpacket3_hdr *)interface->ringPkt;
+        interface->ringPktLeft --;
+        interface->ringPkt += pkt->tp_next_offset;
+
+        /* ignore own messages and CAN FD */
+        addr = (struct sockaddr_ll *)((uint8_t *)pkt +
+                                      TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+        if (addr->sll_pkttype == PACKET_OUTGOING ||
+            addr->sll_pkttype == PACKET_LOOPBACK ||
+            pkt->tp_snaplen != CAN_MTU) {
+            continue;
+        }
+
+        *msg = (const struct can_frame *)((uint8_t *)pkt + pkt->tp_mac);
+        /* this is system time, not monotonic time! */
+        timestamp->tv_sec = pkt->tp_sec;
+        timestamp->tv_nsec = pkt->tp_nsec;
+
+        return CO_ERROR_NO;
+    }
+}
+
+#endif
+
+#ifdef CO_DRIVER_IO_URING
+
+/** Get next message received by multishot recvmsg() **************************/
+static CO_ReturnError_t CO_CANreadUring(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        struct can_frame       *msg,
+        struct timespec        *timestamp)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+    struct io_uring_recvmsg_out *out;
+    struct msghdr msghdr;
+    uint8_t *buf;
+    uint16_t bid;
+
+    if (interface->uringRxCount == 0) {
+        /* no message available */
+        return CO_ERROR_TIMEOUT;
+    }
+    bid = interface->uringRxFifo[interface->uringRxHead];
+    interface->uringRxHead = (interface->uringRxHead + 1) & (CO_DRIVER_IO_URING_BUFFERS - 1);
+    interface->uringRxCount --;
+
+    buf = uring->buf + bid * CO_CANURING_BUF_SIZE;
+    out = (struct io_uring_recvmsg_out *)buf;
+    if (out->payloadlen != CAN_MTU || (out->flags & MSG_TRUNC) != 0) {
+        CO_CANuringBufferRelease(uring, bid);
+        uring->bufUsed --;
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                       CO_EMC_CAN_OVERRUN, out->payloadlen);
+#endif
+        log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+        return CO_ERROR_SYSCALL;
+    }
+
+    /* buffer layout: header, name (not used), control messages, payload */
+    memset(&msghdr, 0, sizeof(msghdr));
+    msghdr.msg_control = buf + sizeof(*out);
+    msghdr.msg_controllen = out->controllen;
+    msghdr.msg_flags = out->flags;
+    memcpy(msg, buf + sizeof(*out) + uring->rxMsg.msg_controllen, CAN_MTU);
+    CO_CANreadCtrlMsg(CANmodule, interface, &msghdr, timestamp);
+
+    CO_CANuringBufferRelease(uring, bid);
+    uring->bufUsed --;
+
+    return CO_ERROR_NO;
+}
+
+#endif
+
+#ifdef CO_DRIVER_RX_BATCH
+
+/******************************************************************************/
+static CO_ReturnError_t CO_CANread(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        struct can_frame       *msg,
+        struct timespec        *timestamp)
+{
+    int32_t n;
+    uint16_t i;
+    uint16_t count;
+    struct mmsghdr *hdr;
+
+#ifdef CO_DRIVER_IO_URING
+    if (CANmodule->uring.fd >= 0) {
+        return CO_CANreadUring(CANmodule, interface, msg, timestamp);
+    }
+#endif
+
+    if (CANmodule->rxBatchNext >= CANmodule->rxBatchCount) {
+        /* don't take more messages than the receive budget allows */
+        count = CO_DRIVER_RX_BATCH;
+        if (interface->rxBudget > 0 && interface->rxBudget < count) {
+            count = interface->rxBudget;
+        }
+
+        /* batch is empty, get all available messages up to batch size. Header
+         * fields are reset every time as the kernel modifies them. */
+        for (i = 0; i < count; i ++) {
+            hdr = &CANmodule->rxBatchHdr[i];
+
+            CANmodule->rxBatchIov[i].iov_base = &CANmodule->rxBatchMsg[i];
+            CANmodule->rxBatchIov[i].iov_len = sizeof(CANmodule->rxBatchMsg[i]);
+
+            hdr->msg_hdr.msg_name = NULL;
+            hdr->msg_hdr.msg_namelen = 0;
+            hdr->msg_hdr.msg_iov = &CANmodule->rxBatchIov[i];
+            hdr->msg_hdr.msg_iovlen = 1;
+            hdr->msg_hdr.msg_control = CANmodule->rxBatchCtrl[i];
+            hdr->msg_hdr.msg_controllen = sizeof(CANmodule->rxBatchCtrl[i]);
+            hdr->msg_hdr.msg_flags = 0;
+            hdr->msg_len = 0;
+        }
+
+        n = recvmmsg(interface->fd, CANmodule->rxBatchHdr, count,
+                     MSG_DONTWAIT, NULL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            /* no message available */
+            return CO_ERROR_TIMEOUT;
+        }
+        if (n <= 0) {
+#ifdef USE_EMERGENCY_OBJECT
+            CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                           CO_EMC_CAN_OVERRUN, n);
+#endif
+            log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+            log_printf(LOG_DEBUG, DBG_ERRNO, "recvmmsg()");
+            return CO_ERROR_SYSCALL;
+        }
+        CANmodule->rxBatchInterface = interface;
+        CANmodule->rxBatchCount = n;
+        CANmodule->rxBatchNext = 0;
+    }
+
+    /* messages are evaluated in order of reception */
+    i = CANmodule->rxBatchNext;
+    CANmodule->rxBatchNext ++;
+    hdr = &CANmodule->rxBatchHdr[i];
+    if (hdr->msg_len != CAN_MTU) {
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                       CO_EMC_CAN_OVERRUN, hdr->msg_len);
+#endif
+        log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+        log_printf(LOG_DEBUG, DBG_ERRNO, "recvmmsg()");
+        return CO_ERROR_SYSCALL;
+    }
+    *msg = CANmodule->rxBatchMsg[i];
+
+    CO_CANreadCtrlMsg(CANmodule, interface, &hdr->msg_hdr, timestamp);
+
+    return CO_ERROR_NO;
+}
+
+#else
+
+/******************************************************************************/
+static CO_ReturnError_t CO_CANread(
+        CO_CANmodule_t         *CANmodule,
+        CO_CANinterface_t      *interface,
+        struct can_frame       *msg,
+        struct timespec        *timestamp)
+{
+    int32_t n;
+    /* recvmsg - like read, but generates statistics about the socket
+     * example in berlios candump.c */
+    struct iovec iov;
+    struct msghdr msghdr;
+    char ctrlmsg[CO_CANRX_CTRLMSG_SIZE];
+
+#ifdef CO_DRIVER_IO_URING
+    if (CANmodule->uring.fd >= 0) {
+        return CO_CANreadUring(CANmodule, interface, msg, timestamp);
+    }
+#endif
+
+    iov.iov_base = msg;
+    iov.iov_len = sizeof(*msg);
+
+    msghdr.msg_name = NULL;
+    msghdr.msg_namelen = 0;
+    msghdr.msg_iov = &iov;
+    msghdr.msg_iovlen = 1;
+    msghdr.msg_control = &ctrlmsg;
+    msghdr.msg_controllen = sizeof(ctrlmsg);
+    msghdr.msg_flags = 0;
+
+    n = recvmsg(interface->fd, &msghdr, MSG_DONTWAIT);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        /* no message available */
+        return CO_ERROR_TIMEOUT;
+    }
+    if (n != CAN_MTU) {
+#ifdef USE_EMERGENCY_OBJECT
+        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
+                       CO_EMC_CAN_OVERRUN, n);
+#endif
+        log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
+        log_printf(LOG_DEBUG, DBG_ERRNO, "recvmsg()");
+        return CO_ERROR_SYSCALL;
+    }
+
+    CO_CANreadCtrlMsg(CANmodule, interface, &msghdr, timestamp);
+
+    return CO_ERROR_NO;
+}
+
+#endif
+
+static int32_t CO_CANrxMsg(
+        CO_CANmodule_t        *CANmodule,
+        const struct can_frame *msg,
+        const struct timespec *timestamp,
+        CO_CANrxMsg_t         *buffer)
+{
+    int32_t retval;
+    CO_CANrxMsg_t rcvMsgBuf;
+    const CO_CANrxMsg_t *rcvMsg;  /* pointer to received message */
+    uint16_t index;               /* index of received message */
+    CO_CANrx_t *rcvMsgObj = NULL; /* receive message object from CO_CANmodule_t object. */
+
+    /* CANopenNode can message begins binary compatible to the socketCAN one,
+     * except for extension flags */
+    memcpy(&rcvMsgBuf, msg, sizeof(*msg));
+    rcvMsgBuf.ident &= CAN_EFF_MASK;
+    rcvMsgBuf.timestamp = *timestamp;
+    rcvMsg = &rcvMsgBuf;
+
+    /* Message has been received. Search rxArray for the CAN-ID */
+    index = CO_CANrxLookup(CANmodule, rcvMsg->ident);
+    if(index != CO_CANRX_DISPATCH_NONE) {
+        rcvMsgObj = &CANmodule->rxArray[index];
+        /* Call specific function, which will process the message */
+        if ((rcvMsgObj != NULL) && (rcvMsgObj->pFunct != NULL)){
+            rcvMsgObj->pFunct(rcvMsgObj->object, rcvMsg);
+        }
+        /* return message */
+        if (buffer != NULL) {
+            memcpy(buffer, rcvMsg, sizeof(*buffer));
+        }
+        retval = index;
+    }
+    else {
+        /* passed socket filter, but no rx buffer */
+        CANmodule->rxUnmatched ++;
+        retval = -1;
+    }
+
+    return retval;
+}
+
+/** Process received message, _rxTime_ is CLOCK_MONOTONIC *******************/
+static int32_t CO_CANrxProcess(
+        CO_CANmodule_t        *CANmodule,
+        CO_CANinterface_t     *interface,
+        const struct can_frame *msg,
+        const struct timespec *rxTime,
+        CO_CANrxMsg_t         *buffer)
+{
+    int32_t retval;
+
+    retval = -1;
+    if(CANmodule->CANnormal){
+
+        if (msg->can_id & CAN_ERR_FLAG) {
+            /* error msg */
+#ifdef CO_DRIVER_ERROR_REPORTING
+            CO_CANerror_rxMsgError(&interface->errorhandler, msg);
+#endif
+        }
+        else {
+            /* data msg */
+            int32_t msgIndex;
+
+#ifdef CO_DRIVER_ERROR_REPORTING
+            CO_CANerror_rxMsg(&interface->errorhandler);
+#endif
+
+            msgIndex = CO_CANrxMsg(CANmodule, msg, rxTime, buffer);
+            if (msgIndex > -1) {
+#ifdef CO_DRIVER_MULTI_INTERFACE
+                /* Store message info */
+                CANmodule->rxArray[msgIndex].timestamp = *rxTime;
+                CANmodule->rxArray[msgIndex].CANbaseAddress = interface->CANbaseAddress;
+#endif
+            }
+            retval = msgIndex;
+        }
+    }
+    return retval;
+}
+
+/******************************************************************************/
+static int32_t CO_CANrxEvaluate(
+        CO_CANmodule_t        *CANmodule,
+        CO_CANinterface_t     *interface,
+        const struct can_frame *msg,
+        struct timespec       *timestamp,
+        CO_CANrxMsg_t         *buffer)
+{
+    struct timespec rxTime;
+
+    /* socket timestamp to monotonic time. Current time is only used if the
+     * control message with the timestamp was missing. */
+    if (timestamp->tv_sec == 0 && timestamp->tv_nsec == 0) {
+        (void)clock_gettime(CLOCK_MONOTONIC, &rxTime);
+    }
+    else {
+        rxTime.tv_sec = timestamp->tv_sec - CANmodule->rxClockOffset.tv_sec;
+        rxTime.tv_nsec = timestamp->tv_nsec - CANmodule->rxClockOffset.tv_nsec;
+        if (rxTime.tv_nsec < 0) {
+            rxTime.tv_sec --;
+            rxTime.tv_nsec += 1000000000L;
+        }
+    }
+
+    return CO_CANrxProcess(CANmodule, interface, msg, &rxTime, buffer);
+}
+
+#ifdef CO_DRIVER_MULTI_INTERFACE
+
+/******************************************************************************/
+int32_t CO_CANrxFrame(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        const struct can_frame *msg,
+        const struct timespec  *timestamp)
+{
+    uint32_t i;
+    struct timespec rxTime;
+
+    if (CANmodule == NULL || msg == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i++) {
+        CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
+
+        if (interface->rxBackend == CO_CANRX_BACKEND_EXTERNAL &&
+            interface->CANbaseAddress == CANbaseAddress) {
+
+            if (timestamp != NULL) {
+                rxTime = *timestamp;
+            }
+            else {
+                (void)clock_gettime(CLOCK_MONOTONIC, &rxTime);
+            }
+            interface->rxFrames ++;
+            return CO_CANrxProcess(CANmodule, interface, msg, &rxTime, NULL);
+        }
+    }
+    return -1;
+}
+
+#endif
+
+/** Wait for events, mark ready interfaces *********************************/
+static int32_t CO_CANrxEpollWait(CO_CANmodule_t *CANmodule, int fdTimer, int timeout)
+{
+    int32_t ret;
+    int32_t i;
+    uint32_t j;
+    struct epoll_event ev[CO_CANRX_EPOLL_EVENTS];
+    struct can_frame msg;
+
+    do {
+        errno = 0;
+        ret = epoll_wait(CANmodule->fdEpoll, ev, CO_CANRX_EPOLL_EVENTS, timeout);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        /* epoll failed */
+        return -1;
+    }
+
+    /* take all events of this wakeup */
+    for (i = 0; i < ret; i ++) {
+        CO_CANinterface_t *interface = NULL;
+
+        if (ev[i].data.fd == CO_NotifyPipeGetFd(CANmodule->pipe)) {
+            /* pipe is level triggered, empty it */
+            CO_NotifyPipeReceive(CANmodule->pipe);
+            CANmodule->rxNotifyReady = true;
+            continue;
+        }
+        if (ev[i].data.fd == fdTimer) {
+            /* timer socket */
+            CANmodule->rxNotifyReady = true;
+            continue;
+        }
+#ifdef CO_DRIVER_RX_THREADS
+        if (ev[i].data.fd == CANmodule->fdRxThreads) {
+            /* receive threads added messages, reset counter */
+            uint64_t count;
+
+            if (read(CANmodule->fdRxThreads, &count, sizeof(count)) < 0) {
+                /* counter was reset already */
+            }
+            continue;
+        }
+#endif
+
+        /* CAN socket */
+        for (j = 0; j < CANmodule->CANinterfaceCount; j ++) {
+            if (ev[i].data.fd == CANmodule->CANinterfaces[j].fd) {
+                interface = &CANmodule->CANinterfaces[j];
+                break;
+            }
+#ifdef CO_DRIVER_RX_RING
+            if (ev[i].data.fd == CANmodule->CANinterfaces[j].fdRing) {
+                /* rx ring has a block ready */
+                interface = &CANmodule->CANinterfaces[j];
+                break;
+            }
+#endif
+        }
+        if (interface == NULL) {
+            continue;
+        }
 
-            CO_ReturnError_t tmp;
+#ifdef CO_DRIVER_TX_QUEUE
+        if ((ev[i].events & EPOLLOUT) != 0) {
+            /* CAN socket can take messages again */
+            CO_LOCK_CAN_SEND(CANmodule);
+            CO_CANtxQueueDrain(CANmodule, j);
+            CO_UNLOCK_CAN_SEND(CANmodule);
+        }
+#endif
 
-            /* match, use this one */
-            tmp = CO_CANCheckSendInterface(CANmodule, buffer, interface);
-            if (tmp) {
-                /* only last error is returned to callee */
-                err = tmp;
+        if ((ev[i].events & (EPOLLERR | EPOLLHUP)) != 0) {
+            /* epoll detected close/error on socket. Try to pull event */
+            errno = 0;
+#ifdef CO_DRIVER_RX_THREADS
+            if (interface->rxThread != NULL) {
+                /* don't take a message from the receive thread */
+                int err = 0;
+                socklen_t len = sizeof(err);
+
+                getsockopt(ev[i].data.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+                errno = err;
             }
+            else
+#endif
+            recv(ev[i].data.fd, &msg, sizeof(msg), MSG_DONTWAIT);
+            log_printf(LOG_DEBUG, DBG_CAN_RX_EPOLL, ev[i].events, strerror(errno));
+        }
+        else if ((ev[i].events & EPOLLIN) != 0) {
+            interface->rxReady = true;
+            interface->rxBudget = CO_DRIVER_RX_BUDGET;
+            interface->rxWakeups ++;
         }
     }
 
-    return err;
+    return ret;
 }
 
-
-/******************************************************************************/
-void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule)
+/** Get next interface to service, round robin ********************************/
+static CO_CANinterface_t *CO_CANrxNextReady(CO_CANmodule_t *CANmodule)
 {
-    /* Messages are either written to the socket queue or dropped */
+    uint32_t i;
+    uint32_t index;
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        index = (CANmodule->rxServiceNext + i) % CANmodule->CANinterfaceCount;
+        if (CANmodule->CANinterfaces[index].rxReady) {
+            CANmodule->rxServiceNext = index;
+            return &CANmodule->CANinterfaces[index];
+        }
+    }
+    return NULL;
 }
 
+#ifdef CO_DRIVER_IO_URING
 
-/******************************************************************************/
-void CO_CANverifyErrors(CO_CANmodule_t *CANmodule)
+/** Get free submission queue entry, NULL if queue is full ********************/
+static struct io_uring_sqe *CO_CANuringGetSqe(CO_CANuring_t *uring)
 {
-  /* socketCAN doesn't support microcontroller-like error counters. If an
-   * error has occured, a special can message is created by the driver and
-   * received by the application like a regular message.
-   * Therefore, error counter evaluation is included in rx function.*/
+    struct io_uring_sqe *sqe;
+    uint32_t head;
+    uint32_t tail;
+
+    head = __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+    tail = *uring->sqTail;
+    if (tail - head > uring->sqMask) {
+        return NULL;
+    }
+    /* the kernel only reads entries in io_uring_enter(), so the tail can be
+     * published before the entry is filled */
+    sqe = &uring->sqes[tail & uring->sqMask];
+    memset(sqe, 0, sizeof(*sqe));
+    uring->sqArray[tail & uring->sqMask] = tail & uring->sqMask;
+    __atomic_store_n(uring->sqTail, tail + 1, __ATOMIC_RELEASE);
+    uring->sqPending ++;
+    return sqe;
 }
 
-/******************************************************************************/
-static CO_ReturnError_t CO_CANread(
-        CO_CANmodule_t         *CANmodule,
-        CO_CANinterface_t      *interface,
-        struct can_frame       *msg,
-        struct timespec        *timestamp)
+/** Prepare poll request ******************************************************/
+static bool_t CO_CANuringPoll(
+        CO_CANuring_t          *uring,
+        int                     fd,
+        uint32_t                events,
+        bool_t                  multishot,
+        uint64_t                userData)
 {
-    int32_t n;
-    uint32_t dropped;
-    /* recvmsg - like read, but generates statistics about the socket
-     * example in berlios candump.c */
-    struct iovec iov;
-    struct msghdr msghdr;
-    char ctrlmsg[CMSG_SPACE(sizeof(struct timeval)) + CMSG_SPACE(sizeof(dropped))];
-    struct cmsghdr *cmsg;
+    struct io_uring_sqe *sqe;
 
-    iov.iov_base = msg;
-    iov.iov_len = sizeof(*msg);
+    sqe = CO_CANuringGetSqe(uring);
+    if (sqe == NULL) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = events;
+    sqe->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+    sqe->user_data = userData;
+    return true;
+}
 
-    msghdr.msg_name = NULL;
-    msghdr.msg_namelen = 0;
-    msghdr.msg_iov = &iov;
-    msghdr.msg_iovlen = 1;
-    msghdr.msg_control = &ctrlmsg;
-    msghdr.msg_controllen = sizeof(ctrlmsg);
-    msghdr.msg_flags = 0;
+/** (Re-)arm all requests that are not active *********************************/
+static void CO_CANuringArm(CO_CANmodule_t *CANmodule)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+    struct io_uring_sqe *sqe;
+    uint32_t i;
 
-    n = recvmsg(interface->fd, &msghdr, 0);
-    if (n != CAN_MTU) {
-#ifdef USE_EMERGENCY_OBJECT
-        CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
-                       CO_EMC_CAN_OVERRUN, n);
-#endif
-        log_printf(LOG_DEBUG, DBG_CAN_RX_FAILED, interface->ifName);
-        log_printf(LOG_DEBUG, DBG_ERRNO, "recvmsg()");
-        return CO_ERROR_SYSCALL;
+    if (!uring->notifyArmed) {
+        uring->notifyArmed = CO_CANuringPoll(uring, CO_NotifyPipeGetFd(CANmodule->pipe),
+                POLLIN, false, CO_CANURING_DATA(CO_CANURING_NOTIFY, 0));
     }
 
-    /* check for rx queue overflow, get rx time */
-    for (cmsg = CMSG_FIRSTHDR(&msghdr);
-         cmsg && (cmsg->cmsg_level == SOL_SOCKET);
-         cmsg = CMSG_NXTHDR(&msghdr, cmsg)) {
-        if (cmsg->cmsg_type == SO_TIMESTAMPING) {
-            /* this is system time, not monotonic time! */
-            *timestamp = ((struct timespec*)CMSG_DATA(cmsg))[0];
+    if (!uring->timerArmed && CANmodule->fdTimerRead >= 0) {
+        if (uring->timerInterval > 0) {
+            /* cycle timer, absolute time to avoid drift */
+            sqe = CO_CANuringGetSqe(uring);
+            if (sqe != NULL) {
+                sqe->opcode = IORING_OP_TIMEOUT;
+                sqe->fd = -1;
+                sqe->addr = (uintptr_t)&uring->timerNext;
+                sqe->len = 1;
+                sqe->timeout_flags = IORING_TIMEOUT_ABS;
+                sqe->user_data = CO_CANURING_DATA(CO_CANURING_TIMER, 0);
+                uring->timerArmed = true;
+            }
         }
-        else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
-            dropped = *(uint32_t*)CMSG_DATA(cmsg);
-            if (dropped > CANmodule->rxDropCount) {
-#ifdef USE_EMERGENCY_OBJECT
-                CO_errorReport((CO_EM_t*)CANmodule->em, CO_EM_CAN_RXB_OVERFLOW,
-                               CO_EMC_COMMUNICATION, 0);
+        else {
+            /* not a timerfd interval, wait for fd */
+            uring->timerArmed = CO_CANuringPoll(uring, CANmodule->fdTimerRead,
+                    POLLIN, false, CO_CANURING_DATA(CO_CANURING_TIMER, 0));
+        }
+    }
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CO_CANinterface_t *interface = &CANmodule->CANinterfaces[i];
+
+        if (!interface->uringRxArmed &&
+            interface->rxBackend != CO_CANRX_BACKEND_EXTERNAL) {
+#ifdef CO_DRIVER_RX_RING
+            if (interface->rxBackend == CO_CANRX_BACKEND_RING) {
+                interface->uringRxArmed = CO_CANuringPoll(uring, interface->fdRing,
+                        POLLIN, true, CO_CANURING_DATA(CO_CANURING_POLLRX, i));
+            }
+            else
 #endif
-                log_printf(LOG_ERR, CAN_RX_SOCKET_QUEUE_OVERFLOW,
-                           interface->ifName, dropped);
+            if (uring->bufUsed < CO_DRIVER_IO_URING_BUFFERS) {
+                sqe = CO_CANuringGetSqe(uring);
+                if (sqe != NULL) {
+                    sqe->opcode = IORING_OP_RECVMSG;
+                    sqe->fd = interface->fd;
+                    sqe->addr = (uintptr_t)&uring->rxMsg;
+                    sqe->len = 1;
+                    sqe->ioprio = IORING_RECV_MULTISHOT;
+                    sqe->flags = IOSQE_BUFFER_SELECT;
+                    sqe->buf_group = CO_CANURING_BUF_GROUP;
+                    sqe->user_data = CO_CANURING_DATA(CO_CANURING_RECV, i);
+                    interface->uringRxArmed = true;
+                }
             }
-            CANmodule->rxDropCount = dropped;
-            //todo use this info!
         }
+#ifdef CO_DRIVER_TX_QUEUE
+        if (interface->txEpollOut && !interface->uringTxArmed) {
+            interface->uringTxArmed = CO_CANuringPoll(uring, interface->fd,
+                    POLLOUT, false, CO_CANURING_DATA(CO_CANURING_POLLTX, i));
+        }
+#endif
+    }
+}
+
+/** Cycle timer expired *******************************************************/
+static void CO_CANuringTimerExpired(CO_CANuring_t *uring)
+{
+    struct timespec now;
+    uint64_t late;
+    uint64_t expired;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    late = (now.tv_sec - uring->timerNext.tv_sec) * 1000000000LL +
+           (now.tv_nsec - uring->timerNext.tv_nsec);
+    if ((int64_t)late < 0) {
+        late = 0;
     }
+    expired = 1 + late / uring->timerInterval;
 
-    return CO_ERROR_NO;
+    uring->timerNext.tv_nsec += expired * uring->timerInterval;
+    uring->timerNext.tv_sec += uring->timerNext.tv_nsec / 1000000000LL;
+    uring->timerNext.tv_nsec %= 1000000000LL;
+    uring->timerExpired += expired;
 }
 
-static int32_t CO_CANrxMsg(
-        CO_CANmodule_t        *CANmodule,
-        struct can_frame      *msg,
-        CO_CANrxMsg_t         *buffer)
+/** Take over interval of timerfd, use timeout request instead ***************/
+static void CO_CANuringTimerInit(CO_CANmodule_t *CANmodule, int fdTimer)
 {
-    int32_t retval;
-    const CO_CANrxMsg_t *rcvMsg;  /* pointer to received message in CAN module */
-    uint16_t index;               /* index of received message */
-    CO_CANrx_t *rcvMsgObj = NULL; /* receive message object from CO_CANmodule_t object. */
-    bool_t msgMatched = false;
-
-    /* CANopenNode can message is binary compatible to the socketCAN one, except
-     * for extension flags */
-    msg->can_id &= CAN_EFF_MASK;
-    rcvMsg = (CO_CANrxMsg_t *)msg;
-
-    /* Message has been received. Search rxArray from CANmodule for the
-     * same CAN-ID. */
-    rcvMsgObj = &CANmodule->rxArray[0];
-    for (index = 0; index < CANmodule->rxSize; index ++) {
-        if(((rcvMsg->ident ^ rcvMsgObj->ident) & rcvMsgObj->mask) == 0U){
-            msgMatched = true;
+    CO_CANuring_t *uring = &CANmodule->uring;
+    struct itimerspec itval;
+    struct timespec now;
+
+    uring->timerInterval = 0;
+    uring->timerExpired = 0;
+    if (timerfd_gettime(fdTimer, &itval) < 0 ||
+        (itval.it_interval.tv_sec == 0 && itval.it_interval.tv_nsec == 0)) {
+        /* no interval timer, fd is polled */
+        return;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    uring->timerInterval = itval.it_interval.tv_sec * 1000000000LL +
+                           itval.it_interval.tv_nsec;
+    uring->timerNext.tv_sec = now.tv_sec + itval.it_value.tv_sec;
+    uring->timerNext.tv_nsec = now.tv_nsec + itval.it_value.tv_nsec;
+    uring->timerNext.tv_sec += uring->timerNext.tv_nsec / 1000000000LL;
+    uring->timerNext.tv_nsec %= 1000000000LL;
+
+    /* stop timerfd */
+    memset(&itval, 0, sizeof(itval));
+    (void)timerfd_settime(fdTimer, 0, &itval, NULL);
+}
+
+/** io_uring not usable, give timer back and continue with epoll **************/
+static void CO_CANuringFallback(CO_CANmodule_t *CANmodule)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+    struct itimerspec itval;
+    uint32_t i;
+
+    log_printf(LOG_DEBUG, DBG_ERRNO, "io_uring, using epoll");
+    if (uring->timerInterval > 0 && CANmodule->fdTimerRead >= 0) {
+        itval.it_interval.tv_sec = uring->timerInterval / 1000000000LL;
+        itval.it_interval.tv_nsec = uring->timerInterval % 1000000000LL;
+        itval.it_value = itval.it_interval;
+        (void)timerfd_settime(CANmodule->fdTimerRead, 0, &itval, NULL);
+    }
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        CANmodule->CANinterfaces[i].uringRxCount = 0;
+    }
+    CO_CANuringDisable(CANmodule);
+}
+
+/** Evaluate one completion, returns false if io_uring is not usable **********/
+static bool_t CO_CANuringComplete(CO_CANmodule_t *CANmodule, struct io_uring_cqe *cqe)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+    CO_CANinterface_t *interface = NULL;
+    uint32_t type = (uint32_t)(cqe->user_data >> 16);
+    uint32_t index = (uint32_t)(cqe->user_data & 0xffff);
+    uint16_t bid;
+    uint16_t tail;
+    bool_t more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+    uring->completions ++;
+    if (index < CANmodule->CANinterfaceCount) {
+        interface = &CANmodule->CANinterfaces[index];
+    }
+
+    switch (type) {
+        case CO_CANURING_NOTIFY:
+            /* empty the pipe like the epoll path does, otherwise the poll
+             * request completes again immediately after re-arming */
+            CO_NotifyPipeReceive(CANmodule->pipe);
+            uring->notifyArmed = false;
+            CANmodule->rxNotifyReady = true;
+            break;
+        case CO_CANURING_TIMER:
+            uring->timerArmed = false;
+            if (uring->timerInterval > 0) {
+                if (cqe->res != -ETIME) {
+                    break;
+                }
+                CO_CANuringTimerExpired(uring);
+            }
+            CANmodule->rxNotifyReady = true;
+            break;
+        case CO_CANURING_RECV:
+            if ((cqe->flags & IORING_CQE_F_BUFFER) != 0) {
+                bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+                uring->bufUsed ++;
+                if (cqe->res > 0 && interface != NULL) {
+                    tail = (interface->uringRxHead + interface->uringRxCount) &
+                           (CO_DRIVER_IO_URING_BUFFERS - 1);
+                    interface->uringRxFifo[tail] = bid;
+                    interface->uringRxCount ++;
+                }
+                else {
+                    CO_CANuringBufferRelease(uring, bid);
+                    uring->bufUsed --;
+                }
+            }
+            if (!more && interface != NULL) {
+                /* multishot receive terminated, e.g. because no buffers were
+                 * left (ENOBUFS). It is armed again by next wait. */
+                interface->uringRxArmed = false;
+            }
+            if (cqe->res == -EINVAL) {
+                /* multishot recvmsg() not supported */
+                return false;
+            }
+            if (cqe->res < 0 && cqe->res != -ENOBUFS) {
+                errno = -cqe->res;
+                log_printf(LOG_DEBUG, DBG_ERRNO, "io_uring(recvmsg)");
+            }
+            break;
+        case CO_CANURING_POLLRX:
+            if (cqe->res == -EINVAL) {
+                return false;
+            }
+            if (!more && interface != NULL) {
+                interface->uringRxArmed = false;
+            }
+            if (cqe->res > 0 && interface != NULL) {
+                interface->rxReady = true;
+                interface->rxBudget = CO_DRIVER_RX_BUDGET;
+                interface->rxWakeups ++;
+            }
+            break;
+#ifdef CO_DRIVER_TX_QUEUE
+        case CO_CANURING_POLLTX:
+            if (interface != NULL) {
+                interface->uringTxArmed = false;
+                if (cqe->res > 0) {
+                    /* CAN socket can take messages again */
+                    CO_LOCK_CAN_SEND(CANmodule);
+                    CO_CANtxQueueDrain(CANmodule, index);
+                    CO_UNLOCK_CAN_SEND(CANmodule);
+                }
+            }
             break;
+#endif
+        default:
+            break;
+    }
+    return true;
+}
+
+/**
+ * Arm requests, submit and wait for completions with one io_uring_enter()
+ * call. Does not block if received messages are left from last pass.
+ */
+static int32_t CO_CANuringWait(CO_CANmodule_t *CANmodule)
+{
+    CO_CANuring_t *uring = &CANmodule->uring;
+    CO_CANinterface_t *interface;
+    int32_t ret;
+    uint32_t i;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t minComplete = 1;
+    bool_t usable = true;
+
+    CO_CANuringArm(CANmodule);
+
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        interface = &CANmodule->CANinterfaces[i];
+        if (interface->uringRxCount > 0) {
+            /* messages left, budget was used up in last pass */
+            minComplete = 0;
         }
-        rcvMsgObj++;
+#ifdef CO_DRIVER_RX_RING
+        if (interface->rxBackend == CO_CANRX_BACKEND_RING &&
+            interface->rxBudget == 0) {
+            minComplete = 0;
+        }
+#endif
     }
-    if(msgMatched) {
-        /* Call specific function, which will process the message */
-        if ((rcvMsgObj != NULL) && (rcvMsgObj->pFunct != NULL)){
-            rcvMsgObj->pFunct(rcvMsgObj->object, rcvMsg);
+
+    if (uring->sqPending > 0 || minComplete > 0) {
+        do {
+            errno = 0;
+            ret = syscall(__NR_io_uring_enter, uring->fd, uring->sqPending,
+                          minComplete, IORING_ENTER_GETEVENTS, NULL, 0);
+            uring->enterCalls ++;
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0) {
+            log_printf(LOG_DEBUG, DBG_ERRNO, "io_uring_enter()");
+            return -1;
         }
-        /* return message */
-        if (buffer != NULL) {
-            memcpy(buffer, rcvMsg, sizeof(*buffer));
+        uring->sqPending -= ret;
+    }
+
+    /* take all completions of this wakeup */
+    head = *uring->cqHead;
+    tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        if (!CO_CANuringComplete(CANmodule, &uring->cqes[head & uring->cqMask])) {
+            usable = false;
         }
-        retval = index;
+        head ++;
     }
-    else {
-        retval = -1;
+    __atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+
+    if (!usable) {
+        CO_CANuringFallback(CANmodule);
+        return 0;
     }
 
-    return retval;
+    for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
+        interface = &CANmodule->CANinterfaces[i];
+        if (interface->rxReady) {
+            continue;
+        }
+        if (interface->uringRxCount > 0) {
+            interface->rxReady = true;
+            interface->rxBudget = CO_DRIVER_RX_BUDGET;
+            interface->rxWakeups ++;
+        }
+#ifdef CO_DRIVER_RX_RING
+        else if (interface->rxBackend == CO_CANRX_BACKEND_RING &&
+                 interface->rxBudget == 0) {
+            /* ring may still contain messages, poll doesn't signal them again */
+            interface->rxReady = true;
+            interface->rxBudget = CO_DRIVER_RX_BUDGET;
+        }
+#endif
+    }
+
+    return 0;
+}
+
+#endif
+
+/** Interface is serviced for this pass, continue with next one ***************/
+static void CO_CANrxDone(CO_CANmodule_t *CANmodule, CO_CANinterface_t *interface)
+{
+    interface->rxReady = false;
+    CANmodule->rxServiceNext = ((interface - CANmodule->CANinterfaces) + 1) %
+                               CANmodule->CANinterfaceCount;
 }
 
 /******************************************************************************/
 int32_t CO_CANrxWait(CO_CANmodule_t *CANmodule, int fdTimer, CO_CANrxMsg_t *buffer)
 {
-    int32_t retval;
     int32_t ret;
-    int32_t CANbaseAddress __attribute__((unused));
     CO_ReturnError_t err;
     CO_CANinterface_t *interface = NULL;
-    struct epoll_event ev[1];
+    struct epoll_event ev;
     struct can_frame msg;
+    const struct can_frame *frame = &msg;
     struct timespec timestamp;
+#ifdef CO_DRIVER_TX_QUEUE
+    bool_t txQueued;
+#endif
 
     if (CANmodule==NULL || CANmodule->CANinterfaceCount==0) {
         return -1;
     }
+    CANmodule->rxWaitUsed = true;
 
     if (fdTimer>=0 && fdTimer!=CANmodule->fdTimerRead) {
         /* new timer, timer changed */
         epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_DEL, CANmodule->fdTimerRead, NULL);
-        ev[0].events = EPOLLIN;
-        ev[0].data.fd = fdTimer;
-        ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev[0].data.fd, &ev[0]);
+        ev.events = EPOLLIN;
+        ev.data.fd = fdTimer;
+        ret = epoll_ctl(CANmodule->fdEpoll, EPOLL_CTL_ADD, ev.data.fd, &ev);
         if(ret < 0){
             return -1;
         }
         CANmodule->fdTimerRead = fdTimer;
+#ifdef CO_DRIVER_IO_URING
+        if (CANmodule->uring.fd >= 0) {
+            CO_CANuringTimerInit(CANmodule, fdTimer);
+            CANmodule->uring.timerArmed = false;
+        }
+#endif
+    }
+
+#ifdef CO_DRIVER_TX_QUEUE
+    CO_LOCK_CAN_SEND(CANmodule);
+    txQueued = CANmodule->txQueueCount > 0;
+    CO_UNLOCK_CAN_SEND(CANmodule);
+    if (txQueued) {
+        /* retry messages that could not be sent before */
+        CO_CANtxQueueDrainAll(CANmodule);
     }
+#endif
+
+#ifdef CO_DRIVER_RX_BATCH
+    if (CANmodule->rxBatchNext < CANmodule->rxBatchCount) {
+        /* messages from last recvmmsg() call are pending, no need to wait */
+        interface = CANmodule->rxBatchInterface;
+        err = CO_CANread(CANmodule, interface, &msg, &timestamp);
+        if (err != CO_ERROR_NO) {
+            return -1;
+        }
+        interface->rxFrames ++;
+        if (interface->rxBudget > 0) {
+            interface->rxBudget --;
+            if (interface->rxBudget == 0) {
+                CO_CANrxDone(CANmodule, interface);
+            }
+        }
+        return CO_CANrxEvaluate(CANmodule, interface, &msg, &timestamp, buffer);
+    }
+#endif
 
     /*
-     * blocking read using epoll
+     * All events of one epoll wakeup are serviced in one pass: timer and pipe
+     * first, then each ready CAN interface for up to CO_DRIVER_RX_BUDGET
+     * messages, round robin. epoll is only called again after the pass.
      */
-    do {
-        errno = 0;
-        ret = epoll_wait(CANmodule->fdEpoll, ev, sizeof(ev) / sizeof(ev[0]), -1);
-        if (errno == EINTR) {
-            /* try again */
-            continue;
-        }
-        else if (ret < 0) {
-            /* epoll failed */
+    for (;;) {
+        if (CANmodule->rxNotifyReady) {
+            /* timer/pipe socket */
+            CANmodule->rxNotifyReady = false;
             return -1;
         }
-        else if ((ev[0].events & (EPOLLERR | EPOLLHUP)) != 0) {
-            /* epoll detected close/error on socket. Try to pull event */
-            errno = 0;
-            recv(ev[0].data.fd, &msg, sizeof(msg), MSG_DONTWAIT);
-            log_printf(LOG_DEBUG, DBG_CAN_RX_EPOLL, ev[0].events, strerror(errno));
-            continue;
+
+#ifdef CO_DRIVER_RX_THREADS
+        if (CANmodule->rxThreadBudget > 0) {
+            /* receive thread rings first, oldest message of all rings */
+            interface = CO_CANrxThreadsTake(CANmodule, &msg, &timestamp);
+            if (interface != NULL) {
+                CANmodule->rxThreadBudget --;
+                interface->rxFrames ++;
+                break;
+            }
+            CANmodule->rxThreadBudget = 0;
         }
-        else if ((ev[0].events & EPOLLIN) != 0) {
-            /* one of the sockets is ready */
-            if ((ev[0].data.fd == CO_NotifyPipeGetFd(CANmodule->pipe)) ||
-                (ev[0].data.fd == fdTimer)) {
-                /* timer/pipe socket */
+#endif
+
+        interface = CO_CANrxNextReady(CANmodule);
+        if (interface == NULL) {
+            /* pass finished, blocking wait for next events */
+#ifdef CO_DRIVER_IO_URING
+            if (CANmodule->uring.fd >= 0) {
+                if (CO_CANuringWait(CANmodule) < 0) {
+                    return -1;
+                }
+                CO_CANrxClockOffsetUpdate(CANmodule);
+                continue;
+            }
+#endif
+#ifdef CO_DRIVER_RX_THREADS
+            /* don't block while receive thread rings hold messages */
+            if (CO_CANrxEpollWait(CANmodule, fdTimer,
+                                  CO_CANrxThreadsPending(CANmodule) ? 0 : -1) < 0) {
                 return -1;
             }
-            else {
-                /* CAN socket */
-                uint32_t i;
-
-                for (i = 0; i < CANmodule->CANinterfaceCount; i ++) {
-                    interface = &CANmodule->CANinterfaces[i];
-
-                    if (ev[0].data.fd == interface->fd) {
-                        /* get interface handle */
-                        CANbaseAddress = interface->CANbaseAddress;
-                        /* get message */
-                        err = CO_CANread(CANmodule, interface, &msg, &timestamp);
-                        if (err != CO_ERROR_NO) {
-                            return -1;
-                        }
-                        /* no need to continue search */
-                        break;
-                    }
-                }
+            CANmodule->rxThreadBudget = CO_DRIVER_RX_BUDGET * CANmodule->CANinterfaceCount;
+            CO_CANrxThreadsErrors(CANmodule);
+#else
+            if (CO_CANrxEpollWait(CANmodule, fdTimer, -1) < 0) {
+                return -1;
             }
+#endif
+            CO_CANrxClockOffsetUpdate(CANmodule);
+            continue;
+        }
+
+        /* get message */
+#ifdef CO_DRIVER_RX_RING
+        if (interface->rxBackend == CO_CANRX_BACKEND_RING) {
+            /* used in place, the ring isn't read again before evaluation */
+            err = CO_CANreadRing(CANmodule, interface, &frame, &timestamp);
+        }
+        else
+#endif
+        {
+            err = CO_CANread(CANmodule, interface, &msg, &timestamp);
+        }
+        if (err == CO_ERROR_TIMEOUT) {
+            /* socket is empty */
+            CO_CANrxDone(CANmodule, interface);
+            continue;
+        }
+        else if (err != CO_ERROR_NO) {
+            CO_CANrxDone(CANmodule, interface);
+            return -1;
+        }
+
+        interface->rxFrames ++;
+        interface->rxBudget --;
+        if (interface->rxBudget == 0) {
+            CO_CANrxDone(CANmodule, interface);
         }
-    } while (errno != 0);
+        break;
+    }
 
     /*
      * evaluate Rx
      */
-    retval = -1;
-    if(CANmodule->CANnormal){
-
-        if (msg.can_id & CAN_ERR_FLAG) {
-            /* error msg */
-#ifdef CO_DRIVER_ERROR_REPORTING
-            CO_CANerror_rxMsgError(&interface->errorhandler, &msg);
-#endif
-        }
-        else {
-            /* data msg */
-            int32_t msgIndex;
+    return CO_CANrxEvaluate(CANmodule, interface, frame, &timestamp, buffer);
+}
 
-#ifdef CO_DRIVER_ERROR_REPORTING
-            CO_CANerror_rxMsg(&interface->errorhandler);
+/******************************************************************************/
+uint64_t CO_CANrxTimerRead(CO_CANmodule_t *CANmodule, int fdTimer)
+{
+    uint64_t expired = 0;
+
+#ifdef CO_DRIVER_IO_URING
+    if (CANmodule != NULL && CANmodule->uring.fd >= 0 &&
+        CANmodule->uring.timerInterval > 0 && fdTimer == CANmodule->fdTimerRead) {
+        /* timer is a timeout request */
+        expired = CANmodule->uring.timerExpired;
+        CANmodule->uring.timerExpired = 0;
+        return expired;
+    }
 #endif
 
-            msgIndex = CO_CANrxMsg(CANmodule, &msg, buffer);
-            if (msgIndex > -1) {
-#ifdef CO_DRIVER_MULTI_INTERFACE
-                /* Store message info */
-                CANmodule->rxArray[msgIndex].timestamp = timestamp;
-                CANmodule->rxArray[msgIndex].CANbaseAddress = CANbaseAddress;
-#endif
-            }
-            retval = msgIndex;
-        }
+    if (read(fdTimer, &expired, sizeof(expired)) != sizeof(expired)) {
+        return 0;
     }
-    return retval;
+    return expired;
 }
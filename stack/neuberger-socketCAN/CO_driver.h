@@ -79,6 +79,162 @@ extern "C" {
  */
 //#define CO_DRIVER_ERROR_REPORTING
 
+/**
+ * @name batched reception
+ *
+ * Enable this to receive up to CO_DRIVER_RX_BATCH CAN messages with one
+ * recvmmsg() syscall. Received messages are buffered inside the driver and
+ * returned in order by the following CO_CANrxWait() calls without waiting
+ * for epoll again.
+ */
+//#define CO_DRIVER_RX_BATCH 16
+
+/**
+ * @name batched transmission
+ *
+ * Enable this to stage up to CO_DRIVER_TX_BATCH CAN messages inside the
+ * driver while a processing cycle is active (see CO_CANtxBatchBegin()). Staged
+ * messages are sent with one sendmmsg() syscall per interface by
+ * CO_CANtxBatchFlush(). Messages from other threads are sent immediately.
+ */
+//#define CO_DRIVER_TX_BATCH 16
+
+/**
+ * @name software transmit queue
+ *
+ * Enable this to queue up to CO_DRIVER_TX_QUEUE CAN messages inside the driver
+ * if the socket can't take them (EAGAIN, ENOBUFS). Queued messages are sorted
+ * by COB ID, so the message with the highest CAN priority is sent first. The
+ * queue is drained by CO_CANrxWait(). While a message is queued, _bufferFull_
+ * of the transmit buffer is set, like in the microcontroller drivers.
+ */
+//#define CO_DRIVER_TX_QUEUE 32
+
+/**
+ * @name memory mapped receive ring
+ *
+ * Enable this to support receiving CAN messages from a TPACKET_V3 memory mapped
+ * ring on a PF_PACKET socket instead of calling recvmsg() for every message.
+ * The backend is selected per interface with CO_CANmodule_addInterfaceBackend().
+ * Without CO_DRIVER_MULTI_INTERFACE, the ring is used for the one interface.
+ *
+ * The kernel hands over ring blocks when they are full or after
+ * CO_DRIVER_RX_RING_TIMEOUT ms, which adds up to this time to rx latency.
+ * Messages are not filtered by the kernel, this is done by the driver. Messages
+ * sent by other sockets on the same host are not received.
+ */
+//#define CO_DRIVER_RX_RING
+#ifndef CO_DRIVER_RX_RING_TIMEOUT
+#define CO_DRIVER_RX_RING_TIMEOUT 1
+#endif
+
+/**
+ * @name rx filter compaction
+ *
+ * The socketCAN filter list is compacted before it is installed. Filters that
+ * are covered by another filter are removed. The kernel looks up exact 11 bit
+ * filters by hash, all other filters (masks, RTR) are checked one by one for
+ * every message. These are merged as long as the merged filters let at most
+ * CO_DRIVER_RX_FILTER_BUDGET CAN identifiers (11 bit + RTR) pass that don't
+ * belong to any rx buffer. With 0, only lossless merges are done.
+ *
+ * Enable CO_DRIVER_RX_FILTER_BPF to install a classic BPF socket filter
+ * instead of the filter list. The program checks exact identifiers with a
+ * binary search, there are no false positives.
+ */
+#ifndef CO_DRIVER_RX_FILTER_BUDGET
+#define CO_DRIVER_RX_FILTER_BUDGET 0
+#endif
+//#define CO_DRIVER_RX_FILTER_BPF
+
+/**
+ * @name io_uring event engine
+ *
+ * Enable this to wait for events with io_uring instead of epoll. Messages are
+ * received by one multishot recvmsg() request per CAN socket into
+ * CO_DRIVER_IO_URING_BUFFERS buffers shared with the kernel, the cycle timer
+ * of CO_CANrxWait() becomes a timeout request. Submitting requests and
+ * waiting for completions is one io_uring_enter() syscall per wakeup.
+ *
+ * If io_uring is not available (kernel < 6.0, disabled by sysctl), the epoll
+ * engine is used.
+ */
+//#define CO_DRIVER_IO_URING
+#ifndef CO_DRIVER_IO_URING_BUFFERS
+#define CO_DRIVER_IO_URING_BUFFERS 64 /* must be power of 2 */
+#endif
+
+/**
+ * @name Object Dictionary sequence lock
+ *
+ * Enable this to let CO_OD_READ_BEGIN()/CO_OD_READ_RETRY() read the Object
+ * Dictionary without taking the OD mutex. Writers still serialize on the mutex
+ * with CO_LOCK_OD() and increment a sequence counter on lock and unlock.
+ * Readers copy the values and retry if the counter changed meanwhile, so they
+ * never delay the realtime thread. Without this, the read functions take the
+ * mutex.
+ */
+//#define CO_DRIVER_OD_SEQLOCK
+
+/**
+ * @name receive threads
+ *
+ * Enable this to receive messages from every CAN socket in its own thread,
+ * optionally pinned to a CPU (CO_CANmodule_setRxThreadCpu()). The threads are
+ * started by CO_CANsetNormalMode(). A receive thread reads messages with
+ * recvmmsg(), drops messages without rx buffer and hands the others over to
+ * CO_CANrxWait() through a lock-free single producer/single consumer ring of
+ * CO_DRIVER_RX_THREAD_RING entries. CO_CANrxWait() always takes the oldest
+ * message available in the rings and calls the rx buffer callbacks. The
+ * threads number their messages from a common sequence counter when they
+ * store them, so the order doesn't depend on the system clock. Messages of one
+ * interface keep their order; between interfaces, a message published late by
+ * its thread may follow a newer one. Socket overflows and ring overflows are
+ * reported by CO_CANrxWait(), not by the threads. The threads search the dispatch
+ * table under a read lock, CO_CANrxBufferInit() changes it under the write
+ * lock. Benchmark in benchmark/rx_threads.c.
+ *
+ * Interfaces with rx ring backend are still read by CO_CANrxWait(). Can't be
+ * combined with CO_DRIVER_IO_URING.
+ */
+//#define CO_DRIVER_RX_THREADS
+#ifndef CO_DRIVER_RX_THREAD_RING
+#define CO_DRIVER_RX_THREAD_RING 256 /* must be power of 2 */
+#endif
+#ifndef CO_DRIVER_CACHE_LINE
+#define CO_DRIVER_CACHE_LINE 64 /* bytes, ring indices of different threads are kept apart */
+#endif
+
+#if defined CO_DRIVER_RX_THREADS && defined CO_DRIVER_IO_URING
+#error "CO_DRIVER_RX_THREADS and CO_DRIVER_IO_URING can't be combined"
+#endif
+
+/**
+ * @name tickless timer
+ *
+ * Enable this to let CANrx_threadTmr_process() arm its timerfd for the next
+ * deadline of SYNC, TPDOs and the mainline thread instead of waking every
+ * interval. The interval given to CANrx_threadTmr_init() becomes the minimum
+ * time between two processing passes. The mainline deadline includes the
+ * next 50 ms step of LED blinking. Can't be combined with CO_DRIVER_IO_URING.
+ */
+//#define CO_DRIVER_TICKLESS
+
+#if defined CO_DRIVER_TICKLESS && defined CO_DRIVER_IO_URING
+#error "CO_DRIVER_TICKLESS and CO_DRIVER_IO_URING can't be combined"
+#endif
+
+/**
+ * @name receive budget
+ *
+ * Maximum number of CAN messages received from one interface in one pass of
+ * CO_CANrxWait(), before the other interfaces are serviced and epoll is
+ * called again.
+ */
+#ifndef CO_DRIVER_RX_BUDGET
+#define CO_DRIVER_RX_BUDGET 8
+#endif
+
 
 #include "CO_driver_base.h"
 #include "CO_notify_pipe.h"
@@ -87,6 +243,62 @@ extern "C" {
   #include "CO_error.h"
 #endif
 
+#if defined CO_DRIVER_RX_BATCH || defined CO_DRIVER_TX_BATCH
+  #include <sys/socket.h>
+#endif
+
+#ifdef CO_DRIVER_IO_URING
+  #include <sys/socket.h>
+  #include <linux/io_uring.h>
+#endif
+
+/**
+ * Size of control message buffer for received messages. Contains software
+ * timestamp (three struct timespec) and dropped messages counter.
+ */
+#define CO_CANRX_CTRLMSG_SIZE (CMSG_SPACE(3 * sizeof(struct timespec)) + \
+                               CMSG_SPACE(sizeof(uint32_t)))
+
+/**
+ * Receive backend of a socketCAN interface
+ */
+typedef enum {
+    CO_CANRX_BACKEND_SOCKET = 0,        /**< recvmsg() on CAN_RAW socket */
+    CO_CANRX_BACKEND_RING = 1,          /**< TPACKET_V3 ring, needs CO_DRIVER_RX_RING */
+    CO_CANRX_BACKEND_EXTERNAL = 2       /**< socket is owned and read by the application,
+                                             messages are passed with #CO_CANrxFrame() */
+} CO_CANrxBackend_t;
+
+#ifdef CO_DRIVER_RX_THREADS
+/**
+ * Message handed over from receive thread to CO_CANrxWait()
+ */
+typedef struct {
+    struct can_frame    msg;            /**< received message */
+    struct timespec     timestamp;      /**< socket timestamp (CLOCK_REALTIME), 0 if not available */
+    uint32_t            sequence;       /**< order of all rings, from _rxThreadSequence_ of CO_CANmodule_t */
+} CO_CANrxThreadEntry_t;
+
+/**
+ * Receive thread of one interface
+ */
+typedef struct {
+    pthread_t           thread;
+    void               *CANmodule;      /**< CO_CANmodule_t the thread belongs to */
+    uint32_t            interfaceIndex; /**< index in _CANinterfaces_ */
+    volatile bool_t     stop;           /**< thread shall terminate */
+    /** next entry to take, written by CO_CANrxWait() */
+    uint32_t            head __attribute__((aligned(CO_DRIVER_CACHE_LINE)));
+    uint32_t            overflowsReported; /**< _overflows_ already reported by CO_CANrxWait() */
+    /** next entry to fill, written by receive thread */
+    uint32_t            tail __attribute__((aligned(CO_DRIVER_CACHE_LINE)));
+    uint32_t            overflows;      /**< statistics, messages dropped because ring was full */
+    uint32_t            unmatched;      /**< statistics, messages dropped without rx buffer */
+    uint32_t            socketDropped;  /**< SO_RXQ_OVFL counter of socket, reported by CO_CANrxWait() */
+    CO_CANrxThreadEntry_t ring[CO_DRIVER_RX_THREAD_RING];
+} CO_CANrxThread_t;
+#endif
+
 /**
  * socketCAN interface object
  */
@@ -94,11 +306,86 @@ typedef struct {
     int32_t             CANbaseAddress;   /**< CAN Interface identifier */
     char                ifName[IFNAMSIZ]; /**< CAN Interface name */
     int                 fd;               /**< socketCAN file descriptor */
+    CO_CANrxBackend_t   rxBackend;        /**< receive backend */
+#ifdef CO_DRIVER_RX_RING
+    int                 fdRing;           /**< PF_PACKET file descriptor with rx ring, -1 if not used */
+    uint8_t            *ring;             /**< mmap()ed TPACKET_V3 ring */
+    uint32_t            ringBlock;        /**< ring block currently processed */
+    uint8_t            *ringPkt;          /**< next packet in current block, NULL if block is not taken */
+    uint32_t            ringPktLeft;      /**< packets left in current block */
+#endif
+#ifdef CO_DRIVER_TX_QUEUE
+    bool_t              txEpollOut;       /**< EPOLLOUT is registered for fd */
+#endif
+    bool_t              rxReady;          /**< fd is readable in current pass of CO_CANrxWait() */
+    uint16_t            rxBudget;         /**< messages left to receive in current pass */
+    uint32_t            rxWakeups;        /**< statistics, epoll wakeups with fd readable */
+    uint32_t            rxFrames;         /**< statistics, messages received */
+    uint32_t            txFrames;         /**< statistics, messages written to socket */
+    uint32_t            rxDropCount;      /**< messages dropped on rx socket queue of this interface */
+#ifdef CO_DRIVER_RX_THREADS
+    int32_t             rxThreadCpu;      /**< CPU for receive thread, -1 if not pinned */
+    CO_CANrxThread_t   *rxThread;         /**< receive thread, NULL if not running */
+#endif
+#ifdef CO_DRIVER_IO_URING
+    /** io_uring buffer IDs of received messages, in order of reception */
+    uint16_t            uringRxFifo[CO_DRIVER_IO_URING_BUFFERS];
+    uint16_t            uringRxHead;      /**< oldest entry in _uringRxFifo_ */
+    uint16_t            uringRxCount;     /**< number of entries in _uringRxFifo_ */
+    bool_t              uringRxArmed;     /**< multishot receive request is active */
+    bool_t              uringTxArmed;     /**< poll request for tx queue space is active */
+#endif
 #ifdef CO_DRIVER_ERROR_REPORTING
     CO_CANinterfaceErrorhandler_t errorhandler;
 #endif
 } CO_CANinterface_t;
 
+#ifdef CO_DRIVER_IO_URING
+/**
+ * io_uring event engine. Only used by the thread that calls CO_CANrxWait().
+ */
+typedef struct {
+    int                 fd;             /**< io_uring FD, -1 if epoll engine is used */
+    uint8_t            *sqRing;         /**< mmap()ed submission queue ring */
+    size_t              sqRingSize;     /**< size of _sqRing_ */
+    uint8_t            *cqRing;         /**< mmap()ed completion queue ring, may be _sqRing_ */
+    size_t              cqRingSize;     /**< size of _cqRing_ */
+    struct io_uring_sqe *sqes;          /**< mmap()ed submission queue entries */
+    size_t              sqesSize;       /**< size of _sqes_ */
+    uint32_t           *sqHead;         /**< submission queue head, written by kernel */
+    uint32_t           *sqTail;         /**< submission queue tail */
+    uint32_t           *sqArray;        /**< submission queue index array */
+    uint32_t            sqMask;         /**< submission queue ring mask */
+    uint32_t            sqPending;      /**< entries prepared but not submitted */
+    uint32_t           *cqHead;         /**< completion queue head */
+    uint32_t           *cqTail;         /**< completion queue tail, written by kernel */
+    struct io_uring_cqe *cqes;          /**< completion queue entries */
+    uint32_t            cqMask;         /**< completion queue ring mask */
+    struct io_uring_buf_ring *bufRing;  /**< mmap()ed provided buffer ring */
+    uint8_t            *buf;            /**< receive buffers */
+    uint16_t            bufTail;        /**< tail of _bufRing_ */
+    uint16_t            bufUsed;        /**< buffers currently held by _CANinterfaces_ */
+    struct msghdr       rxMsg;          /**< recvmsg() template for multishot receive */
+    bool_t              notifyArmed;    /**< poll request for notification pipe is active */
+    bool_t              timerArmed;     /**< timeout request is active */
+    struct __kernel_timespec timerNext; /**< next expiry of cycle timer, CLOCK_MONOTONIC */
+    uint64_t            timerInterval;  /**< cycle timer interval in ns, 0 if not used */
+    uint64_t            timerExpired;   /**< expirations not yet read by CO_CANrxTimerRead() */
+    uint32_t            enterCalls;     /**< statistics, io_uring_enter() syscalls */
+    uint32_t            completions;    /**< statistics, completion queue entries */
+} CO_CANuring_t;
+#endif
+
+#ifdef CO_DRIVER_TX_QUEUE
+/**
+ * Entry in software transmit queue
+ */
+typedef struct {
+    uint16_t            txIndex;        /**< index in _txArray_ */
+    uint16_t            interfaceIndex; /**< index in _CANinterfaces_ */
+} CO_CANtxQueueEntry_t;
+#endif
+
 /**
  * CAN module object. It may be different in different microcontrollers.
  */
@@ -109,7 +396,11 @@ typedef struct{
     CO_CANrx_t         *rxArray;        /**< From CO_CANmodule_init() */
     uint16_t            rxSize;         /**< From CO_CANmodule_init() */
     struct can_filter  *rxFilter;       /**< socketCAN filter list, one per rx buffer */
-    uint32_t            rxDropCount;    /**< messages dropped on rx socket queue */
+    uint32_t            rxDropCount;    /**< messages dropped on rx socket queues of all interfaces */
+    uint16_t            rxFilterCount;  /**< statistics, number of installed socketCAN filters */
+    uint32_t            rxUnmatched;    /**< statistics, received messages without rx buffer */
+    /** CLOCK_REALTIME - CLOCK_MONOTONIC, to convert socket timestamps. Updated every wakeup */
+    struct timespec     rxClockOffset;
     CO_CANtx_t         *txArray;        /**< From CO_CANmodule_init() */
     uint16_t            txSize;         /**< From CO_CANmodule_init() */
     volatile bool_t     CANnormal;      /**< CAN module is in normal mode */
@@ -117,11 +408,61 @@ typedef struct{
     CO_NotifyPipe_t    *pipe;           /**< Notification Pipe */
     int                 fdEpoll;        /**< epoll FD */
     int                 fdTimerRead;    /**< timer handle from CANrxWait() */
+    bool_t              rxNotifyReady;  /**< timer or pipe signalled in current pass of CANrxWait() */
+    uint32_t            rxServiceNext;  /**< next interface to service in CANrxWait(), round robin */
+    bool_t              rxWaitUsed;     /**< CANrxWait() was called, it must be woken up on disable */
+    CO_CANlocks_t       locks;          /**< mutexes of CO_LOCK_CAN_SEND(), CO_LOCK_EMCY() and CO_LOCK_OD() */
+#ifdef CO_DRIVER_IO_URING
+    CO_CANuring_t       uring;          /**< io_uring event engine */
+#endif
+#ifdef CO_DRIVER_RX_THREADS
+    int                 fdRxThreads;    /**< eventfd, signalled by receive threads */
+    uint32_t            rxThreadBudget; /**< messages left to take from rings in current pass */
+    uint32_t            rxThreadSequence; /**< next sequence number, taken by receive threads */
+#endif
+    /**
+     * Receive dispatch table, COB ID to rx array index. Contains all rx buffers
+     * that match exactly one 11 bit identifier. If more than one buffer uses
+     * the same identifier, the one with the lowest index is stored.
+     */
+    uint16_t            rxDispatch[CO_CAN_MSG_SFF_MAX_COB_ID];
+    /**
+     * Rx array indices of all buffers that can not be put into _rxDispatch_
+     * (real masks, RTR, unconfigured), sorted ascending. From CO_CANmodule_init()
+     */
+    uint16_t           *rxMaskIndex;
+    uint16_t            rxMaskCount;    /**< number of valid entries in _rxMaskIndex_ */
+#ifdef CO_DRIVER_RX_BATCH
+    /** Messages received by last recvmmsg() call */
+    struct can_frame    rxBatchMsg[CO_DRIVER_RX_BATCH];
+    struct iovec        rxBatchIov[CO_DRIVER_RX_BATCH]; /**< recvmmsg() data buffers */
+    struct mmsghdr     *rxBatchHdr;     /**< recvmmsg() message headers, from CO_CANmodule_init() */
+    /** recvmmsg() control message buffers */
+    char                rxBatchCtrl[CO_DRIVER_RX_BATCH][CO_CANRX_CTRLMSG_SIZE];
+    CO_CANinterface_t  *rxBatchInterface; /**< interface the batch was received on */
+    uint16_t            rxBatchCount;   /**< number of messages in batch */
+    uint16_t            rxBatchNext;    /**< index of next message to process */
+#endif
+#ifdef CO_DRIVER_TX_BATCH
+    /** Messages staged for transmission by CO_CANsend() */
+    struct can_frame    txBatchMsg[CO_DRIVER_TX_BATCH];
+    uint32_t            txBatchInterface[CO_DRIVER_TX_BATCH]; /**< index of interface in _CANinterfaces_ */
+    uint16_t            txBatchTxIndex[CO_DRIVER_TX_BATCH]; /**< index of tx buffer in _txArray_ */
+    struct iovec        txBatchIov[CO_DRIVER_TX_BATCH]; /**< sendmmsg() data buffers */
+    struct mmsghdr     *txBatchHdr;     /**< sendmmsg() message headers, from CO_CANmodule_init() */
+    uint16_t            txBatchCount;   /**< number of staged messages */
+    volatile bool_t     txBatchActive;  /**< processing cycle is active */
+    pthread_t           txBatchThread;  /**< thread that called CO_CANtxBatchBegin() */
+#endif
+#ifdef CO_DRIVER_TX_QUEUE
+    /** Software transmit queue, sorted by COB ID. Protected by CO_LOCK_CAN_SEND() */
+    CO_CANtxQueueEntry_t txQueue[CO_DRIVER_TX_QUEUE];
+    uint16_t            txQueueCount;   /**< number of queued messages */
+#endif
 #ifdef CO_DRIVER_MULTI_INTERFACE
     /**
-     * Lookup tables Cob ID to rx/tx array index. Only feasible for SFF Messages.
+     * Lookup table Cob ID to tx array index. Only feasible for SFF Messages.
      */
-    uint32_t            rxIdentToIndex[CO_CAN_MSG_SFF_MAX_COB_ID]; /**< COB ID to index assignment */
     uint32_t            txIdentToIndex[CO_CAN_MSG_SFF_MAX_COB_ID]; /**< COB ID to index assignment */
 #endif
 }CO_CANmodule_t;
@@ -192,7 +533,8 @@ CO_ReturnError_t CO_CANmodule_init(
 /**
  * Add socketCAN interface to can driver
  *
- * Function must be called after CO_CANmodule_init.
+ * Function must be called after CO_CANmodule_init. Messages are received with
+ * #CO_CANRX_BACKEND_SOCKET.
  *
  * @param CANmodule This object will be initialized.
  * @param CANbaseAddress CAN module base address.
@@ -203,10 +545,86 @@ CO_ReturnError_t CO_CANmodule_addInterface(
         CO_CANmodule_t         *CANmodule,
         int32_t                 CANbaseAddress);
 
+/**
+ * Add socketCAN interface with given receive backend to can driver
+ *
+ * Function must be called after CO_CANmodule_init.
+ *
+ * @param CANmodule This object will be initialized.
+ * @param CANbaseAddress CAN module base address.
+ * @param rxBackend receive backend. #CO_CANRX_BACKEND_RING is only available
+ * with CO_DRIVER_RX_RING.
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_SYSCALL or CO_ERROR_INVALID_STATE.
+ */
+CO_ReturnError_t CO_CANmodule_addInterfaceBackend(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        CO_CANrxBackend_t       rxBackend);
+
+/**
+ * Add socketCAN interface with a socket owned by the application
+ *
+ * Function must be called after CO_CANmodule_init. The socket may be shared by
+ * any number of CAN modules, e.g. for simulating many CANopen devices on one
+ * interface. Messages are sent to the socket as usual, but the socket is not
+ * read by CO_CANrxWait(), rx filters are not set and the socket is not closed
+ * by CO_CANmodule_disable(). The application reads the socket and passes
+ * received messages with #CO_CANrxFrame() (#CO_CANRX_BACKEND_EXTERNAL).
+ *
+ * @param CANmodule This object will be initialized.
+ * @param CANbaseAddress CAN module base address, the socket is bound to.
+ * @param fd bound CAN_RAW socket
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_OUT_OF_MEMORY, CO_ERROR_SYSCALL or CO_ERROR_INVALID_STATE.
+ */
+CO_ReturnError_t CO_CANmodule_addInterfaceExternal(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        int                     fd);
+
+/**
+ * Pass a received message to the CAN module
+ *
+ * For interfaces added with CO_CANmodule_addInterfaceExternal(). The message
+ * is processed like in CO_CANrxWait(), so this must not be called at the same
+ * time as CO_CANrxWait() for the same CAN module. Messages are ignored if the
+ * CAN module is not in normal mode.
+ *
+ * @param CANmodule This object.
+ * @param CANbaseAddress CAN interface the message was received from
+ * @param msg received message
+ * @param timestamp time of reception (CLOCK_MONOTONIC), NULL for current time
+ * @return Number of CANopen rx buffer which received the message, -1 if the
+ * message was not used.
+ */
+int32_t CO_CANrxFrame(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        const struct can_frame *msg,
+        const struct timespec  *timestamp);
+
 #endif
 
+#ifdef CO_DRIVER_RX_THREADS
 /**
- * Close socketCAN connection. Call at program exit.
+ * Pin receive thread of one interface to a CPU. Must be called before
+ * CO_CANsetNormalMode().
+ *
+ * @param CANmodule This object.
+ * @param CANbaseAddress CAN interface, as given to CO_CANmodule_addInterface()
+ * @param cpu CPU number, -1 for no pinning
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_INVALID_STATE (threads already started)
+ */
+CO_ReturnError_t CO_CANmodule_setRxThreadCpu(
+        CO_CANmodule_t         *CANmodule,
+        int32_t                 CANbaseAddress,
+        int32_t                 cpu);
+#endif
+
+/**
+ * Close socketCAN connection and destroy the mutexes. Call at program exit.
  *
  * @param CANmodule CAN module object.
  */
@@ -265,7 +683,7 @@ CO_ReturnError_t CO_CANrxBufferInit(
  * @param CANmodule This object.
  * @param ident 11-bit standard CAN Identifier.
  * @param [out] CANbaseAddressRx message was received on this interface
- * @param [out] timestamp message was received at this time (system clock)
+ * @param [out] timestamp message was received at this time (CLOCK_MONOTONIC)
  *
  * @retval false message has never been received, therefore no base address
  * and timestamp are available
@@ -331,6 +749,11 @@ CO_ReturnError_t CO_CANtxBuffer_setInterface(
 /**
  * Send CAN message.
  *
+ * With CO_DRIVER_TX_QUEUE, the message is queued if the socket is busy. Data
+ * bytes in buffer must not be changed while _bufferFull_ is set. If the
+ * previous message of this buffer is still queued, #CO_ERROR_TX_OVERFLOW is
+ * returned and the queued message is sent with the new contents.
+ *
  * @param CANmodule This object.
  * @param buffer Pointer to transmit buffer, returned by CO_CANtxBufferInit().
  * Data bytes must be written in buffer before function call.
@@ -346,7 +769,8 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer);
  *
  * The default threshold is 50%, or at least 1 message buffer. If sending
  * would violate those limits, #CO_ERROR_TX_OVERFLOW is returned and the
- * message will not be sent.
+ * message will not be sent. With CO_DRIVER_TX_QUEUE, the limits are applied
+ * to the software transmit queue and #CO_ERROR_TX_BUSY is returned.
  *
  * @param CANmodule This object.
  * @param buffer Pointer to transmit buffer, returned by CO_CANtxBufferInit().
@@ -357,9 +781,36 @@ CO_ReturnError_t CO_CANsend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer);
  */
 CO_ReturnError_t CO_CANCheckSend(CO_CANmodule_t *CANmodule, CO_CANtx_t *buffer);
 
+#ifdef CO_DRIVER_TX_BATCH
+
+/**
+ * Start staging CAN messages.
+ *
+ * All messages sent by the calling thread are staged inside the driver until
+ * CO_CANtxBatchFlush() is called. If the staging queue is full, it is flushed
+ * automatically.
+ *
+ * @param CANmodule This object.
+ */
+void CO_CANtxBatchBegin(CO_CANmodule_t *CANmodule);
+
+/**
+ * Send all staged CAN messages and stop staging.
+ *
+ * Messages are sent in order with one sendmmsg() call per interface. As
+ * CO_CANsend() already returned, transmission errors are reported via
+ * emergency object in the same way CO_CANsend() does.
+ *
+ * @param CANmodule This object.
+ */
+void CO_CANtxBatchFlush(CO_CANmodule_t *CANmodule);
+
+#endif
+
 /**
  * Clear all synchronous TPDOs from CAN module transmit buffers.
- * This function is not supported in this driver.
+ * This function is only supported with CO_DRIVER_TX_QUEUE, it removes the
+ * TPDOs from the software transmit queue.
  */
 void CO_CANclearPendingSyncPDOs(CO_CANmodule_t *CANmodule);
 
@@ -381,8 +832,17 @@ void CO_CANverifyErrors(CO_CANmodule_t *CANmodule);
  *
  * Both modes can be combined.
  *
+ * All events of one epoll wakeup are serviced in one pass over several calls:
+ * timer and notification pipe first, then each ready CAN interface for up to
+ * CO_DRIVER_RX_BUDGET messages, round robin. epoll is called again after all
+ * ready interfaces are serviced.
+ *
+ * With the io_uring engine, the interval of _fdTimer_ is taken over by a
+ * timeout request and the timerfd is stopped. Use CO_CANrxTimerRead() to get
+ * the number of expirations.
+ *
  * @param CANmodule This object.
- * @param fdTimer file descriptor with activated timeout. fd is not read after
+ * @param fdTimer timerfd with activated interval. fd is not read after
  *                expiring! -1 if not used.
  * @param buffer [out] storage for received message or _NULL_
  * @retval >= 0 index of received message in array set by #CO_CANmodule_init()
@@ -391,6 +851,17 @@ void CO_CANverifyErrors(CO_CANmodule_t *CANmodule);
  */
 int32_t CO_CANrxWait(CO_CANmodule_t *CANmodule, int fdTimer, CO_CANrxMsg_t *buffer);
 
+
+/**
+ * Read the timer given to CO_CANrxWait(). Doesn't block.
+ *
+ * @param CANmodule This object.
+ * @param fdTimer timerfd given to CO_CANrxWait().
+ * @return number of timer expirations since last call, 0 if timer has not
+ * expired.
+ */
+uint64_t CO_CANrxTimerRead(CO_CANmodule_t *CANmodule, int fdTimer);
+
 #ifdef __cplusplus
 }
 #endif /*__cplusplus*/
@@ -54,6 +54,7 @@
 #include <sys/time.h>       /* for 'struct timespec' */
 #include <endian.h>
 #include <pthread.h>
+#include <sched.h>
 #include <linux/can.h>
 #include <net/if.h>
 
@@ -173,17 +174,100 @@ extern "C" {
  * @{
  */
 
-/* unused */
-#define CO_LOCK_CAN_SEND()  /**< Lock critical section in CO_CANsend() */
-#define CO_UNLOCK_CAN_SEND()/**< Unlock critical section in CO_CANsend() */
+/**
+ * Mutexes of a CAN module, used by the macros below. Each CANopen object has
+ * its own CAN module, so objects in one program don't serialize each other.
+ */
+typedef struct {
+    pthread_mutex_t     CANsend;        /**< CO_LOCK_CAN_SEND() */
+    pthread_mutex_t     EMCY;           /**< CO_LOCK_EMCY() */
+    pthread_mutex_t     OD;             /**< CO_LOCK_OD() */
+#ifdef CO_DRIVER_OD_SEQLOCK
+    uint32_t            ODsequence;     /**< odd while CO_LOCK_OD() is held */
+#endif
+    /** Mutexes are initialized by the first CO_CANmodule_init(), so they stay
+     * valid on communication reset, until CO_CANmodule_disable(). */
+    bool                initialized;
+} CO_CANlocks_t;
+
+#define CO_LOCK_CAN_SEND(CAN_MODULE)    pthread_mutex_lock(&(CAN_MODULE)->locks.CANsend)   /**< Lock critical section in CO_CANsend() */
+#define CO_UNLOCK_CAN_SEND(CAN_MODULE)  (void)pthread_mutex_unlock(&(CAN_MODULE)->locks.CANsend) /**< Unlock critical section in CO_CANsend() */
 
-extern pthread_mutex_t CO_EMCY_mutex;
-static inline int CO_LOCK_EMCY()    { return pthread_mutex_lock(&CO_EMCY_mutex); }  /**< Lock critical section in CO_errorReport() or CO_errorReset() */
-static inline void CO_UNLOCK_EMCY() { (void)pthread_mutex_unlock(&CO_EMCY_mutex); } /**< Unlock critical section in CO_errorReport() or CO_errorReset() */
+#define CO_LOCK_EMCY(CAN_MODULE)        pthread_mutex_lock(&(CAN_MODULE)->locks.EMCY)      /**< Lock critical section in CO_errorReport() or CO_errorReset() */
+#define CO_UNLOCK_EMCY(CAN_MODULE)      (void)pthread_mutex_unlock(&(CAN_MODULE)->locks.EMCY) /**< Unlock critical section in CO_errorReport() or CO_errorReset() */
 
-extern pthread_mutex_t CO_OD_mutex;
-static inline int CO_LOCK_OD()      { return pthread_mutex_lock(&CO_OD_mutex); }    /**< Lock critical section when accessing Object Dictionary */
-static inline void CO_UNLOCK_OD()   { (void)pthread_mutex_unlock(&CO_OD_mutex); }   /**< Unock critical section when accessing Object Dictionary */
+#define CO_LOCK_OD(CAN_MODULE)          CO_CANlockOD(&(CAN_MODULE)->locks)   /**< Lock critical section when accessing Object Dictionary */
+#define CO_UNLOCK_OD(CAN_MODULE)        CO_CANunlockOD(&(CAN_MODULE)->locks) /**< Unock critical section when accessing Object Dictionary */
+#define CO_OD_READ_BEGIN(CAN_MODULE)    CO_CANreadBeginOD(&(CAN_MODULE)->locks)  /**< Begin reading Object Dictionary */
+#define CO_OD_READ_RETRY(CAN_MODULE, seq) CO_CANreadRetryOD(&(CAN_MODULE)->locks, seq) /**< End reading Object Dictionary */
+
+#ifdef CO_DRIVER_OD_SEQLOCK
+/** Lock Object Dictionary, sequence counter is odd while locked */
+static inline int CO_CANlockOD(CO_CANlocks_t *locks)
+{
+    int ret = pthread_mutex_lock(&locks->OD);
+    if (ret == 0) {
+        __atomic_store_n(&locks->ODsequence,
+                         __atomic_load_n(&locks->ODsequence, __ATOMIC_RELAXED) + 1,
+                         __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    return ret;
+}
+/** Unlock Object Dictionary */
+static inline void CO_CANunlockOD(CO_CANlocks_t *locks)
+{
+    __atomic_store_n(&locks->ODsequence,
+                     __atomic_load_n(&locks->ODsequence, __ATOMIC_RELAXED) + 1,
+                     __ATOMIC_RELEASE);
+    (void)pthread_mutex_unlock(&locks->OD);
+}
+/**
+ * Begin reading Object Dictionary without lock. If CO_LOCK_OD() is held by
+ * another thread, yield until CO_UNLOCK_OD(). Readers never touch the mutex,
+ * so they can't delay a writer.
+ *
+ * @return sequence number for CO_OD_READ_RETRY()
+ */
+static inline uint32_t CO_CANreadBeginOD(CO_CANlocks_t *locks)
+{
+    uint32_t seq = __atomic_load_n(&locks->ODsequence, __ATOMIC_ACQUIRE);
+
+    while ((seq & 1) != 0) {
+        (void)sched_yield();
+        seq = __atomic_load_n(&locks->ODsequence, __ATOMIC_ACQUIRE);
+    }
+    return seq;
+}
+/**
+ * End reading Object Dictionary.
+ *
+ * @param seq return value of CO_OD_READ_BEGIN()
+ * @return true if Object Dictionary was written meanwhile, values read must be
+ * discarded and read again.
+ */
+static inline bool CO_CANreadRetryOD(CO_CANlocks_t *locks, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&locks->ODsequence, __ATOMIC_RELAXED) != seq;
+}
+#else
+static inline int CO_CANlockOD(CO_CANlocks_t *locks)      { return pthread_mutex_lock(&locks->OD); }    /**< Lock Object Dictionary */
+static inline void CO_CANunlockOD(CO_CANlocks_t *locks)   { (void)pthread_mutex_unlock(&locks->OD); }   /**< Unlock Object Dictionary */
+static inline uint32_t CO_CANreadBeginOD(CO_CANlocks_t *locks) { (void)CO_CANlockOD(locks); return 0; }  /**< Begin reading Object Dictionary, takes lock */
+static inline bool CO_CANreadRetryOD(CO_CANlocks_t *locks, uint32_t seq) { (void)seq; CO_CANunlockOD(locks); return false; } /**< End reading Object Dictionary, releases lock */
+#endif
+
+/**
+ * Driver provides CO_OD_READ_BEGIN() and CO_OD_READ_RETRY(). Objects read
+ * plain OD variables with them instead of CO_LOCK_OD():
+ *
+ *     do {
+ *         seq = CO_OD_READ_BEGIN(CANmodule);
+ *         copy variables;
+ *     } while (CO_OD_READ_RETRY(CANmodule, seq));
+ */
+#define CO_OD_READ_SEQUENCE
 
 /** @} */
 
@@ -260,7 +344,21 @@ typedef enum{
 #define CO_CAN_MSG_SFF_MAX_COB_ID (1 << CAN_SFF_ID_BITS)
 
 /**
- * CAN receive message structure as aligned in socketCAN.
+ * Received CAN messages carry a receive timestamp. CANopen objects store it
+ * if this is defined.
+ */
+#define CO_CANRX_TIMESTAMP
+
+#ifdef CO_DRIVER_TICKLESS
+/**
+ * Driver sleeps until the next deadline reported by timerNext_ms, so
+ * CO_process() reports the time to the next LED step instead of 50 ms.
+ */
+#define CO_PROCESS_TICKLESS
+#endif
+
+/**
+ * CAN receive message structure. Begins like struct can_frame.
  */
 typedef struct{
     /** CAN identifier. It must be read through CO_CANrxMsg_readIdent() function. */
@@ -268,6 +366,7 @@ typedef struct{
     uint8_t             DLC ;           /**< Length of CAN message */
     uint8_t             padding[3];     /**< ensure alignment */
     uint8_t             data[8];        /**< 8 data bytes */
+    struct timespec     timestamp;      /**< time of reception (CLOCK_MONOTONIC) */
 }CO_CANrxMsg_t;
 
 /**
@@ -282,7 +381,7 @@ typedef struct{
 #ifdef CO_DRIVER_MULTI_INTERFACE
     /** info about last received message */
     int32_t             CANbaseAddress; /**< CAN Interface identifier */
-    struct timespec     timestamp;      /**< time of reception */
+    struct timespec     timestamp;      /**< time of reception (CLOCK_MONOTONIC) */
 #endif
 }CO_CANrx_t;
 
@@ -296,7 +395,7 @@ typedef struct{
     uint8_t             DLC ;           /**< Length of CAN message */
     uint8_t             padding[3];     /**< ensure alignment */
     uint8_t             data[8];        /**< 8 data bytes */
-    volatile bool_t     bufferFull;     /**< True if previous message is still in buffer (not used in this driver) */
+    volatile bool_t     bufferFull;     /**< True if previous message is still in buffer (only used with CO_DRIVER_TX_QUEUE) */
     /** Synchronous PDO messages has this flag set. It prevents them to be sent outside the synchronous window */
     volatile bool_t     syncFlag;
 
@@ -1,33 +1,34 @@
-/* Snipped from https://stackoverflow.com/a/2486353 */
+/* Notification of a thread waiting in epoll, based on an eventfd */
 
 #include <unistd.h>
 #include <assert.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/eventfd.h>
 
 #include "CO_notify_pipe.h"
 
 struct CO_NotifyPipe {
-    int m_receiveFd;
-    int m_sendFd;
+    int m_fd;
+    bool m_pending;             /* eventfd was written, not yet received */
+    CO_NotifyStats_t m_stats;   /* updated atomically from all threads */
 };
 
 CO_NotifyPipe_t *CO_NotifyPipeCreate(void)
 {
-    int pipefd[2];
     CO_NotifyPipe_t *p;
-    int ret = pipe(pipefd);
 
-    if (ret < 0) {
-        return NULL;
-    }
     p = calloc(1, sizeof(CO_NotifyPipe_t));
     if (p == NULL) {
         return NULL;
     }
-    p->m_receiveFd = pipefd[0];
-    p->m_sendFd = pipefd[1];
-    fcntl(p->m_sendFd,F_SETFL,O_NONBLOCK);
+    p->m_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (p->m_fd < 0) {
+        free(p);
+        return NULL;
+    }
     return p;
 }
 
@@ -36,8 +37,7 @@ void CO_NotifyPipeFree(CO_NotifyPipe_t *p)
     if (p == NULL) {
         return;
     }
-    close(p->m_sendFd);
-    close(p->m_receiveFd);
+    close(p->m_fd);
     free(p);
 }
 
@@ -47,14 +47,89 @@ int CO_NotifyPipeGetFd(CO_NotifyPipe_t *p)
     if (p == NULL) {
         return -1;
     }
-    return p->m_receiveFd;
+    return p->m_fd;
 }
 
 
 void CO_NotifyPipeSend(CO_NotifyPipe_t *p)
 {
+    CO_NotifyPipeSendFrom(p, CO_NOTIFY_SOURCE_OTHER);
+}
+
+
+void CO_NotifyPipeSendFrom(CO_NotifyPipe_t *p, CO_NotifySource_t source)
+{
+    uint64_t one = 1;
+
+    if (p == NULL) {
+        return;
+    }
+    if ((unsigned)source >= CO_NOTIFY_SOURCE_COUNT) {
+        source = CO_NOTIFY_SOURCE_OTHER;
+    }
+    __atomic_fetch_add(&p->m_stats.signals[source], 1, __ATOMIC_RELAXED);
+
+    /* the receiver processes after taking the pending signal, so this one is
+     * covered as well */
+    if (__atomic_exchange_n(&p->m_pending, true, __ATOMIC_ACQ_REL)) {
+        __atomic_fetch_add(&p->m_stats.coalesced, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_fetch_add(&p->m_stats.notified, 1, __ATOMIC_RELAXED);
+    if (write(p->m_fd, &one, sizeof(one)) < 0) {
+        /* counter can't overflow with one write per pending signal */
+    }
+}
+
+
+void CO_NotifyPipeReceive(CO_NotifyPipe_t *p)
+{
+    uint64_t count;
+
     if (p == NULL) {
         return;
     }
-    write(p->m_sendFd,"1",1);
+    /* drain first, then clear pending. A signal in between is coalesced
+     * and taken by the processing that follows this call; a signal after
+     * clearing writes again. */
+    if (read(p->m_fd, &count, sizeof(count)) == sizeof(count)) {
+        __atomic_fetch_add(&p->m_stats.wakeups, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&p->m_pending, false, __ATOMIC_SEQ_CST);
+}
+
+
+void CO_NotifyPipeGetStats(CO_NotifyPipe_t *p, CO_NotifyStats_t *stats)
+{
+    uint32_t i;
+
+    if (stats == NULL) {
+        return;
+    }
+    memset(stats, 0, sizeof(*stats));
+    if (p == NULL) {
+        return;
+    }
+    for (i = 0; i < CO_NOTIFY_SOURCE_COUNT; i++) {
+        stats->signals[i] = __atomic_load_n(&p->m_stats.signals[i], __ATOMIC_RELAXED);
+    }
+    stats->notified = __atomic_load_n(&p->m_stats.notified, __ATOMIC_RELAXED);
+    stats->coalesced = __atomic_load_n(&p->m_stats.coalesced, __ATOMIC_RELAXED);
+    stats->wakeups = __atomic_load_n(&p->m_stats.wakeups, __ATOMIC_RELAXED);
+}
+
+
+void CO_NotifyPipeResetStats(CO_NotifyPipe_t *p)
+{
+    uint32_t i;
+
+    if (p == NULL) {
+        return;
+    }
+    for (i = 0; i < CO_NOTIFY_SOURCE_COUNT; i++) {
+        __atomic_store_n(&p->m_stats.signals[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&p->m_stats.notified, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->m_stats.coalesced, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->m_stats.wakeups, 0, __ATOMIC_RELAXED);
 }
@@ -48,6 +48,8 @@
 #ifndef CO_NOTIFY_PIPE_H_
 #define CO_NOTIFY_PIPE_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,7 +60,38 @@ extern "C" {
  * @{
  *
  * This is needed to wake up the can socket when blocking in select
+ *
+ * The notification is an eventfd. Signals are coalesced: while a signal is
+ * pending and not yet taken by CO_NotifyPipeReceive(), further signals don't
+ * write to the eventfd. Every signal is counted by its source, so it can be
+ * seen what drives the wakeups of the waiting thread.
+ */
+
+/**
+ * Origin of a notification, for statistics
+ */
+typedef enum {
+    CO_NOTIFY_SOURCE_OTHER = 0,     /**< not specified, CO_NotifyPipeSend() */
+    CO_NOTIFY_SOURCE_SDO_SERVER,    /**< SDO server received a message */
+    CO_NOTIFY_SOURCE_SDO_CLIENT,    /**< SDO client received a message */
+    CO_NOTIFY_SOURCE_EMCY,          /**< emergency reported or received */
+    CO_NOTIFY_SOURCE_LSS,           /**< LSS master received a message */
+    CO_NOTIFY_SOURCE_DAISY,         /**< daisy chain consumer event */
+    CO_NOTIFY_SOURCE_RX,            /**< CAN messages received by realtime thread */
+    CO_NOTIFY_SOURCE_DEADLINE,      /**< processing deadline reached */
+    CO_NOTIFY_SOURCE_MAINLINE,      /**< mainline thread requests a pass */
+    CO_NOTIFY_SOURCE_COUNT          /**< number of sources */
+} CO_NotifySource_t;
+
+/**
+ * Notification statistics, see CO_NotifyPipeGetStats()
  */
+typedef struct {
+    uint32_t signals[CO_NOTIFY_SOURCE_COUNT]; /**< signals per source */
+    uint32_t notified;      /**< signals passed on to the waiting thread */
+    uint32_t coalesced;     /**< signals merged into a pending one */
+    uint32_t wakeups;       /**< pending signals taken by the waiting thread */
+} CO_NotifyStats_t;
 
 /**
  * Object
@@ -93,6 +126,41 @@ int CO_NotifyPipeGetFd(CO_NotifyPipe_t *p);
  */
 void CO_NotifyPipeSend(CO_NotifyPipe_t *p);
 
+/**
+ * Send event and count it for the given source
+ *
+ * Only writes to the eventfd if no signal is pending. Can be called from any
+ * thread.
+ *
+ * @param p pointer to object
+ * @param source origin of the event
+ */
+void CO_NotifyPipeSendFrom(CO_NotifyPipe_t *p, CO_NotifySource_t source);
+
+/**
+ * Take all pending notifications, doesn't block
+ *
+ * Signals sent while the caller processes afterwards wake it again.
+ *
+ * @param p pointer to object
+ */
+void CO_NotifyPipeReceive(CO_NotifyPipe_t *p);
+
+/**
+ * Get notification statistics
+ *
+ * @param p pointer to object
+ * @param [out] stats statistics since creation or last reset
+ */
+void CO_NotifyPipeGetStats(CO_NotifyPipe_t *p, CO_NotifyStats_t *stats);
+
+/**
+ * Reset notification statistics
+ *
+ * @param p pointer to object
+ */
+void CO_NotifyPipeResetStats(CO_NotifyPipe_t *p);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -0,0 +1,186 @@
+/*
+ * Check of the cycle statistics of the realtime thread.
+ *
+ * @file        cycle_stats.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * CO_LinuxThreads_rtProcess() runs for a CANopen object without CAN
+ * interface, so CO_CANrxWait() returns at once and this check sleeps between
+ * the calls instead. Checked are the log-scale bins of a histogram, that every
+ * cycle is counted once in both histograms, that cycles and overruns cover
+ * all timer intervals, the catch-up step after a stall and the reset of the
+ * statistics by the realtime thread.
+ *
+ *     ./check_cyclestats
+ */
+
+/* static functions are checked as well */
+#include "CO_Linux_threads.c"
+
+#include <stdlib.h>
+#include <time.h>
+
+static unsigned int check_errors;
+
+static void check(bool_t ok, const char *what)
+{
+    if (!ok) {
+        printf("failed: %s\n", what);
+        check_errors ++;
+    }
+}
+
+static void check_sleep_us(uint32_t us)
+{
+    struct timespec ts;
+
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    (void)nanosleep(&ts, NULL);
+}
+
+static uint32_t check_sum(const CANrx_threadTmr_histogram_t *histogram)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < CANRX_THREADTMR_HISTOGRAM_BINS; i++) {
+        sum += histogram->bins[i];
+    }
+    return sum;
+}
+
+/* Timer intervals of 1 ms since _start_ */
+static uint32_t check_intervals(const struct timespec *start)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((now.tv_sec - start->tv_sec) * 1000000000LL +
+                       (now.tv_nsec - start->tv_nsec)) / 1000000);
+}
+
+static void check_histogram(void)
+{
+    static const uint32_t values[] = {0, 1, 2, 3, 4, 1000, 65535, UINT32_MAX};
+    CANrx_threadTmr_histogram_t histogram;
+    size_t i;
+
+    memset(&histogram, 0, sizeof(histogram));
+    for (i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        CANrx_threadTmr_record(&histogram, values[i]);
+    }
+    check(histogram.bins[0] == 2 && histogram.bins[1] == 2 && histogram.bins[2] == 1 &&
+          histogram.bins[9] == 1 && histogram.bins[CANRX_THREADTMR_HISTOGRAM_BINS - 1] == 2,
+          "histogram bins");
+    check(histogram.max_us == UINT32_MAX, "histogram maximum");
+}
+
+int main(void)
+{
+    static CO_LinuxThreads_t threads;
+    CANrx_threadTmr_stats_t stats;
+    CO_t *inst = NULL;
+    struct timespec start;
+    uint32_t overruns;
+    uint32_t catchUps;
+    uint32_t skipped;
+    uint32_t intervals;
+    int i;
+
+    check_histogram();
+
+    if (CO_newInstance(&inst) != CO_ERROR_NO ||
+        CO_CANinitInstance(inst, 0, 125) != CO_ERROR_NO ||
+        CO_CANopenInitInstance(inst, 1) != CO_ERROR_NO) {
+        printf("failed: instance init\n");
+        return EXIT_FAILURE;
+    }
+    /* SYNC and PDOs are processed, catch-up steps only in normal mode */
+    CO_CANsetNormalMode(inst->CANmodule[0]);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    CO_LinuxThreads_rtInit(&threads, inst, 1);
+
+    /* regular cycles */
+    for (i = 0; i < 100; i++) {
+        check_sleep_us(1000);
+        CO_LinuxThreads_rtProcess(&threads);
+    }
+    intervals = check_intervals(&start);
+    CO_LinuxThreads_rtGetStats(&threads, &stats);
+    check(stats.cycles > 0, "cycles counted");
+    check(check_sum(&stats.latency) == stats.cycles, "latency of every cycle");
+    check(check_sum(&stats.processing) == stats.cycles, "processing of every cycle");
+    check(stats.cycles + stats.overruns <= intervals &&
+          stats.cycles + stats.overruns + 2 >= intervals, "all intervals covered");
+
+    /* stall of 20 intervals, one cycle with catch-up step */
+    overruns = stats.overruns;
+    catchUps = stats.catchUps;
+    skipped = stats.skipped;
+    check_sleep_us(20000);
+    CO_LinuxThreads_rtProcess(&threads);
+    CO_LinuxThreads_rtGetStats(&threads, &stats);
+    check(stats.overruns - overruns >= 19, "overruns of stall");
+    check(stats.catchUps - catchUps == 1, "catch-up step");
+    check(stats.skipped - skipped == stats.overruns - overruns + 1 - CANRX_THREADTMR_MAX_BURST,
+          "intervals covered by catch-up step");
+
+    /* reset is done by the next cycle */
+    CO_LinuxThreads_rtResetStats(&threads);
+    CO_LinuxThreads_rtGetStats(&threads, &stats);
+    check(stats.cycles > 0, "statistics kept until next cycle");
+    do {
+        check_sleep_us(1000);
+        CO_LinuxThreads_rtProcess(&threads);
+        CO_LinuxThreads_rtGetStats(&threads, &stats);
+    } while (stats.cycles == 0 && check_errors == 0);
+    check(stats.cycles == 1 && stats.catchUps == 0 && stats.skipped == 0 &&
+          check_sum(&stats.latency) == 1, "statistics after reset");
+
+    CO_LinuxThreads_rtClose(&threads);
+    CO_deleteInstance(inst, 0);
+
+    printf("cycle statistics checked, %u errors\n", check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,208 @@
+/*
+ * Receive dispatch table against linear search of the rx array.
+ *
+ * @file        dispatch.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * The driver is included to reach the static CO_CANrxLookup(). The linear
+ * search is the one CO_CANrxMsg() used before the dispatch table. Both run
+ * on the same rx array, configured with CO_CANrxBufferInit(): exact 11 bit
+ * COB IDs and one masked buffer at the end. A quarter of the looked up IDs
+ * has no rx buffer. No CAN interface is needed.
+ *
+ *     ./bench_dispatch [<lookups>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CO_driver.c"
+#include "CO_Emergency.h"
+
+#define BENCH_RX_SIZE_MAX       256
+#define BENCH_IDS               4096    /* looked up IDs, repeated */
+
+static CO_CANmodule_t   bench_CANmodule;
+static CO_CANrx_t       bench_rxArray[BENCH_RX_SIZE_MAX];
+static CO_CANtx_t       bench_txArray[1];
+static uint32_t         bench_ids[BENCH_IDS];
+
+/* not used without CAN interface */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+/* rx array search of the driver without dispatch table */
+static uint16_t bench_linearLookup(const CO_CANmodule_t *CANmodule, uint32_t ident)
+{
+    const CO_CANrx_t *rcvMsgObj = &CANmodule->rxArray[0];
+    uint16_t index;
+
+    for (index = 0; index < CANmodule->rxSize; index ++) {
+        if(((ident ^ rcvMsgObj->ident) & rcvMsgObj->mask) == 0U){
+            return index;
+        }
+        rcvMsgObj++;
+    }
+    return CO_CANRX_DISPATCH_NONE;
+}
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Configure _rxSize_ buffers and the looked up IDs, returns 0 on success */
+static int bench_setup(uint16_t rxSize)
+{
+    uint16_t cobId[CO_CAN_MSG_SFF_MAX_COB_ID];
+    CO_ReturnError_t err;
+    uint16_t i;
+
+    err = CO_CANmodule_init(&bench_CANmodule, 0, bench_rxArray, rxSize,
+                            bench_txArray, 1, 1000);
+    if (err != CO_ERROR_NO) {
+        return -1;
+    }
+
+    /* distinct COB IDs in random order, first _rxSize_ ones get a buffer */
+    for (i = 0; i < CO_CAN_MSG_SFF_MAX_COB_ID; i++) {
+        cobId[i] = i;
+    }
+    for (i = CO_CAN_MSG_SFF_MAX_COB_ID - 1; i > 0; i--) {
+        uint16_t j = rand() % (i + 1);
+        uint16_t tmp = cobId[i];
+
+        cobId[i] = cobId[j];
+        cobId[j] = tmp;
+    }
+    for (i = 0; i < rxSize - 1 && err == CO_ERROR_NO; i++) {
+        err = CO_CANrxBufferInit(&bench_CANmodule, i, cobId[i], 0x7FF, 0, NULL, NULL);
+    }
+    /* masked buffer for 16 COB IDs, like a receiver for a range of nodes */
+    if (err == CO_ERROR_NO) {
+        err = CO_CANrxBufferInit(&bench_CANmodule, rxSize - 1, cobId[rxSize],
+                                 0x7F0, 0, NULL, NULL);
+    }
+    if (err != CO_ERROR_NO) {
+        CO_CANmodule_disable(&bench_CANmodule);
+        return -1;
+    }
+
+    for (i = 0; i < BENCH_IDS; i++) {
+        if (rand() % 4 != 0) {
+            bench_ids[i] = cobId[rand() % (rxSize - 1)];
+        }
+        else {
+            bench_ids[i] = cobId[rxSize + rand() % (CO_CAN_MSG_SFF_MAX_COB_ID - rxSize)];
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint16_t rxSizes[] = {8, 16, 32, 64, 128, 256};
+    unsigned long lookups = 10000000;
+    unsigned long n;
+    uint32_t i;
+
+    if (argc > 1) {
+        lookups = strtoul(argv[1], NULL, 0);
+    }
+    if (lookups < BENCH_IDS) {
+        fprintf(stderr, "Usage: %s [<lookups>, at least %d]\n", argv[0], BENCH_IDS);
+        exit(EXIT_FAILURE);
+    }
+    srand(1);
+
+    printf("rx buffers   linear ns/msg   dispatch ns/msg   speedup\n");
+    for (i = 0; i < sizeof(rxSizes) / sizeof(rxSizes[0]); i++) {
+        volatile uint32_t sink = 0;
+        uint32_t sum = 0;
+        double start;
+        double linear;
+        double dispatch;
+        uint32_t k;
+
+        if (bench_setup(rxSizes[i]) < 0) {
+            fprintf(stderr, "driver init failed\n");
+            exit(EXIT_FAILURE);
+        }
+
+        /* both searches must find the same buffer */
+        for (k = 0; k < BENCH_IDS; k++) {
+            if (bench_linearLookup(&bench_CANmodule, bench_ids[k]) !=
+                CO_CANrxLookup(&bench_CANmodule, bench_ids[k])) {
+                fprintf(stderr, "mismatch for COB ID 0x%03X\n", bench_ids[k]);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        start = bench_now();
+        for (n = 0; n < lookups; n++) {
+            sum += bench_linearLookup(&bench_CANmodule, bench_ids[n % BENCH_IDS]);
+        }
+        linear = (bench_now() - start) * 1e9 / lookups;
+        sink = sum;
+
+        sum = 0;
+        start = bench_now();
+        for (n = 0; n < lookups; n++) {
+            sum += CO_CANrxLookup(&bench_CANmodule, bench_ids[n % BENCH_IDS]);
+        }
+        dispatch = (bench_now() - start) * 1e9 / lookups;
+        sink += sum;
+        (void)sink;
+
+        printf("%10u   %13.2f   %15.2f   %6.1fx\n", rxSizes[i], linear, dispatch,
+               linear / dispatch);
+        CO_CANmodule_disable(&bench_CANmodule);
+    }
+
+    return 0;
+}
@@ -0,0 +1,340 @@
+/*
+ * Benchmark and checks of the heartbeat consumer with its timer wheel.
+ *
+ * @file        hb_consumer.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Runs CO_HBconsumer_process() end to end, heartbeats are passed to the
+ * receive function registered with CO_CANrxBufferInit(), as the CAN driver
+ * would do. First some checks with few nodes: a heartbeat, which arrives in
+ * the same cycle as its timeout, must not be a timeout, a silent node must
+ * time out after exactly its consumer time, bootup and heartbeat after a
+ * timeout must set and reset the emergencies. Then the time per 1 ms step is
+ * measured for a growing number of monitored nodes. Each node has its own
+ * consumer time between 50 and 1000 ms and sends its heartbeat twice as often.
+ *
+ *     ./bench_hbconsumer [<simulated ms>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "CANopen.h"
+#include "CO_HBconsumer.h"
+
+#define BENCH_NODES_MAX         255
+#define BENCH_SCHEDULE_SLOTS    1024    /* > longest heartbeat period */
+
+static CO_HBconsumer_t      bench_HBcons;
+static CO_HBconsNode_t      bench_nodes[BENCH_NODES_MAX];
+static uint32_t             bench_HBconsTime[BENCH_NODES_MAX];
+static CO_EM_t              bench_em;
+
+/* from CO_CANrxBufferInit() */
+static void                *bench_rxObject[BENCH_NODES_MAX];
+static void               (*bench_rxFunct)(void *object, const CO_CANrxMsg_t *message);
+
+/* emergencies and callbacks seen */
+static bool_t               bench_emcyTimeout;
+static bool_t               bench_emcyRemoteReset;
+static uint32_t             bench_timeouts;
+
+/* heartbeat schedule: next node in the same slot, period of each node */
+static int16_t              bench_schedule[BENCH_SCHEDULE_SLOTS];
+static int16_t              bench_scheduleNext[BENCH_NODES_MAX];
+static uint16_t             bench_period[BENCH_NODES_MAX];
+
+
+/* stack is linked for the heartbeat consumer only */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorCode; (void)infoCode;
+    if (errorBit == CO_EM_HEARTBEAT_CONSUMER) bench_emcyTimeout = true;
+    if (errorBit == CO_EM_HB_CONSUMER_REMOTE_RESET) bench_emcyRemoteReset = true;
+}
+
+void CO_errorReset(CO_EM_t *em, const uint8_t errorBit, const uint32_t infoCode)
+{
+    (void)em; (void)infoCode;
+    if (errorBit == CO_EM_HEARTBEAT_CONSUMER) bench_emcyTimeout = false;
+    if (errorBit == CO_EM_HB_CONSUMER_REMOTE_RESET) bench_emcyRemoteReset = false;
+}
+
+void CO_OD_configure(CO_SDO_t *SDO, uint16_t index,
+                     CO_SDO_abortCode_t (*pODFunc)(CO_ODF_arg_t *ODF_arg),
+                     void *object, uint8_t *flags, uint8_t flagsSize)
+{
+    (void)SDO; (void)index; (void)pODFunc; (void)object; (void)flags; (void)flagsSize;
+}
+
+uint32_t CO_getUint32(const uint8_t data[])
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+CO_ReturnError_t CO_CANrxBufferInit(CO_CANmodule_t *CANmodule, uint32_t index,
+                                    uint32_t ident, uint32_t mask, bool_t rtr,
+                                    void *object,
+                                    void (*pFunct)(void *object, const CO_CANrxMsg_t *message))
+{
+    (void)CANmodule; (void)ident; (void)mask; (void)rtr;
+    bench_rxObject[index] = object;
+    bench_rxFunct = pFunct;
+    return CO_ERROR_NO;
+}
+
+static void bench_timeout(uint8_t nodeId, uint8_t idx, void *object)
+{
+    (void)nodeId; (void)idx; (void)object;
+    bench_timeouts ++;
+}
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Pass a heartbeat or bootup message of node _idx_ to the consumer */
+static void bench_receive(uint8_t idx, CO_NMT_internalState_t state)
+{
+    CO_CANrxMsg_t msg = {0};
+
+    msg.ident = CO_CAN_ID_HEARTBEAT + idx + 1;
+    msg.DLC = 1;
+    msg.data[0] = (uint8_t)state;
+    bench_rxFunct(bench_rxObject[idx], &msg);
+}
+
+/* Configure _count_ nodes with the given consumer times */
+static void bench_init(uint8_t count, const uint16_t times[])
+{
+    static CO_SDO_t SDO;
+    static CO_CANmodule_t CANmodule;
+    uint8_t i;
+
+    for (i = 0; i < count; i++) {
+        bench_HBconsTime[i] = ((uint32_t)(i + 1) << 16) | times[i];
+    }
+    if (CO_HBconsumer_init(&bench_HBcons, &bench_em, &SDO, bench_HBconsTime,
+                           bench_nodes, count, &CANmodule, 0) != CO_ERROR_NO) {
+        fprintf(stderr, "CO_HBconsumer_init() failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < count; i++) {
+        CO_HBconsumer_initCallbackTimeout(&bench_HBcons, i, NULL, bench_timeout);
+    }
+    bench_timeouts = 0;
+}
+
+static uint32_t bench_errors;
+
+static void bench_check(bool_t ok, const char *what)
+{
+    if (!ok) {
+        printf("failed: %s\n", what);
+        bench_errors ++;
+    }
+}
+
+/* Behaviour with two nodes, consumer time 10 ms */
+static void bench_checks(void)
+{
+    static const uint16_t times[] = {10, 10};
+    uint16_t timerNext_ms;
+    int t;
+
+    bench_init(2, times);
+    bench_receive(0, CO_NMT_OPERATIONAL);
+    bench_receive(1, CO_NMT_OPERATIONAL);
+    CO_HBconsumer_process(&bench_HBcons, true, 0, NULL);
+    bench_check(bench_HBcons.allMonitoredOperational != 0, "all operational");
+
+    /* heartbeat exactly every 10 ms from node 0, node 1 silent */
+    for (t = 1; t <= 100; t++) {
+        if (t % 10 == 0) {
+            bench_receive(0, CO_NMT_OPERATIONAL);
+        }
+        timerNext_ms = 1000;
+        CO_HBconsumer_process(&bench_HBcons, true, 1, &timerNext_ms);
+        if (t == 9) {
+            bench_check(bench_timeouts == 0 && timerNext_ms == 1,
+                        "no timeout before consumer time");
+        }
+        if (t == 10) {
+            bench_check(bench_timeouts == 1, "timeout after consumer time");
+        }
+    }
+    bench_check(CO_HBconsumer_getState(&bench_HBcons, 0) == CO_HBconsumer_ACTIVE,
+                "heartbeat in the cycle of its timeout");
+    bench_check(CO_HBconsumer_getState(&bench_HBcons, 1) == CO_HBconsumer_TIMEOUT,
+                "silent node");
+    bench_check(bench_timeouts == 1 && bench_emcyTimeout, "timeout emergency");
+    bench_check(bench_HBcons.allMonitoredOperational == 0, "not all operational");
+
+    /* node 1 back, node 0 resets */
+    bench_receive(1, CO_NMT_OPERATIONAL);
+    bench_receive(0, CO_NMT_INITIALIZING);
+    CO_HBconsumer_process(&bench_HBcons, true, 1, NULL);
+    bench_check(!bench_emcyTimeout, "timeout emergency reset");
+    bench_check(bench_emcyRemoteReset, "remote reset emergency");
+    bench_check(CO_HBconsumer_getState(&bench_HBcons, 0) == CO_HBconsumer_UNKNOWN,
+                "node after bootup");
+    CO_HBconsumer_process(&bench_HBcons, true, 1, NULL);
+    bench_check(!bench_emcyRemoteReset, "remote reset emergency cleared");
+
+    /* stopped: no monitoring */
+    bench_receive(0, CO_NMT_OPERATIONAL);
+    CO_HBconsumer_process(&bench_HBcons, false, 1, NULL);
+    bench_check(CO_HBconsumer_getState(&bench_HBcons, 0) == CO_HBconsumer_UNKNOWN &&
+                CO_HBconsumer_getState(&bench_HBcons, 1) == CO_HBconsumer_UNKNOWN,
+                "nodes after stop");
+    for (t = 0; t < 100; t++) {
+        CO_HBconsumer_process(&bench_HBcons, true, 1, NULL);
+    }
+    bench_check(bench_timeouts == 1 && !bench_emcyTimeout, "no timeout while unknown");
+}
+
+/* Configure _count_ nodes with random times, schedule their heartbeats */
+static void bench_setup(uint8_t count)
+{
+    uint16_t times[BENCH_NODES_MAX];
+    uint16_t i;
+
+    for (i = 0; i < BENCH_SCHEDULE_SLOTS; i++) {
+        bench_schedule[i] = -1;
+    }
+    for (i = 0; i < count; i++) {
+        uint16_t slot;
+
+        times[i] = 50 + rand() % 951;
+        bench_period[i] = times[i] / 2;
+        slot = rand() % bench_period[i];
+        bench_scheduleNext[i] = bench_schedule[slot];
+        bench_schedule[slot] = i;
+    }
+    bench_init(count, times);
+}
+
+/* One ms: heartbeats due in this ms, then process, returns timerNext_ms */
+static uint16_t bench_step(unsigned long t)
+{
+    uint16_t slot = t % BENCH_SCHEDULE_SLOTS;
+    uint16_t timerNext_ms = 1000;
+    int16_t i = bench_schedule[slot];
+
+    bench_schedule[slot] = -1;
+    while (i >= 0) {
+        int16_t next = bench_scheduleNext[i];
+        uint16_t nextSlot = (t + bench_period[i]) % BENCH_SCHEDULE_SLOTS;
+
+        bench_receive((uint8_t)i, CO_NMT_OPERATIONAL);
+        bench_scheduleNext[i] = bench_schedule[nextSlot];
+        bench_schedule[nextSlot] = i;
+        i = next;
+    }
+    CO_HBconsumer_process(&bench_HBcons, true, 1, &timerNext_ms);
+    return timerNext_ms;
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint8_t counts[] = {8, 16, 32, 64, 127, 255};
+    unsigned long duration_ms = 1000000;
+    uint32_t i;
+
+    if (argc > 1) {
+        duration_ms = strtoul(argv[1], NULL, 0);
+    }
+    if (duration_ms == 0) {
+        fprintf(stderr, "Usage: %s [<simulated ms>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    srand(1);
+
+    bench_checks();
+    printf("heartbeat consumer checks: %u errors\n", bench_errors);
+    if (bench_errors != 0) {
+        exit(EXIT_FAILURE);
+    }
+
+    printf("nodes   heartbeats/s   ns/ms   ns/ms/node\n");
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        volatile uint32_t sink = 0;
+        double start;
+        double step;
+        unsigned long t;
+        uint32_t heartbeats = 0;
+
+        bench_setup(counts[i]);
+        for (t = 0; t < 1000; t++) {
+            (void)bench_step(t);
+        }
+        start = bench_now();
+        for (t = 1000; t < duration_ms + 1000; t++) {
+            sink += bench_step(t);
+        }
+        step = (bench_now() - start) * 1e9 / duration_ms;
+        (void)sink;
+
+        {
+            uint8_t n;
+            for (n = 0; n < counts[i]; n++) {
+                heartbeats += 1000 / bench_period[n];
+            }
+        }
+        if (bench_timeouts != 0) {
+            fprintf(stderr, "%u nodes: %u unexpected timeouts\n", counts[i], bench_timeouts);
+            exit(EXIT_FAILURE);
+        }
+        printf("%5u   %12u   %5.1f   %10.2f\n", counts[i], heartbeats, step,
+               step / counts[i]);
+        fflush(stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
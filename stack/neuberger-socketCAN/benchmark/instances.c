@@ -0,0 +1,151 @@
+/*
+ * Check of separate CANopen objects from CO_newInstance().
+ *
+ * @file        instances.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Two CANopen objects are created in one process, without CAN interface.
+ * Each must have its own Object Dictionary variables, found by OD_xxx under
+ * CO_OD_instance.h as well as by the SDO server, its own CAN module locks
+ * and its own NMT callback object. The global variables must stay untouched.
+ *
+ *     ./check_instances
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CANopen.h"
+#include "CO_OD.h"
+
+/* global variables, they can't be named after CO_OD_instance.h */
+static struct sCO_OD_EEPROM *const check_globalEEPROM = &CO_OD_EEPROM;
+
+#include "CO_OD_instance.h"
+
+static unsigned int check_errors;
+
+static void check(bool_t ok, const char *what)
+{
+    if (!ok) {
+        printf("failed: %s\n", what);
+        check_errors ++;
+    }
+}
+
+static void check_powerOn(CO_t *CO)
+{
+    CO_LOCK_OD(CO->CANmodule[0]);
+    OD_powerOnCounter ++;
+    CO_UNLOCK_OD(CO->CANmodule[0]);
+}
+
+static uint32_t check_powerOnCounter(CO_t *CO)
+{
+    return OD_powerOnCounter;
+}
+
+static void check_nmtCallback(void *object, CO_NMT_internalState_t state)
+{
+    (void)state;
+    *(void **)object = object;
+}
+
+int main(void)
+{
+    CO_t *instA = NULL;
+    CO_t *instB = NULL;
+    void *nmtObjectA = NULL;
+    void *nmtObjectB = NULL;
+    uint32_t start;
+    uint16_t index;
+
+    start = check_globalEEPROM->powerOnCounter;
+
+    if (CO_newInstance(&instA) != CO_ERROR_NO ||
+        CO_newInstance(&instB) != CO_ERROR_NO ||
+        CO_CANinitInstance(instA, 0, 125) != CO_ERROR_NO ||
+        CO_CANinitInstance(instB, 0, 125) != CO_ERROR_NO ||
+        CO_CANopenInitInstance(instA, 1) != CO_ERROR_NO ||
+        CO_CANopenInitInstance(instB, 2) != CO_ERROR_NO) {
+        printf("failed: instance init\n");
+        return EXIT_FAILURE;
+    }
+
+    check(instA->OD_EEPROM != instB->OD_EEPROM &&
+          instA->OD_EEPROM != check_globalEEPROM, "separate OD variables");
+
+    /* OD_xxx of CO_OD_instance.h */
+    check_powerOn(instA);
+    check_powerOn(instA);
+    check_powerOn(instB);
+    check(check_powerOnCounter(instA) == start + 2, "OD_xxx of instance A");
+    check(check_powerOnCounter(instB) == start + 1, "OD_xxx of instance B");
+    check(check_globalEEPROM->powerOnCounter == start, "global OD untouched");
+
+    /* SDO server finds the variables of its own instance */
+    index = CO_OD_find(instA->SDO[0], 0x2106);
+    check(CO_OD_getDataPointer(instA->SDO[0], index, 0) ==
+          &instA->OD_EEPROM->powerOnCounter, "SDO server of instance A");
+    index = CO_OD_find(instB->SDO[0], 0x2106);
+    check(CO_OD_getDataPointer(instB->SDO[0], index, 0) ==
+          &instB->OD_EEPROM->powerOnCounter, "SDO server of instance B");
+
+    /* OD lock of one instance does not block the other one */
+    CO_LOCK_OD(instA->CANmodule[0]);
+    check(pthread_mutex_trylock(&instB->CANmodule[0]->locks.OD) == 0,
+          "separate OD locks");
+    CO_UNLOCK_OD(instB->CANmodule[0]);
+    CO_UNLOCK_OD(instA->CANmodule[0]);
+
+    /* CO_NMT_initCallback() calls back at once, with the given object */
+    CO_NMT_initCallback(instA->NMT, &nmtObjectA, check_nmtCallback);
+    CO_NMT_initCallback(instB->NMT, &nmtObjectB, check_nmtCallback);
+    check(nmtObjectA == &nmtObjectA && nmtObjectB == &nmtObjectB,
+          "NMT callback object");
+
+    CO_deleteInstance(instA, 0);
+    CO_deleteInstance(instB, 0);
+
+    printf("instances checked, %u errors\n", check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
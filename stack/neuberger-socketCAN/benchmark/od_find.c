@@ -0,0 +1,187 @@
+/*
+ * Benchmark of CO_OD_find(), perfect hash index against binary search.
+ *
+ * @file        od_find.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * CO_SDO_init() builds a hash index over the OD indexes, without index
+ * buffer CO_OD_find() falls back to binary search. Both are measured on the
+ * example OD and on a synthetic OD of 2000 entries, with random lookups of
+ * which half hit an existing index. Before measuring, both paths must return
+ * the same result for all 65536 indexes.
+ *
+ *     ./bench_odfind [<lookups>]
+ */
+
+/* CO_OD_indexBuild() is static */
+#include "CO_SDO.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CO_Emergency.h"
+#include "CO_OD.h"
+
+#define BENCH_SYNTHETIC_SIZE    2000
+#define BENCH_KEYS              4096    /* must be power of 2 */
+
+/* from CO_OD.c, declared like in CANopen.c */
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];
+
+static CO_OD_entry_t    bench_synthetic[BENCH_SYNTHETIC_SIZE];
+static uint16_t         bench_keys[BENCH_KEYS];
+
+/* driver is linked for CO_SDO.c, it reports errors */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Sorted indexes with random gaps, like a large device profile */
+static void bench_syntheticInit(void)
+{
+    uint32_t index = 0x1000;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_SYNTHETIC_SIZE; i++) {
+        bench_synthetic[i].index = (uint16_t)index;
+        index += 1 + rand() % 16;
+    }
+}
+
+/* ns per lookup of the keys */
+static double bench_lookups(CO_SDO_t *SDO, unsigned long lookups)
+{
+    volatile uint32_t sink = 0;
+    unsigned long i;
+    double start;
+
+    start = bench_now();
+    for (i = 0; i < lookups; i++) {
+        sink += CO_OD_find(SDO, bench_keys[i & (BENCH_KEYS - 1)]);
+    }
+    (void)sink;
+    return (bench_now() - start) * 1e9 / lookups;
+}
+
+/* Compare both paths, then measure. Returns false on differences. */
+static bool_t bench_od(const char *name, const CO_OD_entry_t *OD, uint16_t ODSize,
+                       unsigned long lookups)
+{
+    CO_SDO_t binary;
+    CO_SDO_t hash;
+    uint16_t *ODIndex;
+    uint16_t ODIndexSize = CO_OD_INDEX_SIZE(ODSize);
+    uint32_t index;
+    uint32_t i;
+    double start;
+    double build;
+
+    memset(&binary, 0, sizeof(binary));
+    binary.OD = OD;
+    binary.ODSize = ODSize;
+    hash = binary;
+
+    ODIndex = malloc(ODIndexSize * sizeof(ODIndex[0]));
+    if (ODIndex == NULL) {
+        return false;
+    }
+    start = bench_now();
+    if (!CO_OD_indexBuild(&hash, ODIndex, ODIndexSize)) {
+        printf("%s: index not built\n", name);
+        free(ODIndex);
+        return false;
+    }
+    build = (bench_now() - start) * 1e6;
+
+    for (index = 0; index <= 0xFFFF; index++) {
+        if (CO_OD_find(&binary, index) != CO_OD_find(&hash, index)) {
+            printf("%s: index %04X differs\n", name, index);
+            free(ODIndex);
+            return false;
+        }
+    }
+
+    for (i = 0; i < BENCH_KEYS; i++) {
+        bench_keys[i] = (rand() % 2) ? OD[rand() % ODSize].index : (uint16_t)rand();
+    }
+    printf("%-12s %7u   %9.1f   %9.1f   %9u   %9.1f\n", name, ODSize,
+           bench_lookups(&binary, lookups), bench_lookups(&hash, lookups),
+           (unsigned)(ODIndexSize * sizeof(ODIndex[0])), build);
+    fflush(stdout);
+
+    free(ODIndex);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long lookups = 10000000;
+    bool_t ok;
+
+    if (argc > 1) {
+        lookups = strtoul(argv[1], NULL, 0);
+    }
+    if (lookups == 0) {
+        fprintf(stderr, "Usage: %s [<lookups>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    srand(1);
+    bench_syntheticInit();
+
+    printf("OD           entries   binary ns   index ns   index bytes   build us\n");
+    ok = bench_od("example", CO_OD, CO_OD_NoOfElements, lookups);
+    ok = bench_od("synthetic", bench_synthetic, BENCH_SYNTHETIC_SIZE, lookups) && ok;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,270 @@
+/*
+ * Object Dictionary lock with several reader threads, mutex against seqlock.
+ *
+ * @file        od_lock.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Built twice by the Makefile: bench_odlock_mutex with CO_OD_READ_BEGIN()
+ * taking CO_LOCK_OD(), bench_odlock_seqlock with CO_DRIVER_OD_SEQLOCK.
+ *
+ * One writer thread, like the realtime thread processing PDOs, changes a
+ * block of OD variables under CO_LOCK_OD() every 50 us. 1, 2, 4 and 8 reader
+ * threads, like SDO server or application threads, copy the block in a loop
+ * with CO_OD_READ_BEGIN()/CO_OD_READ_RETRY(). Printed are the reads per
+ * second, the time the writer waits for CO_LOCK_OD() and the number of
+ * inconsistent copies, which must be 0.
+ *
+ *     ./bench_odlock_mutex [-t <s per pass>] [-r <max readers>]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "CO_driver.h"
+#include "CO_Emergency.h"
+
+#define BENCH_READERS_MAX       8
+#define BENCH_OD_WORDS          16      /* 64 byte block, like a few PDO mapped variables */
+#define BENCH_WRITE_PERIOD_NS   50000
+
+typedef struct {
+    pthread_t           thread;
+    uint64_t            reads;
+    uint64_t            retries;
+    uint64_t            torn;
+} bench_reader_t;
+
+/* CAN module holds the OD lock, OD variables, all words hold the same value */
+static CO_CANmodule_t   bench_CANmodule;
+static CO_CANrx_t       bench_rxArray[1];
+static CO_CANtx_t       bench_txArray[1];
+static volatile uint32_t bench_od[BENCH_OD_WORDS];
+static volatile int     bench_stop;
+
+static uint64_t         bench_writes;
+static uint64_t         bench_lockWaitSum_ns;
+static uint64_t         bench_lockWaitMax_ns;
+
+/* driver is linked for the OD lock, no CAN interface is used */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void *bench_writerThread(void *arg)
+{
+    struct timespec next;
+    uint64_t start;
+    uint64_t wait;
+    uint32_t value = 0;
+    uint32_t i;
+
+    (void)arg;
+    (void)clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!bench_stop) {
+        next.tv_nsec += BENCH_WRITE_PERIOD_NS;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec ++;
+        }
+        (void)clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+
+        start = bench_now_ns();
+        CO_LOCK_OD(&bench_CANmodule);
+        wait = bench_now_ns() - start;
+        value ++;
+        for (i = 0; i < BENCH_OD_WORDS; i++) {
+            bench_od[i] = value;
+        }
+        CO_UNLOCK_OD(&bench_CANmodule);
+
+        bench_writes ++;
+        bench_lockWaitSum_ns += wait;
+        if (wait > bench_lockWaitMax_ns) {
+            bench_lockWaitMax_ns = wait;
+        }
+    }
+    return NULL;
+}
+
+static void *bench_readerThread(void *arg)
+{
+    bench_reader_t *reader = (bench_reader_t *)arg;
+    uint32_t copy[BENCH_OD_WORDS];
+    uint32_t seq;
+    uint32_t i;
+
+    while (!bench_stop) {
+        seq = CO_OD_READ_BEGIN(&bench_CANmodule);
+        for (;;) {
+            for (i = 0; i < BENCH_OD_WORDS; i++) {
+                copy[i] = bench_od[i];
+            }
+            if (!CO_OD_READ_RETRY(&bench_CANmodule, seq)) {
+                break;
+            }
+            reader->retries ++;
+            seq = CO_OD_READ_BEGIN(&bench_CANmodule);
+        }
+        for (i = 1; i < BENCH_OD_WORDS; i++) {
+            if (copy[i] != copy[0]) {
+                reader->torn ++;
+                break;
+            }
+        }
+        reader->reads ++;
+    }
+    return NULL;
+}
+
+/* One pass with _count_ readers */
+static void bench_pass(bench_reader_t *readers, uint32_t count, double duration)
+{
+    pthread_t writer;
+    struct timespec wait;
+    uint64_t reads = 0;
+    uint64_t retries = 0;
+    uint64_t torn = 0;
+    uint32_t i;
+
+    bench_stop = 0;
+    bench_writes = 0;
+    bench_lockWaitSum_ns = 0;
+    bench_lockWaitMax_ns = 0;
+    memset(readers, 0, count * sizeof(*readers));
+
+    if (pthread_create(&writer, NULL, bench_writerThread, NULL) != 0) {
+        fprintf(stderr, "pthread_create() failed\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < count; i++) {
+        if (pthread_create(&readers[i].thread, NULL, bench_readerThread, &readers[i]) != 0) {
+            fprintf(stderr, "pthread_create() failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    wait.tv_sec = (time_t)duration;
+    wait.tv_nsec = (long)((duration - wait.tv_sec) * 1e9);
+    (void)nanosleep(&wait, NULL);
+    bench_stop = 1;
+
+    pthread_join(writer, NULL);
+    for (i = 0; i < count; i++) {
+        pthread_join(readers[i].thread, NULL);
+        reads += readers[i].reads;
+        retries += readers[i].retries;
+        torn += readers[i].torn;
+    }
+
+    printf("%7u   %12.0f   %9llu   %9llu   %12.2f   %12.2f   %8llu\n", count,
+           reads / duration, (unsigned long long)retries,
+           (unsigned long long)bench_writes,
+           bench_writes ? bench_lockWaitSum_ns / 1000.0 / bench_writes : 0.0,
+           bench_lockWaitMax_ns / 1000.0, (unsigned long long)torn);
+    fflush(stdout);
+}
+
+static void usage(const char *progName)
+{
+    fprintf(stderr,
+"Usage: %s [options]\n"
+"\n"
+"Options:\n"
+"  -t <s>        Duration of one pass, default 2.\n"
+"  -r <count>    Maximum number of reader threads, default %d.\n",
+            progName, BENCH_READERS_MAX);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_reader_t readers[BENCH_READERS_MAX];
+    double duration = 2.0;
+    long readersMax = BENCH_READERS_MAX;
+    uint32_t count;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:r:")) != -1) {
+        switch (opt) {
+            case 't': duration = strtod(optarg, NULL); break;
+            case 'r': readersMax = strtol(optarg, NULL, 0); break;
+            default:
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (duration <= 0 || readersMax < 1 || readersMax > BENCH_READERS_MAX) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if (CO_CANmodule_init(&bench_CANmodule, 0, bench_rxArray, 1,
+                          bench_txArray, 1, 0) != CO_ERROR_NO) {
+        fprintf(stderr, "CAN module not initialized\n");
+        exit(EXIT_FAILURE);
+    }
+
+#ifdef CO_DRIVER_OD_SEQLOCK
+    printf("CO_DRIVER_OD_SEQLOCK, %.1f s per pass\n", duration);
+#else
+    printf("OD mutex, %.1f s per pass\n", duration);
+#endif
+    printf("readers        reads/s     retries      writes   lock avg us    lock max us       torn\n");
+    for (count = 1; count <= (uint32_t)readersMax; count *= 2) {
+        bench_pass(readers, count, duration);
+    }
+
+    CO_CANmodule_disable(&bench_CANmodule);
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * Cross check of CO_OD_typed.h against the CO_OD[] table of CO_OD.c.
+ *
+ * @file        od_typed.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * CO_OD_typed.h is kept in sync with CO_OD.c by hand. The static_asserts of
+ * canopen_od.h only compare the variable against the length written into
+ * CO_OD_typed.h. This check expands CO_OD_typed.h into a table and walks
+ * CO_OD[] against it: every typed entry must use the variable, attribute,
+ * length and array size of CO_OD.c, and every entry of CO_OD.c except
+ * domains must have a typed entry. Built once per example OD, the include
+ * path selects CO_OD.h and CO_OD_typed.h.
+ *
+ *     ./check_od_typed
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_OD.h"
+
+/* One entry of CO_OD_typed.h */
+typedef struct {
+    uint16_t            index;
+    uint8_t             subIndex;     /* 0 for Var and Array */
+    uint8_t             count;        /* Array: number of elements, else 0 */
+    uint16_t            attribute;
+    uint16_t            length;       /* from CO_OD_typed.h */
+    const void         *pData;
+    size_t              size;         /* sizeof() of the variable */
+    uint8_t             real64;       /* REAL64, size may differ from 8 */
+    uint8_t             used;
+} check_entry_t;
+
+#define CO_OD_TYPED_VAR(index, attr, length, var) \
+    {(index), 0, 0, (attr), (length), &(var), sizeof(var), 0, 0},
+#define CO_OD_TYPED_ARRAY(index, count, attr, length, var) \
+    {(index), 0, (count), (attr), (length), &(var)[0], sizeof((var)[0]), 0, 0},
+#define CO_OD_TYPED_RECORD(index, subindex, attr, length, var) \
+    {(index), (subindex), 0, (attr), (length), &(var), sizeof(var), 0, 0},
+#define CO_OD_TYPED_RECORD_REAL64(index, subindex, attr, var) \
+    {(index), (subindex), 0, (attr), 8, &(var), sizeof(var), 1, 0},
+
+static check_entry_t check_typed[] = {
+#include "CO_OD_typed.h"
+};
+
+/* from CO_OD.c, declared like in CANopen.c */
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];
+
+#define CHECK_TYPED_COUNT   (sizeof(check_typed) / sizeof(check_typed[0]))
+
+static unsigned check_errors;
+
+/* Find typed entry, returns NULL if none */
+static check_entry_t *check_find(uint16_t index, uint8_t subIndex)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHECK_TYPED_COUNT; i++) {
+        if (check_typed[i].index == index && check_typed[i].subIndex == subIndex) {
+            return &check_typed[i];
+        }
+    }
+    return NULL;
+}
+
+/* Compare one typed entry with the values from CO_OD.c */
+static void check_compare(uint16_t index, uint8_t subIndex, uint8_t count,
+                          uint16_t attribute, uint16_t length, const void *pData)
+{
+    check_entry_t *entry = check_find(index, subIndex);
+
+    if (entry == NULL) {
+        printf("%04X.%u: missing in CO_OD_typed.h\n", index, subIndex);
+        check_errors ++;
+        return;
+    }
+    entry->used = 1;
+    if (entry->pData != pData) {
+        printf("%04X.%u: other variable than CO_OD.c\n", index, subIndex);
+        check_errors ++;
+    }
+    if (entry->attribute != attribute) {
+        printf("%04X.%u: attribute 0x%02X, CO_OD.c has 0x%02X\n", index, subIndex,
+               entry->attribute, attribute);
+        check_errors ++;
+    }
+    if (entry->length != length) {
+        printf("%04X.%u: length %u, CO_OD.c has %u\n", index, subIndex,
+               entry->length, length);
+        check_errors ++;
+    }
+    if (entry->count != count) {
+        printf("%04X.%u: %u elements, CO_OD.c has %u\n", index, subIndex,
+               entry->count, count);
+        check_errors ++;
+    }
+    if (entry->size != length && !entry->real64) {
+        printf("%04X.%u: variable has %u bytes, CO_OD.c has %u\n", index, subIndex,
+               (unsigned)entry->size, length);
+        check_errors ++;
+    }
+}
+
+int main(void)
+{
+    uint32_t checked = 0;
+    uint32_t i;
+
+    for (i = 0; i < CO_OD_NoOfElements; i++) {
+        const CO_OD_entry_t *object = &CO_OD[i];
+
+        if (object->maxSubIndex == 0) {
+            /* Var, domains have no typed access */
+            if (object->pData != NULL && object->length != 0) {
+                check_compare(object->index, 0, 0, object->attribute,
+                              object->length, object->pData);
+                checked ++;
+            }
+        }
+        else if (object->attribute != 0) {
+            /* Array */
+            check_compare(object->index, 0, object->maxSubIndex,
+                          object->attribute, object->length, object->pData);
+            checked ++;
+        }
+        else {
+            /* Record */
+            const CO_OD_entryRecord_t *record = (const CO_OD_entryRecord_t *)object->pData;
+            uint8_t sub;
+
+            for (sub = 0; sub <= object->maxSubIndex; sub++) {
+                if (record[sub].pData != NULL && record[sub].length != 0) {
+                    check_compare(object->index, sub, 0, record[sub].attribute,
+                                  record[sub].length, record[sub].pData);
+                    checked ++;
+                }
+            }
+        }
+    }
+    for (i = 0; i < CHECK_TYPED_COUNT; i++) {
+        if (!check_typed[i].used) {
+            printf("%04X.%u: not in CO_OD.c\n", check_typed[i].index,
+                   check_typed[i].subIndex);
+            check_errors ++;
+        }
+    }
+
+    printf("%u entries of CO_OD.c checked, %u errors\n", checked, check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,208 @@
+/*
+ * Check of the receive thread ring merge in CO_CANrxWait().
+ *
+ * @file        rx_merge.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Fills the rings of three interfaces by hand, like the receive threads do,
+ * and takes the messages like CO_CANrxWait(). Messages must come out in
+ * sequence number order, also when the sequence counter wraps around, and
+ * the messages of one interface must keep their order. Then socket and ring
+ * overflows counted by the threads must be reported by the consumer once,
+ * with the aggregate drop counter of the CAN module. No CAN interface needed.
+ *
+ *     ./check_rxmerge
+ */
+
+/* static functions of the driver are checked */
+#include "CO_driver.c"
+
+#include <stdio.h>
+
+#define CHECK_INTERFACES    3
+
+static CO_CANmodule_t   check_CANmodule;
+static CO_CANinterface_t check_interfaces[CHECK_INTERFACES];
+static unsigned         check_errors;
+static unsigned         check_reports;
+
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+    check_reports ++;
+}
+
+/* Store message in ring like CO_CANrxThread() */
+static void check_put(uint32_t interface, uint32_t sequence)
+{
+    CO_CANrxThread_t *rxThread = check_interfaces[interface].rxThread;
+    CO_CANrxThreadEntry_t *entry;
+
+    entry = &rxThread->ring[rxThread->tail & (CO_DRIVER_RX_THREAD_RING - 1)];
+    memset(entry, 0, sizeof(*entry));
+    /* identifier tells the interface, data the sequence number */
+    entry->msg.can_id = 0x180 + interface;
+    entry->msg.can_dlc = 4;
+    memcpy(entry->msg.data, &sequence, sizeof(sequence));
+    entry->sequence = sequence;
+    __atomic_store_n(&rxThread->tail, rxThread->tail + 1, __ATOMIC_RELEASE);
+}
+
+/* Take all messages, they must be in order of _expected_ */
+static void check_take(const char *name, const uint32_t *expected, uint32_t count)
+{
+    struct can_frame msg;
+    struct timespec timestamp;
+    CO_CANinterface_t *interface;
+    uint32_t sequence;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        interface = CO_CANrxThreadsTake(&check_CANmodule, &msg, &timestamp);
+        if (interface == NULL) {
+            printf("%s: rings empty after %u of %u messages\n", name, i, count);
+            check_errors ++;
+            return;
+        }
+        memcpy(&sequence, msg.data, sizeof(sequence));
+        if (sequence != expected[i] ||
+            msg.can_id != 0x180 + (uint32_t)(interface - check_interfaces)) {
+            printf("%s: message %u is %u from %s, expected %u\n", name, i,
+                   sequence, interface->ifName, expected[i]);
+            check_errors ++;
+        }
+    }
+    if (CO_CANrxThreadsTake(&check_CANmodule, &msg, &timestamp) != NULL) {
+        printf("%s: rings not empty\n", name);
+        check_errors ++;
+    }
+    if (CO_CANrxThreadsPending(&check_CANmodule)) {
+        printf("%s: still pending\n", name);
+        check_errors ++;
+    }
+}
+
+static void check_order(void)
+{
+    static const uint32_t interleaved[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    static const uint32_t wrapped[] = {0xFFFFFFFEU, 0xFFFFFFFFU, 0, 1, 2, 3};
+
+    /* thread of interface 2 published late, its messages are still first */
+    check_put(0, 4);
+    check_put(0, 5);
+    check_put(1, 3);
+    check_put(1, 7);
+    check_put(1, 9);
+    check_put(2, 1);
+    check_put(2, 2);
+    check_put(2, 6);
+    check_put(0, 8);
+    check_take("interleaved", interleaved, 9);
+
+    /* 0 follows 0xFFFFFFFF */
+    check_put(0, 0);
+    check_put(0, 3);
+    check_put(1, 0xFFFFFFFFU);
+    check_put(1, 1);
+    check_put(2, 0xFFFFFFFEU);
+    check_put(2, 2);
+    check_take("wrap around", wrapped, 6);
+}
+
+static void check_overflows(void)
+{
+    CO_CANrxThread_t *rxThread0 = check_interfaces[0].rxThread;
+    CO_CANrxThread_t *rxThread1 = check_interfaces[1].rxThread;
+
+    /* SO_RXQ_OVFL counters are cumulative per socket */
+    rxThread0->socketDropped = 5;
+    rxThread1->socketDropped = 3;
+    CO_CANrxThreadsErrors(&check_CANmodule);
+    rxThread0->socketDropped = 7;
+    CO_CANrxThreadsErrors(&check_CANmodule);
+    CO_CANrxThreadsErrors(&check_CANmodule);
+    if (check_CANmodule.rxDropCount != 10 || check_interfaces[0].rxDropCount != 7 ||
+        check_reports != 3) {
+        printf("socket overflow: %u dropped, %u reports, expected 10 and 3\n",
+               check_CANmodule.rxDropCount, check_reports);
+        check_errors ++;
+    }
+
+    check_reports = 0;
+    rxThread1->overflows = 2;
+    CO_CANrxThreadsErrors(&check_CANmodule);
+    CO_CANrxThreadsErrors(&check_CANmodule);
+    if (check_reports != 1) {
+        printf("ring overflow: %u reports, expected 1\n", check_reports);
+        check_errors ++;
+    }
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    check_CANmodule.CANinterfaces = check_interfaces;
+    check_CANmodule.CANinterfaceCount = CHECK_INTERFACES;
+    for (i = 0; i < CHECK_INTERFACES; i++) {
+        CO_CANrxThread_t *rxThread;
+
+        if (posix_memalign((void**)&rxThread, CO_DRIVER_CACHE_LINE, sizeof(*rxThread)) != 0) {
+            return EXIT_FAILURE;
+        }
+        memset(rxThread, 0, sizeof(*rxThread));
+        /* start close to the index wrap around as well */
+        rxThread->head = rxThread->tail = 0xFFFFFFFCU + i;
+        snprintf(check_interfaces[i].ifName, IFNAMSIZ, "can%u", i);
+        check_interfaces[i].rxThread = rxThread;
+    }
+
+    check_order();
+    check_overflows();
+
+    for (i = 0; i < CHECK_INTERFACES; i++) {
+        free(check_interfaces[i].rxThread);
+    }
+    printf("receive thread merge: %u errors\n", check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
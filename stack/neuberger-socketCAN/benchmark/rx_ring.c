@@ -0,0 +1,289 @@
+/*
+ * Benchmark of the TPACKET_V3 receive ring in the socketCAN driver.
+ *
+ * @file        rx_ring.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Fills a ring in memory like the kernel fills the mmap()ed PF_PACKET ring
+ * and reads it with CO_CANreadRing() and CO_CANrxEvaluate(), so no CAN
+ * interface is needed. First checks, that all frames reach the rx buffer
+ * callbacks in order, that own and loopback frames are skipped, that the
+ * frames are used in place and that each block is given back to the kernel.
+ * Then times the frames used in place against a copy of each frame to the
+ * stack before evaluation, like the driver did before.
+ *
+ *     ./bench_rxring [<passes>]
+ */
+
+/* static functions of the driver are benchmarked */
+#include "CO_driver.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BENCH_RX_BUFFERS    8       /* COB IDs 0x181... */
+#define BENCH_PKT_PER_BLOCK ((CO_CANRX_RING_BLOCK_SIZE - BENCH_PKT_FIRST) / \
+                             CO_CANRX_RING_FRAME_SIZE)
+#define BENCH_PKT_FIRST     TPACKET_ALIGN(sizeof(struct tpacket_block_desc))
+#define BENCH_OWN_EVERY     16      /* every 16th packet is an own message */
+
+static CO_CANmodule_t   bench_CANmodule;
+static CO_CANinterface_t bench_interface;
+static CO_CANrx_t       bench_rxArray[BENCH_RX_BUFFERS];
+static CO_CANtx_t       bench_txArray[1];
+static uint32_t         bench_expected;
+static uint32_t         bench_received;
+static unsigned         bench_errors;
+
+/* driver is linked for the ring, it reports errors */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Frames carry their number within the ring, own frames are not counted */
+static void bench_rxCallback(void *object, const CO_CANrxMsg_t *message)
+{
+    uint32_t number;
+
+    (void)object;
+    memcpy(&number, message->data, sizeof(number));
+    if (number != bench_expected && bench_errors++ < 10) {
+        printf("frame %u received, expected %u\n", number, bench_expected);
+    }
+    bench_expected = number + 1;
+    if ((bench_expected % BENCH_OWN_EVERY) == 0) {
+        bench_expected ++;
+    }
+    bench_received ++;
+}
+
+/* Fill all blocks like the kernel, returns number of frames to receive */
+static uint32_t bench_fill(uint8_t *ring)
+{
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *pkt;
+    struct sockaddr_ll *addr;
+    struct can_frame *frame;
+    uint32_t number = 0;
+    uint32_t received = 0;
+    uint32_t b, p;
+
+    memset(ring, 0, CO_CANRX_RING_BLOCK_NR * CO_CANRX_RING_BLOCK_SIZE);
+    for (b = 0; b < CO_CANRX_RING_BLOCK_NR; b++) {
+        block = (struct tpacket_block_desc *)(ring + b * CO_CANRX_RING_BLOCK_SIZE);
+        block->hdr.bh1.num_pkts = BENCH_PKT_PER_BLOCK;
+        block->hdr.bh1.offset_to_first_pkt = BENCH_PKT_FIRST;
+        for (p = 0; p < BENCH_PKT_PER_BLOCK; p++) {
+            pkt = (struct tpacket3_hdr *)((uint8_t *)block + BENCH_PKT_FIRST +
+                                          p * CO_CANRX_RING_FRAME_SIZE);
+            addr = (struct sockaddr_ll *)((uint8_t *)pkt +
+                                          TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+            pkt->tp_next_offset = CO_CANRX_RING_FRAME_SIZE;
+            pkt->tp_snaplen = CAN_MTU;
+            pkt->tp_mac = TPACKET_ALIGN(sizeof(struct tpacket3_hdr)) +
+                          TPACKET_ALIGN(sizeof(struct sockaddr_ll));
+            pkt->tp_sec = 1;
+            pkt->tp_nsec = number;
+            addr->sll_pkttype = (number % BENCH_OWN_EVERY) == 0 ?
+                                PACKET_OUTGOING : PACKET_HOST;
+            if (addr->sll_pkttype == PACKET_HOST) {
+                received ++;
+            }
+            frame = (struct can_frame *)((uint8_t *)pkt + pkt->tp_mac);
+            frame->can_id = 0x181 + (number % BENCH_RX_BUFFERS);
+            frame->can_dlc = 8;
+            memcpy(frame->data, &number, sizeof(number));
+            number ++;
+        }
+        block->hdr.bh1.block_status = TP_STATUS_USER;
+    }
+    return received;
+}
+
+/* Give all blocks to the application again, contents stay valid */
+static void bench_refill(uint8_t *ring)
+{
+    struct tpacket_block_desc *block;
+    uint32_t b;
+
+    for (b = 0; b < CO_CANRX_RING_BLOCK_NR; b++) {
+        block = (struct tpacket_block_desc *)(ring + b * CO_CANRX_RING_BLOCK_SIZE);
+        block->hdr.bh1.block_status = TP_STATUS_USER;
+    }
+    bench_expected = 1;
+}
+
+static bool_t bench_check(uint8_t *ring)
+{
+    const struct can_frame *msg;
+    struct timespec timestamp;
+    struct tpacket_block_desc *block;
+    uint32_t frames;
+    uint32_t b;
+
+    frames = bench_fill(ring);
+    bench_expected = 1;
+    bench_received = 0;
+    while (CO_CANreadRing(&bench_CANmodule, &bench_interface, &msg,
+                          &timestamp) == CO_ERROR_NO) {
+        if ((const uint8_t *)msg < ring ||
+            (const uint8_t *)msg >= ring + CO_CANRX_RING_BLOCK_NR * CO_CANRX_RING_BLOCK_SIZE) {
+            printf("frame is not in the ring\n");
+            bench_errors ++;
+        }
+        if (CO_CANrxEvaluate(&bench_CANmodule, &bench_interface, msg,
+                             &timestamp, NULL) < 0) {
+            printf("frame %03X not matched\n", msg->can_id);
+            bench_errors ++;
+        }
+    }
+    if (bench_received != frames) {
+        printf("%u of %u frames received\n", bench_received, frames);
+        bench_errors ++;
+    }
+    for (b = 0; b < CO_CANRX_RING_BLOCK_NR; b++) {
+        block = (struct tpacket_block_desc *)(ring + b * CO_CANRX_RING_BLOCK_SIZE);
+        if (block->hdr.bh1.block_status != TP_STATUS_KERNEL) {
+            printf("block %u not given back\n", b);
+            bench_errors ++;
+        }
+    }
+    if (bench_interface.ringBlock != 0 || bench_interface.ringPkt != NULL) {
+        printf("ring position not at start\n");
+        bench_errors ++;
+    }
+    return bench_errors == 0;
+}
+
+/* Returns ns per frame, _copy_ copies each frame to the stack first */
+static double bench_run(uint8_t *ring, uint32_t passes, bool_t copy)
+{
+    const struct can_frame *msg;
+    struct can_frame frame;
+    struct timespec timestamp;
+    uint64_t frames = 0;
+    uint32_t i;
+    double start;
+
+    start = bench_now();
+    for (i = 0; i < passes; i++) {
+        bench_refill(ring);
+        while (CO_CANreadRing(&bench_CANmodule, &bench_interface, &msg,
+                              &timestamp) == CO_ERROR_NO) {
+            if (copy) {
+                memcpy(&frame, msg, sizeof(frame));
+                msg = &frame;
+            }
+            (void)CO_CANrxEvaluate(&bench_CANmodule, &bench_interface, msg,
+                                   &timestamp, NULL);
+            frames ++;
+        }
+    }
+    return (bench_now() - start) * 1e9 / frames;
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t *ring;
+    uint32_t passes = 2000;
+    uint32_t i;
+    double inPlace, copied;
+
+    if (argc > 1) {
+        passes = strtoul(argv[1], NULL, 0);
+        if (passes == 0) {
+            fprintf(stderr, "Usage: %s [<passes>]\n", argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (CO_CANmodule_init(&bench_CANmodule, 0, bench_rxArray, BENCH_RX_BUFFERS,
+                          bench_txArray, 1, 0) != CO_ERROR_NO) {
+        fprintf(stderr, "CAN module not initialized\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < BENCH_RX_BUFFERS; i++) {
+        (void)CO_CANrxBufferInit(&bench_CANmodule, i, 0x181 + i, 0x7FF, false,
+                                 NULL, bench_rxCallback);
+    }
+    bench_CANmodule.CANnormal = true;
+
+    /* ring block is aligned to the page like mmap() */
+    if (posix_memalign((void **)&ring, 4096,
+                       CO_CANRX_RING_BLOCK_NR * CO_CANRX_RING_BLOCK_SIZE) != 0) {
+        fprintf(stderr, "ring not allocated\n");
+        exit(EXIT_FAILURE);
+    }
+    bench_interface.rxBackend = CO_CANRX_BACKEND_RING;
+    bench_interface.fdRing = -1;
+    bench_interface.ring = ring;
+    strcpy(bench_interface.ifName, "ring");
+
+    if (!bench_check(ring)) {
+        exit(EXIT_FAILURE);
+    }
+
+    /* warm up, then alternate to even out frequency scaling */
+    (void)bench_run(ring, passes / 10 + 1, false);
+    inPlace = bench_run(ring, passes, false);
+    copied = bench_run(ring, passes, true);
+    inPlace = (inPlace + bench_run(ring, passes, false)) / 2;
+    copied = (copied + bench_run(ring, passes, true)) / 2;
+
+    printf("frames per pass: %u\n", (unsigned)(CO_CANRX_RING_BLOCK_NR * BENCH_PKT_PER_BLOCK));
+    printf("in place:  %6.1f ns per frame\n", inPlace);
+    printf("copied:    %6.1f ns per frame\n", copied);
+
+    free(ring);
+    CO_CANmodule_disable(&bench_CANmodule);
+    return bench_errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
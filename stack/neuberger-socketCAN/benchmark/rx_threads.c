@@ -0,0 +1,301 @@
+/*
+ * Receive throughput of the socketCAN driver over several CAN interfaces.
+ *
+ * @file        rx_threads.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Built twice by the Makefile: bench_rxwait receives all interfaces in
+ * CO_CANrxWait(), bench_rxthreads with CO_DRIVER_RX_THREADS. Use with vcan:
+ *
+ *     ip link add dev vcan0 type vcan && ip link set vcan0 up
+ *     (same for vcan1..vcan3)
+ *     ./bench_rxwait vcan0 vcan1 vcan2 vcan3
+ *     ./bench_rxthreads vcan0 vcan1 vcan2 vcan3
+ *
+ * A pass is made with the first interface only, then with the first two and
+ * so on. In each pass one generator thread per interface sends as fast as
+ * the socket allows. The generators load the CPUs as well, compare results
+ * on a machine with at least twice as many CPUs as interfaces.
+ */
+
+#include <errno.h>
+#include <net/if.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+#include "CO_driver.h"
+#include "CO_Emergency.h"
+
+#define BENCH_INTERFACES_MAX    4
+#define BENCH_RX_BUFFERS        32      /* COB IDs 0x181... */
+
+typedef struct {
+    const char         *ifName;
+    int                 fd;             /* generator socket */
+    volatile int        stop;
+    pthread_t           thread;
+    uint64_t            txFrames;
+} bench_generator_t;
+
+static CO_CANmodule_t   bench_CANmodule;
+static CO_CANrx_t       bench_rxArray[BENCH_RX_BUFFERS];
+static CO_CANtx_t       bench_txArray[1];
+static uint64_t         bench_rxFrames;
+
+/* driver reports socket queue overflows, counted from driver statistics here */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+static void bench_rxCallback(void *object, const CO_CANrxMsg_t *message)
+{
+    (void)object; (void)message;
+    bench_rxFrames ++;
+}
+
+/* Send messages to all rx buffers round robin until stopped */
+static void *bench_generatorThread(void *arg)
+{
+    bench_generator_t *gen = (bench_generator_t *)arg;
+    struct can_frame frame;
+    uint32_t n = 0;
+
+    memset(&frame, 0, sizeof(frame));
+    frame.can_dlc = 8;
+    while (!gen->stop) {
+        frame.can_id = 0x181 + (n % BENCH_RX_BUFFERS);
+        memcpy(frame.data, &n, sizeof(n));
+        if (write(gen->fd, &frame, sizeof(frame)) == sizeof(frame)) {
+            gen->txFrames ++;
+            n ++;
+        }
+        else if (errno == ENOBUFS) {
+            /* device queue full */
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static int bench_generatorOpen(bench_generator_t *gen)
+{
+    struct sockaddr_can addr;
+
+    gen->fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (gen->fd < 0) {
+        return -1;
+    }
+    /* generator doesn't receive anything */
+    (void)setsockopt(gen->fd, SOL_CAN_RAW, CAN_RAW_FILTER, NULL, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = if_nametoindex(gen->ifName);
+    if (addr.can_ifindex == 0 ||
+        bind(gen->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(gen->fd);
+        gen->fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+static double bench_elapsed(const struct timespec *start)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* One pass with the first _count_ interfaces, returns received messages per second */
+static int bench_pass(bench_generator_t *gen, uint32_t count, double duration)
+{
+    CO_ReturnError_t err;
+    struct itimerspec interval;
+    struct timespec start;
+    uint64_t expirations;
+    int fdTimer;
+    uint64_t txFrames = 0;
+    uint64_t drops = 0;
+    double elapsed;
+    uint32_t i;
+
+    err = CO_CANmodule_init(&bench_CANmodule, if_nametoindex(gen[0].ifName),
+                            bench_rxArray, BENCH_RX_BUFFERS, bench_txArray, 1, 1000);
+    for (i = 0; i < count && err == CO_ERROR_NO; i++) {
+        err = CO_CANmodule_addInterface(&bench_CANmodule, if_nametoindex(gen[i].ifName));
+    }
+    for (i = 0; i < BENCH_RX_BUFFERS && err == CO_ERROR_NO; i++) {
+        err = CO_CANrxBufferInit(&bench_CANmodule, i, 0x181 + i, 0x7FF, 0, NULL,
+                                 bench_rxCallback);
+    }
+    if (err != CO_ERROR_NO) {
+        fprintf(stderr, "driver init failed (%d)\n", err);
+        CO_CANmodule_disable(&bench_CANmodule);
+        return -1;
+    }
+    CO_CANsetNormalMode(&bench_CANmodule);
+    if (bench_CANmodule.CANnormal == false) {
+        fprintf(stderr, "driver start failed\n");
+        CO_CANmodule_disable(&bench_CANmodule);
+        return -1;
+    }
+
+    bench_rxFrames = 0;
+    for (i = 0; i < count; i++) {
+        gen[i].stop = 0;
+        gen[i].txFrames = 0;
+        if (pthread_create(&gen[i].thread, NULL, bench_generatorThread, &gen[i]) != 0) {
+            fprintf(stderr, "pthread_create() failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* CO_CANrxWait() returns at least every 100 ms if nothing is received */
+    fdTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    interval.it_interval.tv_sec = 0;
+    interval.it_interval.tv_nsec = 100000000;
+    interval.it_value = interval.it_interval;
+    (void)timerfd_settime(fdTimer, 0, &interval, NULL);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        if (CO_CANrxWait(&bench_CANmodule, fdTimer, NULL) < 0) {
+            (void)read(fdTimer, &expirations, sizeof(expirations));
+        }
+        elapsed = bench_elapsed(&start);
+    } while (elapsed < duration);
+    close(fdTimer);
+
+    for (i = 0; i < count; i++) {
+        gen[i].stop = 1;
+    }
+    drops = bench_CANmodule.rxDropCount;
+    for (i = 0; i < count; i++) {
+        pthread_join(gen[i].thread, NULL);
+        txFrames += gen[i].txFrames;
+#ifdef CO_DRIVER_RX_THREADS
+        if (bench_CANmodule.CANinterfaces[i].rxThread != NULL) {
+            drops += bench_CANmodule.CANinterfaces[i].rxThread->overflows;
+        }
+#endif
+    }
+
+    printf("%u interface(s): %10.0f rx/s %10.0f rx/s per interface, "
+           "sent %llu, dropped %llu\n", count,
+           bench_rxFrames / elapsed, bench_rxFrames / elapsed / count,
+           (unsigned long long)txFrames, (unsigned long long)drops);
+    fflush(stdout);
+
+    CO_CANmodule_disable(&bench_CANmodule);
+    return 0;
+}
+
+static void usage(const char *progName)
+{
+    fprintf(stderr,
+"Usage: %s [options] <CAN interface> [<CAN interface> ...]\n"
+"\n"
+"Receives from 1..n of the given interfaces (up to %d) and prints\n"
+"the processed messages per second.\n"
+"\n"
+"Options:\n"
+"  -t <s>        Duration of one pass, default 5.\n",
+            progName, BENCH_INTERFACES_MAX);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_generator_t gen[BENCH_INTERFACES_MAX];
+    double duration = 5.0;
+    uint32_t count;
+    uint32_t i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:")) != -1) {
+        switch (opt) {
+            case 't': duration = strtod(optarg, NULL); break;
+            default:
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    count = argc - optind;
+    if (count == 0 || count > BENCH_INTERFACES_MAX || duration <= 0) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    for (i = 0; i < count; i++) {
+        gen[i].ifName = argv[optind + i];
+        if (bench_generatorOpen(&gen[i]) < 0) {
+            fprintf(stderr, "%s: can't open %s\n", argv[0], gen[i].ifName);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+#ifdef CO_DRIVER_RX_THREADS
+    printf("receive threads, %.1f s per pass\n", duration);
+#else
+    printf("CO_CANrxWait(), %.1f s per pass\n", duration);
+#endif
+    for (i = 1; i <= count; i++) {
+        if (bench_pass(gen, i, duration) < 0) {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        close(gen[i].fd);
+    }
+    return 0;
+}
@@ -0,0 +1,387 @@
+/*
+ * Check of the SDO client of the application.
+ *
+ * @file        sdo_client.cpp
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Canopen_sdo_client of the application runs against the SDO server of a
+ * second CANopen object, both without CAN interface. A socketpair is the CAN
+ * bus, FreeRTOS is replaced by a single task in virtual time: while the
+ * client waits in ulTaskNotifyTake(), messages are passed between the objects
+ * and both are processed, one tick is 1 ms.
+ *
+ * Every SDO request and response on the bus is observed. Transfers to the
+ * same SDO server must be serialized, a request must not be sent before the
+ * previous one is answered or aborted, and not before 10 ms after an abort.
+ * Transfers to the same server complete in the order they were started,
+ * transfers to other servers use the other channel meanwhile. Responses wake
+ * the client at once.
+ *
+ *     ./check_sdoclient
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "CANopen.h"
+#include "CO_OD.h"
+
+#include "canopen_sdo_client.h"
+
+#include "CO_OD_instance.h"
+
+#define CHECK_CLIENT        10      /* node ID of the client object */
+#define CHECK_SERVER        11      /* node ID of the server object */
+#define CHECK_MISSING       5       /* node ID without SDO server */
+#define CHECK_TIMEOUT_MS    100
+#define CHECK_HOLDOFF_MS    10      /* Canopen_sdo_client::abort_holdoff */
+
+OD_SDOClientParameter_t OD_SDOClientParameter[CO_NO_SDO_CLIENT] = {
+    {3, 0x80000000L, 0x80000000L, 0},
+    {3, 0x80000000L, 0x80000000L, 0}};
+
+static unsigned int check_errors;
+
+static void check(bool_t ok, const char *what)
+{
+    if (!ok) {
+        printf("failed: %s\n", what);
+        check_errors ++;
+    }
+}
+
+/* CANopen objects, check_fd[i] is the CAN interface of check_co[i] */
+static CO_t        *check_co[2];
+static int          check_fd[2];
+
+/* SDO messages on the bus, by node ID of the SDO server */
+typedef struct {
+    bool_t          requestOpen;    /* request without response or abort */
+    bool_t          aborted;        /* client abort, no request since */
+    TickType_t      abortTick;
+    unsigned int    requests;
+    unsigned int    overlaps;       /* request while another one is open */
+    unsigned int    holdoffViolations; /* request too early after abort */
+} check_wire_t;
+
+static check_wire_t check_wire[128];
+
+/* FreeRTOS task */
+static TickType_t   check_tick;
+static bool_t       check_notified;
+static unsigned int check_notifies;
+
+static void check_observe(const struct can_frame *msg)
+{
+    uint32_t ident = msg->can_id & CAN_SFF_MASK;
+    check_wire_t *wire;
+
+    if (ident > 0x600 && ident < 0x680) {
+        wire = &check_wire[ident - 0x600];
+        if (msg->data[0] == 0x80) {
+            wire->requestOpen = false;
+            wire->aborted = true;
+            wire->abortTick = check_tick;
+            return;
+        }
+        if (wire->requestOpen) {
+            wire->overlaps ++;
+        }
+        if (wire->aborted && (check_tick - wire->abortTick) < CHECK_HOLDOFF_MS) {
+            wire->holdoffViolations ++;
+        }
+        wire->requestOpen = true;
+        wire->aborted = false;
+        wire->requests ++;
+    }
+    else if (ident > 0x580 && ident < 0x600) {
+        check_wire[ident - 0x580].requestOpen = false;
+    }
+}
+
+/* Pass all messages on the bus to the other object */
+static void check_bus(void)
+{
+    struct can_frame msg;
+    bool_t received;
+    int i;
+
+    do {
+        received = false;
+        for (i = 0; i < 2; i++) {
+            while (recv(check_fd[i], &msg, sizeof(msg), MSG_DONTWAIT) == CAN_MTU) {
+                check_observe(&msg);
+                (void)CO_CANrxFrame(check_co[i]->CANmodule[0], 1, &msg, NULL);
+                received = true;
+            }
+        }
+    } while (received);
+}
+
+static void check_process(uint16_t timeDifference_ms)
+{
+    int i;
+
+    check_bus();
+    for (i = 0; i < 2; i++) {
+        (void)CO_process(check_co[i], timeDifference_ms, NULL);
+    }
+    check_bus();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)&check_tick;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return check_tick;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    (void)xTaskToNotify;
+    check_notified = true;
+    check_notifies ++;
+    return pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    TickType_t start = check_tick;
+
+    (void)xClearCountOnExit;
+    check_process(0);
+    while (!check_notified && (check_tick - start) < xTicksToWait) {
+        check_tick ++;
+        check_process(1);
+    }
+    if (check_notified) {
+        check_notified = false;
+        return 1;
+    }
+    return 0;
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    TickType_t start = check_tick;
+
+    while ((check_tick - start) < xTicksToDelay) {
+        check_tick ++;
+        check_process(1);
+    }
+}
+
+/* Transfers in coroutines */
+typedef struct {
+    Canopen_sdo_client::result_t result;
+    uint8_t         data[16];
+    unsigned int    sequence;       /* order of completion, 0 = running */
+    TickType_t      tick;           /* time of completion */
+} check_transfer_t;
+
+static unsigned int check_sequence;
+
+static void check_done(check_transfer_t *transfer, Canopen_sdo_client::result_t result)
+{
+    transfer->result = result;
+    transfer->sequence = ++ check_sequence;
+    transfer->tick = check_tick;
+}
+
+static Canopen_sdo_client::task check_upload(Canopen_sdo_client &sdo, u8 nid,
+        u16 index, u8 subindex, check_transfer_t *transfer)
+{
+    check_done(transfer, co_await sdo.upload(nid, index, subindex,
+                                             transfer->data, sizeof(transfer->data)));
+}
+
+/* download, then upload from the same coroutine */
+static Canopen_sdo_client::task check_heartbeatTime(Canopen_sdo_client &sdo,
+        check_transfer_t *download, check_transfer_t *upload)
+{
+    u16 time = 1234;
+
+    check_done(download, co_await sdo.download(CHECK_SERVER, 0x1017, 0, &time, sizeof(time)));
+    check_done(upload, co_await sdo.upload(CHECK_SERVER, 0x1017, 0,
+                                           upload->data, sizeof(upload->data)));
+}
+
+/* data == NULL for download */
+static bool_t check_ok(const check_transfer_t *transfer, uint32_t size, const void *data)
+{
+    return transfer->sequence != 0
+        && transfer->result.ret == CO_SDOcli_ok_communicationEnd
+        && transfer->result.size == size
+        && (data == NULL || memcmp(transfer->data, data, size) == 0);
+}
+
+static void check_setIdentity(CO_t *CO, uint32_t base)
+{
+    OD_identity.vendorID = base + 1;
+    OD_identity.productCode = base + 2;
+    OD_identity.revisionNumber = base + 3;
+    OD_identity.serialNumber = base + 4;
+}
+
+int main(void)
+{
+    Canopen_sdo_client sdo;
+    check_transfer_t server[7];     /* in order of start, [6] after [5] */
+    check_transfer_t missing[2];
+    check_transfer_t wrongNid;
+    check_transfer_t aborted[3];
+    uint32_t identity[4];
+    u16 heartbeatTime = 1234;
+    CO_t *CO;
+    int i;
+
+    memset(server, 0, sizeof(server));
+    memset(missing, 0, sizeof(missing));
+    memset(&wrongNid, 0, sizeof(wrongNid));
+    memset(aborted, 0, sizeof(aborted));
+
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, check_fd) != 0) {
+        printf("failed: socketpair()\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < 2; i++) {
+        if (CO_newInstance(&check_co[i]) != CO_ERROR_NO ||
+            CO_CANinitInstance(check_co[i], 0, 0) != CO_ERROR_NO ||
+            CO_CANmodule_addInterfaceExternal(check_co[i]->CANmodule[0], 1, check_fd[i]) != CO_ERROR_NO ||
+            CO_CANopenInitInstance(check_co[i], (i == 0) ? CHECK_CLIENT : CHECK_SERVER) != CO_ERROR_NO) {
+            printf("failed: CANopen object %d\n", i);
+            return EXIT_FAILURE;
+        }
+        CO_CANsetNormalMode(check_co[i]->CANmodule[0]);
+    }
+    check_setIdentity(check_co[0], 0x22000000);
+    check_setIdentity(check_co[1], 0x11000000);
+    /* boot-up */
+    check_process(0);
+
+    check(sdo.init(check_co[0], CHECK_TIMEOUT_MS) == CO_ERROR_NO, "init()");
+
+    /* first channel waits for the missing server, transfers to the server
+     * follow each other on the second channel */
+    check_upload(sdo, CHECK_MISSING, 0x1000, 0, &missing[0]);
+    for (i = 0; i < 4; i++) {
+        check_upload(sdo, CHECK_SERVER, 0x1018, i + 1, &server[i]);
+    }
+    check_upload(sdo, CHECK_SERVER, 0x1008, 0, &server[4]);
+    check_heartbeatTime(sdo, &server[5], &server[6]);
+    check_upload(sdo, CHECK_MISSING, 0x1000, 0, &missing[1]);
+    check_upload(sdo, 0, 0x1000, 0, &wrongNid);
+    check(sdo.get_outstanding() == 9, "all transfers outstanding");
+
+    while (sdo.get_outstanding() != 0 && check_tick < 10 * CHECK_TIMEOUT_MS) {
+        sdo.process(50);
+    }
+    check(sdo.get_outstanding() == 0, "all transfers completed");
+
+    /* results from the server object */
+    CO = check_co[1];
+    identity[0] = OD_identity.vendorID;
+    identity[1] = OD_identity.productCode;
+    identity[2] = OD_identity.revisionNumber;
+    identity[3] = OD_identity.serialNumber;
+    for (i = 0; i < 4; i++) {
+        check(check_ok(&server[i], 4, &identity[i]), "upload of identity");
+    }
+    check(check_ok(&server[4], ODL_manufacturerDeviceName_stringLength,
+                   OD_manufacturerDeviceName), "segmented upload of device name");
+    check(check_ok(&server[5], 2, NULL), "download of heartbeat time");
+    check(check_ok(&server[6], 2, &heartbeatTime), "upload of downloaded heartbeat time");
+    check(OD_producerHeartbeatTime == 1234, "heartbeat time of server object");
+    CO = check_co[0];
+    check(OD_producerHeartbeatTime != 1234, "heartbeat time of client object");
+
+    /* serialized and in order of start */
+    check(check_wire[CHECK_SERVER].overlaps == 0, "one request at a time to the server");
+    check(check_wire[CHECK_SERVER].requests >= 9, "requests to the server");
+    for (i = 1; i < 7; i++) {
+        check(server[i - 1].sequence < server[i].sequence, "transfers to the server in order");
+    }
+
+    /* the missing server times out, meanwhile the other channel is used */
+    check(missing[0].result.ret == CO_SDOcli_endedWithTimeout, "timeout of missing server");
+    check(missing[0].tick >= CHECK_TIMEOUT_MS, "time of timeout");
+    check(server[6].tick < missing[0].tick, "transfers to the server during timeout");
+    check(missing[1].result.ret == CO_SDOcli_endedWithTimeout, "second timeout of missing server");
+    check(check_wire[CHECK_MISSING].requests == 2, "requests to the missing server");
+    check(check_wire[CHECK_MISSING].overlaps == 0, "one request at a time to missing server");
+    check(check_wire[CHECK_MISSING].holdoffViolations == 0, "request after abort holdoff");
+    check(missing[1].tick >= missing[0].tick + CHECK_HOLDOFF_MS + CHECK_TIMEOUT_MS,
+          "second transfer started after abort holdoff");
+
+    /* node ID 0 ends without request, as soon as it is taken from the queue */
+    check(wrongNid.result.ret == CO_SDOcli_wrongArguments, "wrong node ID");
+    check(wrongNid.tick < missing[0].tick, "wrong node ID ends without waiting");
+
+    /* responses wake the task, the server answers without ticks passing */
+    check(check_notifies != 0, "notification by SDO response");
+    check(server[6].tick == 0, "transfers to the server without polling");
+
+    /* transfers not started yet are aborted by deinit() */
+    for (i = 0; i < 3; i++) {
+        check_upload(sdo, CHECK_SERVER, 0x1018, i + 1, &aborted[i]);
+    }
+    sdo.deinit();
+    for (i = 0; i < 3; i++) {
+        check(aborted[i].sequence != 0 &&
+              aborted[i].result.ret == CO_SDOcli_endedWithClientAbort, "abort by deinit()");
+    }
+    check(sdo.get_outstanding() == 0, "no transfers after deinit()");
+
+    for (i = 0; i < 2; i++) {
+        CO_deleteInstance(check_co[i], 0);
+        close(check_fd[i]);
+    }
+
+    printf("SDO client checked, %u errors\n", check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,270 @@
+/*
+ * Benchmark of SDO expedited upload, with and without OD descriptors.
+ *
+ * @file        sdo_expedited.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * CANopen.c passes a table of OD descriptors to CO_SDO_init() if
+ * CO_USE_OD_DESCRIPTORS is defined. Two SDO servers are initialized on the
+ * example OD, one with and one without the table. Each gets expedited upload
+ * requests for all readable objects of up to 4 bytes, in random order, and
+ * answers them in CO_SDO_process(). The CAN module has no interface, so the
+ * response is only written into the tx buffer. Before timing, both servers
+ * must give the same response for every object. Also measured is only the OD
+ * access of the upload, CO_SDO_initTransfer() and CO_SDO_readOD().
+ *
+ *     ./bench_sdoexpedited [<rounds>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CO_driver.h"
+#include "CO_SDO.h"
+#include "CO_Emergency.h"
+#include "CO_OD.h"
+
+#define BENCH_OBJECTS_MAX       512
+
+typedef struct {
+    uint16_t            index;
+    uint8_t             subIndex;
+} bench_object_t;
+
+/* from CO_OD.c, declared like in CANopen.c */
+extern const CO_OD_entry_t CO_OD[CO_OD_NoOfElements];
+
+static CO_CANmodule_t   bench_CANmodule;
+static CO_CANrx_t       bench_rxArray[2];
+static CO_CANtx_t       bench_txArray[2];
+static CO_SDO_t         bench_SDO[2];
+static CO_OD_extension_t bench_ODExtensions[2][CO_OD_NoOfElements];
+static uint16_t         bench_ODIndex[2][CO_OD_INDEX_SIZE(CO_OD_NoOfElements)];
+static CO_OD_descriptor_t *bench_ODDescriptors;
+static bench_object_t   bench_objects[BENCH_OBJECTS_MAX];
+static uint32_t         bench_objectCount;
+
+/* driver is linked for the CAN module, it reports errors */
+void CO_errorReport(CO_EM_t *em, const uint8_t errorBit, const uint16_t errorCode,
+                    const uint32_t infoCode)
+{
+    (void)em; (void)errorBit; (void)errorCode; (void)infoCode;
+}
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* Expedited upload request to server _i_, returns response */
+static const uint8_t *bench_upload(uint32_t i, const bench_object_t *object)
+{
+    CO_CANrxMsg_t msg;
+    uint16_t timerNext_ms = 1000;
+
+    memset(&msg, 0, sizeof(msg));
+    msg.ident = 0x600 + 1 + i;
+    msg.DLC = 8;
+    msg.data[0] = 0x40;
+    msg.data[1] = (uint8_t)object->index;
+    msg.data[2] = (uint8_t)(object->index >> 8);
+    msg.data[3] = object->subIndex;
+    bench_rxArray[i].pFunct(bench_rxArray[i].object, &msg);
+    (void)CO_SDO_process(&bench_SDO[i], true, 0, 1000, &timerNext_ms);
+    return bench_SDO[i].CANtxBuff->data;
+}
+
+/* Readable objects of up to 4 bytes, in random order */
+static void bench_objectsInit(void)
+{
+    CO_SDO_t *SDO = &bench_SDO[0];
+    uint16_t entryNo;
+    uint32_t i;
+
+    bench_objectCount = 0;
+    for (entryNo = 0; entryNo < CO_OD_NoOfElements; entryNo++) {
+        uint16_t subIndex;
+
+        if (CO_OD[entryNo].index == OD_H1200_SDO_SERVER_PARAM) {
+            /* COB IDs depend on the node-ID of the server */
+            continue;
+        }
+
+        for (subIndex = 0; subIndex <= CO_OD[entryNo].maxSubIndex; subIndex++) {
+            uint16_t length = CO_OD_getLength(SDO, entryNo, (uint8_t)subIndex);
+
+            if ((CO_OD_getAttribute(SDO, entryNo, (uint8_t)subIndex) & CO_ODA_READABLE) != 0 &&
+                CO_OD_getDataPointer(SDO, entryNo, (uint8_t)subIndex) != NULL &&
+                length > 0 && length <= 4 && bench_objectCount < BENCH_OBJECTS_MAX) {
+                bench_objects[bench_objectCount].index = CO_OD[entryNo].index;
+                bench_objects[bench_objectCount].subIndex = (uint8_t)subIndex;
+                bench_objectCount ++;
+            }
+        }
+    }
+    for (i = bench_objectCount - 1; i > 0; i--) {
+        uint32_t j = rand() % (i + 1);
+        bench_object_t tmp = bench_objects[i];
+
+        bench_objects[i] = bench_objects[j];
+        bench_objects[j] = tmp;
+    }
+}
+
+/* ns per upload of server _i_ */
+static double bench_measure(uint32_t i, unsigned long rounds)
+{
+    volatile uint32_t sink = 0;
+    unsigned long r;
+    uint32_t o;
+    double start;
+
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (o = 0; o < bench_objectCount; o++) {
+            sink += bench_upload(i, &bench_objects[o])[4];
+        }
+    }
+    (void)sink;
+    return (bench_now() - start) * 1e9 / ((double)rounds * bench_objectCount);
+}
+
+/* ns per CO_SDO_initTransfer() and CO_SDO_readOD() of server _i_, the part
+ * of the upload the descriptors speed up */
+static double bench_measureRead(uint32_t i, unsigned long rounds)
+{
+    volatile uint32_t sink = 0;
+    unsigned long r;
+    uint32_t o;
+    double start;
+
+    start = bench_now();
+    for (r = 0; r < rounds; r++) {
+        for (o = 0; o < bench_objectCount; o++) {
+            sink += CO_SDO_initTransfer(&bench_SDO[i], bench_objects[o].index,
+                                        bench_objects[o].subIndex);
+            sink += CO_SDO_readOD(&bench_SDO[i], CO_SDO_BUFFER_SIZE);
+        }
+    }
+    (void)sink;
+    return (bench_now() - start) * 1e9 / ((double)rounds * bench_objectCount);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long rounds = 20000;
+    uint16_t descriptorCount;
+    uint32_t i;
+    double plain;
+    double descriptors;
+
+    if (argc > 1) {
+        rounds = strtoul(argv[1], NULL, 0);
+    }
+    if (rounds == 0) {
+        fprintf(stderr, "Usage: %s [<rounds>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    srand(1);
+
+    if (CO_CANmodule_init(&bench_CANmodule, 0, bench_rxArray, 2, bench_txArray, 2, 0)
+        != CO_ERROR_NO) {
+        fprintf(stderr, "CO_CANmodule_init() failed\n");
+        exit(EXIT_FAILURE);
+    }
+    descriptorCount = CO_OD_getDescriptorCount(CO_OD, CO_OD_NoOfElements);
+    bench_ODDescriptors = calloc(descriptorCount, sizeof(*bench_ODDescriptors));
+    if (bench_ODDescriptors == NULL) {
+        exit(EXIT_FAILURE);
+    }
+    /* server 0 without, server 1 with descriptors */
+    for (i = 0; i < 2; i++) {
+        /* COB IDs must differ, node-ID 1 and 2 */
+        if (CO_SDO_init(&bench_SDO[i], 0x600 + 1 + i, 0x580 + 1 + i, OD_H1200_SDO_SERVER_PARAM,
+                        NULL, CO_OD, CO_OD_NoOfElements, bench_ODExtensions[i],
+                        bench_ODIndex[i], CO_OD_INDEX_SIZE(CO_OD_NoOfElements),
+                        (i == 1) ? bench_ODDescriptors : NULL,
+                        (i == 1) ? descriptorCount : 0,
+                        1 + i, &bench_CANmodule, i, &bench_CANmodule, i) != CO_ERROR_NO) {
+            fprintf(stderr, "CO_SDO_init() failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (bench_SDO[0].ODDescriptors != NULL || bench_SDO[1].ODDescriptors == NULL) {
+        fprintf(stderr, "OD descriptors not set up\n");
+        exit(EXIT_FAILURE);
+    }
+    bench_objectsInit();
+
+    for (i = 0; i < bench_objectCount; i++) {
+        uint8_t response[8];
+
+        memcpy(response, bench_upload(0, &bench_objects[i]), sizeof(response));
+        if ((response[0] & 0xF3) != 0x43 ||
+            memcmp(response, bench_upload(1, &bench_objects[i]), sizeof(response)) != 0) {
+            fprintf(stderr, "%04X.%u: responses differ\n", bench_objects[i].index,
+                    bench_objects[i].subIndex);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printf("%u objects, %u descriptors (%u bytes)\n", bench_objectCount,
+           descriptorCount, (unsigned)(descriptorCount * sizeof(*bench_ODDescriptors)));
+    printf("                      without ns   with ns   speedup\n");
+    plain = bench_measureRead(0, rounds);
+    descriptors = bench_measureRead(1, rounds);
+    printf("initTransfer+readOD   %10.1f   %7.1f   %6.2fx\n", plain, descriptors,
+           plain / descriptors);
+    plain = bench_measure(0, rounds);
+    descriptors = bench_measure(1, rounds);
+    printf("upload request        %10.1f   %7.1f   %6.2fx\n", plain, descriptors,
+           plain / descriptors);
+
+    CO_CANmodule_disable(&bench_CANmodule);
+    free(bench_ODDescriptors);
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Check of the message demultiplexing of the device simulator.
+ *
+ * @file        sim_demux.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * The receive thread of the simulator reads all messages of a CAN interface
+ * from one socket and passes each to the device with the node ID of its
+ * COB-ID. This check passes messages to CO_sim_interfaceReceive() directly,
+ * for devices without CANopen object, and verifies the inboxes: messages for
+ * one node go to that device only, NMT, SYNC, TIME and LSS go to all devices,
+ * other messages are unmatched, a full inbox drops messages. Each device with
+ * messages is queued to a worker once.
+ *
+ *     ./check_simdemux
+ */
+
+/* static functions are checked */
+#include "CO_simulator.c"
+
+#include <stdio.h>
+
+#define CHECK_WORKERS   2
+
+static unsigned int check_errors;
+
+static void check(bool_t ok, const char *what)
+{
+    if (!ok) {
+        printf("failed: %s\n", what);
+        check_errors ++;
+    }
+}
+
+static CO_simulator_t       check_sim;
+static CO_simNode_t         check_nodes[3];
+static const uint8_t        check_nodeIds[3] = {1, 5, 127};
+
+static void check_send(uint32_t can_id, uint32_t length)
+{
+    struct can_frame msg;
+    struct timespec timestamp = {0, 0};
+
+    memset(&msg, 0, sizeof(msg));
+    msg.can_id = can_id;
+    msg.can_dlc = 8;
+    CO_sim_interfaceReceive(&check_sim.interfaces[0], &msg, length, &timestamp);
+}
+
+/* Take all messages from inboxes, return number of messages of each device */
+static void check_inboxes(uint32_t counts[3])
+{
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        counts[i] = check_nodes[i].inboxCount;
+        check_nodes[i].inboxCount = 0;
+        check_nodes[i].inboxHead = 0;
+    }
+}
+
+static bool_t check_counts(const uint32_t counts[3], uint32_t n1, uint32_t n5, uint32_t n127)
+{
+    return counts[0] == n1 && counts[1] == n5 && counts[2] == n127;
+}
+
+int main(void)
+{
+    static const CO_simConfig_t config = {CHECK_WORKERS, 0, 0, 1000};
+    CO_simInterface_t *interface;
+    uint32_t counts[3];
+    uint32_t queued;
+    uint32_t i;
+
+    if (CO_sim_init(&check_sim, &config) != CO_ERROR_NO) {
+        printf("failed: CO_sim_init()\n");
+        return EXIT_FAILURE;
+    }
+    /* interface and worker queues as from CO_sim_addInterface() and CO_sim_start() */
+    interface = &check_sim.interfaces[0];
+    interface->sim = &check_sim;
+    check_sim.interfaceCount = 1;
+    check_sim.nodeCount = 3;
+    for (i = 0; i < 3; i++) {
+        check_nodes[i].sim = &check_sim;
+        check_nodes[i].interface = interface;
+        check_nodes[i].nodeId = check_nodeIds[i];
+        check_nodes[i].state = CO_SIM_NODE_IDLE;
+        pthread_mutex_init(&check_nodes[i].inboxLock, NULL);
+        interface->nodes[check_nodeIds[i]] = &check_nodes[i];
+    }
+    check_sim.workers = calloc(CHECK_WORKERS, sizeof(*check_sim.workers));
+    for (i = 0; i < CHECK_WORKERS; i++) {
+        pthread_mutex_init(&check_sim.workers[i].lock, NULL);
+        check_sim.workers[i].queue = calloc(check_sim.nodeCount,
+                                            sizeof(*check_sim.workers[i].queue));
+    }
+
+    /* messages for one device */
+    check_send(0x605, CAN_MTU);     /* SDO request */
+    check_send(0x205, CAN_MTU);     /* RPDO */
+    check_send(0x77F, CAN_MTU);     /* heartbeat with node ID 127 */
+    check_send(0x201, CAN_MTU);
+    queued = check_sim.workers[0].queueCount + check_sim.workers[1].queueCount;
+    check(queued == 3 && check_sim.pending == 3, "each device queued once");
+    check(check_nodes[1].state == CO_SIM_NODE_QUEUED, "device queued");
+    check_inboxes(counts);
+    check(check_counts(counts, 1, 2, 1), "messages by node ID");
+
+    /* messages for all devices */
+    check_send(0x000, CAN_MTU);     /* NMT */
+    check_send(0x080, CAN_MTU);     /* SYNC */
+    check_send(0x100, CAN_MTU);     /* TIME */
+    check_send(CO_CAN_ID_LSS_SRV, CAN_MTU);
+    check_inboxes(counts);
+    check(check_counts(counts, 4, 4, 4), "messages to all devices");
+
+    /* unmatched messages */
+    check_send(0x60A, CAN_MTU);     /* no device 10 */
+    check_send(0x605 | CAN_EFF_FLAG, CAN_MTU);
+    check_send(0x605 | CAN_ERR_FLAG, CAN_MTU);
+    check_send(0x605, CANFD_MTU);
+    check_inboxes(counts);
+    check(check_counts(counts, 0, 0, 0) && interface->unmatched == 4, "unmatched messages");
+
+    /* full inbox */
+    for (i = 0; i < CO_SIM_INBOX_SIZE + 6; i++) {
+        check_send(0x605, CAN_MTU);
+    }
+    check(check_nodes[1].inboxCount == CO_SIM_INBOX_SIZE &&
+          check_nodes[1].inboxOverflows == 6, "inbox overflow");
+    queued = check_sim.workers[0].queueCount + check_sim.workers[1].queueCount;
+    check(queued == 3, "queued device not queued again");
+
+    for (i = 0; i < CHECK_WORKERS; i++) {
+        free(check_sim.workers[i].queue);
+    }
+    free(check_sim.workers);
+
+    printf("simulator demultiplexing checked, %u errors\n", check_errors);
+    return (check_errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
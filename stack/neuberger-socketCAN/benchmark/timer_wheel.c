@@ -0,0 +1,197 @@
+/*
+ * Timer wheel against a scan of per object countdown timers.
+ *
+ * @file        timer_wheel.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+/*
+ * Both variants run the same timed objects, each with its own period between
+ * 50 and 1000 ms, like heartbeat consumer times. An object is restarted when
+ * its timer expires. The scan is what CO_HBconsumer_process() did before the
+ * timer wheel: every object adds the time difference to its counter, checks
+ * it and lowers timerNext_ms. The wheel variant calls CO_timerWheel_process(),
+ * fetches the expired timers and gets timerNext_ms from CO_timerWheel_next().
+ * Time advances in steps of 1 ms. Both must see the same number of expiries.
+ *
+ *     ./bench_timerwheel [<simulated ms>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "CO_driver.h"
+#include "CO_timerWheel.h"
+
+#define BENCH_OBJECTS_MAX       1000
+
+/* timed object of the scan variant */
+typedef struct {
+    uint16_t            timer;
+    uint16_t            time;
+} bench_scanObject_t;
+
+static bench_scanObject_t   bench_scanObjects[BENCH_OBJECTS_MAX];
+static CO_timer_t           bench_timers[BENCH_OBJECTS_MAX];
+static uint16_t             bench_times[BENCH_OBJECTS_MAX];
+static CO_timerWheel_t      bench_wheel;
+
+static double bench_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/* One step of the scan variant, returns number of expired objects */
+static uint32_t bench_scanProcess(uint32_t count, uint16_t timeDifference_ms,
+                                  uint16_t *timerNext_ms)
+{
+    bench_scanObject_t *object = &bench_scanObjects[0];
+    uint32_t expired = 0;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        object->timer += timeDifference_ms;
+        if (object->timer >= object->time) {
+            expired ++;
+            object->timer = 0;
+        }
+        if (*timerNext_ms > object->time - object->timer) {
+            *timerNext_ms = object->time - object->timer;
+        }
+        object++;
+    }
+    return expired;
+}
+
+/* One step of the wheel variant, returns number of expired objects */
+static uint32_t bench_wheelProcess(uint16_t timeDifference_ms, uint16_t *timerNext_ms)
+{
+    CO_timer_t *timer;
+    uint32_t expired = 0;
+    uint32_t diff;
+
+    CO_timerWheel_process(&bench_wheel, timeDifference_ms);
+    while ((timer = CO_timerWheel_getExpired(&bench_wheel)) != NULL) {
+        expired ++;
+        CO_timer_start(&bench_wheel, timer, *(uint16_t *)timer->object);
+    }
+    diff = CO_timerWheel_next(&bench_wheel);
+    if (*timerNext_ms > diff) {
+        *timerNext_ms = (uint16_t)diff;
+    }
+    return expired;
+}
+
+/* Start _count_ objects in both variants */
+static void bench_setup(uint32_t count)
+{
+    uint32_t i;
+
+    CO_timerWheel_init(&bench_wheel);
+    for (i = 0; i < count; i++) {
+        bench_times[i] = 50 + rand() % 951;
+        bench_scanObjects[i].timer = 0;
+        bench_scanObjects[i].time = bench_times[i];
+        CO_timer_init(&bench_timers[i], &bench_times[i]);
+        CO_timer_start(&bench_wheel, &bench_timers[i], bench_times[i]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t counts[] = {10, 20, 50, 100, 200, 500, 1000};
+    unsigned long duration_ms = 1000000;
+    uint32_t i;
+
+    if (argc > 1) {
+        duration_ms = strtoul(argv[1], NULL, 0);
+    }
+    if (duration_ms == 0) {
+        fprintf(stderr, "Usage: %s [<simulated ms>]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    srand(1);
+
+    printf("objects   expiries   scan ns/ms   wheel ns/ms   speedup\n");
+    for (i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        volatile uint32_t sink = 0;
+        uint32_t scanExpired = 0;
+        uint32_t wheelExpired = 0;
+        uint16_t timerNext_ms;
+        double start;
+        double scan;
+        double wheel;
+        unsigned long t;
+
+        bench_setup(counts[i]);
+
+        start = bench_now();
+        for (t = 0; t < duration_ms; t++) {
+            timerNext_ms = 1000;
+            scanExpired += bench_scanProcess(counts[i], 1, &timerNext_ms);
+            sink += timerNext_ms;
+        }
+        scan = (bench_now() - start) * 1e9 / duration_ms;
+
+        start = bench_now();
+        for (t = 0; t < duration_ms; t++) {
+            timerNext_ms = 1000;
+            wheelExpired += bench_wheelProcess(1, &timerNext_ms);
+            sink += timerNext_ms;
+        }
+        wheel = (bench_now() - start) * 1e9 / duration_ms;
+        (void)sink;
+
+        if (scanExpired != wheelExpired) {
+            fprintf(stderr, "%u objects: %u expiries with scan, %u with wheel\n",
+                    counts[i], scanExpired, wheelExpired);
+            exit(EXIT_FAILURE);
+        }
+        printf("%7u   %8u   %10.1f   %11.1f   %6.1fx\n", counts[i], scanExpired,
+               scan, wheel, scan / wheel);
+        fflush(stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,802 @@
+/*
+ * Simulator for many CANopen devices on socketCAN interfaces.
+ *
+ * @file        CO_simulator.c
+ * @ingroup     CO_simulator
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     /* for recvmmsg() */
+#endif
+
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "CO_simulator.h"
+
+/* Scheduling state of a device */
+#define CO_SIM_NODE_IDLE     0  /* not queued, waits for messages or deadline */
+#define CO_SIM_NODE_QUEUED   1  /* in queue of a worker */
+#define CO_SIM_NODE_RUNNING  2  /* processed by a worker */
+#define CO_SIM_NODE_RERUN    3  /* processed, queue again afterwards */
+#define CO_SIM_NODE_STOPPED  4  /* CO_RESET_QUIT, not processed any more */
+
+/* Maximum time between two passes of a device in ms */
+#define CO_SIM_MAX_SLEEP_MS  1000
+
+/* receive thread checks for termination in this interval */
+#define CO_SIM_RX_TIMEOUT_MS 100
+
+
+/* Helper function - get monotonic clock time in us */
+static uint64_t CO_sim_now_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Add to statistics counter, only written by owning thread */
+static void CO_sim_statsAdd(uint64_t *counter, uint64_t value)
+{
+    __atomic_store_n(counter, *counter + value, __ATOMIC_RELAXED);
+}
+
+
+/* Worker queues ***************************************************************/
+
+/* Append device to queue of worker and wake an idle worker */
+static void CO_sim_queuePush(CO_simulator_t *sim, CO_simWorker_t *worker,
+                             CO_simNode_t *node)
+{
+    /* Each device is in at most one queue, so queues can't overflow */
+    pthread_mutex_lock(&worker->lock);
+    worker->queue[(worker->queueHead + worker->queueCount) % sim->nodeCount] = node;
+    worker->queueCount ++;
+    pthread_mutex_unlock(&worker->lock);
+
+    __atomic_add_fetch(&sim->pending, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sim->idleCount, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&sim->idleLock);
+        pthread_cond_signal(&sim->idleCond);
+        pthread_mutex_unlock(&sim->idleLock);
+    }
+}
+
+/* Take device from queue. The owner takes the oldest entry, so deadlines are
+ * processed in order. Other workers steal the newest one. */
+static CO_simNode_t *CO_sim_queuePop(CO_simulator_t *sim, CO_simWorker_t *worker,
+                                     bool_t steal)
+{
+    CO_simNode_t *node = NULL;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->queueCount > 0) {
+        worker->queueCount --;
+        if (steal) {
+            node = worker->queue[(worker->queueHead + worker->queueCount) % sim->nodeCount];
+        }
+        else {
+            node = worker->queue[worker->queueHead];
+            worker->queueHead = (worker->queueHead + 1) % sim->nodeCount;
+        }
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    if (node != NULL) {
+        __atomic_sub_fetch(&sim->pending, 1, __ATOMIC_SEQ_CST);
+    }
+    return node;
+}
+
+/* Request processing of device. If it is already queued, nothing happens. If
+ * it is processed right now, it is queued again afterwards. */
+static void CO_sim_schedule(CO_simNode_t *node)
+{
+    CO_simulator_t *sim = node->sim;
+    int state = __atomic_load_n(&node->state, __ATOMIC_ACQUIRE);
+    uint32_t worker;
+
+    for (;;) {
+        int next;
+
+        if (state == CO_SIM_NODE_IDLE) {
+            next = CO_SIM_NODE_QUEUED;
+        }
+        else if (state == CO_SIM_NODE_RUNNING) {
+            next = CO_SIM_NODE_RERUN;
+        }
+        else {
+            return;
+        }
+        if (__atomic_compare_exchange_n(&node->state, &state, next, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            if (next == CO_SIM_NODE_QUEUED) {
+                /* distribute round robin, idle workers balance by stealing */
+                worker = __atomic_fetch_add(&sim->workerNext, 1, __ATOMIC_RELAXED);
+                CO_sim_queuePush(sim, &sim->workers[worker % sim->config.workerCount], node);
+            }
+            return;
+        }
+    }
+}
+
+
+/* Devices *********************************************************************/
+
+/* (Re)initialize communication objects of device */
+static CO_ReturnError_t CO_sim_nodeCommInit(CO_simNode_t *node)
+{
+    CO_ReturnError_t err;
+
+    node->CO->CANmodule[0]->CANnormal = false;
+    err = CO_CANopenInitInstance(node->CO, node->nodeId);
+    if (err == CO_ERROR_NO) {
+        CO_CANsetNormalMode(node->CO->CANmodule[0]);
+    }
+    node->last_us = CO_sim_now_us();
+    node->remainder_us = 0;
+    node->input_us = node->last_us + node->sim->config.inputPeriod_ms * 1000;
+    return err;
+}
+
+/* Create device */
+static CO_ReturnError_t CO_sim_nodeNew(CO_simInterface_t *interface,
+                                       uint8_t nodeId, CO_simNode_t **pNode)
+{
+    CO_simNode_t *node;
+    CO_ReturnError_t err;
+
+    node = calloc(1, sizeof(*node));
+    if (node == NULL) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    *pNode = node;
+    node->sim = interface->sim;
+    node->interface = interface;
+    node->nodeId = nodeId;
+    node->state = CO_SIM_NODE_IDLE;
+    pthread_mutex_init(&node->inboxLock, NULL);
+    CO_timer_init(&node->timer, node);
+
+    err = CO_newInstance(&node->CO);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+    node->CO->OD_ROM->producerHeartbeatTime = node->sim->config.heartbeatTime_ms;
+
+    err = CO_CANinitInstance(node->CO, interface->CANbaseAddress, 0);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+    err = CO_CANmodule_addInterfaceExternal(node->CO->CANmodule[0],
+                                            interface->CANbaseAddress, interface->fd);
+    if (err != CO_ERROR_NO) {
+        return err;
+    }
+    return CO_sim_nodeCommInit(node);
+}
+
+/* Delete device */
+static void CO_sim_nodeDelete(CO_simNode_t *node)
+{
+    if (node->CO != NULL) {
+        CO_deleteInstance(node->CO, node->interface->CANbaseAddress);
+    }
+    pthread_mutex_destroy(&node->inboxLock);
+    free(node);
+}
+
+/* Store received message in inbox of device */
+static void CO_sim_nodeReceive(CO_simNode_t *node, const struct can_frame *msg,
+                               const struct timespec *timestamp)
+{
+    pthread_mutex_lock(&node->inboxLock);
+    if (node->inboxCount < CO_SIM_INBOX_SIZE) {
+        CO_simRxEntry_t *entry;
+
+        entry = &node->inbox[(node->inboxHead + node->inboxCount) % CO_SIM_INBOX_SIZE];
+        entry->msg = *msg;
+        entry->timestamp = *timestamp;
+        node->inboxCount ++;
+    }
+    else {
+        node->inboxOverflows ++;
+    }
+    pthread_mutex_unlock(&node->inboxLock);
+
+    CO_sim_schedule(node);
+}
+
+/* Pass messages from inbox to CAN module, returns number of messages */
+static uint32_t CO_sim_nodeRxProcess(CO_simNode_t *node)
+{
+    CO_simRxEntry_t entries[CO_SIM_INBOX_SIZE];
+    uint32_t count;
+    uint32_t i;
+
+    /* copy out, so the receive thread isn't blocked by processing */
+    pthread_mutex_lock(&node->inboxLock);
+    count = node->inboxCount;
+    for (i = 0; i < count; i++) {
+        entries[i] = node->inbox[(node->inboxHead + i) % CO_SIM_INBOX_SIZE];
+    }
+    node->inboxHead = (node->inboxHead + count) % CO_SIM_INBOX_SIZE;
+    node->inboxCount = 0;
+    pthread_mutex_unlock(&node->inboxLock);
+
+    for (i = 0; i < count; i++) {
+        (void)CO_CANrxFrame(node->CO->CANmodule[0], node->interface->CANbaseAddress,
+                            &entries[i].msg, &entries[i].timestamp);
+    }
+    return count;
+}
+
+/* Simulated application: counter on 6000,01, 6200,01 mirrored to 6000,02 */
+static void CO_sim_nodeApplication(CO_simNode_t *node, uint64_t now_us,
+                                   uint32_t *timerNext_us)
+{
+    uint32_t period_us = node->sim->config.inputPeriod_ms * 1000;
+
+    node->CO->OD_RAM->readInput8Bit[1] = node->CO->OD_RAM->writeOutput8Bit[0];
+
+    if (period_us == 0) {
+        return;
+    }
+    if (now_us >= node->input_us) {
+        node->CO->OD_RAM->readInput8Bit[0] ++;
+        node->input_us += period_us;
+        if (node->input_us <= now_us) {
+            /* don't catch up missed periods */
+            node->input_us = now_us + period_us;
+        }
+    }
+    if (node->input_us - now_us < *timerNext_us) {
+        *timerNext_us = (uint32_t)(node->input_us - now_us);
+    }
+}
+
+/* One processing pass of device */
+static void CO_sim_nodeProcess(CO_simWorker_t *worker, CO_simNode_t *node)
+{
+    CO_simulator_t *sim = node->sim;
+    CO_t *CO = node->CO;
+    CO_CANinterface_t *CANinterface;
+    CO_NMT_reset_cmd_t reset;
+    uint64_t now_us;
+    uint64_t late_us;
+    uint32_t diff_us;
+    uint32_t rxFrames;
+    uint16_t timerNext_ms = CO_SIM_MAX_SLEEP_MS;
+    uint32_t timerNext_us;
+    uint64_t tick;
+    uint32_t ticks;
+    bool_t syncWas;
+
+    now_us = CO_sim_now_us();
+    if (node->deadline_us != 0 && now_us >= node->deadline_us) {
+        late_us = now_us - node->deadline_us;
+        CO_sim_statsAdd(&worker->stats.deadlines, 1);
+        if (late_us > sim->config.missThreshold_us) {
+            CO_sim_statsAdd(&worker->stats.deadlineMisses, 1);
+        }
+        if (late_us > worker->stats.maxLate_us) {
+            __atomic_store_n(&worker->stats.maxLate_us, late_us, __ATOMIC_RELAXED);
+        }
+    }
+
+    rxFrames = CO_sim_nodeRxProcess(node);
+
+    /* elapsed time, CO_process() gets whole ms only */
+    diff_us = (uint32_t)(now_us - node->last_us);
+    node->last_us = now_us;
+    node->remainder_us += diff_us;
+
+    reset = CO_process(CO, (uint16_t)(node->remainder_us / 1000), &timerNext_ms);
+    node->remainder_us %= 1000;
+    timerNext_us = (uint32_t)timerNext_ms * 1000;
+
+    syncWas = CO_process_SYNC_RPDO(CO, diff_us, &timerNext_us);
+    CO_sim_nodeApplication(node, now_us, &timerNext_us);
+    CO_process_TPDO(CO, syncWas, diff_us, &timerNext_us);
+
+    CANinterface = &CO->CANmodule[0]->CANinterfaces[0];
+    CO_sim_statsAdd(&worker->stats.passes, 1);
+    CO_sim_statsAdd(&worker->stats.rxFrames, rxFrames);
+    CO_sim_statsAdd(&worker->stats.txFrames, CANinterface->txFrames - node->txFrames);
+    node->txFrames = CANinterface->txFrames;
+
+    switch (reset) {
+        case CO_RESET_COMM:
+        case CO_RESET_APP:
+            /* CAN module and Object Dictionary stay, like after power cycle
+             * of a device with stored parameters */
+            (void)CO_sim_nodeCommInit(node);
+            timerNext_us = 0;
+            break;
+        case CO_RESET_QUIT:
+            __atomic_store_n(&node->state, CO_SIM_NODE_STOPPED, __ATOMIC_RELEASE);
+            pthread_mutex_lock(&sim->wheelLock);
+            CO_timer_stop(&sim->wheel, &node->timer);
+            pthread_mutex_unlock(&sim->wheelLock);
+            node->deadline_us = 0;
+            return;
+        default:
+            break;
+    }
+
+    /* next deadline, rounded up to the next tick of the wheel. Tick n of the
+     * wheel expires at wheelStart_us + n * CO_SIM_TICK_US. */
+    tick = (now_us + timerNext_us - sim->wheelStart_us + CO_SIM_TICK_US - 1) / CO_SIM_TICK_US;
+    pthread_mutex_lock(&sim->wheelLock);
+    ticks = (tick > sim->wheel.now) ? (uint32_t)(tick - sim->wheel.now) : 1;
+    node->deadline_us = sim->wheelStart_us + (uint64_t)(sim->wheel.now + ticks) * CO_SIM_TICK_US;
+    CO_timer_start(&sim->wheel, &node->timer, ticks);
+    pthread_mutex_unlock(&sim->wheelLock);
+}
+
+
+/* Threads *********************************************************************/
+
+/* Worker thread */
+static void *CO_sim_workerThread(void *arg)
+{
+    CO_simWorker_t *worker = (CO_simWorker_t*)arg;
+    CO_simulator_t *sim = worker->sim;
+    CO_simNode_t *node;
+    uint32_t i;
+    int state;
+
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+        node = CO_sim_queuePop(sim, worker, false);
+        if (node == NULL) {
+            /* steal, start at random worker so victims are spread */
+            uint32_t start;
+
+            worker->random = worker->random * 1103515245 + 12345;
+            start = (worker->random >> 16) % sim->config.workerCount;
+            for (i = 0; i < sim->config.workerCount && node == NULL; i++) {
+                CO_simWorker_t *victim = &sim->workers[(start + i) % sim->config.workerCount];
+
+                if (victim != worker) {
+                    node = CO_sim_queuePop(sim, victim, true);
+                }
+            }
+            if (node != NULL) {
+                CO_sim_statsAdd(&worker->stats.steals, 1);
+            }
+        }
+        if (node == NULL) {
+            /* nothing to do, wait for CO_sim_queuePush() */
+            pthread_mutex_lock(&sim->idleLock);
+            __atomic_add_fetch(&sim->idleCount, 1, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&sim->pending, __ATOMIC_SEQ_CST) == 0 &&
+                   __atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+                pthread_cond_wait(&sim->idleCond, &sim->idleLock);
+            }
+            __atomic_sub_fetch(&sim->idleCount, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&sim->idleLock);
+            continue;
+        }
+
+        __atomic_store_n(&node->state, CO_SIM_NODE_RUNNING, __ATOMIC_RELEASE);
+        CO_sim_nodeProcess(worker, node);
+
+        /* events during processing queue device again */
+        state = CO_SIM_NODE_RUNNING;
+        if (!__atomic_compare_exchange_n(&node->state, &state, CO_SIM_NODE_IDLE, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) &&
+            state == CO_SIM_NODE_RERUN) {
+            __atomic_store_n(&node->state, CO_SIM_NODE_QUEUED, __ATOMIC_RELEASE);
+            CO_sim_queuePush(sim, worker, node);
+        }
+    }
+    return NULL;
+}
+
+/* Timer thread, advances wheel and queues devices with expired deadline */
+static void *CO_sim_timerThread(void *arg)
+{
+    CO_simulator_t *sim = (CO_simulator_t*)arg;
+    CO_timer_t *timer;
+    uint64_t ticks;
+    uint32_t count;
+    uint32_t i;
+
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+        if (read(sim->fdTimer, &ticks, sizeof(ticks)) != sizeof(ticks)) {
+            continue;
+        }
+
+        count = 0;
+        pthread_mutex_lock(&sim->wheelLock);
+        CO_timerWheel_process(&sim->wheel, (ticks > UINT32_MAX) ? UINT32_MAX : (uint32_t)ticks);
+        while ((timer = CO_timerWheel_getExpired(&sim->wheel)) != NULL) {
+            sim->expired[count++] = (CO_simNode_t*)timer->object;
+        }
+        pthread_mutex_unlock(&sim->wheelLock);
+
+        for (i = 0; i < count; i++) {
+            CO_sim_schedule(sim->expired[i]);
+        }
+    }
+    return NULL;
+}
+
+/* Receive thread of one interface, passes messages to devices by node ID */
+/* Pass received message to the device with its node ID, or to all devices */
+static void CO_sim_interfaceReceive(CO_simInterface_t *interface,
+                                    const struct can_frame *msg, uint32_t length,
+                                    const struct timespec *timestamp)
+{
+    uint16_t ident;
+    uint8_t nodeId;
+    uint32_t id;
+
+    if (length != CAN_MTU || (msg->can_id & (CAN_EFF_FLAG | CAN_ERR_FLAG)) != 0) {
+        /* CANopen uses 11 bit identifiers only */
+        __atomic_store_n(&interface->unmatched, interface->unmatched + 1,
+                         __ATOMIC_RELAXED);
+        return;
+    }
+    ident = msg->can_id & CAN_SFF_MASK;
+    nodeId = ident & 0x7F;
+
+    if (nodeId == 0 || ident == CO_CAN_ID_LSS_SRV) {
+        /* NMT, SYNC, TIME, LSS go to all devices */
+        for (id = 1; id <= CO_SIM_NODE_ID_MAX; id++) {
+            if (interface->nodes[id] != NULL) {
+                CO_sim_nodeReceive(interface->nodes[id], msg, timestamp);
+            }
+        }
+    }
+    else if (interface->nodes[nodeId] != NULL) {
+        CO_sim_nodeReceive(interface->nodes[nodeId], msg, timestamp);
+    }
+    else {
+        __atomic_store_n(&interface->unmatched, interface->unmatched + 1,
+                         __ATOMIC_RELAXED);
+    }
+}
+
+static void *CO_sim_rxThread(void *arg)
+{
+    CO_simInterface_t *interface = (CO_simInterface_t*)arg;
+    CO_simulator_t *sim = interface->sim;
+    struct can_frame msgs[CO_SIM_RX_BATCH];
+    struct mmsghdr hdrs[CO_SIM_RX_BATCH];
+    struct iovec iovs[CO_SIM_RX_BATCH];
+    struct timespec timestamp;
+    int n;
+    int i;
+
+    for (i = 0; i < CO_SIM_RX_BATCH; i++) {
+        iovs[i].iov_base = &msgs[i];
+        iovs[i].iov_len = sizeof(msgs[i]);
+    }
+
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+        memset(hdrs, 0, sizeof(hdrs));
+        for (i = 0; i < CO_SIM_RX_BATCH; i++) {
+            hdrs[i].msg_hdr.msg_iov = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+        n = recvmmsg(interface->fd, hdrs, CO_SIM_RX_BATCH, MSG_WAITFORONE, NULL);
+        if (n <= 0) {
+            /* timeout or interrupted */
+            continue;
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &timestamp);
+        __atomic_store_n(&interface->rxFrames, interface->rxFrames + n, __ATOMIC_RELAXED);
+
+        for (i = 0; i < n; i++) {
+            CO_sim_interfaceReceive(interface, &msgs[i], hdrs[i].msg_len, &timestamp);
+        }
+    }
+    return NULL;
+}
+
+
+/* Public functions ************************************************************/
+
+/******************************************************************************/
+CO_ReturnError_t CO_sim_init(CO_simulator_t *sim, const CO_simConfig_t *config)
+{
+    if (sim == NULL || config == NULL || config->workerCount == 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    memset(sim, 0, sizeof(*sim));
+    sim->config = *config;
+    sim->fdTimer = -1;
+    pthread_mutex_init(&sim->wheelLock, NULL);
+    pthread_mutex_init(&sim->idleLock, NULL);
+    pthread_cond_init(&sim->idleCond, NULL);
+    CO_timerWheel_init(&sim->wheel);
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_sim_addInterface(
+        CO_simulator_t         *sim,
+        const char             *ifName,
+        uint8_t                 firstNodeId,
+        uint8_t                 lastNodeId)
+{
+    CO_simInterface_t *interface;
+    CO_simNode_t **nodes;
+    struct sockaddr_can sockAddr;
+    struct timeval timeout;
+    uint32_t id;
+    CO_ReturnError_t err;
+
+    if (sim == NULL || ifName == NULL || sim->running ||
+        sim->interfaceCount >= CO_SIM_MAX_INTERFACES ||
+        firstNodeId < 1 || lastNodeId > CO_SIM_NODE_ID_MAX || firstNodeId > lastNodeId) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    interface = &sim->interfaces[sim->interfaceCount];
+    memset(interface, 0, sizeof(*interface));
+    interface->sim = sim;
+    interface->fd = -1;
+    interface->CANbaseAddress = if_nametoindex(ifName);
+    if (interface->CANbaseAddress == 0) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+    strncpy(interface->ifName, ifName, sizeof(interface->ifName) - 1);
+
+    /* one socket for all devices. Messages of the devices are not received
+     * back, as CAN_RAW_RECV_OWN_MSGS is off by default. */
+    interface->fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (interface->fd < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    /* blocking receive returns regularly, so the thread can terminate */
+    timeout.tv_sec = 0;
+    timeout.tv_usec = CO_SIM_RX_TIMEOUT_MS * 1000;
+    memset(&sockAddr, 0, sizeof(sockAddr));
+    sockAddr.can_family = AF_CAN;
+    sockAddr.can_ifindex = interface->CANbaseAddress;
+    if (setsockopt(interface->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+        bind(interface->fd, (struct sockaddr*)&sockAddr, sizeof(sockAddr)) < 0) {
+        close(interface->fd);
+        return CO_ERROR_SYSCALL;
+    }
+    sim->interfaceCount ++;
+
+    nodes = realloc(sim->nodes, (sim->nodeCount + lastNodeId - firstNodeId + 1) *
+                                sizeof(*sim->nodes));
+    if (nodes == NULL) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    sim->nodes = nodes;
+
+    for (id = firstNodeId; id <= lastNodeId; id++) {
+        err = CO_sim_nodeNew(interface, id, &interface->nodes[id]);
+        if (interface->nodes[id] != NULL) {
+            sim->nodes[sim->nodeCount++] = interface->nodes[id];
+        }
+        if (err != CO_ERROR_NO) {
+            return err;
+        }
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+CO_ReturnError_t CO_sim_start(CO_simulator_t *sim)
+{
+    struct itimerspec itval;
+    uint32_t i;
+    int ret;
+
+    if (sim == NULL || sim->nodeCount == 0 || sim->running) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    sim->workers = calloc(sim->config.workerCount, sizeof(*sim->workers));
+    sim->expired = calloc(sim->nodeCount, sizeof(*sim->expired));
+    if (sim->workers == NULL || sim->expired == NULL) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    for (i = 0; i < sim->config.workerCount; i++) {
+        CO_simWorker_t *worker = &sim->workers[i];
+
+        worker->sim = sim;
+        worker->index = i;
+        worker->random = i + 1;
+        pthread_mutex_init(&worker->lock, NULL);
+        worker->queue = calloc(sim->nodeCount, sizeof(*worker->queue));
+        if (worker->queue == NULL) {
+            return CO_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    /* absolute start time, so the time of each tick is known */
+    sim->fdTimer = timerfd_create(CLOCK_MONOTONIC, 0);
+    if (sim->fdTimer < 0) {
+        return CO_ERROR_SYSCALL;
+    }
+    sim->wheelStart_us = CO_sim_now_us();
+    itval.it_interval.tv_sec = 0;
+    itval.it_interval.tv_nsec = CO_SIM_TICK_US * 1000;
+    itval.it_value.tv_sec = (sim->wheelStart_us + CO_SIM_TICK_US) / 1000000;
+    itval.it_value.tv_nsec = ((sim->wheelStart_us + CO_SIM_TICK_US) % 1000000) * 1000;
+    (void)timerfd_settime(sim->fdTimer, TFD_TIMER_ABSTIME, &itval, NULL);
+
+    sim->running = true;
+
+    /* first pass of all devices, they set their deadlines themselves */
+    for (i = 0; i < sim->config.workerCount; i++) {
+        ret = pthread_create(&sim->workers[i].thread, NULL, CO_sim_workerThread,
+                             &sim->workers[i]);
+        if (ret != 0) {
+            CO_sim_stop(sim);
+            return CO_ERROR_SYSCALL;
+        }
+    }
+    for (i = 0; i < sim->nodeCount; i++) {
+        CO_sim_schedule(sim->nodes[i]);
+    }
+
+    ret = pthread_create(&sim->timerThread, NULL, CO_sim_timerThread, sim);
+    for (i = 0; i < sim->interfaceCount && ret == 0; i++) {
+        ret = pthread_create(&sim->interfaces[i].rxThread, NULL, CO_sim_rxThread,
+                             &sim->interfaces[i]);
+        sim->interfaces[i].rxThreadRunning = (ret == 0);
+    }
+    if (ret != 0) {
+        CO_sim_stop(sim);
+        return CO_ERROR_SYSCALL;
+    }
+
+    return CO_ERROR_NO;
+}
+
+
+/******************************************************************************/
+void CO_sim_stop(CO_simulator_t *sim)
+{
+    uint32_t i;
+
+    if (sim == NULL || !sim->running) {
+        return;
+    }
+
+    __atomic_store_n(&sim->running, false, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&sim->idleLock);
+    pthread_cond_broadcast(&sim->idleCond);
+    pthread_mutex_unlock(&sim->idleLock);
+
+    /* threads notice within one tick or one receive timeout. Threads, which
+     * failed to start, are all zero */
+    for (i = 0; i < sim->interfaceCount; i++) {
+        if (sim->interfaces[i].rxThreadRunning) {
+            pthread_join(sim->interfaces[i].rxThread, NULL);
+            sim->interfaces[i].rxThreadRunning = false;
+        }
+    }
+    if (sim->timerThread != 0) {
+        pthread_join(sim->timerThread, NULL);
+        sim->timerThread = 0;
+    }
+    for (i = 0; i < sim->config.workerCount; i++) {
+        if (sim->workers[i].thread != 0) {
+            pthread_join(sim->workers[i].thread, NULL);
+            sim->workers[i].thread = 0;
+        }
+    }
+}
+
+
+/******************************************************************************/
+void CO_sim_delete(CO_simulator_t *sim)
+{
+    uint32_t i;
+
+    if (sim == NULL) {
+        return;
+    }
+
+    for (i = 0; i < sim->nodeCount; i++) {
+        CO_sim_nodeDelete(sim->nodes[i]);
+    }
+    free(sim->nodes);
+    sim->nodes = NULL;
+    sim->nodeCount = 0;
+
+    for (i = 0; i < sim->interfaceCount; i++) {
+        close(sim->interfaces[i].fd);
+        sim->interfaces[i].fd = -1;
+    }
+    sim->interfaceCount = 0;
+
+    if (sim->workers != NULL) {
+        for (i = 0; i < sim->config.workerCount; i++) {
+            free(sim->workers[i].queue);
+            pthread_mutex_destroy(&sim->workers[i].lock);
+        }
+        free(sim->workers);
+        sim->workers = NULL;
+    }
+    free(sim->expired);
+    sim->expired = NULL;
+
+    if (sim->fdTimer >= 0) {
+        close(sim->fdTimer);
+    }
+    sim->fdTimer = -1;
+}
+
+
+/******************************************************************************/
+void CO_sim_getWorkerStats(
+        const CO_simulator_t   *sim,
+        uint32_t                worker,
+        CO_simWorkerStats_t    *stats)
+{
+    const uint64_t *src;
+    uint64_t *dst = (uint64_t*)stats;
+    size_t i;
+
+    if (sim == NULL || sim->workers == NULL || worker >= sim->config.workerCount) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    /* only 64 bit members, each is consistent */
+    src = (const uint64_t*)&sim->workers[worker].stats;
+    for (i = 0; i < sizeof(*stats) / sizeof(uint64_t); i++) {
+        dst[i] = __atomic_load_n(&src[i], __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,285 @@
+/**
+ * Simulator for many CANopen devices on socketCAN interfaces.
+ *
+ * @file        CO_simulator.h
+ * @ingroup     CO_simulator
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+#ifndef CO_SIMULATOR_H
+#define CO_SIMULATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+#include <net/if.h>
+#include <linux/can.h>
+
+#include "CO_driver.h"
+#include "CANopen.h"
+#include "CO_timerWheel.h"
+
+/**
+ * @defgroup CO_simulator Device simulator
+ * @ingroup CO_driver
+ * @{
+ *
+ * Simulation of many CANopen devices in one process, e.g. for load tests of a
+ * CANopen master.
+ *
+ * Each simulated device is a CANopen object from CO_newInstance() with its own
+ * copy of the Object Dictionary. All devices on one CAN interface share one
+ * CAN_RAW socket (#CO_CANmodule_addInterfaceExternal()). A receive thread per
+ * interface reads the socket and passes each message to the device with the
+ * node ID from the COB-ID. NMT, SYNC, TIME and LSS messages are passed to all
+ * devices of the interface.
+ *
+ * Devices are processed by a pool of worker threads. A device is queued to a
+ * worker when it received messages or when its next deadline from
+ * CO_process(), CO_process_SYNC_RPDO() or CO_process_TPDO() is reached. Idle
+ * workers steal devices from the queues of other workers. A device is never
+ * processed by two workers at the same time, so no OD lock is needed for it.
+ * Deadlines are kept in one timer wheel with a tick of #CO_SIM_TICK_US. A
+ * deadline miss is a pass which started more than
+ * CO_simConfig_t.missThreshold_us after the tick the deadline was rounded up
+ * to.
+ *
+ * Besides the communication objects configured in the Object Dictionary, each
+ * device counts up input 6000,01 in a configurable period and mirrors output
+ * 6200,01 to input 6000,02. With the Object Dictionary from example/CO_OD.c,
+ * both are mapped to TPDO 1 with change of state transmission.
+ */
+
+#ifndef CO_SIM_TICK_US
+#define CO_SIM_TICK_US 1000         /**< tick of the deadline timer wheel in us */
+#endif
+#ifndef CO_SIM_INBOX_SIZE
+#define CO_SIM_INBOX_SIZE 64        /**< received messages buffered per device */
+#endif
+#ifndef CO_SIM_RX_BATCH
+#define CO_SIM_RX_BATCH 32          /**< messages read with one recvmmsg() call */
+#endif
+#define CO_SIM_MAX_INTERFACES 8     /**< maximum number of CAN interfaces */
+#define CO_SIM_NODE_ID_MAX 127      /**< highest CANopen node ID */
+
+/**
+ * Configuration of the simulator
+ */
+typedef struct {
+    uint32_t workerCount;       /**< number of worker threads */
+    uint16_t heartbeatTime_ms;  /**< producer heartbeat time (1017), 0 for off */
+    uint16_t inputPeriod_ms;    /**< period of input changes, 0 for no changes */
+    uint32_t missThreshold_us;  /**< processing later than this after a deadline
+                                     is counted as deadline miss */
+} CO_simConfig_t;
+
+/**
+ * Statistics of one worker thread. Counters are since CO_sim_start().
+ */
+typedef struct {
+    uint64_t passes;            /**< processing passes of devices */
+    uint64_t rxFrames;          /**< messages passed to devices */
+    uint64_t txFrames;          /**< messages sent by devices */
+    uint64_t steals;            /**< devices taken from other workers */
+    uint64_t deadlines;         /**< passes which were due by a deadline */
+    uint64_t deadlineMisses;    /**< deadlines which were processed too late */
+    uint64_t maxLate_us;        /**< largest delay after a deadline */
+} CO_simWorkerStats_t;
+
+struct CO_simulator;
+struct CO_simInterface;
+
+/**
+ * Received message in inbox of a device
+ */
+typedef struct {
+    struct can_frame    msg;            /**< received message */
+    struct timespec     timestamp;      /**< time of reception (CLOCK_MONOTONIC) */
+} CO_simRxEntry_t;
+
+/**
+ * Simulated device
+ */
+typedef struct {
+    CO_t               *CO;             /**< CANopen object of this device */
+    struct CO_simulator *sim;           /**< simulator the device belongs to */
+    struct CO_simInterface *interface;  /**< CAN interface of the device */
+    uint8_t             nodeId;         /**< CANopen node ID */
+    int                 state;          /**< scheduling state, CO_SIM_NODE_xxx in CO_simulator.c */
+    CO_timer_t          timer;          /**< deadline timer, protected by _wheelLock_ */
+    uint64_t            deadline_us;    /**< time of next deadline, rounded up to a
+                                             tick of the timer wheel, 0 if none */
+    uint64_t            last_us;        /**< time of last pass */
+    uint32_t            remainder_us;   /**< time not yet given to CO_process() */
+    uint64_t            input_us;       /**< time of next input change */
+    uint32_t            txFrames;       /**< tx counter of CAN interface at last pass */
+    pthread_mutex_t     inboxLock;      /**< protects inbox */
+    uint32_t            inboxHead;      /**< oldest entry in _inbox_ */
+    uint32_t            inboxCount;     /**< number of entries in _inbox_ */
+    uint32_t            inboxOverflows; /**< statistics, messages dropped because inbox was full */
+    CO_simRxEntry_t     inbox[CO_SIM_INBOX_SIZE];
+} CO_simNode_t;
+
+/**
+ * CAN interface with its devices
+ */
+typedef struct CO_simInterface {
+    struct CO_simulator *sim;           /**< simulator the interface belongs to */
+    int32_t             CANbaseAddress; /**< interface index */
+    char                ifName[IFNAMSIZ]; /**< interface name */
+    int                 fd;             /**< CAN_RAW socket shared by all devices */
+    pthread_t           rxThread;       /**< receive thread */
+    bool_t              rxThreadRunning; /**< receive thread was started */
+    CO_simNode_t       *nodes[CO_SIM_NODE_ID_MAX + 1]; /**< devices by node ID */
+    uint64_t            rxFrames;       /**< statistics, messages received */
+    uint64_t            unmatched;      /**< statistics, messages without device */
+} CO_simInterface_t;
+
+/**
+ * Worker thread with its queue of devices
+ */
+typedef struct {
+    struct CO_simulator *sim;           /**< simulator the worker belongs to */
+    uint32_t            index;          /**< index in _workers_ */
+    pthread_t           thread;         /**< worker thread */
+    pthread_mutex_t     lock;           /**< protects the queue */
+    CO_simNode_t      **queue;          /**< ring of queued devices, one entry per device */
+    uint32_t            queueHead;      /**< oldest entry in _queue_ */
+    uint32_t            queueCount;     /**< number of entries in _queue_ */
+    uint32_t            random;         /**< state for choosing steal victims */
+    CO_simWorkerStats_t stats;          /**< written by worker thread only */
+} CO_simWorker_t;
+
+/**
+ * Simulator object
+ */
+typedef struct CO_simulator {
+    CO_simConfig_t      config;         /**< configuration */
+    CO_simInterface_t   interfaces[CO_SIM_MAX_INTERFACES]; /**< CAN interfaces */
+    uint32_t            interfaceCount; /**< number of used _interfaces_ */
+    CO_simNode_t      **nodes;          /**< all devices */
+    uint32_t            nodeCount;      /**< number of _nodes_ */
+    CO_simWorker_t     *workers;        /**< worker threads */
+    uint32_t            workerNext;     /**< worker for next device from timer or receive thread */
+    pthread_mutex_t     wheelLock;      /**< protects _wheel_ and timers of devices */
+    CO_timerWheel_t     wheel;          /**< deadlines of all devices */
+    uint64_t            wheelStart_us;  /**< time of tick 0 of _wheel_ */
+    CO_simNode_t      **expired;        /**< devices taken from _wheel_ in one tick */
+    int                 fdTimer;        /**< timerfd for wheel ticks */
+    pthread_t           timerThread;    /**< thread advancing _wheel_ */
+    pthread_mutex_t     idleLock;       /**< protects _idleCond_ */
+    pthread_cond_t      idleCond;       /**< idle workers wait here */
+    uint32_t            idleCount;      /**< number of waiting workers */
+    uint32_t            pending;        /**< number of queued devices */
+    bool_t              running;        /**< threads shall run */
+} CO_simulator_t;
+
+/**
+ * Initialize simulator object.
+ *
+ * @param sim This object will be initialized.
+ * @param config configuration, copied
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT.
+ */
+CO_ReturnError_t CO_sim_init(CO_simulator_t *sim, const CO_simConfig_t *config);
+
+/**
+ * Add CAN interface with simulated devices.
+ *
+ * Must be called before CO_sim_start(). Creates one CANopen object for each
+ * node ID from _firstNodeId_ to _lastNodeId_.
+ *
+ * @param sim This object.
+ * @param ifName CAN interface name, e.g. "can0"
+ * @param firstNodeId node ID of first device
+ * @param lastNodeId node ID of last device
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT,
+ * CO_ERROR_OUT_OF_MEMORY, CO_ERROR_SYSCALL, CO_ERROR_PARAMETERS.
+ */
+CO_ReturnError_t CO_sim_addInterface(
+        CO_simulator_t         *sim,
+        const char             *ifName,
+        uint8_t                 firstNodeId,
+        uint8_t                 lastNodeId);
+
+/**
+ * Start receive, timer and worker threads.
+ *
+ * @param sim This object.
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_OUT_OF_MEMORY,
+ * CO_ERROR_SYSCALL.
+ */
+CO_ReturnError_t CO_sim_start(CO_simulator_t *sim);
+
+/**
+ * Stop all threads. Devices keep their state.
+ *
+ * @param sim This object.
+ */
+void CO_sim_stop(CO_simulator_t *sim);
+
+/**
+ * Delete all devices and close CAN sockets. Threads must be stopped.
+ *
+ * @param sim This object.
+ */
+void CO_sim_delete(CO_simulator_t *sim);
+
+/**
+ * Get statistics of a worker thread. May be called from any thread, counters
+ * are read one by one.
+ *
+ * @param sim This object.
+ * @param worker index of worker thread
+ * @param [out] stats statistics
+ */
+void CO_sim_getWorkerStats(
+        const CO_simulator_t   *sim,
+        uint32_t                worker,
+        CO_simWorkerStats_t    *stats);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif /*__cplusplus*/
+
+#endif
@@ -0,0 +1,225 @@
+/*
+ * CANopen device simulator for load tests of a CANopen master.
+ *
+ * @file        main.c
+ * @author      Martin Wagner
+ * @copyright   2020 Neuberger Gebaeudeautomation GmbH
+ *
+ * This file is part of CANopenNode, an opensource CANopen Stack.
+ * Project home page is <https://github.com/CANopenNode/CANopenNode>.
+ * For more information on CANopen see <http://www.can-cia.org/>.
+ *
+ * CANopenNode is free and open source software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Following clarification and special exception to the GNU General Public
+ * License is included to the distribution terms of CANopenNode:
+ *
+ * Linking this library statically or dynamically with other modules is
+ * making a combined work based on this library. Thus, the terms and
+ * conditions of the GNU General Public License cover the whole combination.
+ *
+ * As a special exception, the copyright holders of this library give
+ * you permission to link this library with independent modules to
+ * produce an executable, regardless of the license terms of these
+ * independent modules, and to copy and distribute the resulting
+ * executable under terms of your choice, provided that you also meet,
+ * for each linked independent module, the terms and conditions of the
+ * license of that module. An independent module is a module which is
+ * not derived from or based on this library. If you modify this
+ * library, you may extend this exception to your version of the
+ * library, but you are not obliged to do so. If you do not wish
+ * to do so, delete this exception statement from your version.
+ */
+
+#include <sys/resource.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "CO_simulator.h"
+
+static CO_simulator_t CO_sim;
+static volatile sig_atomic_t CO_endProgram = 0;
+
+static void sigHandler(int sig)
+{
+    (void)sig;
+    CO_endProgram = 1;
+}
+
+static void usage(const char *progName)
+{
+    fprintf(stderr,
+"Usage: %s [options] <CAN interface> [<CAN interface> ...]\n"
+"\n"
+"Simulates CANopen devices with the Object Dictionary from example/CO_OD.c\n"
+"(IO.eds). Node IDs are the same on each interface.\n"
+"\n"
+"Options:\n"
+"  -f <node ID>  First node ID, default 1.\n"
+"  -l <node ID>  Last node ID, default 127.\n"
+"  -w <count>    Number of worker threads, default number of CPUs.\n"
+"  -h <ms>       Producer heartbeat time, default 1000, 0 for off.\n"
+"  -i <ms>       Period of input changes (TPDO 1), default 100, 0 for off.\n"
+"  -m <us>       Count processing later than this after a deadline as\n"
+"                deadline miss, default 1000.\n"
+"  -r <s>        Report interval, default 1.\n"
+"  -t <s>        Run time, default 0 (until SIGINT/SIGTERM).\n",
+            progName);
+}
+
+/* Print rates since last report and totals of all workers */
+static void report(const CO_simulator_t *sim, CO_simWorkerStats_t *last,
+                   double interval_s, uint32_t elapsed_s)
+{
+    CO_simWorkerStats_t stats;
+    CO_simWorkerStats_t sum;
+    uint64_t rxFrames = 0;
+    uint64_t unmatched = 0;
+    uint64_t overflows = 0;
+    uint32_t i;
+
+    memset(&sum, 0, sizeof(sum));
+    for (i = 0; i < sim->interfaceCount; i++) {
+        rxFrames += __atomic_load_n(&sim->interfaces[i].rxFrames, __ATOMIC_RELAXED);
+        unmatched += __atomic_load_n(&sim->interfaces[i].unmatched, __ATOMIC_RELAXED);
+    }
+    for (i = 0; i < sim->nodeCount; i++) {
+        overflows += __atomic_load_n(&sim->nodes[i]->inboxOverflows, __ATOMIC_RELAXED);
+    }
+    printf("%us: %u devices, bus rx %llu, unmatched %llu, inbox overflows %llu\n",
+           elapsed_s, sim->nodeCount, (unsigned long long)rxFrames,
+           (unsigned long long)unmatched, (unsigned long long)overflows);
+
+    for (i = 0; i < sim->config.workerCount; i++) {
+        CO_sim_getWorkerStats(sim, i, &stats);
+        printf("  worker %2u: %8.0f passes/s %8.0f rx/s %8.0f tx/s, steals %llu,"
+               " deadlines %llu, misses %llu, max late %llu us\n", i,
+               (stats.passes - last[i].passes) / interval_s,
+               (stats.rxFrames - last[i].rxFrames) / interval_s,
+               (stats.txFrames - last[i].txFrames) / interval_s,
+               (unsigned long long)stats.steals,
+               (unsigned long long)stats.deadlines,
+               (unsigned long long)stats.deadlineMisses,
+               (unsigned long long)stats.maxLate_us);
+        sum.passes += stats.passes - last[i].passes;
+        sum.rxFrames += stats.rxFrames - last[i].rxFrames;
+        sum.txFrames += stats.txFrames - last[i].txFrames;
+        sum.deadlines += stats.deadlines;
+        sum.deadlineMisses += stats.deadlineMisses;
+        last[i] = stats;
+    }
+    printf("  total    : %8.0f passes/s %8.0f rx/s %8.0f tx/s, deadlines %llu, misses %llu\n",
+           sum.passes / interval_s, sum.rxFrames / interval_s,
+           sum.txFrames / interval_s, (unsigned long long)sum.deadlines,
+           (unsigned long long)sum.deadlineMisses);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    CO_simConfig_t config;
+    CO_simWorkerStats_t *last;
+    CO_ReturnError_t err;
+    struct rlimit rlim;
+    struct timespec start;
+    struct timespec now;
+    struct timespec wait;
+    long firstNodeId = 1;
+    long lastNodeId = CO_SIM_NODE_ID_MAX;
+    long reportInterval = 1;
+    long runTime = 0;
+    long cpus;
+    uint32_t elapsed = 0;
+    int opt;
+    int i;
+
+    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    config.workerCount = (cpus > 0) ? (uint32_t)cpus : 1;
+    config.heartbeatTime_ms = 1000;
+    config.inputPeriod_ms = 100;
+    config.missThreshold_us = 1000;
+
+    while ((opt = getopt(argc, argv, "f:l:w:h:i:m:r:t:")) != -1) {
+        switch (opt) {
+            case 'f': firstNodeId = strtol(optarg, NULL, 0); break;
+            case 'l': lastNodeId = strtol(optarg, NULL, 0); break;
+            case 'w': config.workerCount = strtoul(optarg, NULL, 0); break;
+            case 'h': config.heartbeatTime_ms = strtoul(optarg, NULL, 0); break;
+            case 'i': config.inputPeriod_ms = strtoul(optarg, NULL, 0); break;
+            case 'm': config.missThreshold_us = strtoul(optarg, NULL, 0); break;
+            case 'r': reportInterval = strtol(optarg, NULL, 0); break;
+            case 't': runTime = strtol(optarg, NULL, 0); break;
+            default:
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (optind >= argc || firstNodeId < 1 || lastNodeId > CO_SIM_NODE_ID_MAX ||
+        firstNodeId > lastNodeId || config.workerCount == 0 || reportInterval < 1) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    /* each device has an epoll fd and a notification pipe */
+    if (getrlimit(RLIMIT_NOFILE, &rlim) == 0 && rlim.rlim_cur < rlim.rlim_max) {
+        rlim.rlim_cur = rlim.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &rlim);
+    }
+
+    err = CO_sim_init(&CO_sim, &config);
+    for (i = optind; i < argc && err == CO_ERROR_NO; i++) {
+        err = CO_sim_addInterface(&CO_sim, argv[i], firstNodeId, lastNodeId);
+        if (err != CO_ERROR_NO) {
+            fprintf(stderr, "%s: can't add devices on %s (%d)\n", argv[0], argv[i], err);
+        }
+    }
+    if (err == CO_ERROR_NO) {
+        err = CO_sim_start(&CO_sim);
+    }
+    last = calloc(config.workerCount, sizeof(*last));
+    if (err != CO_ERROR_NO || last == NULL) {
+        fprintf(stderr, "%s: start failed (%d)\n", argv[0], err);
+        CO_sim_stop(&CO_sim);
+        CO_sim_delete(&CO_sim);
+        exit(EXIT_FAILURE);
+    }
+    printf("%u devices on %u interfaces, %u workers\n", CO_sim.nodeCount,
+           CO_sim.interfaceCount, config.workerCount);
+
+    signal(SIGINT, sigHandler);
+    signal(SIGTERM, sigHandler);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    while (!CO_endProgram && (runTime == 0 || elapsed < runTime)) {
+        wait.tv_sec = reportInterval;
+        wait.tv_nsec = 0;
+        if (nanosleep(&wait, NULL) != 0) {
+            /* signal */
+            continue;
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = now.tv_sec - start.tv_sec;
+        report(&CO_sim, last, (double)reportInterval, elapsed);
+    }
+
+    CO_sim_stop(&CO_sim);
+    CO_sim_delete(&CO_sim);
+    free(last);
+
+    return 0;
+}
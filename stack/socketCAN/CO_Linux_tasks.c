@@ -278,22 +278,22 @@ bool_t CANrx_taskTmr_process(int fd) {
 
 
         /* Lock PDOs and OD */
-        CO_LOCK_OD();
+        CO_LOCK_OD(CO->CANmodule[0]);
 
         if(CO->CANmodule[0]->CANnormal) {
             bool_t syncWas;
 
             /* Process Sync and read inputs */
-            syncWas = CO_process_SYNC_RPDO(CO, taskRT.intervalus);
+            syncWas = CO_process_SYNC_RPDO(CO, taskRT.intervalus, NULL);
 
             /* Further I/O or nonblocking application code may go here. */
 
             /* Write outputs */
-            CO_process_TPDO(CO, syncWas, taskRT.intervalus);
+            CO_process_TPDO(CO, syncWas, taskRT.intervalus, NULL);
         }
 
         /* Unlock */
-        CO_UNLOCK_OD();
+        CO_UNLOCK_OD(CO->CANmodule[0]);
     }
 
     else {
@@ -29,6 +29,7 @@
 #include "CO_Emergency.h"
 #include "CO_OD_storage.h"
 #include "crc16-ccitt.h"
+#include "CANopen.h"
 
 #include <stdio.h>
 #include <string.h>     /* for memcpy */
@@ -55,6 +56,7 @@ CO_SDO_abortCode_t CO_ODF_1010(CO_ODF_arg_t *ODF_arg) {
         if(ODF_arg->subIndex == 1) {
             /* store parameters */
             if(value == 0x65766173UL) {
+                odStor->synced = false;
                 if(CO_OD_storage_saveSecure(odStor->odAddress, odStor->odSize, odStor->filename) != 0) {
                     ret = CO_SDO_AB_HW;
                 }
@@ -85,6 +87,7 @@ CO_SDO_abortCode_t CO_ODF_1011(CO_ODF_arg_t *ODF_arg) {
         if(ODF_arg->subIndex >= 1) {
             /* restore default parameters */
             if(value == 0x64616F6CUL) {
+                odStor->synced = false;
                 if(CO_OD_storage_restoreSecure(odStor->filename) != 0) {
                     ret = CO_SDO_AB_HW;
                 }
@@ -129,10 +132,10 @@ int CO_OD_storage_saveSecure(
         FILE *fp = fopen(filename, "w");
         if(fp != NULL) {
 
-            CO_LOCK_OD();
+            CO_LOCK_OD(CO->CANmodule[0]);
             fwrite((const void *)odAddress, 1, odSize, fp);
             CRC = crc16_ccitt((unsigned char*)odAddress, odSize, 0);
-            CO_UNLOCK_OD();
+            CO_UNLOCK_OD(CO->CANmodule[0]);
 
             fwrite((const void *)&CRC, 1, 2, fp);
             fclose(fp);
@@ -244,6 +247,8 @@ CO_ReturnError_t CO_OD_storage_init(
         odStor->fp = NULL;
         odStor->tmr1msPrev = 0;
         odStor->lastSavedMs = 0;
+        odStor->SDO = NULL;
+        odStor->synced = false;
 
         buf = malloc(odStor->odSize);
         if(buf == NULL) {
@@ -290,6 +295,44 @@ CO_ReturnError_t CO_OD_storage_init(
 }
 
 
+/******************************************************************************/
+CO_ReturnError_t CO_OD_storage_initDirty(
+        CO_OD_storage_t        *odStor,
+        CO_SDO_t               *SDO)
+{
+    CO_ReturnError_t ret = CO_ERROR_NO;
+    uint32_t *bits;
+    uint16_t words;
+
+    /* verify arguments */
+    if(odStor==NULL || odStor->odAddress==NULL || SDO==NULL || odStor->SDO!=NULL) {
+        return CO_ERROR_ILLEGAL_ARGUMENT;
+    }
+
+    /* one allocation for bits and mask */
+    words = CO_OD_DIRTY_WORDS(CO_OD_getDescriptorCount(SDO->OD, SDO->ODSize));
+    bits = calloc(2U * words, sizeof(uint32_t));
+    if(bits == NULL) {
+        return CO_ERROR_OUT_OF_MEMORY;
+    }
+    CO_OD_dirtyMaskRange(SDO, &bits[words], words, odStor->odAddress, odStor->odSize);
+
+    CO_LOCK_OD(SDO->CANdevTx);
+    ret = CO_OD_dirtyRegister(SDO, &odStor->dirty, bits, &bits[words], words);
+    CO_UNLOCK_OD(SDO->CANdevTx);
+
+    if(ret == CO_ERROR_NO) {
+        odStor->SDO = SDO;
+        odStor->synced = false;
+    }
+    else {
+        free(bits);
+    }
+
+    return ret;
+}
+
+
 /******************************************************************************/
 CO_ReturnError_t CO_OD_storage_autoSave(
         CO_OD_storage_t        *odStor,
@@ -311,6 +354,21 @@ CO_ReturnError_t CO_OD_storage_autoSave(
         void *buf = NULL;
         bool_t saveData = false;
 
+        /* nothing written to memory block since file was verified */
+        if(ret == CO_ERROR_NO && odStor->SDO != NULL) {
+            bool_t dirty;
+
+            CO_LOCK_OD(odStor->SDO->CANdevTx);
+            dirty = CO_OD_dirtyClear(&odStor->dirty);
+            CO_UNLOCK_OD(odStor->SDO->CANdevTx);
+
+            if(odStor->synced && !dirty) {
+                odStor->tmr1msPrev = timer1ms;
+                return CO_ERROR_NO;
+            }
+            odStor->synced = false;
+        }
+
         /* allocate buffer and open file if necessary */
         if(ret == CO_ERROR_NO) {
             buf = malloc(odStor->odSize);
@@ -364,6 +422,10 @@ CO_ReturnError_t CO_OD_storage_autoSave(
             odStor->lastSavedMs = 0;
         }
 
+        if(ret == CO_ERROR_NO) {
+            odStor->synced = true;
+        }
+
         free(buf);
     }
 
@@ -376,4 +438,11 @@ void CO_OD_storage_autoSaveClose(CO_OD_storage_t *odStor) {
     if(odStor->fp != NULL) {
         fclose(odStor->fp);
     }
+    if(odStor->SDO != NULL) {
+        CO_LOCK_OD(odStor->SDO->CANdevTx);
+        CO_OD_dirtyUnregister(odStor->SDO, &odStor->dirty);
+        CO_UNLOCK_OD(odStor->SDO->CANdevTx);
+        free(odStor->dirty.bits);
+        odStor->SDO = NULL;
+    }
 }
@@ -97,6 +97,12 @@ typedef struct {
     FILE       *fp;
     uint16_t    tmr1msPrev;     /**< used with CO_OD_storage_autoSave. */
     uint32_t    lastSavedMs;    /**< used with CO_OD_storage_autoSave. */
+    /** From CO_OD_storage_initDirty(), NULL if dirty bits are not used. */
+    CO_SDO_t   *SDO;
+    /** Dirty bits of the memory block, used with CO_OD_storage_autoSave. */
+    CO_OD_dirty_t dirty;
+    /** True, if file is known to be equal to the memory block. */
+    bool_t      synced;
 } CO_OD_storage_t;
 
 
@@ -122,6 +128,26 @@ CO_ReturnError_t CO_OD_storage_init(
         char                   *filename);
 
 
+/**
+ * Use dirty bits of the Object Dictionary with CO_OD_storage_autoSave().
+ *
+ * Optional, called after CO_OD_storage_init() and CO_SDO_init(). Once the file
+ * is verified to be equal to the memory block, CO_OD_storage_autoSave() reads
+ * and compares the file only after a write to the memory block by SDO, RPDO or
+ * CO_OD_markDirty(). Direct writes of the application to the variables of the
+ * memory block must be reported with CO_OD_markDirty().
+ *
+ * @param odStor OD storage object.
+ * @param SDO SDO server object with the Object Dictionary.
+ *
+ * @return #CO_ReturnError_t: CO_ERROR_NO, CO_ERROR_ILLEGAL_ARGUMENT or
+ * CO_ERROR_OUT_OF_MEMORY (malloc failed).
+ */
+CO_ReturnError_t CO_OD_storage_initDirty(
+        CO_OD_storage_t        *odStor,
+        CO_SDO_t               *SDO);
+
+
 /**
  * Automatically save memory block if differs from file.
  *
@@ -143,7 +169,8 @@ CO_ReturnError_t CO_OD_storage_autoSave(
 
 
 /**
- * Closes file opened by CO_OD_storage_autoSave.
+ * Closes file opened by CO_OD_storage_autoSave and releases dirty bits from
+ * CO_OD_storage_initDirty.
  *
  * @param odStor OD storage object.
  */
@@ -53,27 +53,27 @@
 
 /* Critical sections */
 #ifdef CO_SINGLE_THREAD
-    #define CO_LOCK_CAN_SEND()
-    #define CO_UNLOCK_CAN_SEND()
+    #define CO_LOCK_CAN_SEND(CAN_MODULE)
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE)
 
-    #define CO_LOCK_EMCY()
-    #define CO_UNLOCK_EMCY()
+    #define CO_LOCK_EMCY(CAN_MODULE)
+    #define CO_UNLOCK_EMCY(CAN_MODULE)
 
-    #define CO_LOCK_OD()
-    #define CO_UNLOCK_OD()
+    #define CO_LOCK_OD(CAN_MODULE)
+    #define CO_UNLOCK_OD(CAN_MODULE)
 
     #define CANrxMemoryBarrier()
 #else
-    #define CO_LOCK_CAN_SEND()      /* not needed */
-    #define CO_UNLOCK_CAN_SEND()
+    #define CO_LOCK_CAN_SEND(CAN_MODULE) /* not needed */
+    #define CO_UNLOCK_CAN_SEND(CAN_MODULE)
 
     extern pthread_mutex_t CO_EMCY_mtx;
-    #define CO_LOCK_EMCY()          {if(pthread_mutex_lock(&CO_EMCY_mtx) != 0) CO_errExit("Mutex lock CO_EMCY_mtx failed");}
-    #define CO_UNLOCK_EMCY()        {if(pthread_mutex_unlock(&CO_EMCY_mtx) != 0) CO_errExit("Mutex unlock CO_EMCY_mtx failed");}
+    #define CO_LOCK_EMCY(CAN_MODULE) {if(pthread_mutex_lock(&CO_EMCY_mtx) != 0) CO_errExit("Mutex lock CO_EMCY_mtx failed");}
+    #define CO_UNLOCK_EMCY(CAN_MODULE) {if(pthread_mutex_unlock(&CO_EMCY_mtx) != 0) CO_errExit("Mutex unlock CO_EMCY_mtx failed");}
 
     extern pthread_mutex_t CO_OD_mtx;
-    #define CO_LOCK_OD()            {if(pthread_mutex_lock(&CO_OD_mtx) != 0) CO_errExit("Mutex lock CO_OD_mtx failed");}
-    #define CO_UNLOCK_OD()          {if(pthread_mutex_unlock(&CO_OD_mtx) != 0) CO_errExit("Mutex unlock CO_OD_mtx failed");}
+    #define CO_LOCK_OD(CAN_MODULE)  {if(pthread_mutex_lock(&CO_OD_mtx) != 0) CO_errExit("Mutex lock CO_OD_mtx failed");}
+    #define CO_UNLOCK_OD(CAN_MODULE) {if(pthread_mutex_unlock(&CO_OD_mtx) != 0) CO_errExit("Mutex unlock CO_OD_mtx failed");}
 
     #define CANrxMemoryBarrier()    {__sync_synchronize();}
 #endif